@@ -31,6 +31,58 @@
 
 #include "fnft_kdv_discretization_t.h"
 
+/**
+ * Enum that specifies how the bound states are localized. Used in
+ * \link fnft_kdvv_opts_t \endlink. \n \n
+ * @ingroup data_types
+ *  fnft_kdvv_bsloc_NEWTON: Newton's method is used to refine a given set of
+ *  initial guesses. The discretization used for the refinement is the one due
+ *  to Boffetta and Osborne. The number of iterations is specified through the
+ *  field \link fnft_kdvv_opts_t::niter \endlink. The array bound_states
+ *  passed to \link fnft_kdvv \endlink should contain the initial guesses and
+ *  *K_ptr should specify the number of initial guesses. It is sufficient if
+ *  bound_states and normconst_or_residues are of length *K_ptr in this case.
+ *  The complexity is \f$ O(niter (*K\_ptr) D) \f$. \n \n
+ *  fnft_kdvv_bsloc_SUBSAMPLE_AND_REFINE: The initial guesses for the NEWTON
+ *  method are found automatically. The transfer matrix of a subsampled
+ *  version of the signal is computed with the discretization
+ *  fnft_kdv_discretization_2SPLIT4B, independently of
+ *  \link fnft_kdvv_opts_t::discretization \endlink. (The high polynomial
+ *  degrees of some of the other discretizations would make the fast eigenvalue
+ *  method expensive, while only rough initial guesses are needed.) The function
+ *  \f$ 2j\lambda a(\lambda) \f$, whose zeros are the bound states, is
+ *  approximated by a polynomial in \f$ z \f$ by replacing \f$ 2j\lambda \f$ with
+ *  a rational approximation, and the roots of this polynomial are found using
+ *  the fast eigenvalue method. Roots close to the positive imaginary axis are
+ *  projected onto it and refined using the NEWTON method w.r.t. the full
+ *  signal. The number of samples of the subsampled signal can be controlled
+ *  using the parameter Dsub in \link fnft_kdvv_opts_t \endlink. If Dsub=0,
+ *  the routine automatically chooses this number such that the complexity is
+ *  \f$ O(D \log^2 D + niter K D) \f$, where \f$ K \f$ is the number of initial
+ *  guesses.
+ */
+typedef enum {
+    fnft_kdvv_bsloc_NEWTON,
+    fnft_kdvv_bsloc_SUBSAMPLE_AND_REFINE
+} fnft_kdvv_bsloc_t;
+
+/**
+ * Enum that specifies the type of the discrete spectrum computed by the
+ * routine. Used in \link fnft_kdvv_opts_t \endlink.\n \n
+ * @ingroup data_types
+ *  fnft_kdvv_dstype_NORMING_CONSTANTS: The array is filled with the norming constants
+ *  \f$ b_k \f$. \n\n
+ *  fnft_kdvv_dstype_RESIDUES: The array is filled with the residues (aka spectral amplitudes)
+ *  \f$ b_k\big/\frac{da(\lambda_k)}{d\lambda} \f$. \n \n
+ *  fnft_kdvv_dstype_BOTH: The array contains both, first the norming constants and then the
+ *  residues. Note that the length of the array passed by the user has to be 2*(*K_ptr) in this case.
+ */
+typedef enum {
+    fnft_kdvv_dstype_NORMING_CONSTANTS,
+    fnft_kdvv_dstype_RESIDUES,
+    fnft_kdvv_dstype_BOTH
+} fnft_kdvv_dstype_t;
+
 /**
  * @struct fnft_kdvv_opts_t
  * @brief Stores additional options for the routine \link fnft_kdvv \endlink. 
@@ -42,9 +94,39 @@
  * @var fnft_kdvv_opts_t::discretization
  *  Controls which discretization is applied to the continuous-time scattering
  *  problem. See \link fnft_kdv_discretization_t \endlink.
+ *
+ * @var fnft_kdvv_opts_t::bound_state_localization
+ *  Controls how \link fnft_kdvv \endlink localizes bound states. \n
+ * Should be of type \link fnft_kdvv_bsloc_t \endlink.
+ *
+ * @var fnft_kdvv_opts_t::niter
+ *  Number of Newton iterations to be carried out when the
+ *  fnft_kdvv_bsloc_NEWTON or the fnft_kdvv_bsloc_SUBSAMPLE_AND_REFINE method
+ *  is used.
+ *
+ * @var fnft_kdvv_opts_t::Dsub
+ *   Controls how many samples are used after subsampling when bound states are
+ *   localized using the fnft_kdvv_bsloc_SUBSAMPLE_AND_REFINE method. See
+ *   \link fnft_kdvv_bsloc_t \endlink for details.
+ *
+ * @var fnft_kdvv_opts_t::discspec_type
+ *  Controls how \link fnft_kdvv \endlink fills the array
+ *  normconsts_or_residues. \n
+ * Should be of type \link fnft_kdvv_dstype_t \endlink.
+ *
+ * @var fnft_kdvv_opts_t::normalization_flag
+ *  Controls whether intermediate results during the fast forward scattering
+ *  step are normalized. This takes a bit longer but prevents overflows for
+ *  long or high-amplitude signals. By default, normalization is enabled
+ *  (i.e., the flag is one). To disable, set the flag to zero.
  */
 typedef struct {
     fnft_kdv_discretization_t discretization;
+    fnft_kdvv_bsloc_t bound_state_localization;
+    FNFT_UINT niter;
+    FNFT_UINT Dsub;
+    fnft_kdvv_dstype_t discspec_type;
+    FNFT_INT normalization_flag;
 } fnft_kdvv_opts_t;
 
 /**
@@ -82,13 +164,28 @@ fnft_kdvv_opts_t fnft_kdvv_default_opts();
  * desired samples \f$ R(\xi_m) \f$ of the continuous spectrum (aka
  * reflection coefficient) in ascending order,
  * where \f$ \xi_m = XI[0]+m(XI[1]-XI[0])/(M-1) \f$ and \f$m=0,1,\dots,M-1\f$.
- * Has to be preallocated by the user.
+ * Has to be preallocated by the user. If NULL is passed instead, the
+ * continuous spectrum will not be computed.
  * @param[in] XI Array of length 2, contains the position of the first and the
  * last sample of the continuous spectrum. It should be XI[0]<XI[1]. Can also be
  * NULL if contspec==NULL.
- * @param[in,out] K_ptr Not yet implemented. Pass NULL.
- * @param[out] bound_states Not yet implemented. Pass NULL.
- * @param[out] normconsts_or_residues Not yet implemented. Pass NULL.
+ * @param[in,out] K_ptr Upon entry, *K_ptr should contain the length of the array
+ *  bound_states. Upon return, *K_ptr contains the number of actually detected
+ *  bound states. If the length of the array bound_states was not sufficient
+ *  to store all of the detected bound states, a warning is printed and as many
+ *  bound states as possible are returned instead.
+ * @param[out] bound_states Array. Upon return, the routine has stored the
+ *  detected bound states (aka eigenvalues) in the first *K_ptr entries of
+ *  this array. The bound states \f$ \lambda_k \f$ lie on the positive
+ *  imaginary axis. If NULL is passed instead, the discrete spectrum will not
+ *  be computed. Has to be preallocated by the user.
+ * @param[out] normconsts_or_residues Array of the same length as bound_states.
+ *  Upon return, the routine has stored the norming constants
+ *  \f$ b_k \f$ in the first *K_ptr entries of this array. By passing a
+ *  proper opts, it is also possible to store the residues
+ *  \f$ b_k\big/ \frac{da(\lambda_k)}{d\lambda} \f$ or both. Has to be
+ *  pre-allocated by the user. If NULL is passed instead, neither will be
+ *  computed.
  * @param[in] opts_ptr Pointer to a \link fnft_kdvv_opts_t \endlink object. The
  * object can be used to modify the behavior of the routine. Use
  * the routine \link fnft_kdvv_default_opts \endlink
@@ -110,6 +207,11 @@ FNFT_INT fnft_kdvv(const FNFT_UINT D, FNFT_COMPLEX * const q,
 
 #ifdef FNFT_ENABLE_SHORT_NAMES
 #define kdvv_opts_t fnft_kdvv_opts_t
+#define kdvv_bsloc_NEWTON fnft_kdvv_bsloc_NEWTON
+#define kdvv_bsloc_SUBSAMPLE_AND_REFINE fnft_kdvv_bsloc_SUBSAMPLE_AND_REFINE
+#define kdvv_dstype_NORMING_CONSTANTS fnft_kdvv_dstype_NORMING_CONSTANTS
+#define kdvv_dstype_RESIDUES fnft_kdvv_dstype_RESIDUES
+#define kdvv_dstype_BOTH fnft_kdvv_dstype_BOTH
 #endif
 
 #endif
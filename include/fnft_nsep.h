@@ -65,6 +65,48 @@ typedef enum {
     fnft_nsep_filt_AUTO
 } fnft_nsep_filt_t;
 
+/**
+ * Enum that controls which polynomial root finder is used by the
+ * SUBSAMPLE_AND_REFINE and MIXED localization methods. Used in
+ * \link fnft_nsep_opts_t \endlink.\n \n
+ * @ingroup data_types
+ *  fnft_nsep_rootfind_FAST_EIGENVALUE: Uses
+ *  \link fnft__poly_roots_fasteigen \endlink.\n\n
+ *  fnft_nsep_rootfind_ABERTH: Uses \link fnft__poly_roots_aberth \endlink
+ *  (see \link fnft_nsev_rootfind_t \endlink).
+ */
+typedef enum {
+    fnft_nsep_rootfind_FAST_EIGENVALUE,
+    fnft_nsep_rootfind_ABERTH
+} fnft_nsep_rootfind_t;
+
+/**
+ * Enum that controls how the functions whose roots are the main and
+ * auxiliary spectra are evaluated during the refinement step of the
+ * SUBSAMPLE_AND_REFINE and MIXED localization methods. Used in
+ * \link fnft_nsep_opts_t \endlink.\n \n
+ * @ingroup data_types
+ *  fnft_nsep_ref_BO: The discretization due to Boffetta and Osborne is used.
+ *  Each evaluation costs \f$ O(D) \f$ operations per point, including the
+ *  evaluation of transcendental functions.\n\n
+ *  fnft_nsep_ref_POLY: The monodromy matrix of the complete signal is
+ *  computed once with the fast forward scattering method that is specified
+ *  in \link fnft_nsep_opts_t::discretization \endlink. The polynomials that
+ *  approximate \f$ \Delta(z)\pm 2 \f$ and \f$ b(z) \f$ are then evaluated
+ *  together with their derivatives using Horner's method (see
+ *  \link fnft__poly_evalderiv \endlink). Each evaluation costs
+ *  \f$ O(D) \f$ multiply-adds per point. The spectra are only as accurate
+ *  as the chosen discretization.\n\n
+ *  fnft_nsep_ref_POLY_AND_BO: Same as fnft_nsep_ref_POLY, but a single
+ *  Newton step using the discretization due to Boffetta and Osborne is
+ *  carried out afterwards to polish the spectra.
+ */
+typedef enum {
+    fnft_nsep_ref_BO,
+    fnft_nsep_ref_POLY,
+    fnft_nsep_ref_POLY_AND_BO
+} fnft_nsep_ref_t;
+
 /**
  * @struct fnft_nsep_opts_t
  * @brief Stores additional options for the routine \link fnft_nsep \endlink.
@@ -103,6 +145,26 @@ typedef enum {
  *
  * @var fnft_nsep_opts_t::normalization_flag
  *  See \link fnft_nsev_opts_t::normalization_flag \endlink.
+ *
+ * @var fnft_nsep_opts_t::root_finder
+ *  Controls how the roots of the polynomials that approximate the
+ *  main and auxiliary spectra are computed. \n
+ *  Should be of type \link fnft_nsep_rootfind_t \endlink.
+ *
+ * @var fnft_nsep_opts_t::refinement
+ *  Controls how the main and auxiliary spectra are evaluated during the
+ *  refinement of the roots. \n
+ *  Should be of type \link fnft_nsep_ref_t \endlink.
+ *
+ * @var fnft_nsep_opts_t::adaptive_gridsearch_flag
+ *  If set, the real points of the main and auxiliary spectra are localized
+ *  with a coarse-to-fine grid search that evaluates the fine grid only
+ *  around candidates found on a coarse grid. The memory requirements of
+ *  the grid search then no longer grow with the size of the fine grid,
+ *  which is 32 times the degree of the polynomials. It is only faster if
+ *  the spectra have few real points. For typical periodic signals, whose
+ *  real points cover the whole grid, it is 20 to 35 percent slower than the
+ *  default full grid search.
  */
 typedef struct {
     fnft_nsep_loc_t localization;
@@ -111,6 +173,9 @@ typedef struct {
     FNFT_UINT max_evals;
     fnft_nse_discretization_t discretization;
     FNFT_INT normalization_flag;
+    fnft_nsep_rootfind_t root_finder;
+    fnft_nsep_ref_t refinement;
+    FNFT_INT adaptive_gridsearch_flag;
 } fnft_nsep_opts_t;
 
 /**
@@ -128,6 +193,9 @@ typedef struct {
  *  bounding_box[3] = FNFT_INF\n
  *  normalization_flag = 1\n
  *  discretization = fnft_nse_discretization_2SPLIT2A\n
+ *  root_finder = fnft_nsep_rootfind_FAST_EIGENVALUE\n
+ *  refinement = fnft_nsep_ref_BO\n
+ *  adaptive_gridsearch_flag = 0\n
  */
 fnft_nsep_opts_t fnft_nsep_default_opts();
 
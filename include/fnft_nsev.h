@@ -28,6 +28,7 @@
 #define FNFT_NSEV_H
 
 #include "fnft_nse_discretization_t.h"
+#include "fnft_sample_desc_t.h"
 
 /**
  * Enum that specifies how the bound states are filtered. Used in
@@ -77,14 +78,68 @@ typedef enum {
  *  call to the fnft_nsev_bsloc_FAST_EIGENVALUE method w.r.t. the subsampled
  *  signal. By choosing Dsub between 2 and D, the user can be request a
  *  different number of samples. Note that algorithm uses this value only as an
- *  indication.
+ *  indication. \n \n
+ *  fnft_nsev_bsloc_ARGUMENT_PRINCIPLE: Only the region in which the
+ *  fnft_nsev_bsfilt_FULL filter accepts bound states is searched. The
+ *  number of roots of \f$ a(\lambda) \f$ in a box is found using the
+ *  argument principle, where \f$ a(\lambda) \f$ is evaluated along the
+ *  boundary using the transfer matrix. Boxes with more than one root are
+ *  subdivided. The roots are then computed from contour integrals using the
+ *  method of Delves and Lyness, and finally refined using the NEWTON method.
+ *  The complexity grows with the number of bound states instead of with
+ *  \f$ D^2 \f$.
  */
 typedef enum {
     fnft_nsev_bsloc_FAST_EIGENVALUE,
     fnft_nsev_bsloc_NEWTON,
-    fnft_nsev_bsloc_SUBSAMPLE_AND_REFINE
+    fnft_nsev_bsloc_SUBSAMPLE_AND_REFINE,
+    fnft_nsev_bsloc_ARGUMENT_PRINCIPLE
 } fnft_nsev_bsloc_t;
 
+/**
+ * Enum that specifies how the Newton iterations used by the
+ * fnft_nsev_bsloc_NEWTON and the fnft_nsev_bsloc_SUBSAMPLE_AND_REFINE methods
+ * evaluate \f$ a(\lambda) \f$ and its derivative. Used in
+ * \link fnft_nsev_opts_t \endlink. \n \n
+ * @ingroup data_types
+ *  fnft_nsev_bsref_BO: The discretization due to Boffetta and Osborne is
+ *  used. Each iteration costs \f$ O(D) \f$ operations per bound state,
+ *  including the evaluation of transcendental functions. \n \n
+ *  fnft_nsev_bsref_POLY: The polynomial \f$ a(z) \f$ that is part of the
+ *  already computed transfer matrix and its derivative are evaluated using
+ *  Horner's method instead. Each iteration then costs \f$ O(\deg) \f$
+ *  multiply-adds per bound state. The bound states are only as accurate as
+ *  the discretization in \link fnft_nsev_opts_t::discretization \endlink.
+ *  \n \n
+ *  fnft_nsev_bsref_POLY_AND_BO: Same as fnft_nsev_bsref_POLY, but a single
+ *  Newton step using the discretization due to Boffetta and Osborne is
+ *  carried out afterwards to polish the bound states.
+ */
+typedef enum {
+    fnft_nsev_bsref_BO,
+    fnft_nsev_bsref_POLY,
+    fnft_nsev_bsref_POLY_AND_BO
+} fnft_nsev_bsref_t;
+
+/**
+ * Enum that specifies which polynomial root finder is used by the
+ * fnft_nsev_bsloc_FAST_EIGENVALUE and the
+ * fnft_nsev_bsloc_SUBSAMPLE_AND_REFINE methods. Used in
+ * \link fnft_nsev_opts_t \endlink. \n \n
+ * @ingroup data_types
+ *  fnft_nsev_rootfind_FAST_EIGENVALUE: The roots are computed as the
+ *  eigenvalues of the companion matrix using the fast QR algorithm in
+ *  \link fnft__poly_roots_fasteigen \endlink. \n \n
+ *  fnft_nsev_rootfind_ABERTH: All roots are refined simultaneously using the
+ *  Aberth-Ehrlich method in \link fnft__poly_roots_aberth \endlink. The
+ *  updates of the different roots are independent, which allows to
+ *  parallelize them if FNFT has been built with OpenMP support.
+ */
+typedef enum {
+    fnft_nsev_rootfind_FAST_EIGENVALUE,
+    fnft_nsev_rootfind_ABERTH
+} fnft_nsev_rootfind_t;
+
 /**
  * Enum that specifies the type of the discrete spectrum computed by the
  * routine. Used in \link fnft_nsev_opts_t \endlink.\n \n
@@ -142,15 +197,71 @@ typedef enum {
  *  Controls how \link fnft_nsev \endlink localizes bound states. \n
  * Should be of type \link fnft_nsev_bsloc_t \endlink.
  *
+ * @var fnft_nsev_opts_t::bound_state_refinement
+ *  Controls how \link fnft_nsev \endlink evaluates \f$ a(\lambda) \f$
+ *  during the Newton iterations. \n
+ * Should be of type \link fnft_nsev_bsref_t \endlink.
+ *
+ * @var fnft_nsev_opts_t::root_finder
+ *  Controls how \link fnft_nsev \endlink computes the roots of the
+ *  polynomial \f$ a(z) \f$. \n
+ * Should be of type \link fnft_nsev_rootfind_t \endlink.
+ *
+ * @var fnft_nsev_opts_t::spectral_splitting_flag
+ *  Controls whether the fnft_nsev_bsloc_FAST_EIGENVALUE and the
+ *  fnft_nsev_bsloc_SUBSAMPLE_AND_REFINE methods first split off the factor
+ *  of the polynomial \f$ a(z) \f$ whose roots can survive the filtering
+ *  (see \link fnft__poly_specfact_annulus \endlink). Only this factor,
+ *  whose degree is often much lower than the degree of \f$ a(z) \f$, is
+ *  then passed to the root finder. The splitting is only carried out if
+ *  \link fnft_nsev_opts_t::bound_state_filtering \endlink is not
+ *  fnft_nsev_bsfilt_NONE. If roots are located very close to the boundary
+ *  of the search region, the splitting is skipped automatically. By default,
+ *  the splitting is disabled (i.e., the flag is zero). To enable, set the
+ *  flag to one.\n\n
+ *
+ * @var fnft_nsev_opts_t::bound_state_counting_flag
+ *  Controls whether \link fnft_nsev \endlink first counts the bound states
+ *  that can pass the fnft_nsev_bsfilt_FULL filter. The count is the winding
+ *  number of \f$ a(\lambda) \f$ along the boundary of the region in which
+ *  this filter accepts bound states, which includes the real axis
+ *  (argument principle). It is cheap compared to the localization of the
+ *  bound states. If the count is zero, the localization is skipped. If the
+ *  fnft_nsev_bsloc_SUBSAMPLE_AND_REFINE method does not find as many bound
+ *  states as counted, the fnft_nsev_bsloc_FAST_EIGENVALUE method is
+ *  applied to the full signal. For the other methods, a warning is issued
+ *  in this case. The count is only carried out if
+ *  \link fnft_nsev_opts_t::bound_state_filtering \endlink is
+ *  fnft_nsev_bsfilt_FULL. By default, the counting is disabled (i.e., the
+ *  flag is zero). To enable, set the flag to one.\n\n
+ *
+ * @var fnft_nsev_opts_t::richardson_extrapolation_flag
+ *  Controls whether \link fnft_nsev \endlink improves the continuous
+ *  spectrum and the bound states using Richardson extrapolation. Both are
+ *  computed a second time for the signal that is obtained by keeping every
+ *  second sample. The leading error terms of the discretization then cancel
+ *  in a suitable linear combination of both results. The orders of
+ *  accuracy of the discretizations are listed in
+ *  \link fnft_nse_discretization_t \endlink. The Boffetta-Osborne
+ *  discretization, which is used to refine bound states, has order two.
+ *  Bound states are extrapolated using the order of the discretization with
+ *  which they have been refined. The norming constants and residues are not
+ *  extrapolated. The number of samples D has to be odd so that both
+ *  signals cover the same interval T. For even D, a warning is issued and
+ *  the extrapolation is skipped. The extrapolation
+ *  increases the run time by about 50 percent. It is only applied by
+ *  \link fnft_nsev \endlink itself. By default, the extrapolation is
+ *  disabled (i.e., the flag is zero). To enable, set the flag to one.\n\n
+ *
  * @var fnft_nsev_opts_t::Dsub
  *   Controls how many samples are used after subsampling when bound states are
  *   localized using the fnft_nsev_bsloc_SUBSAMPLE_AND_REFINE method. See
  *   \link fnft_nsev_bsloc_t \endlink for details.
  *
  * @var fnft_nsev_opts_t::niter
- *  Number of Newton iterations to be carried out when either the
- *  fnft_nsev_bsloc_NEWTON or the fnft_nsev_bsloc_SUBSAMPLE_AND_REFINE method
- *  is used.
+ *  Number of Newton iterations to be carried out when the
+ *  fnft_nsev_bsloc_NEWTON, the fnft_nsev_bsloc_SUBSAMPLE_AND_REFINE or the
+ *  fnft_nsev_bsloc_ARGUMENT_PRINCIPLE method is used.
  *
  * @var fnft_nsev_opts_t::discspec_type
  *  Controls how \link fnft_nsev \endlink fills the array
@@ -181,6 +292,11 @@ typedef struct {
     fnft_nsev_cstype_t contspec_type;
     FNFT_INT normalization_flag;
     fnft_nse_discretization_t discretization;
+    fnft_nsev_bsref_t bound_state_refinement;
+    fnft_nsev_rootfind_t root_finder;
+    FNFT_INT spectral_splitting_flag;
+    FNFT_INT bound_state_counting_flag;
+    FNFT_INT richardson_extrapolation_flag;
 } fnft_nsev_opts_t;
 
 /**
@@ -195,6 +311,11 @@ typedef struct {
  *  contspec_type = fnft_nsev_cstype_REFLECTION_COEFFICIENT\n
  *  normalization_flag = 1\n
  *  discretization = fnft_nse_discretization_2SPLIT4B\n
+ *  bound_state_refinement = fnft_nsev_bsref_BO\n
+ *  root_finder = fnft_nsev_rootfind_FAST_EIGENVALUE\n
+ *  spectral_splitting_flag = 0\n
+ *  bound_state_counting_flag = 0\n
+ *  richardson_extrapolation_flag = 0\n
  *
   * @ingroup fnft
  */
@@ -294,6 +415,556 @@ FNFT_INT fnft_nsev(const FNFT_UINT D, FNFT_COMPLEX * const q,
     FNFT_COMPLEX * const normconsts_or_residues, const FNFT_INT kappa,
     fnft_nsev_opts_t *opts);
 
+/**
+ * @brief Same as \link fnft_nsev \endlink, but for samples that are
+ * described by a sample descriptor.
+ *
+ * The samples are read through the descriptor q_desc (see
+ * \link fnft_sample_desc_t \endlink), which supports, e.g., interleaved
+ * int16 or float32 I/Q data with a stride and a scale factor. The fast
+ * forward scattering step, the refinement of the bound states, the
+ * computation of the norming constants and residues, and Richardson
+ * extrapolation read the samples directly from the descriptor. Subsampled
+ * signals (see Dsub in \link fnft_nsev_opts_t \endlink) are described by
+ * descriptors with a larger stride. The samples are thus never copied.
+ *
+ * @param[in] D Number of samples, see \link fnft_nsev \endlink.
+ * @param[in] q_desc Pointer to a descriptor of the D samples of the
+ *  to-be-transformed signal.
+ * @param[in] T See \link fnft_nsev \endlink.
+ * @param[in] M See \link fnft_nsev \endlink.
+ * @param[out] contspec See \link fnft_nsev \endlink.
+ * @param[in] XI See \link fnft_nsev \endlink.
+ * @param[in,out] K_ptr See \link fnft_nsev \endlink.
+ * @param[out] bound_states See \link fnft_nsev \endlink.
+ * @param[out] normconsts_or_residues See \link fnft_nsev \endlink.
+ * @param[in] kappa See \link fnft_nsev \endlink.
+ * @param[in] opts See \link fnft_nsev \endlink.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ *
+ * @ingroup fnft
+ */
+FNFT_INT fnft_nsev_desc(const FNFT_UINT D,
+    fnft_sample_desc_t const * const q_desc,
+    FNFT_REAL const * const T, const FNFT_UINT M,
+    FNFT_COMPLEX * const contspec, FNFT_REAL const * const XI,
+    FNFT_UINT * const K_ptr, FNFT_COMPLEX * const bound_states,
+    FNFT_COMPLEX * const normconsts_or_residues, const FNFT_INT kappa,
+    fnft_nsev_opts_t *opts);
+
+/**
+ * @brief Accumulator for the streaming computation of
+ * \link fnft_nsev \endlink.
+ * @ingroup data_types
+ *
+ * Opaque type. Use \link fnft_nsev_accum_init \endlink to create an
+ * accumulator and \link fnft_nsev_accum_free \endlink to release it.
+ */
+typedef struct fnft_nsev_accum_s fnft_nsev_accum_t;
+
+/**
+ * @brief Creates an accumulator that computes the output of
+ * \link fnft_nsev \endlink from a signal that arrives in chunks.
+ *
+ * Instead of passing all samples to \link fnft_nsev \endlink at once, the
+ * samples can be passed in consecutive chunks to
+ * \link fnft_nsev_accum_push \endlink as soon as they become available.
+ * The transfer matrix of each chunk is computed when it is pushed. The
+ * partial transfer matrices are kept on a stack that works like a binary
+ * counter: Whenever the two partial transfer matrices on top of the stack
+ * cover the same number of chunks, they are replaced by their product
+ * (see \link fnft__poly_fmult2x2 \endlink). At most
+ * \f$ \lceil\log_2(\text{number of chunks})\rceil \f$ products therefore
+ * remain when \link fnft_nsev_accum_finalize \endlink is called, which then
+ * computes the nonlinear Fourier spectrum in the same way as
+ * \link fnft_nsev \endlink. Most of the work of the fast forward scattering
+ * step is thus done while the remaining samples are acquired.
+ *
+ * @param[in] D Total number of samples, see \link fnft_nsev \endlink.
+ * @param[in] T Array of length 2, see \link fnft_nsev \endlink.
+ * @param[in] kappa =+1 for the focusing nonlinear Schroedinger equation,
+ *  =-1 for the defocusing one
+ * @param[in] opts Pointer to a \link fnft_nsev_opts_t \endlink object, see
+ *  \link fnft_nsev \endlink. The options are copied. It is also possible to
+ *  pass NULL, in which case the default options are used.
+ * @param[out] accum_ptr Upon return, *accum_ptr points to the new
+ *  accumulator. It has to be released with
+ *  \link fnft_nsev_accum_free \endlink.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ *
+ * @ingroup fnft
+ */
+FNFT_INT fnft_nsev_accum_init(const FNFT_UINT D, FNFT_REAL const * const T,
+    const FNFT_INT kappa, fnft_nsev_opts_t const * opts,
+    fnft_nsev_accum_t ** const accum_ptr);
+
+/**
+ * @brief Adds the next chunk of samples to an accumulator.
+ *
+ * @param[in,out] accum Accumulator created with
+ *  \link fnft_nsev_accum_init \endlink.
+ * @param[in] D_chunk Number of samples in the chunk. The total number of
+ *  pushed samples must not exceed the number D that was passed to
+ *  \link fnft_nsev_accum_init \endlink.
+ * @param[in] q_chunk Array of length D_chunk that contains the next samples
+ *  of the signal in ascending order. The samples are copied.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ *
+ * @ingroup fnft
+ */
+FNFT_INT fnft_nsev_accum_push(fnft_nsev_accum_t * const accum,
+    const FNFT_UINT D_chunk, FNFT_COMPLEX const * const q_chunk);
+
+/**
+ * @brief Computes the nonlinear Fourier spectrum of the samples in an
+ * accumulator.
+ *
+ * All D samples must have been pushed before this routine is called. The
+ * remaining arguments and the results are the same as for
+ * \link fnft_nsev \endlink. The accumulator still has to be released with
+ * \link fnft_nsev_accum_free \endlink afterwards.
+ *
+ * @param[in,out] accum Accumulator created with
+ *  \link fnft_nsev_accum_init \endlink.
+ * @param[in] M See \link fnft_nsev \endlink.
+ * @param[out] contspec See \link fnft_nsev \endlink.
+ * @param[in] XI See \link fnft_nsev \endlink.
+ * @param[in,out] K_ptr See \link fnft_nsev \endlink.
+ * @param[out] bound_states See \link fnft_nsev \endlink.
+ * @param[out] normconsts_or_residues See \link fnft_nsev \endlink.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ *
+ * @ingroup fnft
+ */
+FNFT_INT fnft_nsev_accum_finalize(fnft_nsev_accum_t * const accum,
+    const FNFT_UINT M, FNFT_COMPLEX * const contspec,
+    FNFT_REAL const * const XI, FNFT_UINT * const K_ptr,
+    FNFT_COMPLEX * const bound_states,
+    FNFT_COMPLEX * const normconsts_or_residues);
+
+/**
+ * @brief Releases the memory used by an accumulator.
+ *
+ * @param[in] accum Accumulator created with
+ *  \link fnft_nsev_accum_init \endlink. Can be NULL.
+ *
+ * @ingroup fnft
+ */
+void fnft_nsev_accum_free(fnft_nsev_accum_t * const accum);
+
+/**
+ * @brief Persistent product tree for the repeated computation of
+ * \link fnft_nsev \endlink after changes of a few samples.
+ * @ingroup data_types
+ *
+ * Opaque type. Use \link fnft_nsev_tree_init \endlink to create a tree and
+ * \link fnft_nsev_tree_free \endlink to release it.
+ */
+typedef struct fnft_nsev_tree_s fnft_nsev_tree_t;
+
+/**
+ * @brief Creates a persistent product tree of partial transfer matrices.
+ *
+ * The samples are split into blocks of \a block_len samples. The transfer
+ * matrices of the blocks and all their products that occur in the binary
+ * product tree are stored, up to the transfer matrix of the full signal at
+ * the root. After changing samples with \link fnft_nsev_tree_update
+ * \endlink, only the blocks that contain them and their ancestors are
+ * recomputed. The nonlinear Fourier spectrum of the current samples can be
+ * obtained at any time with \link fnft_nsev_tree_query \endlink.
+ *
+ * Larger blocks reduce the memory consumption since the lower levels of the
+ * tree are not stored, but an update then has to recompute a full block.
+ * With block_len=1, all levels are stored.
+ *
+ * @param[in] D Number of samples
+ * @param[in] q Array of length D, contains the initial samples. See
+ *  \link fnft_nsev \endlink. The samples are copied.
+ * @param[in] T Array of length 2, see \link fnft_nsev \endlink.
+ * @param[in] block_len Number of samples in the blocks at the lowest level
+ *  of the tree. Has to be positive.
+ * @param[in] kappa =+1 for the focusing nonlinear Schroedinger equation,
+ *  =-1 for the defocusing one
+ * @param[in] opts Pointer to a \link fnft_nsev_opts_t \endlink object, see
+ *  \link fnft_nsev \endlink. The options are copied. Can be NULL, in which
+ *  case the default options are used.
+ * @param[out] tree_ptr Upon return, *tree_ptr points to the new tree. It has
+ *  to be released with \link fnft_nsev_tree_free \endlink.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ *
+ * @ingroup fnft
+ */
+FNFT_INT fnft_nsev_tree_init(const FNFT_UINT D, FNFT_COMPLEX const * const q,
+    FNFT_REAL const * const T, const FNFT_UINT block_len,
+    const FNFT_INT kappa, fnft_nsev_opts_t const * opts,
+    fnft_nsev_tree_t ** const tree_ptr);
+
+/**
+ * @brief Changes samples and updates a product tree.
+ *
+ * Sets the samples \f$ q[idx[k]] \f$ to \f$ q\_new[k] \f$ for
+ * \f$ k=0,\dots,n\_updates-1 \f$. Every node of the tree that depends on
+ * one of the changed samples is recomputed exactly once.
+ *
+ * @param[in,out] tree Tree created with \link fnft_nsev_tree_init \endlink.
+ * @param[in] n_updates Number of changed samples.
+ * @param[in] idx Array of length n_updates with the indices of the changed
+ *  samples.
+ * @param[in] q_new Array of length n_updates with the new values.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ *
+ * @ingroup fnft
+ */
+FNFT_INT fnft_nsev_tree_update(fnft_nsev_tree_t * const tree,
+    const FNFT_UINT n_updates, FNFT_UINT const * const idx,
+    FNFT_COMPLEX const * const q_new);
+
+/**
+ * @brief Computes the nonlinear Fourier spectrum of the current samples in
+ * a product tree.
+ *
+ * The parameters M, contspec, XI, K_ptr, bound_states and
+ * normconsts_or_residues have the same meaning as for
+ * \link fnft_nsev \endlink. The tree is not changed and can be updated and
+ * queried again afterwards.
+ *
+ * @param[in] tree Tree created with \link fnft_nsev_tree_init \endlink.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ *
+ * @ingroup fnft
+ */
+FNFT_INT fnft_nsev_tree_query(fnft_nsev_tree_t * const tree,
+    const FNFT_UINT M, FNFT_COMPLEX * const contspec,
+    FNFT_REAL const * const XI, FNFT_UINT * const K_ptr,
+    FNFT_COMPLEX * const bound_states,
+    FNFT_COMPLEX * const normconsts_or_residues);
+
+/**
+ * @brief Releases the memory used by a product tree.
+ *
+ * @param[in] tree Tree created with \link fnft_nsev_tree_init \endlink. Can
+ *  be NULL.
+ *
+ * @ingroup fnft
+ */
+void fnft_nsev_tree_free(fnft_nsev_tree_t * const tree);
+
+/**
+ * @brief Gradient of a real-valued function of the nonlinear Fourier
+ * spectrum w.r.t. the signal.
+ *
+ * Let \f$ L \f$ be a real-valued function of the continuous spectrum and
+ * the bound states computed by \link fnft_nsev \endlink. Given the derivatives of \f$ L \f$ w.r.t. the
+ * complex conjugates of these quantities (e.g.,
+ * \f$ \bar r_m = \partial L/\partial r(\xi_m)^* = r(\xi_m)-r_{target,m} \f$
+ * for \f$ L=\sum_m |r(\xi_m)-r_{target,m}|^2 \f$), this routine computes
+ *
+ *  \f[ grad[n] = \frac{\partial L}{\partial q[n]^*}, \quad
+ *  \frac{\partial L}{\partial q[n]} = grad[n]^*, \f]
+ *
+ * i.e., \f$ dL = 2\,\mathrm{Re}\sum_n grad[n]^*\,dq[n] \f$.
+ *
+ * The gradient is computed in reverse mode: The product tree of the
+ * transfer matrices is computed and stored as in
+ * \link fnft_nsev_tree_init \endlink. The derivatives w.r.t. the
+ * coefficients of the transfer matrix of the full signal are then
+ * propagated back through the chirp transform and the tree, where each
+ * multiplication is reversed with FFT-based cross-correlations. The
+ * derivatives of the transfer matrices of the individual samples are
+ * obtained with Cauchy's integral formula from 32 transfer matrices of
+ * perturbed samples per sample. The tree and its reversal cost about as
+ * much as two forward transforms. The 32*D single-sample transfer
+ * matrices cost roughly as much as one more forward transform for the
+ * default discretization and D between 256 and 16384, but grow linearly in
+ * D with a large constant. The bound states are differentiated as the roots of
+ * the (1,1) element of the transfer matrix. If the bound states of
+ * \link fnft_nsev \endlink have been refined with the Boffetta-Osborne
+ * discretization, their derivatives therefore agree only up to the
+ * discretization error. Set the option bound_state_refinement to
+ * fnft_nsev_bsref_POLY to avoid this. Norming constants are not supported
+ * since evaluating b at the bound states from the transfer matrix is too
+ * ill-conditioned (see \link fnft_nsev \endlink).
+ *
+ * @param[in] D Number of samples
+ * @param[in] q Array of length D, see \link fnft_nsev \endlink.
+ * @param[in] T Array of length 2, see \link fnft_nsev \endlink.
+ * @param[in] M Number of points in the continuous spectrum.
+ * @param[in] contspec_bar Array with the derivatives w.r.t. the conjugated
+ *  continuous spectrum. Its layout is the one of the array contspec of
+ *  \link fnft_nsev \endlink for the same options. Can be NULL if L does not
+ *  depend on the continuous spectrum.
+ * @param[in] XI Array of length 2, see \link fnft_nsev \endlink. Can be NULL
+ *  if contspec_bar==NULL.
+ * @param[in] K Number of bound states.
+ * @param[in] bound_states Array of length K with the bound states, e.g., as
+ *  computed by \link fnft_nsev \endlink.
+ * @param[in] bound_states_bar Array of length K with the derivatives
+ *  w.r.t. the conjugated bound states. Can be NULL if L does not depend on
+ *  the bound states.
+ * @param[in] kappa =+1 for the focusing nonlinear Schroedinger equation,
+ *  =-1 for the defocusing one
+ * @param[in] opts Pointer to a \link fnft_nsev_opts_t \endlink object, see
+ *  \link fnft_nsev \endlink. Can be NULL, in which case the default options
+ *  are used.
+ * @param[out] grad Array of length D. Upon return, contains the gradient.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ *
+ * @ingroup fnft
+ */
+FNFT_INT fnft_nsev_gradient(const FNFT_UINT D, FNFT_COMPLEX * const q,
+    FNFT_REAL const * const T, const FNFT_UINT M,
+    FNFT_COMPLEX const * const contspec_bar, FNFT_REAL const * const XI,
+    const FNFT_UINT K, FNFT_COMPLEX const * const bound_states,
+    FNFT_COMPLEX const * const bound_states_bar, const FNFT_INT kappa,
+    fnft_nsev_opts_t *opts, FNFT_COMPLEX * const grad);
+
+/**
+ * @brief Short-time nonlinear Fourier transform for the nonlinear
+ * Schroedinger equation with vanishing boundary conditions.
+ *
+ * Computes the continuous spectra of the windows
+ * \f$ q_{wH},q_{wH+1},\dots,q_{wH+L-1} \f$ of the signal, where \f$ L \f$ is
+ * the window length, \f$ H \f$ is the hop size and
+ * \f$ w=0,1,\dots,(D-L)/H \f$. Each window is treated as in
+ * \link fnft_nsev \endlink, with the time interval
+ * \f$ [T[0]+wH\varepsilon_t, T[0]+(wH+L-1)\varepsilon_t] \f$, where
+ * \f$ \varepsilon_t=(T[1]-T[0])/(D-1) \f$.
+ *
+ * The signal is split into blocks of \f$ H \f$ samples. The transfer
+ * matrices of aligned groups of \f$ 1,2,4,\dots \f$ consecutive blocks (up
+ * to the number of blocks in a window) are computed once and stored in a
+ * segment tree. The transfer matrix of each window is then assembled from
+ * \f$ O(\log(L/H)) \f$ nodes of the tree instead of being recomputed from
+ * scratch, so that overlapping windows share most of the work.
+ *
+ * @param[in] D Number of samples
+ * @param[in] q Array of length D, contains samples \f$ q(t_n)=q(x_0, t_n) \f$,
+ *  where \f$ t_n = T[0] + n(T[1]-T[0])/(D-1) \f$ and \f$n=0,1,\dots,D-1\f$.
+ * @param[in] T Array of length 2, contains the position in time of the first
+ *  and of the last sample. It should be T[0]<T[1].
+ * @param[in] window_len Number of samples per window, 2<=window_len<=D.
+ * @param[in] hop Number of samples between the starts of consecutive
+ *  windows. The window length has to be a multiple of hop.
+ * @param[in] M Number of points at which the continuous spectrum of each
+ *  window should be computed.
+ * @param[out] contspec Array in which the continuous spectra of the
+ *  \f$ (D-window\_len)/hop+1 \f$ windows are stored one after another. The
+ *  spectrum of each window occupies as much memory as the contspec array of
+ *  \link fnft_nsev \endlink for the same options (i.e., M, 2*M or 3*M
+ *  entries). Has to be preallocated by the user.
+ * @param[in] XI Array of length 2, contains the position of the first and the
+ *  last sample of the continuous spectra. It should be XI[0]<XI[1].
+ * @param[in] kappa =+1 for the focusing nonlinear Schroedinger equation,
+ *  =-1 for the defocusing one
+ * @param[in] opts Pointer to a \link fnft_nsev_opts_t \endlink object, see
+ *  \link fnft_nsev \endlink. Options that only affect the discrete spectrum
+ *  are ignored. Can be NULL, in which case the default options are used.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ *
+ * @ingroup fnft
+ */
+FNFT_INT fnft_nsev_short_time(const FNFT_UINT D, FNFT_COMPLEX * const q,
+    FNFT_REAL const * const T, const FNFT_UINT window_len,
+    const FNFT_UINT hop, const FNFT_UINT M, FNFT_COMPLEX * const contspec,
+    FNFT_REAL const * const XI, const FNFT_INT kappa,
+    fnft_nsev_opts_t *opts);
+
+/**
+ * @brief Tracker for the bound states of consecutive frames.
+ * @ingroup data_types
+ *
+ * Opaque type. Use \link fnft_nsev_tracker_init \endlink to create a
+ * tracker and \link fnft_nsev_tracker_free \endlink to release it.
+ */
+typedef struct fnft_nsev_tracker_s fnft_nsev_tracker_t;
+
+/**
+ * @brief Creates a tracker that reuses the bound states of the previous
+ * frame as initial guesses.
+ *
+ * In streaming applications, \link fnft_nsev \endlink is applied to
+ * consecutive frames of a signal whose bound states only move a little
+ * from one frame to the next. \link fnft_nsev_tracker_step \endlink then
+ * uses the bound states of the previous frame as initial guesses for the
+ * Newton iterations, instead of localizing them from scratch.
+ *
+ * @param[out] tracker_ptr Upon return, *tracker_ptr points to the new
+ *  tracker. It has to be released with \link fnft_nsev_tracker_free
+ *  \endlink.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ *
+ * @ingroup fnft
+ */
+FNFT_INT fnft_nsev_tracker_init(fnft_nsev_tracker_t ** const tracker_ptr);
+
+/**
+ * @brief Computes the nonlinear Fourier spectrum of the next frame.
+ *
+ * The parameters D, q, T, M, contspec, XI, K_ptr, bound_states,
+ * normconsts_or_residues, kappa and opts have the same meaning as for
+ * \link fnft_nsev \endlink. The frames may differ in the number of samples
+ * and in the time interval.
+ *
+ * If kappa=+1 and bound states are requested, the bound states of the
+ * previous frame are refined as in the fnft_nsev_bsloc_NEWTON method (see
+ * \link fnft_nsev_opts_t::bound_state_refinement \endlink). The result is
+ * accepted if none of the iterations leaves the region in which the
+ * fnft_nsev_bsfilt_FULL filter accepts bound states, no two of them converge
+ * to the same bound state, and the number of bound states agrees with the
+ * number of zeros of \f$ a(\lambda) \f$ in this region. The latter is
+ * computed with the argument principle from the winding number of
+ * \f$ a(\lambda) \f$ along the boundary of the region, which includes the
+ * real axis. Only if one of these checks fails, or for the first frame, the
+ * bound states are localized from scratch using the method in
+ * \link fnft_nsev_opts_t::bound_state_localization \endlink. Note that
+ * the checks cannot detect a new bound state that appears while another
+ * one disappears in the same frame.
+ *
+ * @param[in,out] tracker Tracker created with
+ *  \link fnft_nsev_tracker_init \endlink. Upon return, it contains the
+ *  bound states of this frame.
+ * @param[out] relocalized_flag_ptr Upon return, *relocalized_flag_ptr is
+ *  one if the bound states have been localized from scratch and zero
+ *  otherwise. Can be NULL.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ *
+ * @ingroup fnft
+ */
+FNFT_INT fnft_nsev_tracker_step(fnft_nsev_tracker_t * const tracker,
+    const FNFT_UINT D, FNFT_COMPLEX * const q, FNFT_REAL const * const T,
+    const FNFT_UINT M, FNFT_COMPLEX * const contspec,
+    FNFT_REAL const * const XI, FNFT_UINT * const K_ptr,
+    FNFT_COMPLEX * const bound_states,
+    FNFT_COMPLEX * const normconsts_or_residues, const FNFT_INT kappa,
+    fnft_nsev_opts_t *opts, FNFT_INT * const relocalized_flag_ptr);
+
+/**
+ * @brief Releases the memory used by a tracker.
+ *
+ * @param[in] tracker Tracker created with
+ *  \link fnft_nsev_tracker_init \endlink. Can be NULL.
+ *
+ * @ingroup fnft
+ */
+void fnft_nsev_tracker_free(fnft_nsev_tracker_t * const tracker);
+
+/**
+ * @struct fnft_nsev_autotune_cache_t
+ * @brief Cache for the decisions of \link fnft_nsev_autotune \endlink.
+ * @ingroup data_types
+ *
+ * Opaque type. Use \link fnft_nsev_autotune_cache_init \endlink to create
+ * a cache and \link fnft_nsev_autotune_cache_free \endlink to release it.
+ */
+typedef struct fnft_nsev_autotune_cache_s fnft_nsev_autotune_cache_t;
+
+/**
+ * @brief Creates an empty cache for \link fnft_nsev_autotune \endlink.
+ *
+ * @param[out] cache_ptr Upon return, *cache_ptr points to the new cache. It
+ *  has to be released with \link fnft_nsev_autotune_cache_free \endlink.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ *
+ * @ingroup fnft
+ */
+FNFT_INT fnft_nsev_autotune_cache_init(
+    fnft_nsev_autotune_cache_t ** const cache_ptr);
+
+/**
+ * @brief Selects the discretization and the number of samples for which
+ * \link fnft_nsev \endlink meets an error tolerance at the lowest cost.
+ *
+ * The discretizations differ in their degree per sample, which determines
+ * the run time, and in their order of accuracy. This routine selects the
+ * cheapest one for a given representative signal. For every candidate, the
+ * reflection coefficient is computed for the signal decimated by 2^l,
+ * starting with the largest l for which at least 64 samples remain. The
+ * relative difference between two consecutive levels, divided by
+ * \f$ 2^p-1 \f$ where \f$ p \f$ is the order of the discretization, is an
+ * estimate of the error of the finer level. From this estimate and the
+ * measured run time of the finer level, the number of samples D for which
+ * the error meets the tolerance and the run time for this D are predicted.
+ * A candidate is refined until its estimated error meets the tolerance or
+ * its predicted run time exceeds the one of the best candidate so far.
+ * Among the candidates whose estimated error meets the tolerance on one of
+ * the levels, the one with the lowest predicted run time is returned.
+ *
+ * The tolerance is rounded down to the next power of two. All tolerances
+ * between two consecutive powers of two thus lead to the same decision,
+ * which can be shared via the cache.
+ *
+ * Only the error of the continuous spectrum is estimated, and only the run
+ * time of its computation is measured. The run times are wall clock times
+ * (CPU times if no monotonic clock is available).
+ *
+ * @param[in] D Number of samples of the representative signal
+ * @param[in] q Array of length D, contains the samples of the signal as in
+ *  \link fnft_nsev \endlink.
+ * @param[in] T Array of length 2, contains the position in time of the first
+ *  and of the last sample.
+ * @param[in] M Number of points at which the continuous spectrum is
+ *  compared. Has to be positive.
+ * @param[in] XI Array of length 2, contains the position of the first and
+ *  the last point in the continuous spectrum, see \link fnft_nsev \endlink.
+ * @param[in] kappa =+1 for the focusing nonlinear Schroedinger equation,
+ *  =-1 for the defocusing one.
+ * @param[in] err_tol Tolerance for the relative error of the continuous
+ *  spectrum. Has to be positive.
+ * @param[in] time_budget Time in seconds after which no further
+ *  candidates are tried. The candidates are tried in the order of
+ *  increasing degree. The first candidate is always refined as if there
+ *  was no time budget, so that it is selected for a budget of zero if it
+ *  can meet the tolerance. Use INFINITY to try all candidates.
+ * @param[in,out] cache Cache created with \link
+ *  fnft_nsev_autotune_cache_init \endlink or NULL. If the cache already
+ *  contains a decision for signal_class and a tolerance in the same range
+ *  between two powers of two as err_tol, it is returned without further
+ *  computations. Otherwise, the new decision is added to it.
+ * @param[in] signal_class User-defined identifier of the class of signals
+ *  that q represents. Only used together with a cache.
+ * @param[in,out] opts Options for \link fnft_nsev \endlink that are used
+ *  for the computations. Upon return, opts->discretization contains the
+ *  selected discretization. Cannot be NULL.
+ * @param[out] D_ptr Upon return, *D_ptr contains the predicted number of
+ *  samples on the interval T. It is at most D.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink. If no candidate meets the
+ *  tolerance before the time budget is exhausted, FNFT_EC_OTHER is returned
+ *  and opts and *D_ptr are not changed. The signal then has to be sampled
+ *  more densely.
+ *
+ * @ingroup fnft
+ */
+FNFT_INT fnft_nsev_autotune(const FNFT_UINT D, FNFT_COMPLEX * const q,
+    FNFT_REAL const * const T, const FNFT_UINT M, FNFT_REAL const * const XI,
+    const FNFT_INT kappa, const FNFT_REAL err_tol,
+    const FNFT_REAL time_budget, fnft_nsev_autotune_cache_t * const cache,
+    const FNFT_UINT signal_class, fnft_nsev_opts_t * const opts,
+    FNFT_UINT * const D_ptr);
+
+/**
+ * @brief Releases the memory used by a cache for
+ * \link fnft_nsev_autotune \endlink.
+ *
+ * @param[in] cache Cache created with
+ *  \link fnft_nsev_autotune_cache_init \endlink. Can be NULL.
+ *
+ * @ingroup fnft
+ */
+void fnft_nsev_autotune_cache_free(fnft_nsev_autotune_cache_t * const cache);
+
 #ifdef FNFT_ENABLE_SHORT_NAMES
 #define nsev_bsfilt_NONE fnft_nsev_bsfilt_NONE
 #define nsev_bsfilt_BASIC fnft_nsev_bsfilt_BASIC
@@ -301,6 +972,12 @@ FNFT_INT fnft_nsev(const FNFT_UINT D, FNFT_COMPLEX * const q,
 #define nsev_bsloc_FAST_EIGENVALUE fnft_nsev_bsloc_FAST_EIGENVALUE
 #define nsev_bsloc_NEWTON fnft_nsev_bsloc_NEWTON
 #define nsev_bsloc_SUBSAMPLE_AND_REFINE fnft_nsev_bsloc_SUBSAMPLE_AND_REFINE
+#define nsev_bsloc_ARGUMENT_PRINCIPLE fnft_nsev_bsloc_ARGUMENT_PRINCIPLE
+#define nsev_bsref_BO fnft_nsev_bsref_BO
+#define nsev_bsref_POLY fnft_nsev_bsref_POLY
+#define nsev_bsref_POLY_AND_BO fnft_nsev_bsref_POLY_AND_BO
+#define nsev_rootfind_FAST_EIGENVALUE fnft_nsev_rootfind_FAST_EIGENVALUE
+#define nsev_rootfind_ABERTH fnft_nsev_rootfind_ABERTH
 #define nsev_dstype_NORMING_CONSTANTS fnft_nsev_dstype_NORMING_CONSTANTS
 #define nsev_dstype_RESIDUES fnft_nsev_dstype_RESIDUES
 #define nsev_dstype_BOTH fnft_nsev_dstype_BOTH
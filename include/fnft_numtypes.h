@@ -133,6 +133,12 @@ typedef size_t FNFT_UINT;
  */
 #define FNFT_LOG2(X) log2(X)
 
+/**
+ * Exponential function of a \link FNFT_REAL \endlink.
+ * @ingroup numtype
+ */
+#define FNFT_EXP(X) exp(X)
+
 /**
  * Power X^Y of two \link FNFT_REAL \endlink.
  * @ingroup numtype
@@ -274,6 +280,7 @@ typedef size_t FNFT_UINT;
 #define CPOW(X,Y)       FNFT_CPOW(X,Y)
 #define LOG2(X)         FNFT_LOG2(X)
 #define LOG(X)          FNFT_LOG(X)
+#define EXP(X)          FNFT_EXP(X)
 #define CLOG(X)         FNFT_CLOG(X)
 #define COS(X)          FNFT_COS(X)
 #define SIN(X)          FNFT_SIN(X)
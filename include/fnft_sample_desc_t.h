@@ -0,0 +1,91 @@
+/*
+ * This file is part of FNFT.
+ *
+ * FNFT is free software; you can redistribute it and/or
+ * modify it under the terms of the version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * FNFT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contributors:
+ * Sander Wahls (TU Delft) 2018.
+ */
+
+/**
+ * @file fnft_sample_desc_t.h
+ * @brief Describes arrays of signal samples that are not stored as
+ * contiguous arrays of complex numbers.
+ *
+ * @ingroup fnft
+ */
+#ifndef FNFT_SAMPLE_DESC_T_H
+#define FNFT_SAMPLE_DESC_T_H
+
+#include "fnft.h"
+#include "fnft_numtypes.h"
+
+/**
+ * @brief Enum that specifies the element type of an array of samples.
+ *
+ * @ingroup data_types
+ *  fnft_sample_type_COMPLEX: Each sample is a \link FNFT_COMPLEX \endlink.\n
+ *  fnft_sample_type_FLOAT32_IQ: Each sample consists of two floats, the
+ *  in-phase (real) part followed by the quadrature (imaginary) part.\n
+ *  fnft_sample_type_INT16_IQ: Each sample consists of two 16-bit signed
+ *  integers (int16_t), the in-phase part followed by the quadrature part.
+ */
+typedef enum {
+    fnft_sample_type_COMPLEX,
+    fnft_sample_type_FLOAT32_IQ,
+    fnft_sample_type_INT16_IQ
+} fnft_sample_type_t;
+
+/**
+ * @struct fnft_sample_desc_t
+ * @brief Describes where and how the samples of a signal are stored.
+ * @ingroup data_types
+ *
+ * The n-th sample of the signal is given by scale*x[n*stride], where x is
+ * the array data interpreted as an array of the type given by type. This
+ * allows to pass, e.g., interleaved I/Q data from an analog-to-digital
+ * converter or one polarization of a polarization-multiplexed signal to
+ * the routines without converting it into a contiguous array of
+ * \link FNFT_COMPLEX \endlink first.
+ *
+ * @var fnft_sample_desc_t::type
+ *  Element type of the array. See \link fnft_sample_type_t \endlink.
+ *
+ * @var fnft_sample_desc_t::data
+ *  Pointer to the first sample.
+ *
+ * @var fnft_sample_desc_t::stride
+ *  Distance between consecutive samples, measured in samples (not in bytes
+ *  or scalars). Use 1 for contiguous samples and, e.g., 2 for one component
+ *  of two interleaved signals.
+ *
+ * @var fnft_sample_desc_t::scale
+ *  Factor that is applied to every sample (e.g., to convert ADC codes into
+ *  physical units).
+ */
+typedef struct {
+    fnft_sample_type_t type;
+    void const * data;
+    FNFT_UINT stride;
+    FNFT_REAL scale;
+} fnft_sample_desc_t;
+
+#ifdef FNFT_ENABLE_SHORT_NAMES
+#define sample_type_COMPLEX fnft_sample_type_COMPLEX
+#define sample_type_FLOAT32_IQ fnft_sample_type_FLOAT32_IQ
+#define sample_type_INT16_IQ fnft_sample_type_INT16_IQ
+#define sample_type_t fnft_sample_type_t
+#define sample_desc_t fnft_sample_desc_t
+#endif
+
+#endif
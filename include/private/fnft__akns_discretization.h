@@ -48,6 +48,23 @@
 FNFT_UINT fnft__akns_discretization_degree(fnft__akns_discretization_t
         discretization);
 
+/**
+ * @brief This routine returns the order of accuracy of the discretization or
+ * zero if the discretization is unknown.
+ *
+ * For a discretization `xSPLITyz` (see \link fnft_nse_discretization_t
+ * \endlink), the error of the computed scattering data behaves like
+ * \f$ O(\epsilon_t^p) \f$ with \f$ p=\min(x,y) \f$, i.e., the order of the
+ * unsplit scheme limits the order of the splitting.
+ * @param[in] discretization The type of discretization to be used. Should be
+ * of type \link fnft__akns_discretization_t \endlink.
+ * @returns order of accuracy, or 0 for unknown discretizations.
+ *
+ * @ingroup akns
+ */
+FNFT_UINT fnft__akns_discretization_order(fnft__akns_discretization_t
+        discretization);
+
 /**
  * @brief This routine returns the boundary coefficient based on the
  * discretization.
@@ -109,6 +126,7 @@ FNFT_INT fnft__akns_z_to_lambda(const FNFT_UINT n, const FNFT_REAL eps_t,
 
 #ifdef FNFT_ENABLE_SHORT_NAMES
 #define akns_discretization_degree(...) fnft__akns_discretization_degree(__VA_ARGS__)
+#define akns_discretization_order(...) fnft__akns_discretization_order(__VA_ARGS__)
 #define akns_discretization_boundary_coeff(...) fnft__akns_discretization_boundary_coeff(__VA_ARGS__)
 #define akns_lambda_to_z(...) fnft__akns_lambda_to_z(__VA_ARGS__)
 #define akns_z_to_lambda(...) fnft__akns_z_to_lambda(__VA_ARGS__)
@@ -29,6 +29,7 @@
 #define FNFT__AKNS_FSCATTER_H
 
 #include "fnft__akns_discretization.h"
+#include "fnft_sample_desc_t.h"
 
 /**
  * @brief Returns the length of transfer_matrix to be allocated based on the number
@@ -86,9 +87,79 @@ FNFT_UINT fnft__akns_fscatter_numel(FNFT_UINT D,
 FNFT_INT fnft__akns_fscatter(const FNFT_UINT D, FNFT_COMPLEX const * const q, FNFT_COMPLEX const * const r, const FNFT_REAL eps_t, FNFT_COMPLEX * const result, FNFT_UINT * const deg_ptr,
                             INT * const W_ptr, fnft__akns_discretization_t discretization);
 
+/**
+ * @brief Fast computation of polynomial approximation of the combined scattering
+ * matrix for a constant r.
+ *
+ * Same as \link fnft__akns_fscatter \endlink with \f$ r(t_n)=r \f$ for all
+ * \f$ n \f$, but no array of samples of r has to be provided. If q and r are
+ * real (as in the Korteweg-de Vries case r=-1), all coefficients of the
+ * individual scattering matrices are real. In that case, they are multiplied
+ * with \link fnft__poly_fmult2x2_real \endlink, which computes the FFTs of
+ * two real polynomials with a single complex FFT. Otherwise,
+ * \link fnft__poly_fmult2x2 \endlink is used.
+ *
+ * @param[in] D Number of samples
+ * @param[in] q Array of length D, contains samples of the to-be-transformed
+ *  signal. See \link fnft__akns_fscatter \endlink.
+ * @param[in] r The constant value of \f$ r(t) \f$.
+ * @param[in] eps_t Step-size, eps_t \f$= (T[1]-T[0])/(D-1) \f$.
+ * @param[out] result array of length `akns_fscatter_numel(D,discretization)`,
+ * will contain the combined scattering matrix.
+ * @param[out] deg_ptr Pointer to variable containing degree of the discretization.
+ * @param[in] W_ptr Normalization flag. Polynomial coefficients are normalized
+ * if W_ptr is non-zero.
+ * @param[in] discretization The type of discretization to be used. Should be of type
+ * \link fnft__akns_discretization_t \endlink.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ *
+ * @ingroup akns
+ */
+FNFT_INT fnft__akns_fscatter_const_r(const FNFT_UINT D,
+    FNFT_COMPLEX const * const q, const FNFT_COMPLEX r, const FNFT_REAL eps_t,
+    FNFT_COMPLEX * const result, FNFT_UINT * const deg_ptr,
+    FNFT_INT * const W_ptr, fnft__akns_discretization_t discretization);
+
+/**
+ * @brief Fast computation of polynomial approximation of the combined scattering
+ * matrix for samples described by sample descriptors.
+ *
+ * Same as \link fnft__akns_fscatter \endlink, but the samples of q and r are
+ * read through sample descriptors (see \link fnft_sample_desc_t \endlink)
+ * while the individual scattering matrices are set up. No contiguous copies
+ * of the signal are made.
+ *
+ * @param[in] D Number of samples
+ * @param[in] q Descriptor of the D samples of q.
+ * @param[in] r Descriptor of the D samples of r. The samples are multiplied
+ *  with r_coeff. If NULL is passed instead, \f$ r(t_n) \f$ = r_coeff
+ *  \f$ \overline{q(t_n)} \f$ as in the nonlinear Schroedinger case.
+ * @param[in] r_coeff Factor for the samples of r.
+ * @param[in] eps_t Step-size, eps_t \f$= (T[1]-T[0])/(D-1) \f$.
+ * @param[out] result array of length `akns_fscatter_numel(D,discretization)`,
+ * will contain the combined scattering matrix.
+ * @param[out] deg_ptr Pointer to variable containing degree of the discretization.
+ * @param[in] W_ptr Normalization flag. Polynomial coefficients are normalized
+ * if W_ptr is non-zero.
+ * @param[in] discretization The type of discretization to be used. Should be of type
+ * \link fnft__akns_discretization_t \endlink.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ *
+ * @ingroup akns
+ */
+FNFT_INT fnft__akns_fscatter_desc(const FNFT_UINT D,
+    fnft_sample_desc_t const * const q, fnft_sample_desc_t const * const r,
+    const FNFT_COMPLEX r_coeff, const FNFT_REAL eps_t,
+    FNFT_COMPLEX * const result, FNFT_UINT * const deg_ptr,
+    FNFT_INT * const W_ptr, fnft__akns_discretization_t discretization);
+
 #ifdef FNFT_ENABLE_SHORT_NAMES
 #define akns_fscatter_numel(...) fnft__akns_fscatter_numel(__VA_ARGS__)
 #define akns_fscatter(...) fnft__akns_fscatter(__VA_ARGS__)
+#define akns_fscatter_const_r(...) fnft__akns_fscatter_const_r(__VA_ARGS__)
+#define akns_fscatter_desc(...) fnft__akns_fscatter_desc(__VA_ARGS__)
 #endif
 
 #endif
@@ -28,6 +28,7 @@
 #define FNFT__AKNS_SCATTER_H
 
 #include "fnft__akns_discretization.h"
+#include "fnft_sample_desc_t.h"
 
 
 /**
@@ -64,8 +65,39 @@ FNFT_INT fnft__akns_scatter_matrix(const UINT D, COMPLEX const * const q,
     const UINT K, COMPLEX const * const lambda,
     COMPLEX * const result, akns_discretization_t discretization);
 
+/**
+ * @brief Computes the scattering matrix and its derivative for samples
+ * described by sample descriptors.
+ *
+ * Same as \link fnft__akns_scatter_matrix \endlink, but the samples of q and
+ * r are read through sample descriptors (see
+ * \link fnft_sample_desc_t \endlink).
+ *
+ * @param[in] D Number of samples
+ * @param[in] q Descriptor of the D samples of q.
+ * @param[in] r Descriptor of the D samples of r. The samples are multiplied
+ *  with r_coeff. If NULL is passed instead, \f$ r(t_n) \f$ = r_coeff
+ *  \f$ \overline{q(t_n)} \f$.
+ * @param[in] r_coeff Factor for the samples of r.
+ * @param[in] eps_t Step-size, eps_t \f$= (T[1]-T[0])/(D-1) \f$.
+ * @param[in] K Number of values of \f$\lambda\f$.
+ * @param[in] lambda Array of length K, contains the values of \f$\lambda\f$.
+ * @param[out] result Array of length 8*K, see
+ *  \link fnft__akns_scatter_matrix \endlink.
+ * @param[in] discretization The type of discretization to be used.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ * @ingroup akns
+ */
+FNFT_INT fnft__akns_scatter_matrix_desc(const UINT D,
+    fnft_sample_desc_t const * const q, fnft_sample_desc_t const * const r,
+    const COMPLEX r_coeff, const REAL eps_t,
+    const UINT K, COMPLEX const * const lambda,
+    COMPLEX * const result, akns_discretization_t discretization);
+
 #ifdef FNFT_ENABLE_SHORT_NAMES
 #define akns_scatter_matrix(...) fnft__akns_scatter_matrix(__VA_ARGS__)
+#define akns_scatter_matrix_desc(...) fnft__akns_scatter_matrix_desc(__VA_ARGS__)
 #endif
 
 #endif
@@ -95,6 +95,10 @@ static inline FNFT_INT fnft__fft_wrapper_create_plan(
         return FNFT__E_INVALID_ARGUMENT(is_inverse);
 
 #ifdef HAVE_FFTW3
+    // The FFTW planner is not thread-safe
+#ifdef _OPENMP
+#pragma omp critical (fnft__fftw_planner)
+#endif
     *plan_ptr = fftw_plan_dft_1d(fft_length, in, out, is_inverse, FFTW_ESTIMATE);
 #else
     (void)in;
@@ -154,6 +158,9 @@ static inline FNFT_INT fnft__fft_wrapper_destroy_plan(
     if (plan_ptr == NULL)
         return FNFT__E_INVALID_ARGUMENT(plan_ptr);
 #ifdef HAVE_FFTW3    
+#ifdef _OPENMP
+#pragma omp critical (fnft__fftw_planner)
+#endif
     fftw_destroy_plan(*plan_ptr);
 #else
     KISS_FFT_FREE(*plan_ptr);
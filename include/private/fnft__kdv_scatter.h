@@ -30,6 +30,52 @@
 #include "fnft__kdv_discretization.h"
 #include "fnft__akns_scatter.h"
 
+/**
+ * @brief Computes \f$a(\lambda)\f$, \f$ a'(\lambda) = \frac{\partial a(\lambda)}{\partial \lambda}\f$
+ * and \f$b(\lambda)\f$ for complex values \f$\lambda\f$ assuming that they are very close to the true
+ * bound-states.
+ *
+ * The Korteweg-de Vries equation is treated as an AKNS system with
+ * \f$ r(t)=-1 \f$. The Jost solution that behaves like
+ * \f$ [2j\lambda; 1]e^{-j\lambda t} \f$ for \f$ t\to-\infty \f$ behaves like
+ * \f$ a(\lambda)[2j\lambda; 1]e^{-j\lambda t}+b(\lambda)[0; 1]e^{j\lambda t} \f$
+ * for \f$ t\to\infty \f$. The bound states are the zeros of
+ * \f$a(\lambda)\f$ on the positive imaginary axis. The scattering matrices of
+ * the parts of the signal left and right of the split point are computed with
+ * \link fnft__kdv_scatter_matrix \endlink. The norming constants
+ * \f$b(\lambda)\f$ are obtained by comparing the Jost solutions from the
+ * left and from the right at the split point (forward-backward scheme).
+ *
+ * @param[in] D Number of samples
+ * @param[in] q Array of length D, contains samples \f$ q(t_n)=q(x_0, t_n) \f$,
+ *  where \f$ t_n = T[0] + n(T[1]-T[0])/(D-1) \f$ and \f$n=0,1,\dots,D-1\f$, of
+ *  the to-be-transformed signal in ascending order
+ *  (i.e., \f$ q(t_0), q(t_1), \dots, q(t_{D-1}) \f$)
+ * @param[in] T Array of length 2, contains the position in time of the first and
+ *  of the last sample. It should be T[0]<T[1].
+ * @param[in,out] trunc_index_ptr Pointer containing sample location where the signal will be
+ * split. The value should be between 0 and D-1. If the value is D then the
+ * L1-norm is used to compute the best sample location to split the signal.
+ * @param[in] K Number of bound-states.
+ * @param[in] bound_states Array of length K, contains the bound-states
+ * \f$\lambda\f$. They have to be nonzero.
+ * @param[out] a_vals Array of length K, contains the values of \f$a(\lambda)\f$.
+ * @param[out] aprime_vals Array of length K, contains the values of
+ * \f$ a'(\lambda) = \frac{\partial a(\lambda)}{\partial \lambda}\f$.
+ * @param[out] b Array of length K, contains the values of \f$b(\lambda)\f$.
+ * @param[in] discretization The type of discretization to be used. Should be
+ * kdv_discretization_BO.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ * @ingroup kdv
+ */
+FNFT_INT fnft__kdv_scatter_bound_states(const FNFT_UINT D,
+    FNFT_COMPLEX const * const q, FNFT_REAL const * const T,
+    FNFT_UINT * const trunc_index_ptr, const FNFT_UINT K,
+    FNFT_COMPLEX const * const bound_states, FNFT_COMPLEX * const a_vals,
+    FNFT_COMPLEX * const aprime_vals, FNFT_COMPLEX * const b,
+    fnft_kdv_discretization_t discretization);
+
 
 /**
  * @brief Computes the scattering matrix and its derivative.
@@ -63,6 +109,7 @@ FNFT_INT fnft__kdv_scatter_matrix(const FNFT_UINT D, FNFT_COMPLEX const * const
 
 #ifdef FNFT_ENABLE_SHORT_NAMES
 #define kdv_scatter_matrix(...) fnft__kdv_scatter_matrix(__VA_ARGS__)
+#define kdv_scatter_bound_states(...) fnft__kdv_scatter_bound_states(__VA_ARGS__)
 #endif
 
 #endif
@@ -59,6 +59,9 @@ FNFT_REAL fnft__misc_rel_err(const FNFT_INT len,
  *
  * @ingroup misc
  * This function computes the Hausdorff distance between two vectors vecA and vecB.
+ * For larger vectors, the nearest neighbors are searched using uniform
+ * grids, which leads to an expected complexity of O(lenA+lenB) for
+ * well-distributed points instead of O(lenA*lenB).
  * @param[in] lenA Length of vector vecA.
  * @param[in] vecA Complex vector of length lenA.
  * @param[in] lenB length of vector vecB.
@@ -162,6 +165,10 @@ FNFT_INT fnft__misc_filter_inv(FNFT_UINT * const N_ptr, FNFT_COMPLEX * const val
  *
  * @ingroup misc
  * This function filters an array by merging elements if distance between the elements is less than tol.
+ * An element is removed if an earlier element that has been kept is closer
+ * than tol. The kept elements are stored in a hash table of grid cells of
+ * size tol, which leads to an expected complexity of O(N). Elements that
+ * are not finite or larger than about 4e18*tol are never merged.
  * @param[in,out] N_ptr It is the pointer to the number of elements to be filtered. On exit *N_ptr is overwritten with
  * the number of values that have survived fitering. Their values will be
  * moved to the beginning of vals.
@@ -172,6 +179,35 @@ FNFT_INT fnft__misc_filter_inv(FNFT_UINT * const N_ptr, FNFT_COMPLEX * const val
 FNFT_INT fnft__misc_merge(FNFT_UINT *N_ptr, FNFT_COMPLEX * const vals,
     FNFT_REAL tol);
 
+/**
+ * @brief Transforms, filters and merges the elements of an array in a
+ * single pass.
+ *
+ * @ingroup misc
+ * This function combines an optional coordinate transform
+ * \f$ val \mapsto c\log(val) \f$, the filtering in
+ * \link fnft__misc_filter \endlink and the merging in
+ * \link fnft__misc_merge \endlink. Each element is first transformed (if
+ * log_coeff is nonzero), then removed if it is not inside the bounding box,
+ * and finally removed if a previously kept element is closer than tol.
+ * @param[in,out] N_ptr Pointer to the number of elements. On exit *N_ptr is
+ * overwritten with the number of values that have survived. Their
+ * (transformed) values will be moved to the beginning of vals.
+ * @param[in,out] vals Complex valued array with elements to be processed.
+ * @param[in] bounding_box A real array of 4 elements that defines the
+ * bounding box as in \link fnft__misc_filter \endlink.
+ * @param[in] tol Real valued tolerance for the merging.
+ * @param[in] log_coeff Coefficient c of the coordinate transform. Set to
+ * zero in order to skip the transform. For example, the coordinate
+ * transform from the z-domain to the lambda-domain of the discretizations
+ * of the nonlinear Schroedinger equation (see \link fnft__nse_z_to_lambda
+ * \endlink) corresponds to c=degree1step/(2*I*eps_t).
+ * @return Returns SUCCESS or an error code.
+ */
+FNFT_INT fnft__misc_filter_merge(FNFT_UINT * const N_ptr,
+    FNFT_COMPLEX * const vals, FNFT_REAL const * const bounding_box,
+    const FNFT_REAL tol, const FNFT_COMPLEX log_coeff);
+
 /**
  * @brief Downsamples an array.
  *
@@ -226,6 +262,7 @@ FNFT_UINT fnft__misc_nextpowerof2(const FNFT_UINT number);
 #define misc_filter_inv(...) fnft__misc_filter_inv(__VA_ARGS__)
 #define misc_filter_nonreal(...) fnft__misc_filter_nonreal(__VA_ARGS__)
 #define misc_merge(...) fnft__misc_merge(__VA_ARGS__)
+#define misc_filter_merge(...) fnft__misc_filter_merge(__VA_ARGS__)
 #define misc_downsample(...) fnft__misc_downsample(__VA_ARGS__)
 #define misc_CSINC(...) fnft__misc_CSINC(__VA_ARGS__)
 #define misc_nextpowerof2(...) fnft__misc_nextpowerof2(__VA_ARGS__)
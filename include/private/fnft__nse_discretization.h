@@ -48,6 +48,20 @@
 FNFT_UINT fnft__nse_discretization_degree(fnft_nse_discretization_t
         nse_discretization);
 
+/**
+ * @brief This routine returns the order of accuracy of the discretization or
+ * zero if the discretization is unknown.
+ *
+ * See \link fnft__akns_discretization_order \endlink.
+ * @param[in] nse_discretization The type of discretization to be used. Should be
+ * of type \link fnft_nse_discretization_t \endlink.
+ * @returns order of accuracy, or 0 for unknown discretizations.
+ *
+ * @ingroup nse
+ */
+FNFT_UINT fnft__nse_discretization_order(fnft_nse_discretization_t
+        nse_discretization);
+
 /**
  * @brief This routine returns the boundary coefficient based on the
  * discretization.
@@ -198,6 +212,7 @@ FNFT_INT fnft__nse_phase_factor_b(const FNFT_REAL eps_t, const FNFT_UINT D, FNFT
         
 #ifdef FNFT_ENABLE_SHORT_NAMES
 #define nse_discretization_degree(...) fnft__nse_discretization_degree(__VA_ARGS__)
+#define nse_discretization_order(...) fnft__nse_discretization_order(__VA_ARGS__)
 #define nse_discretization_boundary_coeff(...) fnft__nse_discretization_boundary_coeff(__VA_ARGS__)
 #define nse_discretization_to_akns_discretization(...) fnft__nse_discretization_to_akns_discretization(__VA_ARGS__)
 #define nse_lambda_to_z(...) fnft__nse_lambda_to_z(__VA_ARGS__)
@@ -83,9 +83,39 @@ FNFT_INT fnft__nse_fscatter(const FNFT_UINT D, FNFT_COMPLEX const * const q,
     FNFT_COMPLEX * const result, FNFT_UINT * const deg_ptr,
     FNFT_INT * const W_ptr, fnft_nse_discretization_t discretization);
 
+/**
+ * @brief Fast computation of polynomial approximation of the combined scattering
+ * matrix for samples described by a sample descriptor.
+ *
+ * Same as \link fnft__nse_fscatter \endlink, but the samples of q are read
+ * through the sample descriptor q (see \link fnft_sample_desc_t \endlink)
+ * while the individual scattering matrices are set up.
+ *
+ * @param[in] D Number of samples
+ * @param[in] q Descriptor of the D samples of q.
+ * @param[in] eps_t Step-size, eps_t \f$= (T[1]-T[0])/(D-1) \f$.
+ * @param[in] kappa =+1 for the focusing nonlinear Schroedinger equation,
+ *  =-1 for the defocusing one
+ * @param[out] result array of length `nse_fscatter_numel(D,discretization)`,
+ * will contain the combined scattering matrix.
+ * @param[out] deg_ptr Pointer to variable containing degree of the discretization.
+ * @param[in] W_ptr Pointer to normalization flag \link fnft_nsev_opts_t::normalization_flag \endlink.
+ * @param[in] discretization The type of discretization to be used. Should be of type 
+ * \link fnft_nse_discretization_t \endlink.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ * @ingroup nse
+ */
+FNFT_INT fnft__nse_fscatter_desc(const FNFT_UINT D,
+    fnft_sample_desc_t const * const q, const FNFT_REAL eps_t,
+    const FNFT_INT kappa, FNFT_COMPLEX * const result,
+    FNFT_UINT * const deg_ptr, FNFT_INT * const W_ptr,
+    fnft_nse_discretization_t discretization);
+
 #ifdef FNFT_ENABLE_SHORT_NAMES
 #define nse_fscatter_numel(...) fnft__nse_fscatter_numel(__VA_ARGS__)
 #define nse_fscatter(...) fnft__nse_fscatter(__VA_ARGS__)
+#define nse_fscatter_desc(...) fnft__nse_fscatter_desc(__VA_ARGS__)
 #endif
 
 #endif
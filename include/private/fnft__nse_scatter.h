@@ -29,6 +29,7 @@
 
 #include "fnft__nse_discretization.h"
 #include "fnft__akns_scatter.h"
+#include "fnft_sample_desc_t.h"
 
 /**
  * @brief Computes \f$a(\lambda)\f$, \f$ a'(\lambda) = \frac{\partial a(\lambda)}{\partial \lambda}\f$
@@ -72,6 +73,23 @@ FNFT_INT fnft__nse_scatter_bound_states(const FNFT_UINT D, FNFT_COMPLEX const *c
     FNFT_COMPLEX *aprime_vals, FNFT_COMPLEX *b,
     fnft_nse_discretization_t discretization);
 
+/**
+ * @brief Computes the scattering coefficients at the bound states for
+ * samples described by a sample descriptor.
+ *
+ * Same as \link fnft__nse_scatter_bound_states \endlink, but the samples of
+ * q are read through the sample descriptor q (see
+ * \link fnft_sample_desc_t \endlink) in the Boffetta-Osborne iterations.
+ * All other parameters are the same.
+ * @ingroup nse
+ */
+FNFT_INT fnft__nse_scatter_bound_states_desc(const FNFT_UINT D,
+    fnft_sample_desc_t const * const q,
+    FNFT_REAL const *const T,  FNFT_UINT *trunc_index_ptr, FNFT_UINT K,
+    FNFT_COMPLEX *bound_states, FNFT_COMPLEX *a_vals,
+    FNFT_COMPLEX *aprime_vals, FNFT_COMPLEX *b,
+    fnft_nse_discretization_t discretization);
+
 /**
  * @brief Computes the scattering matrix and its derivative.
  * 
@@ -106,6 +124,7 @@ FNFT_INT fnft__nse_scatter_matrix(const FNFT_UINT D, FNFT_COMPLEX const * const
 
 #ifdef FNFT_ENABLE_SHORT_NAMES
 #define nse_scatter_bound_states(...) fnft__nse_scatter_bound_states(__VA_ARGS__)
+#define nse_scatter_bound_states_desc(...) fnft__nse_scatter_bound_states_desc(__VA_ARGS__)
 #define nse_scatter_matrix(...) fnft__nse_scatter_matrix(__VA_ARGS__)
 #endif
 
@@ -0,0 +1,312 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* Sander Wahls (TU Delft) 2017-2018.
+* Shrinivas Chimmalgi (TU Delft) 2017-2018.
+*/
+
+/**
+ * @file fnft__nsev.h
+ * @brief Internals of fnft_nsev that are shared with the accumulator,
+ * product tree, gradient, short-time and tracking routines.
+ * @ingroup nse
+ */
+
+#ifndef FNFT__NSEV_H
+#define FNFT__NSEV_H
+
+#include "fnft_nsev.h"
+#include "fnft_sample_desc_t.h"
+
+/**
+ * @brief Maximum number of levels of the product tree of
+ * \link fnft_nsev_tree_t \endlink.
+ * @ingroup nse
+ */
+#define FNFT__NSEV_TREE_MAX_LEVELS 64
+
+/**
+ * @brief State of a persistent product tree.
+ *
+ * Node i on level 0 is the transfer matrix of the block of samples
+ * i*block_len,...,(i+1)*block_len-1. Node i on level l is the product of the
+ * nodes 2i+1 (left) and 2i (right) on level l-1, or a copy of node 2i if the
+ * latter has no sibling. The top level consists only of the root. The
+ * definition is private so that fnft_nsev_gradient can traverse the tree.
+ * @ingroup nse
+ */
+struct fnft_nsev_tree_s {
+    FNFT_UINT D;
+    FNFT_UINT block_len;
+    FNFT_REAL T[2];
+    FNFT_INT kappa;
+    fnft_nsev_opts_t opts;
+    FNFT_COMPLEX *q;
+    FNFT_UINT n_levels;
+    FNFT_UINT n_nodes[FNFT__NSEV_TREE_MAX_LEVELS];
+    struct {
+        FNFT_COMPLEX *tm;
+        FNFT_UINT deg;
+        FNFT_INT W;
+    } *nodes[FNFT__NSEV_TREE_MAX_LEVELS];
+};
+
+/**
+ * @brief Computes the continuous and/or discrete spectrum from a transfer
+ * matrix.
+ *
+ * @param[in] D Number of samples.
+ * @param[in] q Descriptor of the samples from which the transfer matrix has
+ *  been computed. They are only read by the routines for the discrete
+ *  spectrum.
+ * @param[in] T Array of length 2, contains the position in time of the first
+ *  and of the last sample.
+ * @param[in] deg Degree of the polynomials in the transfer matrix.
+ * @param[in] W Normalization exponent returned by
+ *  \link fnft__nse_fscatter \endlink (zero if the transfer matrix has not
+ *  been normalized).
+ * @param[in,out] transfer_matrix Transfer matrix as returned by
+ *  \link fnft__nse_fscatter \endlink. The second and fourth quarter are
+ *  used as buffers and overwritten.
+ * @param[in] M,contspec,XI,K_ptr,bound_states,normconsts_or_residues,kappa
+ *  As in \link fnft_nsev \endlink.
+ * @param[in,out] opts Options as in \link fnft_nsev \endlink. They are
+ *  modified temporarily, but restored before the function returns
+ *  successfully.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ * @ingroup nse
+ */
+FNFT_INT fnft__nsev_tf2nfs(const FNFT_UINT D,
+    fnft_sample_desc_t const * const q, FNFT_REAL const * const T,
+    const FNFT_UINT deg, const FNFT_INT W, FNFT_COMPLEX * const transfer_matrix,
+    const FNFT_UINT M, FNFT_COMPLEX * const contspec,
+    FNFT_REAL const * const XI, FNFT_UINT * const K_ptr,
+    FNFT_COMPLEX * const bound_states,
+    FNFT_COMPLEX * const normconsts_or_residues, const FNFT_INT kappa,
+    fnft_nsev_opts_t * const opts);
+
+/**
+ * @brief Computes the continuous spectrum on a frequency grid from a
+ * transfer matrix.
+ *
+ * @param[in] deg Degree of the polynomials in the transfer matrix.
+ * @param[in] W Normalization exponent of the transfer matrix.
+ * @param[in,out] transfer_matrix Transfer matrix as returned by
+ *  \link fnft__nse_fscatter \endlink. The second and fourth quarter are
+ *  used as buffers and overwritten.
+ * @param[in] T Array of length 2, contains the position in time of the first
+ *  and of the last sample.
+ * @param[in] D Number of samples.
+ * @param[in] XI Array of length 2, contains the first and the last point of
+ *  the frequency grid.
+ * @param[in] M Number of points in the frequency grid.
+ * @param[out] result Array of length M (or 2*M if opts->contspec_type is
+ *  fnft_nsev_cstype_BOTH), see \link fnft_nsev \endlink.
+ * @param[in] opts Options as in \link fnft_nsev \endlink.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ * @ingroup nse
+ */
+FNFT_INT fnft__nsev_tf2contspec(const FNFT_UINT deg, const FNFT_INT W,
+    FNFT_COMPLEX * const transfer_matrix, FNFT_REAL const * const T,
+    const FNFT_UINT D, FNFT_REAL const * const XI, const FNFT_UINT M,
+    FNFT_COMPLEX * const result, fnft_nsev_opts_t * const opts);
+
+/**
+ * @brief Computes the norming constants and/or residues of given bound
+ * states with the Boffetta-Osborne scheme.
+ *
+ * @param[in] D Number of samples.
+ * @param[in] q Descriptor of the samples.
+ * @param[in] T Array of length 2, contains the position in time of the first
+ *  and of the last sample.
+ * @param[in] K Number of bound states.
+ * @param[in] transfer_matrix Transfer matrix of the samples.
+ * @param[in] deg Degree of the polynomials in the transfer matrix.
+ * @param[in] bound_states Array of length K, contains the bound states.
+ * @param[out] normconsts_or_residues Array of length K (or 2*K if
+ *  opts->discspec_type is fnft_nsev_dstype_BOTH).
+ * @param[in] opts Options as in \link fnft_nsev \endlink.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ * @ingroup nse
+ */
+FNFT_INT fnft__nsev_tf2normconsts_or_residues(const FNFT_UINT D,
+    fnft_sample_desc_t const * const q, FNFT_REAL const * const T,
+    const FNFT_UINT K, FNFT_COMPLEX * const transfer_matrix,
+    const FNFT_UINT deg, FNFT_COMPLEX * const bound_states,
+    FNFT_COMPLEX * const normconsts_or_residues,
+    fnft_nsev_opts_t * const opts);
+
+/**
+ * @brief Refines bound states with Newton's method as specified by
+ * opts->bound_state_refinement.
+ *
+ * @param[in] D Number of samples.
+ * @param[in] q Descriptor of the samples.
+ * @param[in] T Array of length 2, contains the position in time of the first
+ *  and of the last sample.
+ * @param[in] deg Degree of the polynomials in the transfer matrix.
+ * @param[in] transfer_matrix Transfer matrix of the samples.
+ * @param[in] eps_t Step size.
+ * @param[in] K Number of bound states.
+ * @param[in,out] bound_states Array of length K. Upon entry, the initial
+ *  guesses. Upon exit, the refined bound states. The iterations for a bound
+ *  state are stopped once it leaves the region in which bound states are
+ *  assumed.
+ * @param[in] opts Options as in \link fnft_nsev \endlink. The number of
+ *  iterations is opts->niter.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ * @ingroup nse
+ */
+FNFT_INT fnft__nsev_refine_bound_states(const FNFT_UINT D,
+    fnft_sample_desc_t const * const q, FNFT_REAL const * const T,
+    const FNFT_UINT deg, FNFT_COMPLEX * const transfer_matrix,
+    const FNFT_REAL eps_t, const FNFT_UINT K,
+    FNFT_COMPLEX * const bound_states, fnft_nsev_opts_t * const opts);
+
+/**
+ * @brief Bound on the real parts of the bound states.
+ *
+ * @param[in] eps_t Step size.
+ * @param[in] map_coeff Coefficient of the map z=exp(map_coeff*j*lam*eps_t)
+ *  of the discretization.
+ * @return Bound states are assumed to have a real part in
+ *  [-re_bound,re_bound].
+ * @ingroup nse
+ */
+FNFT_REAL fnft__nsev_re_bound(const FNFT_REAL eps_t,
+    const FNFT_REAL map_coeff);
+
+/**
+ * @brief Bound on the imaginary parts of the bound states based on the
+ * nonlinear Parseval relation.
+ *
+ * @param[in] D Number of samples.
+ * @param[in] q Descriptor of the samples.
+ * @param[in] T Array of length 2, contains the position in time of the first
+ *  and of the last sample.
+ * @return Bound states are assumed to have an imaginary part in
+ *  [0,im_bound].
+ * @ingroup nse
+ */
+FNFT_REAL fnft__nsev_im_bound(const FNFT_UINT D,
+    fnft_sample_desc_t const * const q, FNFT_REAL const * const T);
+
+/**
+ * @brief Localizes the bound states in a box with the argument principle.
+ *
+ * The box [-re_bound_val,re_bound_val]x[0,im_bound_val] is subdivided
+ * recursively until each box contains at most one zero of a(lam) or a
+ * maximum depth is reached. The zeros in the remaining boxes are computed
+ * with the method of Delves and Lyness, and boxes without zeros are
+ * discarded. This avoids the O(deg^2) fast eigenvalue method.
+ *
+ * @param[in] D Number of samples.
+ * @param[in] T Array of length 2, contains the position in time of the first
+ *  and of the last sample.
+ * @param[in] deg Degree of the polynomials in the transfer matrix.
+ * @param[in] transfer_matrix Transfer matrix of the samples.
+ * @param[in] eps_t Step size.
+ * @param[in] re_bound_val Bound on the real parts of the bound states.
+ * @param[in] im_bound_val Bound on the imaginary parts of the bound states.
+ * @param[in,out] K_ptr Upon entry, the length of bound_states. Upon exit,
+ *  the number of zeros that have been found.
+ * @param[out] bound_states Array of length *K_ptr. Not used if count_only
+ *  is set.
+ * @param[in] count_only If set, the zeros are only counted.
+ * @param[in] opts Options as in \link fnft_nsev \endlink.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ * @ingroup nse
+ */
+FNFT_INT fnft__nsev_argprinc_localize(const FNFT_UINT D,
+    FNFT_REAL const * const T, const FNFT_UINT deg,
+    FNFT_COMPLEX const * const transfer_matrix, const FNFT_REAL eps_t,
+    const FNFT_REAL re_bound_val, const FNFT_REAL im_bound_val,
+    FNFT_UINT * const K_ptr, FNFT_COMPLEX * const bound_states,
+    const FNFT_INT count_only, fnft_nsev_opts_t * const opts);
+
+/**
+ * @brief Counts the bound states that can pass the fnft_nsev_bsfilt_FULL
+ * filter with the argument principle.
+ *
+ * The zeros of a(lam) in the box [-re_bound,re_bound]x[0,im_bound] are
+ * counted, where the boundary of the box includes the real axis.
+ *
+ * @param[in] D Number of samples.
+ * @param[in] q Descriptor of the samples.
+ * @param[in] T Array of length 2, contains the position in time of the first
+ *  and of the last sample.
+ * @param[in] deg Degree of the polynomials in the transfer matrix.
+ * @param[in] transfer_matrix Transfer matrix of the samples.
+ * @param[in] eps_t Step size.
+ * @param[out] K_ptr Number of zeros.
+ * @param[in] opts Options as in \link fnft_nsev \endlink.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ * @ingroup nse
+ */
+FNFT_INT fnft__nsev_count_bound_states(const FNFT_UINT D,
+    fnft_sample_desc_t const * const q, FNFT_REAL const * const T,
+    const FNFT_UINT deg, FNFT_COMPLEX const * const transfer_matrix,
+    const FNFT_REAL eps_t, FNFT_UINT * const K_ptr,
+    fnft_nsev_opts_t * const opts);
+
+/**
+ * @brief Improves the continuous spectrum and the bound states computed by
+ * fnft_nsev with Richardson extrapolation.
+ *
+ * Both are recomputed for the signal decimated by a factor of two and
+ * combined with the original ones such that the leading error term of the
+ * discretization cancels. The decimated signal only covers the same
+ * interval T if D is odd. For even D, a warning is issued and the spectra
+ * are not changed.
+ *
+ * @param[in] D,q,T,M,XI,kappa As in \link fnft_nsev_desc \endlink.
+ * @param[in,out] contspec Continuous spectrum computed by fnft_nsev, or NULL.
+ * @param[in] K Number of bound states.
+ * @param[in,out] bound_states Array of length K with the bound states
+ *  computed by fnft_nsev, or NULL.
+ * @param[in,out] opts Options as in \link fnft_nsev \endlink. They are
+ *  modified temporarily, but restored before the function returns
+ *  successfully.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ * @ingroup nse
+ */
+FNFT_INT fnft__nsev_richardson_extrapolation(const FNFT_UINT D,
+    fnft_sample_desc_t const * const q, FNFT_REAL const * const T,
+    const FNFT_UINT M, FNFT_COMPLEX * const contspec,
+    FNFT_REAL const * const XI, const FNFT_UINT K,
+    FNFT_COMPLEX * const bound_states, const FNFT_INT kappa,
+    fnft_nsev_opts_t * const opts);
+
+#ifdef FNFT_ENABLE_SHORT_NAMES
+#define nsev_tf2nfs(...) fnft__nsev_tf2nfs(__VA_ARGS__)
+#define nsev_tf2contspec(...) fnft__nsev_tf2contspec(__VA_ARGS__)
+#define nsev_tf2normconsts_or_residues(...) fnft__nsev_tf2normconsts_or_residues(__VA_ARGS__)
+#define nsev_refine_bound_states(...) fnft__nsev_refine_bound_states(__VA_ARGS__)
+#define nsev_re_bound(...) fnft__nsev_re_bound(__VA_ARGS__)
+#define nsev_im_bound(...) fnft__nsev_im_bound(__VA_ARGS__)
+#define nsev_argprinc_localize(...) fnft__nsev_argprinc_localize(__VA_ARGS__)
+#define nsev_count_bound_states(...) fnft__nsev_count_bound_states(__VA_ARGS__)
+#define nsev_richardson_extrapolation(...) fnft__nsev_richardson_extrapolation(__VA_ARGS__)
+#endif
+
+#endif
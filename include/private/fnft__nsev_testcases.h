@@ -46,6 +46,43 @@ typedef enum {
     fnft__nsev_testcases_TRUNCATED_SOLITON
 } fnft__nsev_testcases_t;
 
+/**
+ * @brief Creates the signal and the exact nonlinear Fourier spectrum of a
+ * test case for \link fnft_nsev \endlink.\n
+ * @ingroup nse
+ *
+ * The arrays *q_ptr, *contspec_ptr, *ab_ptr, *bound_states_ptr,
+ * *normconsts_ptr and *residues_ptr are allocated by the routine and have to
+ * be freed by the user.
+ * @param[in] tc Type of test case.
+ * @param[in] D Number of samples.
+ * @param[out] q_ptr Pointer to the array of the D samples.
+ * @param[out] T Array of length 2 with the times of the first and the last
+ *  sample.
+ * @param[out] M_ptr Pointer to the number of values of the continuous
+ *  spectrum.
+ * @param[out] contspec_ptr Pointer to the array of the M values of the
+ *  reflection coefficient.
+ * @param[out] ab_ptr Pointer to the array of the M values of a followed by
+ *  the M values of b.
+ * @param[out] XI Array of length 2 with the first and the last frequency.
+ * @param[out] K_ptr Pointer to the number of bound states.
+ * @param[out] bound_states_ptr Pointer to the array of the bound states.
+ * @param[out] normconsts_ptr Pointer to the array of the norming constants.
+ * @param[out] residues_ptr Pointer to the array of the residues.
+ * @param[out] kappa_ptr Pointer to kappa.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ */
+FNFT_INT fnft__nsev_testcases(fnft__nsev_testcases_t tc, const FNFT_UINT D,
+    FNFT_COMPLEX ** const q_ptr, FNFT_REAL * const T,
+    FNFT_UINT * const M_ptr, FNFT_COMPLEX ** const contspec_ptr,
+    FNFT_COMPLEX ** const ab_ptr,
+    FNFT_REAL * const XI, FNFT_UINT * const K_ptr,
+    FNFT_COMPLEX ** const bound_states_ptr,
+    FNFT_COMPLEX ** const normconsts_ptr,
+    FNFT_COMPLEX ** residues_ptr, FNFT_INT * const kappa_ptr);
+
 /**
  * @brief Routine to run tests for \link fnft_nsev \endlink.\n
  * @ingroup nse
@@ -0,0 +1,72 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* Sander Wahls (TU Delft) 2017-2018.
+*/
+
+/**
+ * @file fnft__poly_eval_multipoint.h
+ * @brief Fast evaluation of polynomials at many arbitrary points.
+ * @ingroup poly
+ */
+
+#ifndef FNFT__POLY_EVAL_MULTIPOINT_H
+#define FNFT__POLY_EVAL_MULTIPOINT_H
+
+#include "fnft.h"
+
+/**
+ * @brief Fast multipoint evaluation of polynomials using chirp transforms
+ * on rings.
+ * @ingroup poly
+ *
+ * Evaluates a polynomial
+ *
+ *   \f[ p(z)=p_0+p_1 z^1+p_2 z^2+...+p_{deg} z^{deg} \f]
+ *
+ * at \a nz arbitrary points \f$ z_1,\dots,z_{nz} \f$ in the complex plane.
+ * The points are grouped into thin rings
+ * \f$ \{z: r_0 e^{-\pi/N}\leq|z|\leq r_0 e^{\pi/N}\} \f$, where \f$N\f$
+ * is the smallest FFT length that is at least four times the number of
+ * coefficients. For each ring with sufficiently many points, the scaled
+ * derivatives \f$ p^{(j)}(w_m)/j! \f$ are computed on the \f$ N \f$ grid
+ * points \f$ w_m=r_0 e^{2\pi i m/N}\f$ using
+ * \link fnft__poly_chirpz \endlink. The values at the points in the ring
+ * are then obtained from the Taylor series around the closest grid point,
+ * which is truncated as soon as its terms fall below machine precision.
+ * Points in rings with only few points are evaluated using Horner's method.
+ * Since no polynomial divisions are involved, this is numerically as safe
+ * as \link fnft__poly_chirpz \endlink.
+ *
+ * @param[in] deg Degree of the polynomial
+ * @param[in] p Array containing the deg+1 coefficients of the polynomial in
+ *  descending order (i.e., \f$ p_{deg}, p_{deg-1}, \dots, p_1, p_0 \f$).
+ * @param[in] nz Number of points z at which the polynomial should be evaluated
+ * @param[in,out] z Array of \a nz points \f$z_1,\dots,z_{nz}\f$ at which the
+ *  polynomial should be evaluated. These values will be overwritten with
+ *  the corresponding values \f$p(z_1),\dots,p(z_{nz})\f$ of the polynomial.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ */
+FNFT_INT fnft__poly_eval_multipoint_rings(const FNFT_UINT deg,
+    FNFT_COMPLEX const * const p, const FNFT_UINT nz,
+    FNFT_COMPLEX * const z);
+
+#ifdef FNFT_ENABLE_SHORT_NAMES
+#define poly_eval_multipoint_rings(...) fnft__poly_eval_multipoint_rings(__VA_ARGS__)
+#endif
+
+#endif
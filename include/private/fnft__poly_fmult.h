@@ -188,7 +188,11 @@ FNFT_UINT fnft__poly_fmult2x2_numel(const FNFT_UINT deg, const FNFT_UINT n);
  * Fast multiplication of n 2x2 matrix-valued polynomials of degree d. Their
  * coefficients are stored in the array p and will be overwritten. If
  * W_ptr != NULL, the result has been normalized by a factor 2^W. Upon exit,
- * W has been stored in *W_ptr.
+ * W has been stored in *W_ptr. Products in which one of the factors is a
+ * diagonal matrix of monomials, \f$ \mathrm{diag}(c_1 z^{k_1}, c_2 z^{k_2})
+ * \f$, are computed by shifting the coefficients of the other factor instead
+ * of using FFTs. Such factors arise for example from runs of zero samples
+ * in \link fnft__akns_fscatter \endlink and from the internal padding.
  * @param[in] d Pointer to a \link FNFT_UINT \endlink containing the degree of
  * the polynomials.
  * @param[in] n Number of 2x2 matrix-valued polynomials.
@@ -205,6 +209,88 @@ FNFT_UINT fnft__poly_fmult2x2_numel(const FNFT_UINT deg, const FNFT_UINT n);
 FNFT_INT fnft__poly_fmult2x2(FNFT_UINT *d, FNFT_UINT n, FNFT_COMPLEX * const p, 
     FNFT_COMPLEX * const result, FNFT_INT * const W_ptr);
 
+/**
+ * @brief Fast multiplication of multiple 2x2 matrix-valued polynomials with
+ *   real coefficients.
+ *
+ * @ingroup poly
+ * Same as \link fnft__poly_fmult2x2 \endlink, but the imaginary parts of the
+ * coefficients in p are assumed to be zero (and ignored). Since the FFTs of
+ * real sequences are conjugate symmetric, the FFTs of two real polynomials
+ * are computed with a single complex FFT. Each product of two matrices then
+ * requires six instead of 24 FFTs. The real-valued result is returned in
+ * the complex valued array result. The arguments are the same as for
+ * \link fnft__poly_fmult2x2 \endlink.
+ * @param[in] d Pointer to a \link FNFT_UINT \endlink containing the degree of
+ * the polynomials.
+ * @param[in] n Number of 2x2 matrix-valued polynomials.
+ * @param[in,out] p Complex valued array with real coefficients. See
+ * \link fnft__poly_fmult2x2 \endlink. WARNING: p is overwritten.
+ * @param[out] result Complex valued array that holds the result of the
+ * multiplication. Should be of the same size as p.
+ * @param[in] W_ptr Pointer to normalization flag.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ */
+FNFT_INT fnft__poly_fmult2x2_real(FNFT_UINT *d, FNFT_UINT n,
+    FNFT_COMPLEX * const p, FNFT_COMPLEX * const result,
+    FNFT_INT * const W_ptr);
+
+/**
+ * @brief Multiplication of two 2x2 matrix-valued polynomials of possibly
+ *   different degrees.
+ *
+ * @ingroup poly
+ * Computes the product p1*p2 of two 2x2 matrix-valued polynomials of the
+ * degrees deg1 and deg2 using \link fnft__poly_fmult2x2 \endlink. The
+ * coefficients of each matrix are stored as in the result of
+ * \link fnft__poly_fmult2x2 \endlink, i.e., the coefficients of the
+ * (1,1), (1,2), (2,1) and (2,2) elements follow each other, each in
+ * descending order. If W_ptr != NULL, the result has been normalized by a
+ * factor 2^W. Upon exit, W has been stored in *W_ptr.
+ * @param[in] deg1 Degree of p1.
+ * @param[in] p1 Complex valued array of length 4*(deg1+1). Left factor.
+ * @param[in] deg2 Degree of p2.
+ * @param[in] p2 Complex valued array of length 4*(deg2+1). Right factor.
+ * @param[out] result Complex valued array of length 4*(deg1+deg2+1).
+ * @param[in] W_ptr Pointer to normalization flag.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ */
+FNFT_INT fnft__poly_fmult2x2_pair(const FNFT_UINT deg1,
+    FNFT_COMPLEX const * const p1, const FNFT_UINT deg2,
+    FNFT_COMPLEX const * const p2, FNFT_COMPLEX * const result,
+    FNFT_INT * const W_ptr);
+
+/**
+ * @brief Adjoint of the multiplication of two 2x2 matrix-valued polynomials.
+ *
+ * @ingroup poly
+ * Let \f$ P=P_1 P_2 \f$ be the product computed by
+ * \link fnft__poly_fmult2x2_pair \endlink (without normalization) and let
+ * \f$ L \f$ be a real-valued function of the coefficients of \f$ P \f$.
+ * Given the derivatives \f$ \bar P=\partial L/\partial P^* \f$ w.r.t. the
+ * complex conjugates of the coefficients of \f$ P \f$, this routine
+ * computes \f$ \bar P_1 = \partial L/\partial P_1^* \f$ and
+ * \f$ \bar P_2 = \partial L/\partial P_2^* \f$. Since polynomial
+ * multiplication is a convolution, these are given by cross-correlations,
+ * e.g., \f$ \bar P_1 = \bar P \star P_2^H \f$, which are computed with FFTs.
+ * The arrays are stored as in \link fnft__poly_fmult2x2_pair \endlink.
+ * @param[in] deg1 Degree of p1.
+ * @param[in] p1 Complex valued array of length 4*(deg1+1). Left factor.
+ * @param[in] deg2 Degree of p2.
+ * @param[in] p2 Complex valued array of length 4*(deg2+1). Right factor.
+ * @param[in] result_bar Complex valued array of length 4*(deg1+deg2+1).
+ * @param[out] p1_bar Complex valued array of length 4*(deg1+1).
+ * @param[out] p2_bar Complex valued array of length 4*(deg2+1).
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ */
+FNFT_INT fnft__poly_fmult2x2_pair_adjoint(const FNFT_UINT deg1,
+    FNFT_COMPLEX const * const p1, const FNFT_UINT deg2,
+    FNFT_COMPLEX const * const p2, FNFT_COMPLEX const * const result_bar,
+    FNFT_COMPLEX * const p1_bar, FNFT_COMPLEX * const p2_bar);
+
 #ifdef FNFT_ENABLE_SHORT_NAMES
 #define poly_fmult_two_polys_len(...) fnft__poly_fmult_two_polys_len(__VA_ARGS__)
 #define poly_fmult_two_polys_lenmen(...) fnft__poly_fmult_two_polys_lenmen(__VA_ARGS__)
@@ -214,6 +300,9 @@ FNFT_INT fnft__poly_fmult2x2(FNFT_UINT *d, FNFT_UINT n, FNFT_COMPLEX * const p,
 #define poly_fmult2x2_numel(...) fnft__poly_fmult2x2_numel(__VA_ARGS__)
 #define poly_fmult(...) fnft__poly_fmult(__VA_ARGS__)
 #define poly_fmult2x2(...) fnft__poly_fmult2x2(__VA_ARGS__)
+#define poly_fmult2x2_real(...) fnft__poly_fmult2x2_real(__VA_ARGS__)
+#define poly_fmult2x2_pair(...) fnft__poly_fmult2x2_pair(__VA_ARGS__)
+#define poly_fmult2x2_pair_adjoint(...) fnft__poly_fmult2x2_pair_adjoint(__VA_ARGS__)
 #endif
 
 #endif
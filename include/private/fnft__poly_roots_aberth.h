@@ -0,0 +1,70 @@
+/*
+* This file is part of FNFT.  
+*                                                                  
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*                                                                      
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* Sander Wahls (TU Delft) 2017-2018.
+*/
+
+/**
+ * @file fnft__poly_roots_aberth.h
+ * @brief Simultaneous root finding of polynomials.
+ * @ingroup poly
+ */
+
+#ifndef FNFT__POLY_ROOTS_ABERTH_H
+#define FNFT__POLY_ROOTS_ABERTH_H
+
+#include "fnft.h"
+
+/**
+ * @brief Computation of polynomial roots using the Aberth-Ehrlich method.
+ * 
+ * @ingroup poly
+ * This routine computes the roots of a polynomial
+ *   \f[ p(z)=p_0+p_1 z^1+p_2 z^2+...+p_{deg} z^{deg} \f]
+ * by simultaneously refining approximations \f$z_1,\dots,z_{deg}\f$ of all
+ * roots using the Aberth-Ehrlich iteration
+ *   \f[ z_k \leftarrow z_k - \frac{N_k}{1-N_k\sum_{j\neq k}\frac{1}{z_k-z_j}},
+ *   \quad N_k = \frac{p(z_k)}{p'(z_k)}. \f]
+ * The initial approximations are placed on a circle. The values
+ * \f$ p(z_k) \f$ and \f$ p'(z_k) \f$ are computed using
+ * \link fnft__poly_eval_multipoint_rings \endlink, which uses chirp
+ * transforms for points that are located on common circles. Points outside
+ * of the unit circle are handled using the reversed polynomial in order to
+ * avoid overflows. Approximations are no longer updated once
+ * \f$ |p(z_k)| \f$ is below a bound for the rounding errors made during
+ * its evaluation or once the corrections become negligible. Each iteration requires \f$ O(deg^2) \f$ floating point
+ * operations for the Aberth corrections, which are computed in parallel if
+ * FNFT has been built with OpenMP support. Vanishing leading coefficients
+ * result in roots at infinity.
+ * @see Bini, <a href="https://doi.org/10.1007/BF02207694">&quot;Numerical
+ * computation of polynomial zeros by means of Aberth's method,&quot;</a>
+ * Numer. Algorithms 13(2), 1996.
+ * @param[in] deg Degree of the polynomial
+ * @param[in] p Array containing the deg+1 coefficients of the polynomial in
+ *  descending order (i.e., \f$ p_{deg}, p_{deg-1}, \dots, p_1, p_0 \f$).
+ * @param[out] roots Array of deg points. Will be filled with the roots of
+ *  \f$ p(z) \f$.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ */
+FNFT_INT fnft__poly_roots_aberth(const FNFT_UINT deg,
+    FNFT_COMPLEX const * const p, FNFT_COMPLEX * const roots);
+
+#ifdef FNFT_ENABLE_SHORT_NAMES
+#define poly_roots_aberth(...) fnft__poly_roots_aberth(__VA_ARGS__)
+#endif
+
+#endif
@@ -36,7 +36,10 @@
  *
  *   \f[ p(z)=p_0+p_1 z^1+p_2 z^2+...+p_{deg} z^{deg} \f]
  *
- * using only \f$ O\{ deg^2 \}\f$ floating point operations.
+ * using only \f$ O\{ deg^2 \}\f$ floating point operations. Vanishing
+ * leading coefficients result in roots at infinity and vanishing trailing
+ * coefficients in roots at zero. Only the remaining coefficients are passed
+ * to the eigenvalue routine.
  *
  * @see https://arxiv.org/abs/1611.02435v2
  *
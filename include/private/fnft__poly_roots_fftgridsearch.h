@@ -56,6 +56,12 @@
  * center grid poFNFT_INT and the root of this linerization is computed. The
  * root of the linearization is kept if it is not too far from the grid point.
  *
+ * The grid is processed in tiles of consecutive grid points. Each tile is
+ * evaluated with its own Chirp transforms on the three rings and scanned
+ * separately, so that the working set per tile is O(max(deg, 16384)) instead
+ * of O(M). The tiles are processed in parallel if OpenMP is enabled. The
+ * detected roots are returned in the order of the grid points.
+ *
  * @see https://doi.org/10.1109/MSP.2003.1253552
  * @see poly_roots_fftgridsearch_paraherm
  * @see poly_chirpz
@@ -78,6 +84,120 @@ FNFT_INT fnft__poly_roots_fftgridsearch(const FNFT_UINT deg,
     FNFT_COMPLEX const * const p, FNFT_UINT * const M_ptr,
     FNFT_REAL const * const PHI, FNFT_COMPLEX * const roots);
 
+/**
+ * @brief Unit circle roots of several polynomials that differ in one
+ *  coefficient via grid search.
+ *
+ * @ingroup poly
+ * This routine approximates the unit circle roots of the polynomials
+ *
+ *   \f[ p(z)+s_j z^{deg-pos}, \ \ \ \ j=0,1,\dots,nshifts-1, \f]
+ *
+ * using the same method as \link fnft__poly_roots_fftgridsearch \endlink.
+ * The polynomial \f$ p(z) \f$ is evaluated on the three rings of the grid
+ * only once. The shifts \f$ s_j z^{deg-pos} \f$ are then added to the values
+ * in place before the grid is scanned for the roots of the j-th polynomial.
+ * Compared to nshifts calls of \link fnft__poly_roots_fftgridsearch
+ * \endlink, this saves nshifts-1 evaluations with the Chirp transform. The
+ * grid is processed in tiles as in \link fnft__poly_roots_fftgridsearch
+ * \endlink. Each tile is evaluated and scanned for all shifts before the
+ * next one, and its roots are kept in a separate array until the tiles are
+ * merged.
+ *
+ * @param[in] deg The degree of the polynomial.
+ * @param[in] p Array containing the deg+1 coefficients of the polynomial in
+ *  descending order (i.e.,
+ *  \f$ p_{deg}, p_{deg-1}, \dots, p_{1}, p_{0} \f$).
+ * @param[in] pos Index of the coefficient in p to which the shifts are
+ *  added.
+ * @param[in] nshifts Number of shifts.
+ * @param[in] shifts Array of nshifts shifts \f$ s_j \f$.
+ * @param[in,out] M_ptr Upon entry, *M_ptr contains the desired value for the
+ *  number of points M. Upon return, *M_ptr has been overwritten with the
+ *  total number of detected roots.
+ * @param[in] PHI Array with two entries, \f$ \Phi_0 \f$ and \f$ \Phi_1 \f$.
+ *  The first value should be lower than the second one.
+ * @param[out] roots Array of M points. Will be filled with the detected roots
+ *  of the shifted polynomials, one polynomial after another.
+ * @param[out] nroots Array of nshifts entries. Upon return, nroots[j]
+ *  contains the number of detected roots of the j-th shifted polynomial.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ */
+FNFT_INT fnft__poly_roots_fftgridsearch_shifts(const FNFT_UINT deg,
+    FNFT_COMPLEX const * const p, const FNFT_UINT pos,
+    const FNFT_UINT nshifts, FNFT_COMPLEX const * const shifts,
+    FNFT_UINT * const M_ptr, FNFT_REAL const * const PHI,
+    FNFT_COMPLEX * const roots, FNFT_UINT * const nroots);
+
+/**
+ * @brief Unit circle roots of several polynomials that differ in one
+ *  coefficient via an adaptive grid search.
+ *
+ * @ingroup poly
+ * This routine approximates the unit circle roots of the polynomials
+ *
+ *   \f[ p(z)+s_j z^{deg-pos}, \ \ \ \ j=0,1,\dots,nshifts-1, \f]
+ *
+ * or of \f$ p(z) \f$ itself if nshifts is zero, on the same grid as
+ * \link fnft__poly_roots_fftgridsearch_shifts \endlink. The three rings are
+ * however not evaluated completely. First, the polynomials and their
+ * derivatives are evaluated on a coarse grid on the unit circle with about
+ * eight points per \f$ 2\pi/deg \f$ (but at least deg+1 and at most M
+ * points). Coarse grid points at which the absolute value is not larger than
+ * at the two neighboring points and at which the Newton step
+ * \f$ |p(z)/p'(z)| \f$ (at the point or a neighbor) is at most one coarse
+ * grid spacing are candidates for roots. Only the neighborhoods of the
+ * candidates are then evaluated on the three rings of the fine grid, using
+ * zoomed Chirp transforms whose parameters are chosen per part, and scanned
+ * for roots as in \link fnft__poly_roots_fftgridsearch \endlink. Parts that
+ * are close to each other are evaluated together, and each zoomed transform
+ * covers at most 4*deg grid points. The detected roots agree with those of
+ * \link fnft__poly_roots_fftgridsearch_shifts \endlink up to rounding
+ * errors, which can occasionally change the grid point that is used to
+ * estimate a root.
+ *
+ * The benefit is the workspace of about 25*deg (no or one shift) or 32*deg
+ * (several shifts) complex numbers, which does not grow with M, and that
+ * the array roots only needs space for the detected roots instead of M
+ * entries as for \link fnft__poly_roots_fftgridsearch_shifts \endlink.
+ * The run time is only lower if the candidates cover a small part of the
+ * grid. For the main and auxiliary spectra of periodic signals, the roots
+ * typically cover the whole unit circle. The complete fine grid is then
+ * evaluated in addition to the coarse grid, and the run time is about 20 to
+ * 35 percent higher than for \link fnft__poly_roots_fftgridsearch_shifts
+ * \endlink.
+ *
+ * @param[in] deg The degree of the polynomial.
+ * @param[in] p Array containing the deg+1 coefficients of the polynomial in
+ *  descending order (i.e.,
+ *  \f$ p_{deg}, p_{deg-1}, \dots, p_{1}, p_{0} \f$).
+ * @param[in] pos Index of the coefficient in p to which the shifts are
+ *  added.
+ * @param[in] nshifts Number of shifts. Can be zero.
+ * @param[in] shifts Array of nshifts shifts \f$ s_j \f$.
+ * @param[in,out] M_ptr Upon entry, *M_ptr contains the desired value for the
+ *  number of points M of the fine grid, which is at least three. Upon
+ *  return, *M_ptr has been overwritten with the total number of detected
+ *  roots.
+ * @param[in] PHI Array with two entries, \f$ \Phi_0 \f$ and \f$ \Phi_1 \f$.
+ *  The first value should be lower than the second one.
+ * @param[in] capacity Number of entries of the array roots.
+ * @param[out] roots Array of capacity points. Will be filled with the
+ *  detected roots of the shifted polynomials, one polynomial after another.
+ * @param[out] nroots Array of nshifts entries. Upon return, nroots[j]
+ *  contains the number of detected roots of the j-th shifted polynomial.
+ *  Can be NULL if nshifts is zero.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ */
+FNFT_INT fnft__poly_roots_fftgridsearch_adaptive(const FNFT_UINT deg,
+    FNFT_COMPLEX const * const p, const FNFT_UINT pos,
+    const FNFT_UINT nshifts, FNFT_COMPLEX const * const shifts,
+    FNFT_UINT * const M_ptr, FNFT_REAL const * const PHI,
+    const FNFT_UINT capacity, FNFT_COMPLEX * const roots,
+    FNFT_UINT * const nroots);
+
 /**
  * @brief Unit circle roots of a parahermitian Laurent polynomial via grid
  *  search.
@@ -102,7 +222,9 @@ FNFT_INT fnft__poly_roots_fftgridsearch(const FNFT_UINT deg,
  * polynomial is para-hermitian, it will be
  * real on the unit circle. If the sign of the Laurent polynomial changes
  * between two consequtive points on the grid, a root is detected. The
- * position of the roots is determined using linear interpolation.
+ * position of the roots is determined using linear interpolation. The grid
+ * is processed in tiles as in \link fnft__poly_roots_fftgridsearch
+ * \endlink.
  *
  * @see poly_roots_fftgridsearch
  * @see poly_chirpz
@@ -127,6 +249,8 @@ FNFT_INT fnft__poly_roots_fftgridsearch_paraherm(const FNFT_UINT deg,
 
 #ifdef FNFT_ENABLE_SHORT_NAMES
 #define poly_roots_fftgridsearch(...) fnft__poly_roots_fftgridsearch(__VA_ARGS__)
+#define poly_roots_fftgridsearch_shifts(...) fnft__poly_roots_fftgridsearch_shifts(__VA_ARGS__)
+#define poly_roots_fftgridsearch_adaptive(...) fnft__poly_roots_fftgridsearch_adaptive(__VA_ARGS__)
 #define poly_roots_fftgridsearch_paraherm(...) fnft__poly_roots_fftgridsearch_paraherm(__VA_ARGS__)
 #endif
 
@@ -50,8 +50,54 @@ FNFT_INT fnft__poly_specfact(const FNFT_UINT deg,
                              const FNFT_UINT oversampling_factor,
                              const FNFT_INT kappa);
 
+/**
+ * @brief Splits off the factor of a polynomial whose roots are located
+ * inside an annulus.
+ *
+ * @ingroup poly
+ * Computes the monic polynomial whose roots are the roots of the given
+ * polynomial that lie in the annulus \f$ r_{in}<|z|<r_{out} \f$. The
+ * routine uses the same cepstral approach as \link fnft__poly_specfact
+ * \endlink. The logarithmic derivative \f$ zp'(z)/p(z) \f$ is sampled on
+ * the two circles \f$|z|=r_{in}\f$ and \f$|z|=r_{out}\f$ using FFTs. Its
+ * constant Fourier coefficient on either circle is the number of roots
+ * inside that circle. Its coefficients with negative indices are the
+ * scaled power sums of these roots, so that the desired factor can be
+ * obtained by taking their difference, exponentiating and applying an
+ * inverse FFT. The complexity is \f$ O(N\log N) \f$, where \f$ N \f$ is
+ * the FFT length.\n
+ * The results are only accurate if no roots are located close to the two
+ * circles. If the routine detects that the root counts are not reliable,
+ * it returns the original polynomial (i.e., *deg_factor_ptr=deg and
+ * factor=poly).
+ * @param [in] deg Degree of the polynomial.
+ * @param [in] poly Array of deg+1 coefficients of the polynomial in
+ *  descending order.
+ * @param [in] r_in Inner radius of the annulus. Can be zero.
+ * @param [in] r_out Outer radius of the annulus. Should be larger than
+ *  r_in.
+ * @param [in] oversampling_factor The FFT length is at least
+ *  oversampling_factor*(deg+1). Larger values reduce the aliasing errors
+ *  that occur when roots are close to the circles.
+ * @param [out] deg_factor_ptr Pointer to a variable in which the degree of
+ *  the factor is stored.
+ * @param [out] factor Array of at least deg+1 entries in which the
+ *  *deg_factor_ptr+1 coefficients of the factor are stored in descending
+ *  order.
+ * @return \link FNFT_SUCCESS \endlink or one of the FNFT_EC_... error codes
+ *  defined in \link fnft_errwarn.h \endlink.
+ */
+FNFT_INT fnft__poly_specfact_annulus(const FNFT_UINT deg,
+                                     FNFT_COMPLEX const * const poly,
+                                     const FNFT_REAL r_in,
+                                     const FNFT_REAL r_out,
+                                     const FNFT_UINT oversampling_factor,
+                                     FNFT_UINT * const deg_factor_ptr,
+                                     FNFT_COMPLEX * const factor);
+
 #ifdef FNFT_ENABLE_SHORT_NAMES
 #define poly_specfact(...) fnft__poly_specfact(__VA_ARGS__)
+#define poly_specfact_annulus(...) fnft__poly_specfact_annulus(__VA_ARGS__)
 #endif
 
 #endif
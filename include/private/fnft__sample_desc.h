@@ -0,0 +1,204 @@
+/*
+ * This file is part of FNFT.
+ *
+ * FNFT is free software; you can redistribute it and/or
+ * modify it under the terms of the version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * FNFT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contributors:
+ * Sander Wahls (TU Delft) 2018.
+ */
+
+/**
+ * @file fnft__sample_desc.h
+ * @brief Access to samples described by a \link fnft_sample_desc_t \endlink.
+ *
+ * The function bodies are declared as static inline so that the element
+ * type can be resolved inside the per-sample loops of the scattering
+ * routines without function call overhead.
+ * @ingroup misc
+ */
+
+#ifndef FNFT__SAMPLE_DESC_H
+#define FNFT__SAMPLE_DESC_H
+
+#include "fnft_sample_desc_t.h"
+
+/**
+ * @brief Checks if a sample descriptor is valid.
+ *
+ * @param[in] desc Pointer to the descriptor.
+ * @return 1 if desc is not NULL, points to data and has a known type, and 0
+ *  otherwise.
+ * @ingroup misc
+ */
+static inline FNFT_INT fnft__sample_desc_valid(
+    fnft_sample_desc_t const * const desc)
+{
+    if (desc == NULL || desc->data == NULL)
+        return 0;
+    switch (desc->type) {
+        case fnft_sample_type_COMPLEX:
+        case fnft_sample_type_FLOAT32_IQ:
+        case fnft_sample_type_INT16_IQ:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief Returns the n-th sample described by a sample descriptor.
+ *
+ * @param[in] desc Pointer to a valid descriptor.
+ * @param[in] n Index of the sample.
+ * @return desc->scale times the n-th sample.
+ * @ingroup misc
+ */
+static inline FNFT_COMPLEX fnft__sample_desc_get(
+    fnft_sample_desc_t const * const desc, const FNFT_UINT n)
+{
+    const FNFT_UINT i = n*desc->stride;
+    float const * f;
+    int16_t const * s;
+
+    switch (desc->type) {
+        case fnft_sample_type_FLOAT32_IQ:
+            f = (float const *)desc->data + 2*i;
+            return desc->scale*((FNFT_REAL)f[0] + I*(FNFT_REAL)f[1]);
+        case fnft_sample_type_INT16_IQ:
+            s = (int16_t const *)desc->data + 2*i;
+            return desc->scale*((FNFT_REAL)s[0] + I*(FNFT_REAL)s[1]);
+        default:
+            return desc->scale*((FNFT_COMPLEX const *)desc->data)[i];
+    }
+}
+
+/**
+ * @brief Returns a descriptor for a contiguous array of
+ * \link FNFT_COMPLEX \endlink.
+ *
+ * @param[in] x Pointer to the array.
+ * @return Descriptor with type fnft_sample_type_COMPLEX, stride one and
+ *  scale one.
+ * @ingroup misc
+ */
+static inline fnft_sample_desc_t fnft__sample_desc_complex(
+    FNFT_COMPLEX const * const x)
+{
+    fnft_sample_desc_t desc;
+    desc.type = fnft_sample_type_COMPLEX;
+    desc.data = x;
+    desc.stride = 1;
+    desc.scale = 1.0;
+    return desc;
+}
+
+/**
+ * @brief Copies the samples described by a sample descriptor into a
+ * contiguous array.
+ *
+ * @param[in] D Number of samples.
+ * @param[in] desc Pointer to a valid descriptor.
+ * @param[out] x Array of length D.
+ * @ingroup misc
+ */
+static inline void fnft__sample_desc_copy(const FNFT_UINT D,
+    fnft_sample_desc_t const * const desc, FNFT_COMPLEX * const x)
+{
+    FNFT_UINT n;
+    for (n = 0; n < D; n++)
+        x[n] = fnft__sample_desc_get(desc, n);
+}
+
+/**
+ * @brief Squared L2 norm of the samples described by a sample descriptor.
+ *
+ * Same as \link fnft__misc_l2norm2 \endlink, but the samples are read
+ * through a descriptor.
+ *
+ * @param[in] N Number of samples.
+ * @param[in] desc Pointer to a valid descriptor.
+ * @param[in] a Left boundary of the integration interval.
+ * @param[in] b Right boundary of the integration interval.
+ * @return Approximation of the squared L2 norm, or NAN if N<2 or a>=b.
+ * @ingroup misc
+ */
+static inline FNFT_REAL fnft__sample_desc_l2norm2(const FNFT_UINT N,
+    fnft_sample_desc_t const * const desc, const FNFT_REAL a,
+    const FNFT_REAL b)
+{
+    FNFT_REAL val, h, tmp;
+    FNFT_UINT i;
+
+    if (N < 2 || a >= b)
+        return NAN;
+
+    // Integrate |q(t)|^2 numerically as in fnft__misc_l2norm2
+    h = (b - a)/N;
+    tmp = FNFT_CABS(fnft__sample_desc_get(desc, 0));
+    val = 0.5 * h * tmp * tmp;
+    for (i = 1; i < N-1; i++) {
+        tmp = FNFT_CABS(fnft__sample_desc_get(desc, i));
+        val += h * tmp * tmp;
+    }
+    tmp = FNFT_CABS(fnft__sample_desc_get(desc, N-1));
+    val += 0.5 * h * tmp * tmp;
+
+    return val;
+}
+
+/**
+ * @brief Downsampling of the samples described by a sample descriptor.
+ *
+ * Selects the same samples as \link fnft__misc_downsample \endlink. Since
+ * these are equidistant, no copy is made. Instead, a descriptor for them
+ * with a larger stride is returned.
+ *
+ * @param[in] D Number of samples.
+ * @param[in] desc Pointer to a valid descriptor.
+ * @param[in,out] Dsub_ptr Upon entry, the desired number of samples after
+ *  downsampling. Upon exit, the actual number.
+ * @param[out] desc_sub Pointer to the descriptor of the downsampled signal.
+ * @param[out] first_last_index Array of length two. Upon exit, contains the
+ *  indices of the first and last sample of the downsampled signal in the
+ *  original one, as in \link fnft__misc_downsample \endlink.
+ * @ingroup misc
+ */
+static inline void fnft__sample_desc_downsample(const FNFT_UINT D,
+    fnft_sample_desc_t const * const desc, FNFT_UINT * const Dsub_ptr,
+    fnft_sample_desc_t * const desc_sub, FNFT_UINT * const first_last_index)
+{
+    FNFT_UINT Dsub = *Dsub_ptr; // desired Dsub
+    if (Dsub < 2)
+        Dsub = 2;
+    if (Dsub > D)
+        Dsub = D;
+    const FNFT_UINT nskip_per_step = FNFT_ROUND((FNFT_REAL)D / Dsub);
+    Dsub = FNFT_ROUND((FNFT_REAL)D / nskip_per_step); // actual Dsub
+
+    *desc_sub = *desc;
+    desc_sub->stride *= nskip_per_step;
+    first_last_index[0] = 0;
+    first_last_index[1] = Dsub*nskip_per_step - 1;
+    *Dsub_ptr = Dsub;
+}
+
+#ifdef FNFT_ENABLE_SHORT_NAMES
+#define sample_desc_valid(...) fnft__sample_desc_valid(__VA_ARGS__)
+#define sample_desc_get(...) fnft__sample_desc_get(__VA_ARGS__)
+#define sample_desc_complex(...) fnft__sample_desc_complex(__VA_ARGS__)
+#define sample_desc_copy(...) fnft__sample_desc_copy(__VA_ARGS__)
+#define sample_desc_l2norm2(...) fnft__sample_desc_l2norm2(__VA_ARGS__)
+#define sample_desc_downsample(...) fnft__sample_desc_downsample(__VA_ARGS__)
+#endif
+
+#endif
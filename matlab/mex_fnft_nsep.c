@@ -125,6 +125,30 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
             
             opts.localization = fnft_nsep_loc_GRIDSEARCH;
 
+		} else if ( strcmp(str, "rootfind_fasteigen") == 0 ) {
+            
+            opts.root_finder = fnft_nsep_rootfind_FAST_EIGENVALUE;
+
+		} else if ( strcmp(str, "rootfind_aberth") == 0 ) {
+            
+            opts.root_finder = fnft_nsep_rootfind_ABERTH;
+
+		} else if ( strcmp(str, "ref_bo") == 0 ) {
+            
+            opts.refinement = fnft_nsep_ref_BO;
+
+		} else if ( strcmp(str, "ref_poly") == 0 ) {
+            
+            opts.refinement = fnft_nsep_ref_POLY;
+
+		} else if ( strcmp(str, "ref_poly_bo") == 0 ) {
+            
+            opts.refinement = fnft_nsep_ref_POLY_AND_BO;
+
+		} else if ( strcmp(str, "gridsearch_adaptive") == 0 ) {
+            
+            opts.adaptive_gridsearch_flag = 1;
+
         } else if ( strcmp(str, "quiet") == 0 ) {
 
             fnft_errwarn_setprintf(NULL);
@@ -26,6 +26,19 @@
 %    'filt_manual'  Remove spectra outside a given bounding box. This argument
 %                   must be followed by a real 1x4 vector [min_real max_real
 %                   min_imag max_imag] that specifies the box.
+%    'rootfind_fasteigen' Compute polynomial roots using the fast eigenvalue
+%                   method (default).
+%    'rootfind_aberth' Compute polynomial roots using the Aberth-Ehrlich
+%                   method.
+%    'ref_bo'       Refine the roots using the Boffetta-Osborne
+%                   discretization (default).
+%    'ref_poly'     Refine the roots using the polynomials in the monodromy
+%                   matrix of the complete signal.
+%    'ref_poly_bo'  As 'ref_poly', followed by a single Boffetta-Osborne
+%                   step.
+%    'gridsearch_adaptive' Localize the real points of the spectra with a
+%                   coarse-to-fine grid search that needs less memory but
+%                   is slower if there are many real points.
 %   'quiet'         Turns off messages generated by then FNFT C library.
 %                   (To turn off the messages generated by the mex
 %                   interface functions, use Matlab's warning and error
@@ -167,6 +167,10 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
             
             opts.bound_state_localization = fnft_nsev_bsloc_SUBSAMPLE_AND_REFINE;
 
+        } else if ( strcmp(str, "bsloc_argprinc") == 0 ) {
+
+            opts.bound_state_localization = fnft_nsev_bsloc_ARGUMENT_PRINCIPLE;
+
         } else if ( strcmp(str, "bsloc_Dsub") == 0 ) {
 
             /* Extract desired number of iterations */
@@ -182,6 +186,38 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     	    k++;
 
             
+        } else if ( strcmp(str, "bsref_bo") == 0 ) {
+
+            opts.bound_state_refinement = fnft_nsev_bsref_BO;
+
+        } else if ( strcmp(str, "bsref_poly") == 0 ) {
+
+            opts.bound_state_refinement = fnft_nsev_bsref_POLY;
+
+        } else if ( strcmp(str, "bsref_poly_bo") == 0 ) {
+
+            opts.bound_state_refinement = fnft_nsev_bsref_POLY_AND_BO;
+
+        } else if ( strcmp(str, "rootfind_fasteigen") == 0 ) {
+
+            opts.root_finder = fnft_nsev_rootfind_FAST_EIGENVALUE;
+
+        } else if ( strcmp(str, "rootfind_aberth") == 0 ) {
+
+            opts.root_finder = fnft_nsev_rootfind_ABERTH;
+
+        } else if ( strcmp(str, "specsplit") == 0 ) {
+
+            opts.spectral_splitting_flag = 1;
+
+        } else if ( strcmp(str, "bscount") == 0 ) {
+
+            opts.bound_state_counting_flag = 1;
+
+        } else if ( strcmp(str, "richardson") == 0 ) {
+
+            opts.richardson_extrapolation_flag = 1;
+
         } else if ( strcmp(str, "bsfilt_none") == 0 ) {
             
             opts.bound_state_filtering = fnft_nsev_bsfilt_NONE;
@@ -35,6 +35,11 @@
 %                   It requires O(niter D log^2 D) flops if Dsub (see
 %                   below) is set by the algorithm. Not followed by a
 %                   value.
+%   'bsloc_argprinc' Use the argument principle to count the bound states
+%                   in boxes that are subdivided until they contain a
+%                   single bound state, which is then refined using
+%                   'newton'. Only the region accepted by 'bsfilt_full' is
+%                   searched. Not followed by a value.
 %   'bsloc_niter'   Number of iterations to be carried by Newton's method.
 %                   Followed by a scalar double.
 %   'bsloc_Dsub'    The desired number of samples for the subsampled signal
@@ -43,6 +48,30 @@
 %                   might also lead to a loss of precision. Followed
 %                   by scalar value. Note that the routine treates Dsub as
 %                   as an indication. The actually used value might differ.
+%   'bsref_bo'      Evaluate a(lambda) in the Newton iterations using the
+%                   discretization due to Boffetta and Osborne (default).
+%                   Not followed by a value.
+%   'bsref_poly'    Evaluate a(lambda) in the Newton iterations using the
+%                   polynomial from the already computed transfer matrix.
+%                   Faster, but only as accurate as the discretization.
+%                   Not followed by a value.
+%   'bsref_poly_bo' Like 'bsref_poly', but finishes with one Newton step
+%                   based on the Boffetta-Osborne discretization. Not
+%                   followed by a value.
+%   'rootfind_fasteigen' Compute polynomial roots using the fast eigenvalue
+%                   method (default). Not followed by a value.
+%   'rootfind_aberth' Compute polynomial roots using the Aberth-Ehrlich
+%                   method. Not followed by a value.
+%   'specsplit'     Before the polynomial roots are computed, split off the
+%                   factor whose roots can pass the bound state filter.
+%                   Not followed by a value.
+%   'bscount'       Count the bound states with the argument principle
+%                   first. Skip the localization if there are none. Not
+%                   followed by a value.
+%   'richardson'    Improve the continuous spectrum and the bound states
+%                   using Richardson extrapolation. The number of samples
+%                   has to be odd, otherwise the extrapolation is skipped
+%                   with a warning. Not followed by a value.
 %   'bsfilt_none'   Do not filter bound states at all.
 %   'bsfilt_basic'  Basic bound state filtering. Removes duplicates and
 %                   bound states in the lower half plane.
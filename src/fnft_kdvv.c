@@ -25,14 +25,21 @@
 #include "fnft__poly_roots_fasteigen.h"
 #include "fnft__poly_chirpz.h"
 #include "fnft__kdv_fscatter.h"
+#include "fnft__kdv_scatter.h"
 #include "fnft__kdv_discretization.h"
+#include "fnft__misc.h"
 #include "fnft_kdvv.h"
 
 /**
  * Stores additional options for the routine fnft_kdvv.
  */
 kdvv_opts_t default_opts = {
-    .discretization = kdv_discretization_2SPLIT8B
+    .discretization = kdv_discretization_2SPLIT8B,
+    .bound_state_localization = kdvv_bsloc_SUBSAMPLE_AND_REFINE,
+    .niter = 10,
+    .Dsub = 0, // auto
+    .discspec_type = kdvv_dstype_NORMING_CONSTANTS,
+    .normalization_flag = 1
 };
 
 /**
@@ -44,14 +51,54 @@ kdvv_opts_t fnft_kdvv_default_opts()
 }
 
 /**
- * Declare auxiliary routine used by the main routine fnft_kdvv.
- * Its body follows below.
+ * Declare auxiliary routines used by the main routine fnft_kdvv.
+ * Their bodies follow below.
  */
 static INT tf2contspec_negxi(UINT deg,
     COMPLEX *transfer_matrix, REAL const * const T,
     const UINT D, REAL const * const XI, const UINT M,
     COMPLEX * result, fnft_kdvv_opts_t * opts_ptr);
 
+static INT find_bound_states(
+    const UINT D,
+    COMPLEX const * const q,
+    REAL const * const T,
+    UINT * const K_ptr,
+    COMPLEX * const bound_states,
+    fnft_kdvv_opts_t * const opts_ptr);
+
+static INT subsample_and_localize(
+    const UINT D,
+    COMPLEX const * const q,
+    REAL const * const T,
+    const REAL kappa_max,
+    UINT * const K_ptr,
+    COMPLEX ** const buffer_ptr,
+    fnft_kdvv_opts_t * const opts_ptr);
+
+static INT refine_roots_newton(
+    const UINT D,
+    COMPLEX const * const q,
+    REAL const * const T,
+    const REAL kappa_max,
+    const UINT K,
+    COMPLEX * const bound_states,
+    const UINT niter);
+
+static INT filter_bound_states(
+    const REAL kappa_max,
+    UINT * const K_ptr,
+    COMPLEX * const bound_states);
+
+static INT compute_normconsts_or_residues(
+    const UINT D,
+    COMPLEX const * const q,
+    REAL const * const T,
+    const UINT K,
+    COMPLEX * const bound_states,
+    COMPLEX * const normconsts_or_residues,
+    fnft_kdvv_opts_t * const opts_ptr);
+
 /**
  * Fast nonlinear Fourier transform for the Korteweg-de Vries equation with
  * vanishing boundary conditions.
@@ -71,7 +118,6 @@ INT fnft_kdvv(const UINT D,
     UINT deg;
     INT ret_code = SUCCESS;
     INT W = 0, *W_ptr = NULL;
-    (void) W; //To prevent complier warnings
 
     // Check inputs
     if (D < 2)
@@ -80,40 +126,63 @@ INT fnft_kdvv(const UINT D,
         return E_INVALID_ARGUMENT(u);
     if (T == NULL || T[0] >= T[1])
         return E_INVALID_ARGUMENT(T);
-    if (contspec == NULL)
-        return E_INVALID_ARGUMENT(contspec);
-    if (XI == NULL || XI[0] >= XI[1])
-        return E_INVALID_ARGUMENT(XI);
-    if (K_ptr != NULL)
-        return E_NOT_YET_IMPLEMENTED(K_ptr, Please pass "NULL".);
-    if (bound_states != NULL)
-        return E_NOT_YET_IMPLEMENTED(bound_states, Please pass "NULL".);
-    if (normconsts_or_residues != NULL)
-        return E_NOT_YET_IMPLEMENTED(normconsts_or_residues, Please pass "NULL".);
+    if (contspec != NULL) {
+        if (XI == NULL || XI[0] >= XI[1])
+            return E_INVALID_ARGUMENT(XI);
+    }
+    if (bound_states != NULL) {
+        if (K_ptr == NULL)
+            return E_INVALID_ARGUMENT(K_ptr);
+    }
 
     if (opts_ptr == NULL)
         opts_ptr = &default_opts;
 
-    // Allocate memory for the transfer matrix
-    transfer_matrix = malloc(kdv_fscatter_numel(D,opts_ptr->discretization)*sizeof(COMPLEX));
-    if (transfer_matrix == NULL) {
-        ret_code = E_NOMEM;
-        goto release_mem;
-    }
+    // Compute the continuous spectrum
+    if (contspec != NULL && M > 0) {
 
-    // Determine step size
-    const REAL eps_t = (T[1] - T[0])/(D - 1);
+        // Allocate memory for the transfer matrix
+        transfer_matrix = malloc(kdv_fscatter_numel(D,opts_ptr->discretization)*sizeof(COMPLEX));
+        if (transfer_matrix == NULL) {
+            ret_code = E_NOMEM;
+            goto release_mem;
+        }
 
-    // Compute the transfer matrix 
-    ret_code = kdv_fscatter(D, u, eps_t, transfer_matrix, &deg,
-        W_ptr, opts_ptr->discretization);
-    CHECK_RETCODE(ret_code, release_mem);
+        // Determine step size
+        const REAL eps_t = (T[1] - T[0])/(D - 1);
 
+        // Compute the transfer matrix 
+        if (opts_ptr->normalization_flag)
+            W_ptr = &W;
+        ret_code = kdv_fscatter(D, u, eps_t, transfer_matrix, &deg,
+            W_ptr, opts_ptr->discretization);
+        CHECK_RETCODE(ret_code, release_mem);
 
-    // Compute the continuous spectrum
-    ret_code = tf2contspec_negxi(deg, transfer_matrix, T, D, XI, M,
-                                     contspec, opts_ptr);
-    CHECK_RETCODE(ret_code, release_mem);
+        // If normalization is enabled, the transfer matrix has been scaled
+        // by 2^(-W). The reflection coefficient is a ratio of entries of the
+        // transfer matrix, so the scaling cancels and W is not applied.
+        // Applying it would reintroduce the overflows that the
+        // normalization avoids.
+        ret_code = tf2contspec_negxi(deg, transfer_matrix, T, D, XI, M,
+                                         contspec, opts_ptr);
+        CHECK_RETCODE(ret_code, release_mem);
+    }
+
+    // Compute the discrete spectrum
+    if (bound_states != NULL) {
+
+        ret_code = find_bound_states(D, u, T, K_ptr, bound_states, opts_ptr);
+        CHECK_RETCODE(ret_code, release_mem);
+
+        // Norming constants and/or residues
+        if (normconsts_or_residues != NULL && *K_ptr != 0) {
+            ret_code = compute_normconsts_or_residues(D, u, T, *K_ptr,
+                bound_states, normconsts_or_residues, opts_ptr);
+            CHECK_RETCODE(ret_code, release_mem);
+        }
+    } else if (K_ptr != NULL) {
+        *K_ptr = 0;
+    }
 
 release_mem:
     free(transfer_matrix);
@@ -207,3 +276,360 @@ release_mem:
     free(H_vals);
     return ret_code;
 }
+
+// Auxiliary function: Upper bound on the imaginary parts kappa of the bound
+// states lam=j*kappa. Since the eigenvalue -kappa^2 of the Schroedinger
+// operator -d^2/dt^2-q(t) cannot be lower than the minimum of -q(t), we have
+// kappa <= sqrt(max q(t)). A factor of 1.5 has been added to account for
+// numerical discrepancies. Returns zero if q(t) is nowhere positive, since
+// there are no bound states in that case.
+static inline REAL im_bound(const UINT D, COMPLEX const * const q)
+{
+    REAL q_max = 0.0;
+    UINT i;
+
+    for (i = 0; i < D; i++) {
+        if (CREAL(q[i]) > q_max)
+            q_max = CREAL(q[i]);
+    }
+    return 1.5 * SQRT(q_max);
+}
+
+// Auxiliary function: Computes the bound states.
+static INT find_bound_states(
+    const UINT D,
+    COMPLEX const * const q,
+    REAL const * const T,
+    UINT * const K_ptr,
+    COMPLEX * const bound_states,
+    fnft_kdvv_opts_t * const opts_ptr)
+{
+    COMPLEX * buffer = NULL;
+    UINT K;
+    INT ret_code = SUCCESS;
+
+    const REAL kappa_max = im_bound(D, q);
+
+    switch (opts_ptr->bound_state_localization) {
+
+        // Refine the initial guesses provided by the user
+        case kdvv_bsloc_NEWTON:
+
+            K = *K_ptr;
+            buffer = bound_states; // Store intermediate results directly
+            break;
+
+        // Find initial guesses using a subsampled signal
+        case kdvv_bsloc_SUBSAMPLE_AND_REFINE:
+
+            if (kappa_max == 0.0) { // there are no bound states
+                *K_ptr = 0;
+                return SUCCESS;
+            }
+            ret_code = subsample_and_localize(D, q, T, kappa_max, &K, &buffer,
+                opts_ptr);
+            CHECK_RETCODE(ret_code, leave_fun);
+            break;
+
+        default:
+
+            return E_INVALID_ARGUMENT(opts_ptr->bound_state_localization);
+    }
+
+    // Refine the bound states using Newton's method on the full signal
+    ret_code = refine_roots_newton(D, q, T, kappa_max, K, buffer,
+        opts_ptr->niter);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Remove roots that are not plausible and merge those that converged to
+    // the same bound state
+    ret_code = filter_bound_states(kappa_max, &K, buffer);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Copy result from buffer to user-supplied array (if not identical)
+    if (buffer != bound_states) {
+        if (*K_ptr < K) {
+            WARN("Found more than *K_ptr bound states. Returning as many as possible.");
+            K = *K_ptr;
+        }
+        memcpy(bound_states, buffer, K * sizeof(COMPLEX));
+    }
+
+    // Update number of bound states
+    *K_ptr = K;
+
+leave_fun:
+    if (buffer != bound_states)
+        free(buffer);
+    return ret_code;
+}
+
+// Auxiliary function: Computes initial guesses for the bound states from
+// the transfer matrix of a subsampled version of the signal. The bound states
+// are the zeros of 2*j*lam*a(lam) = 2*j*lam*H11(z) + H12(z), where H11 and
+// H12 are the polynomials in the first row of the transfer matrix. Since
+// 2*j*lam = degree1step*log(z)/eps_t is not a polynomial in z, it is
+// replaced by its rational approximation 2*degree1step/eps_t*(z-1)/(z+1).
+// After multiplication with z+1, the roots of the polynomial
+//   2*degree1step/eps_t*(z-1)*H11(z) + (z+1)*H12(z)
+// are computed. The 2SPLIT4B discretization is used since its low degree
+// per sample keeps the fast eigenvalue method cheap. Roots in the upper half-plane that are closer to the
+// imaginary axis than to the real axis are projected onto the imaginary
+// axis. Upon exit, *buffer_ptr points to a newly allocated array that
+// contains the *K_ptr initial guesses.
+static INT subsample_and_localize(
+    const UINT D,
+    COMPLEX const * const q,
+    REAL const * const T,
+    const REAL kappa_max,
+    UINT * const K_ptr,
+    COMPLEX ** const buffer_ptr,
+    fnft_kdvv_opts_t * const opts_ptr)
+{
+    COMPLEX *qsub = NULL, *transfer_matrix = NULL, *p, *roots = NULL;
+    COMPLEX const *q_loc = q;
+    UINT i, K, deg, Dsub, degree1step;
+    const kdv_discretization_t discretization = kdv_discretization_2SPLIT4B;
+    UINT first_last_index[2] = { 0, D - 1 };
+    REAL c;
+    INT W = 0;
+    INT ret_code = SUCCESS;
+
+    const REAL eps_t = (T[1] - T[0])/(D - 1);
+
+    // Subsample the signal. To bound the complexity of the fast eigenvalue
+    // method, the number of samples is reduced to about sqrt(D*log^2(D)).
+    Dsub = opts_ptr->Dsub;
+    if (Dsub == 0) // The user wants us to determine Dsub
+        Dsub = SQRT(D * LOG2(D) * LOG2(D));
+    if (Dsub < D) {
+        ret_code = misc_downsample(D, q, &Dsub, &qsub, first_last_index);
+        CHECK_RETCODE(ret_code, leave_fun);
+        q_loc = qsub;
+    } else {
+        Dsub = D;
+    }
+    const REAL eps_t_sub = (first_last_index[1] - first_last_index[0])
+        * eps_t / (Dsub - 1);
+
+    // Compute the transfer matrix of the subsampled signal
+    degree1step = kdv_discretization_degree(discretization);
+    transfer_matrix = malloc(kdv_fscatter_numel(Dsub, discretization)
+        * sizeof(COMPLEX));
+    if (transfer_matrix == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+    // The roots of the polynomial below do not change if the transfer
+    // matrix is normalized, so W can be discarded
+    ret_code = kdv_fscatter(Dsub, q_loc, eps_t_sub, transfer_matrix, &deg,
+        opts_ptr->normalization_flag ? &W : NULL, discretization);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Allocate memory for the roots. The deg+2 coefficients of the
+    // polynomial are stored in the unused second half of the transfer matrix.
+    roots = malloc((deg + 1) * sizeof(COMPLEX));
+    if (roots == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+    p = transfer_matrix + 2*(deg + 1);
+
+    // Coefficients of the polynomial (in descending order)
+    c = 2.0*degree1step/eps_t_sub;
+    COMPLEX const * const H11 = transfer_matrix;
+    COMPLEX const * const H12 = transfer_matrix + (deg + 1);
+    for (i = 0; i <= deg + 1; i++) {
+        p[i] = 0.0;
+        if (i <= deg)
+            p[i] += c*H11[i] + H12[i];
+        if (i >= 1)
+            p[i] += -c*H11[i-1] + H12[i-1];
+    }
+
+    // Find the roots and transform them to the continuous-time domain
+    ret_code = poly_roots_fasteigen(deg + 1, p, roots);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = kdv_z_to_lambda(deg + 1, eps_t_sub, roots, discretization);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Keep roots close to the positive imaginary axis and project them
+    // onto it
+    K = 0;
+    for (i = 0; i <= deg; i++) {
+        if (CIMAG(roots[i]) > 0.0 && CIMAG(roots[i]) <= kappa_max
+            && FABS(CREAL(roots[i])) < CIMAG(roots[i]))
+            roots[K++] = I*CIMAG(roots[i]);
+    }
+    ret_code = misc_merge(&K, roots, SQRT(EPSILON));
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    *K_ptr = K;
+    *buffer_ptr = roots;
+    roots = NULL;
+
+leave_fun:
+    free(qsub);
+    free(transfer_matrix);
+    free(roots);
+    return ret_code;
+}
+
+// Auxiliary function: Refines the bound states using Newtons method. The
+// values of a(lam) and a'(lam) are computed for all bound states that have
+// not yet converged in one call to kdv_scatter_bound_states. Bound states
+// that leave the region 0<Im(lam)<=kappa_max are no longer updated.
+static INT refine_roots_newton(
+    const UINT D,
+    COMPLEX const * const q,
+    REAL const * const T,
+    const REAL kappa_max,
+    const UINT K,
+    COMPLEX * const bound_states,
+    const UINT niter)
+{
+    COMPLEX *lam = NULL, *a_vals, *aprime_vals, *b_vals;
+    UINT *active = NULL;
+    UINT i, j, n, iter, trunc_index;
+    COMPLEX error;
+    REAL eprecision = EPSILON * 100;
+    INT ret_code = SUCCESS;
+
+    // Check inputs
+    if (K == 0) // no bound states to refine
+        return SUCCESS;
+    if (niter == 0) // no refinement requested
+        return SUCCESS;
+    if (bound_states == NULL)
+        return E_INVALID_ARGUMENT(bound_states);
+
+    // Allocate memory
+    lam = malloc(4*K * sizeof(COMPLEX));
+    active = malloc(K * sizeof(UINT));
+    if (lam == NULL || active == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+    a_vals = lam + K;
+    aprime_vals = a_vals + K;
+    b_vals = aprime_vals + K;
+
+    n = 0;
+    for (i = 0; i < K; i++) {
+        if (CIMAG(bound_states[i]) > 0.0
+            && CIMAG(bound_states[i]) <= kappa_max)
+            active[n++] = i;
+    }
+
+    // Perform iterations of Newton's method
+    trunc_index = D;
+    for (iter = 0; iter < niter && n > 0; iter++) {
+
+        // Compute a(lam) and a'(lam) at the current roots
+        for (i = 0; i < n; i++)
+            lam[i] = bound_states[active[i]];
+        ret_code = kdv_scatter_bound_states(D, q, T, &trunc_index, n, lam,
+            a_vals, aprime_vals, b_vals, kdv_discretization_BO);
+        CHECK_RETCODE(ret_code, leave_fun);
+
+        // Perform Newton updates: lam[i] <- lam[i] - a(lam[i])/a'(lam[i])
+        for (i = 0, j = 0; i < n; i++) {
+            if (aprime_vals[i] == 0.0) {
+                ret_code = E_DIV_BY_ZERO;
+                goto leave_fun;
+            }
+            error = a_vals[i] / aprime_vals[i];
+            bound_states[active[i]] -= error;
+
+            if (CABS(error) <= eprecision
+                || !(CIMAG(bound_states[active[i]]) > 0.0)
+                || CIMAG(bound_states[active[i]]) > kappa_max)
+                continue;
+            active[j++] = active[i];
+        }
+        n = j;
+    }
+
+leave_fun:
+    free(lam);
+    free(active);
+    return ret_code;
+}
+
+// Auxiliary function: Removes roots that are not in the upper half-plane
+// close to the imaginary axis or whose imaginary part exceeds kappa_max, and
+// merges roots that are very close to each other.
+static INT filter_bound_states(
+    const REAL kappa_max,
+    UINT * const K_ptr,
+    COMPLEX * const bound_states)
+{
+    UINT i, K = 0;
+
+    for (i = 0; i < *K_ptr; i++) {
+        if (CIMAG(bound_states[i]) > 0.0
+            && CIMAG(bound_states[i]) <= kappa_max
+            && FABS(CREAL(bound_states[i])) < CIMAG(bound_states[i]))
+            bound_states[K++] = bound_states[i];
+    }
+    *K_ptr = K;
+    return misc_merge(K_ptr, bound_states, SQRT(EPSILON));
+}
+
+// Auxiliary function: Computes the norming constants and/or residues
+// using the BO scheme
+static INT compute_normconsts_or_residues(
+    const UINT D,
+    COMPLEX const * const q,
+    REAL const * const T,
+    const UINT K,
+    COMPLEX * const bound_states,
+    COMPLEX * const normconsts_or_residues,
+    fnft_kdvv_opts_t * const opts_ptr)
+{
+    COMPLEX *a_vals = NULL, *aprime_vals;
+    UINT trunc_index;
+    UINT i, offset = 0;
+    INT ret_code = SUCCESS;
+
+    // Allocate memory
+    a_vals = malloc(2*K * sizeof(COMPLEX));
+    if (a_vals == NULL)
+        return E_NOMEM;
+    aprime_vals = a_vals + K;
+
+    // trunc_index = D corresponds to splitting based on L1-norm
+    trunc_index = D;
+    ret_code = kdv_scatter_bound_states(D, q, T, &trunc_index, K,
+        bound_states, a_vals, aprime_vals, normconsts_or_residues,
+        kdv_discretization_BO);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Update to or add residues if requested
+    if (opts_ptr->discspec_type != kdvv_dstype_NORMING_CONSTANTS) {
+
+        if (opts_ptr->discspec_type == kdvv_dstype_RESIDUES) {
+            offset = 0;
+        } else if (opts_ptr->discspec_type == kdvv_dstype_BOTH) {
+            offset = K;
+            memcpy(normconsts_or_residues + offset,
+                normconsts_or_residues, offset*sizeof(COMPLEX));
+        } else {
+            ret_code = E_INVALID_ARGUMENT(opts_ptr->discspec_type);
+            goto leave_fun;
+        }
+
+        // Divide norming constants by derivatives to get residues
+        for (i = 0; i < K; i++) {
+            if (aprime_vals[i] == 0.0) {
+                ret_code = E_DIV_BY_ZERO;
+                goto leave_fun;
+            }
+            normconsts_or_residues[offset + i] /= aprime_vals[i];
+        }
+    }
+
+leave_fun:
+    free(a_vals);
+    return ret_code;
+}
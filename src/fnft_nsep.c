@@ -25,8 +25,11 @@
 #include "fnft_nsep.h"
 #include "fnft__nse_discretization.h"
 #include "fnft__poly_roots_fasteigen.h"
+#include "fnft__poly_roots_aberth.h"
 #include "fnft__poly_roots_fftgridsearch.h"
+#include "fnft__poly_eval.h"
 #include "fnft__nse_scatter.h"
+#include "fnft__akns_scatter.h"
 #include "fnft__nse_fscatter.h"
 #include <string.h> // for memcpy
 
@@ -39,7 +42,10 @@ static fnft_nsep_opts_t default_opts = {
     .bounding_box[2] = -FNFT_INF,
     .bounding_box[3] = FNFT_INF,
     .normalization_flag = 1,
-    .discretization = nse_discretization_2SPLIT2A
+    .discretization = nse_discretization_2SPLIT2A,
+    .root_finder = fnft_nsep_rootfind_FAST_EIGENVALUE,
+    .refinement = fnft_nsep_ref_BO,
+    .adaptive_gridsearch_flag = 0
 };
 
 static const UINT oversampling_factor = 32;
@@ -56,12 +62,16 @@ static inline INT refine_mainspec(
     const UINT D, COMPLEX const * const q,
     const REAL eps_t, const UINT K,
     COMPLEX * const mainspec, const UINT max_evals,
-    REAL rhs, INT kappa);
+    const UINT max_iter, REAL rhs, INT kappa,
+    const UINT deg, COMPLEX const * const p);
 static inline INT refine_auxspec(
     const UINT D, COMPLEX const * const q,
     const REAL eps_t, const UINT K,
     COMPLEX * const auxspec, const UINT max_evals,
     const INT kappa);
+static inline INT refine_auxspec_poly(const UINT deg,
+    COMPLEX const * const p, const UINT K, COMPLEX * const z,
+    const UINT max_evals);
 static inline INT subsample_and_refine(const UINT D,
     COMPLEX const * const q, 
     REAL const * const T, UINT * const K_ptr,
@@ -78,6 +88,8 @@ static inline INT gridsearch(const UINT D,
     INT warn_flags[2]);
 static inline void update_bounding_box_if_auto(const REAL eps_t,
     const REAL map_coeff, fnft_nsep_opts_t * const opts_ptr);
+static inline INT poly_roots(const UINT deg, COMPLEX const * const p,
+    COMPLEX * const roots, fnft_nsep_opts_t const * const opts_ptr);
 
 // Main routine.
 INT fnft_nsep(const UINT D, COMPLEX const * const q, 
@@ -193,7 +205,8 @@ static inline INT gridsearch(const UINT D,
     REAL PHI[2] = { 0.0, 2.0*PI };
 	UINT deg;
     INT W = 0, *W_ptr = NULL;
-    UINT K, K_filtered;
+    COMPLEX shifts[2];
+    UINT K, nroots[2];
     UINT M;
     UINT i;
     INT ret_code = SUCCESS;
@@ -238,7 +251,13 @@ static inline INT gridsearch(const UINT D,
         PHI[1] = tmp;
     }
 
-    roots = malloc(oversampling_factor*deg*sizeof(COMPLEX));
+    // The full gridsearch needs memory for one root per grid point. The
+    // adaptive gridsearch only needs memory for the detected roots, which
+    // are at most deg per polynomial.
+    if (opts_ptr->adaptive_gridsearch_flag)
+        roots = malloc(2*deg*sizeof(COMPLEX));
+    else
+        roots = malloc(oversampling_factor*deg*sizeof(COMPLEX));
     if (roots == NULL) {
         ret_code = E_NOMEM;
         goto release_mem;
@@ -250,25 +269,31 @@ static inline INT gridsearch(const UINT D,
         // The main spectrum is given by the z that solve Delta(z)=+/-2,
         // where Delta(z)=trace{monodromy matrix(z)}is the Floquet discriminant
 
-        // Allocate memory for the polynomial p(z) approx z^{D/2} Delta(z)+/-2
-        // and its roots
+        // Allocate memory for the polynomial p(z) approx z^{D/2} Delta(z)
         p = malloc((deg + 1)*sizeof(COMPLEX));
         if (p == NULL) {
             ret_code = E_NOMEM;
             goto release_mem;
         }
 
-        // First, determine p(z) for the positive sign (+)
+        // Determine p(z) without the constant +/-2. It is evaluated only
+        // once on the grid. The constants are added to the values during
+        // the search for the roots of p(z)+2 and p(z)-2.
         for (i=0; i<=deg; i++)
             p[i] = transfer_matrix[i] + CONJ(transfer_matrix[deg-i]);
-        p[deg/2] += 2.0 * POW(2.0, -W); // the pow arises because
-                                             // nse_fscatter rescales
+        shifts[0] = 2.0 * POW(2.0, -W); // the pow arises because
+        shifts[1] = -shifts[0];         // nse_fscatter rescales
 
-        // Find the roots of p(z)
+        // Find the roots of p(z)+2, followed by those of p(z)-2
         K = oversampling_factor*deg;
-        ret_code = poly_roots_fftgridsearch(deg, p, &K, PHI, roots);
+        if (opts_ptr->adaptive_gridsearch_flag)
+            ret_code = poly_roots_fftgridsearch_adaptive(deg, p, deg/2, 2,
+                shifts, &K, PHI, 2*deg, roots, nroots);
+        else
+            ret_code = poly_roots_fftgridsearch_shifts(deg, p, deg/2, 2,
+                shifts, &K, PHI, roots, nroots);
         CHECK_RETCODE(ret_code, release_mem);
-        if (K > deg) {
+        if (nroots[0] > deg || nroots[1] > deg) {
             ret_code = E_OTHER("Found more roots than memory is available.");
             goto release_mem;
         }
@@ -292,54 +317,19 @@ static inline INT gridsearch(const UINT D,
             K = *K_ptr;
         }
         memcpy(main_spec, roots, K * sizeof(COMPLEX));
-
-        // Second, determine p(z) for the negative sign (-)
-        p[deg/2] -= 4.0 * POW(2.0, -W);
-
-        // Find the roots of the new p(z)
-        K_filtered = oversampling_factor*deg;
-        ret_code = poly_roots_fftgridsearch(deg, p, &K_filtered, PHI,
-            roots);
-        CHECK_RETCODE(ret_code, release_mem);
-        if (K_filtered > deg) {
-            ret_code = E_OTHER("Found more roots than memory is available.");
-            goto release_mem;
-        }
-
-        // Coordinate transform of the new roots
-        ret_code = nse_z_to_lambda(K_filtered, eps_t, roots, opts_ptr->discretization);
-        CHECK_RETCODE(ret_code, release_mem);
-        
-        // Filter the new roots
-        if (opts_ptr->filtering != fnft_nsep_filt_NONE) {
-            ret_code = misc_filter(&K_filtered, roots, NULL,
-                opts_ptr->bounding_box);
-            CHECK_RETCODE(ret_code, release_mem);
-        }
-
-        // Copy to user-provided array
-        if (K + K_filtered > *K_ptr) {
-            if (warn_flags[0] == 0) {
-                WARN("Found more than *K_ptr main spectrum points. Returning as many as possible.");
-                warn_flags[0] = 1;
-            }
-            if (K < *K_ptr)
-                K_filtered = *K_ptr - K;
-            else
-                K_filtered = 0;
-        }
-        memcpy(main_spec + K, roots, K_filtered * sizeof(COMPLEX));
-
-        // Set number of points in the main spectrum
-        K += K_filtered;
     }
 
     // Compute auxiliary spectrum (real line only)
     if (aux_spec != NULL) {
 
         M = oversampling_factor*deg;
-        ret_code = poly_roots_fftgridsearch(deg, transfer_matrix+(deg+1), &M,
-            PHI, roots);
+        if (opts_ptr->adaptive_gridsearch_flag)
+            ret_code = poly_roots_fftgridsearch_adaptive(deg,
+                transfer_matrix+(deg+1), 0, 0, NULL, &M, PHI, 2*deg, roots,
+                NULL);
+        else
+            ret_code = poly_roots_fftgridsearch(deg, transfer_matrix+(deg+1),
+                &M, PHI, roots);
         CHECK_RETCODE(ret_code, release_mem);
 
         // Coordinate transform (from discrete-time to continuous-time domain)
@@ -375,6 +365,146 @@ release_mem:
     return ret_code;
 }
 
+// Auxiliary function: Runs one of the independent root finding jobs of
+// subsample_and_refine. Jobs 0 and 1 compute the main spectrum points that
+// solve Delta(z)=+2 and Delta(z)=-2, respectively, and job 2 computes the
+// aux spectrum. The roots are transformed, filtered, refined and filtered
+// again. The buffer buf has to provide space for 2*deg+1 elements, plus
+// deg_full+1 elements if the transfer matrix of the complete signal
+// transfer_matrix_full is used for the refinement. The remaining *K_ptr
+// roots are stored at buf+deg+1.
+static INT subsample_and_refine_job(const UINT job, const UINT D,
+    COMPLEX const * const q, const REAL eps_t, const REAL eps_t_sub,
+    const UINT deg, COMPLEX const * const transfer_matrix, const INT W,
+    const UINT deg_full, COMPLEX const * const transfer_matrix_full,
+    const INT W_full, COMPLEX * const buf, UINT * const K_ptr,
+    const INT kappa, fnft_nsep_opts_t const * const opts_ptr,
+    const INT skip_real_flag, const REAL tol_im)
+{
+    COMPLEX * const p = buf;
+    COMPLEX * const roots = buf + (deg + 1);
+    COMPLEX * p_full = NULL;
+    const REAL rhs = (job == 0) ? 2.0 : -2.0;
+    UINT i, K;
+    INT ret_code = SUCCESS;
+
+    if (job < 2) {
+
+        // The main spectrum is given by the z that solve Delta(z)=+/-2,
+        // where Delta(z)=trace{monodromy matrix(z)}is the Floquet
+        // discriminant. Determine p(z) approx z^{D/2} Delta(z)+/-2.
+        for (i=0; i<=deg; i++)
+            p[i] = transfer_matrix[i] + CONJ(transfer_matrix[deg-i]);
+        p[deg/2] += rhs * POW(2.0, -W); // the pow arises because
+                                        // nse_fscatter rescales
+
+        // Find the roots of p(z)
+        ret_code = poly_roots(deg, p, roots, opts_ptr);
+        CHECK_RETCODE(ret_code, leave_fun);
+
+    } else {
+
+        // The aux spectrum is given by the roots of b(z)
+        ret_code = poly_roots(deg, transfer_matrix + (deg + 1), roots,
+            opts_ptr);
+        CHECK_RETCODE(ret_code, leave_fun);
+    }
+
+    // Coordinate transform (from discrete-time to continuous-time domain)
+    ret_code = nse_z_to_lambda(deg, eps_t_sub, roots,
+        opts_ptr->discretization);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Filter the roots
+    K = deg;
+    if (opts_ptr->filtering != fnft_nsep_filt_NONE) {
+        ret_code = misc_filter(&K, roots, NULL, opts_ptr->bounding_box);
+        CHECK_RETCODE(ret_code, leave_fun);
+    }
+    if (skip_real_flag != 0 && job < 2) {
+        ret_code = misc_filter_nonreal(&K, roots, tol_im);
+        CHECK_RETCODE(ret_code, leave_fun);
+    }
+
+    // Refine the remaining roots
+    switch (opts_ptr->refinement) {
+
+    case fnft_nsep_ref_BO:
+
+        if (job < 2)
+            ret_code = refine_mainspec(D, q, eps_t, K, roots,
+                opts_ptr->max_evals, opts_ptr->max_evals, rhs, kappa, 0,
+                NULL);
+        else
+            ret_code = refine_auxspec(D, q, eps_t, K, roots,
+                opts_ptr->max_evals, kappa);
+        CHECK_RETCODE(ret_code, leave_fun);
+        break;
+
+    case fnft_nsep_ref_POLY:
+    case fnft_nsep_ref_POLY_AND_BO:
+
+        // Determine the polynomial whose roots approximate the spectrum
+        // using the transfer matrix of the complete signal
+        p_full = buf + (2*deg + 1);
+        if (job < 2) {
+            for (i=0; i<=deg_full; i++) {
+                p_full[i] = transfer_matrix_full[i]
+                    + CONJ(transfer_matrix_full[deg_full-i]);
+            }
+            p_full[deg_full/2] += rhs * POW(2.0, -W_full);
+        } else {
+            memcpy(p_full, transfer_matrix_full + (deg_full + 1),
+                (deg_full + 1) * sizeof(COMPLEX));
+        }
+
+        // Refine in the z-domain of the complete signal
+        ret_code = nse_lambda_to_z(K, eps_t, roots,
+            opts_ptr->discretization);
+        CHECK_RETCODE(ret_code, leave_fun);
+        if (job < 2)
+            ret_code = refine_mainspec(D, q, eps_t, K, roots,
+                opts_ptr->max_evals, opts_ptr->max_evals, rhs, kappa,
+                deg_full, p_full);
+        else
+            ret_code = refine_auxspec_poly(deg_full, p_full, K, roots,
+                opts_ptr->max_evals);
+        CHECK_RETCODE(ret_code, leave_fun);
+        ret_code = nse_z_to_lambda(K, eps_t, roots,
+            opts_ptr->discretization);
+        CHECK_RETCODE(ret_code, leave_fun);
+
+        // Polish using a single step of the BO scheme
+        if (opts_ptr->refinement == fnft_nsep_ref_POLY_AND_BO) {
+            if (job < 2)
+                ret_code = refine_mainspec(D, q, eps_t, K, roots,
+                    opts_ptr->max_evals, 1, rhs, kappa, 0, NULL);
+            else
+                ret_code = refine_auxspec(D, q, eps_t, K, roots, 1, kappa);
+            CHECK_RETCODE(ret_code, leave_fun);
+        }
+        break;
+
+    default:
+        return E_INVALID_ARGUMENT(opts_ptr->refinement);
+    }
+
+    // Filter the refined roots
+    if (opts_ptr->filtering != fnft_nsep_filt_NONE) {
+        ret_code = misc_filter(&K, roots, NULL, opts_ptr->bounding_box);
+        CHECK_RETCODE(ret_code, leave_fun);
+    }
+    if (skip_real_flag != 0) {
+        ret_code = misc_filter_nonreal(&K, roots, tol_im);
+        CHECK_RETCODE(ret_code, leave_fun);
+    }
+
+    *K_ptr = K;
+
+leave_fun:
+    return ret_code;
+}
+
 static inline INT subsample_and_refine(const UINT D,
     COMPLEX const * const q, 
     REAL const * const T, UINT * const K_ptr,
@@ -384,17 +514,19 @@ static inline INT subsample_and_refine(const UINT D,
     INT warn_flags[2])
 {
     COMPLEX * transfer_matrix = NULL;
+    COMPLEX * transfer_matrix_full = NULL;
     COMPLEX * p = NULL;
     COMPLEX * roots = NULL;
     COMPLEX * qsub = NULL;
     REAL degree1step, map_coeff;
     REAL tol_im;
-	UINT deg;
+	UINT deg, deg_full = 0, job_len;
     UINT Dsub;
-    INT W = 0, *W_ptr = NULL;
-    UINT K = 0, K_filtered = 0;
+    INT W = 0, W_full = 0, *W_ptr = NULL;
+    UINT K = 0, job_K[3];
     UINT M = 0;
-    UINT i;
+    UINT i, j;
+    INT job_ret[3];
     INT ret_code = SUCCESS;
 
     // To suppress unused parameter warnings.
@@ -443,162 +575,78 @@ static inline INT subsample_and_refine(const UINT D,
     tol_im = opts_ptr->bounding_box[1] - opts_ptr->bounding_box[0];
     tol_im /= oversampling_factor*(D - 1);
 
-    // Use unused part of transfer matrix as buffer for the roots
-    roots = transfer_matrix + 3*(deg+1);
- 
-    // Compute main spectrum if desired
-    if (main_spec != NULL) {
-
-        // The main spectrum is given by the z that solve Delta(z)=+/-2,
-        // where Delta(z)=trace{monodromy matrix(z)}is the Floquet discriminant
-
-        // Allocate memory for the polynomial p(z) approx z^{D/2} Delta(z)+/-2
-        p = malloc((deg + 1)*sizeof(COMPLEX));
-        if (p == NULL) {
+    // The polynomial refinement methods require the transfer matrix of the
+    // complete signal
+    if (opts_ptr->refinement == fnft_nsep_ref_POLY
+        || opts_ptr->refinement == fnft_nsep_ref_POLY_AND_BO) {
+        transfer_matrix_full = malloc(nse_fscatter_numel(D,
+            opts_ptr->discretization) * sizeof(COMPLEX));
+        if (transfer_matrix_full == NULL) {
             ret_code = E_NOMEM;
             goto release_mem;
         }
-
-        // First, determine p(z) for the positive sign (+)
-        for (i=0; i<=deg; i++)
-            p[i] = transfer_matrix[i] + CONJ(transfer_matrix[deg-i]);
-        p[deg/2] += 2.0 * POW(2.0, -W); // the pow arises because
-                                             // nse_fscatter rescales
-
-        // Find the roots of p(z)
-        ret_code = poly_roots_fasteigen(deg, p, roots);
-        CHECK_RETCODE(ret_code, release_mem);
-
-        // Coordinate transform (from discrete-time to continuous-time domain)
-        ret_code = nse_z_to_lambda(deg, eps_t_sub, roots, opts_ptr->discretization);
-        CHECK_RETCODE(ret_code, release_mem);
-        
-        // Filter the roots
-        K = deg;
-        if (opts_ptr->filtering != fnft_nsep_filt_NONE) {
-            ret_code = misc_filter(&K, roots, NULL, opts_ptr->bounding_box);
-            CHECK_RETCODE(ret_code, release_mem);
-        }
-        if (skip_real_flag != 0) {
-            ret_code = misc_filter_nonreal(&K, roots, tol_im);
-            CHECK_RETCODE(ret_code, release_mem);
-        }
-
-        // Refine the remaining roots
-        ret_code = refine_mainspec(D, q, eps_t, K, roots,
-            opts_ptr->max_evals, +2.0, kappa);
-        CHECK_RETCODE(ret_code, release_mem);
-
-        // Filter the refined roots
-        if (opts_ptr->filtering != fnft_nsep_filt_NONE) {
-            ret_code = misc_filter(&K, roots, NULL, opts_ptr->bounding_box);
-            CHECK_RETCODE(ret_code, release_mem);
-        }
-         if (skip_real_flag != 0) {
-            ret_code = misc_filter_nonreal(&K, roots, tol_im);
-            CHECK_RETCODE(ret_code, release_mem);
-        }
-
-        // Copy to user-provided array
-        if (K > *K_ptr) {
-            if (warn_flags[0] == 0) {
-                WARN("Found more than *K_ptr main spectrum points. Returning as many as possible.");
-                warn_flags[0] = 1;
-            }
-            K = *K_ptr;
-        }
-        memcpy(main_spec, roots, K * sizeof(COMPLEX));
-
-        // Second, determine p(z) for the negative sign (-)
-        p[deg/2] -= 4.0 * POW(2.0, -W);
-
-        // Find the roots of the new p(z)
-        ret_code = poly_roots_fasteigen(deg, p, roots);
+        ret_code = nse_fscatter(D, q, eps_t, kappa, transfer_matrix_full,
+            &deg_full, opts_ptr->normalization_flag ? &W_full : NULL,
+            opts_ptr->discretization);
         CHECK_RETCODE(ret_code, release_mem);
+    } else if (opts_ptr->refinement != fnft_nsep_ref_BO) {
+        ret_code = E_INVALID_ARGUMENT(opts_ptr->refinement);
+        goto release_mem;
+    }
 
-        // Coordinate transform of the new roots
-        ret_code = nse_z_to_lambda(deg, eps_t_sub, roots, opts_ptr->discretization);
-        CHECK_RETCODE(ret_code, release_mem);
-        
-        // Filter the new roots
-        K_filtered = deg;
-        if (opts_ptr->filtering != fnft_nsep_filt_NONE) {
-            ret_code = misc_filter(&K_filtered, roots, NULL,
-                opts_ptr->bounding_box);
-            CHECK_RETCODE(ret_code, release_mem);
-        }
-        if (skip_real_flag != 0) {
-            ret_code = misc_filter_nonreal(&K_filtered, roots, tol_im);
-            CHECK_RETCODE(ret_code, release_mem);
-        }
+    // Allocate memory for the three independent root finding jobs (main
+    // spectrum for +2 and -2, aux spectrum). Job j uses the polynomial
+    // p+j*job_len, stores the roots right after it and, if needed, the
+    // polynomial for the complete signal after the roots.
+    job_len = 2*deg + 1;
+    if (transfer_matrix_full != NULL)
+        job_len += deg_full + 1;
+    p = malloc(3*job_len*sizeof(COMPLEX));
+    if (p == NULL) {
+        ret_code = E_NOMEM;
+        goto release_mem;
+    }
+    for (j=0; j<3; j++) {
+        job_ret[j] = SUCCESS;
+        job_K[j] = 0;
+    }
 
-        // Refine the remaining new roots
-        ret_code = refine_mainspec(D, q, eps_t, K_filtered,
-            roots, opts_ptr->max_evals, -2.0, kappa);
- 
-        // Filter the refined new roots
-        if (opts_ptr->filtering != fnft_nsep_filt_NONE) {
-            ret_code = misc_filter(&K_filtered, roots, NULL,
-                opts_ptr->bounding_box);
-            CHECK_RETCODE(ret_code, release_mem);
-        }
-        if (skip_real_flag != 0) {
-            ret_code = misc_filter_nonreal(&K_filtered, roots, tol_im);
-            CHECK_RETCODE(ret_code, release_mem);
-        }
+    // Run the jobs. They are independent, so they can run in parallel. The
+    // results are collected in a fixed order below.
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for (j=0; j<3; j++) {
+        if ((j < 2 && main_spec == NULL) || (j == 2 && aux_spec == NULL))
+            continue;
+        job_ret[j] = subsample_and_refine_job(j, D, q, eps_t, eps_t_sub,
+            deg, transfer_matrix, W, deg_full, transfer_matrix_full, W_full,
+            p + j*job_len, &job_K[j], kappa, opts_ptr, skip_real_flag,
+            tol_im);
+    }
+    for (j=0; j<3; j++)
+        CHECK_RETCODE(job_ret[j], release_mem);
 
-        // Copy to user-provided array
-        if (K_filtered + K > *K_ptr) {
-            if (warn_flags[0] == 0) {
-                WARN("Found more than *K_ptr main spectrum points. Returning as many as possible.");
-                warn_flags[0] = 1;
+    // Copy the main spectrum to the user-provided array
+    if (main_spec != NULL) {
+        for (j=0; j<2; j++) {
+            roots = p + j*job_len + (deg + 1);
+            if (K + job_K[j] > *K_ptr) {
+                if (warn_flags[0] == 0) {
+                    WARN("Found more than *K_ptr main spectrum points. Returning as many as possible.");
+                    warn_flags[0] = 1;
+                }
+                job_K[j] = (K < *K_ptr) ? *K_ptr - K : 0;
             }
-            if (K < *K_ptr)
-                K_filtered = *K_ptr - K;
-            else
-                K_filtered = 0;
-        }
-        memcpy(main_spec + K, roots, K_filtered * sizeof(COMPLEX));
-
-        // Set number of points in the main spectrum
-        K += K_filtered;
-   }
-
-    // Compute aux spectrum if desired
-    if (aux_spec != NULL) {      
-        ret_code = poly_roots_fasteigen(deg, transfer_matrix + (deg + 1),
-            roots);
-        CHECK_RETCODE(ret_code, release_mem);
-
-        // Set number of points in the aux spectrum
-        M = deg;
-
-        // Coordinate transform (from discrete-time to continuous-time domain)
-        ret_code = nse_z_to_lambda(M, eps_t_sub, roots, opts_ptr->discretization);
-        CHECK_RETCODE(ret_code, release_mem);
-        
-        // Filter the roots
-        if (opts_ptr->filtering != fnft_nsep_filt_NONE) {
-            ret_code = misc_filter(&M, roots, NULL, opts_ptr->bounding_box);
-            CHECK_RETCODE(ret_code, release_mem);
-        }
-
-        // Refine the roots
-        ret_code = refine_auxspec(D, q, eps_t, M, roots,
-            opts_ptr->max_evals, kappa);
-        CHECK_RETCODE(ret_code, release_mem);
- 
-        // Filter the refined roots
-        if (opts_ptr->filtering != fnft_nsep_filt_NONE) {
-            ret_code = misc_filter(&M, roots, NULL, opts_ptr->bounding_box);
-            CHECK_RETCODE(ret_code, release_mem);
-        }
-        if (skip_real_flag != 0) {
-            ret_code = misc_filter_nonreal(&M, roots, tol_im);
-            CHECK_RETCODE(ret_code, release_mem);
+            memcpy(main_spec + K, roots, job_K[j] * sizeof(COMPLEX));
+            K += job_K[j];
         }
+    }
 
-        // Copy to user-provided array
+    // Copy the aux spectrum to the user-provided array
+    if (aux_spec != NULL) {
+        roots = p + 2*job_len + (deg + 1);
+        M = job_K[2];
         if (M > *M_ptr) {
             if (warn_flags[1] == 0) {
                 WARN("Found more than *M_ptr aux spectrum points. Returning as many as possible.");
@@ -615,127 +663,355 @@ static inline INT subsample_and_refine(const UINT D,
 
 release_mem:
     free(transfer_matrix);
+    free(transfer_matrix_full);
     free(p);
 	free(qsub);
 
     return ret_code;
 }
 
-// Uses Newton's method for roots of higher order to refine the main spectrum.
+// Auxiliary function: Estimates the multiplicity m of the root that
+// Newton's method approaches. The Newton correction u=f/f' has the
+// derivative u'=1-f*f''/f'^2, which is 1/m for f(lam)=c*(lam-lam0)^m. Since
+// u is linear in lam in this case, u' is approximated well by the
+// difference quotient of the corrections at the current and the previous
+// iterate even if the two are far apart. Returns zero if no estimate is
+// available.
+static inline UINT multiplicity_estimate(const COMPLEX incr,
+    const COMPLEX lam, const COMPLEX prev_incr, const COMPLEX prev_lam,
+    const UINT max_m)
+{
+    REAL m;
+
+    if (prev_lam != prev_lam || incr == prev_incr)
+        return 0;
+    m = CREAL((lam - prev_lam) / (incr - prev_incr));
+    if (!(m >= 0.5 && m < max_m + 0.5)) // also catches NaNs
+        return 0;
+    return (UINT)(m + 0.5);
+}
+
+// Auxiliary function: Evaluates f and f'=df/dlam for refine_mainspec at the
+// n points lam. If p is NULL, f=a(lam)+a~(lam)+rhs is computed using the BO
+// scheme, and the buffer M has to provide space for the 8*n entries of the
+// monodromy matrices. Otherwise, the points are in the z-domain and f is
+// the polynomial p(z).
+static inline INT mainspec_eval(const UINT D, COMPLEX const * const q,
+    COMPLEX const * const r, const REAL eps_t, const REAL rhs,
+    const UINT deg, COMPLEX const * const p, const UINT n,
+    COMPLEX const * const lam, COMPLEX * const f, COMPLEX * const f_prime,
+    COMPLEX * const M)
+{
+    UINT i;
+    INT ret_code = SUCCESS;
+
+    if (p != NULL) {
+        memcpy(f, lam, n * sizeof(COMPLEX));
+        ret_code = poly_evalderiv(deg, p, n, f, f_prime);
+        CHECK_RETCODE(ret_code, leave_fun);
+    } else {
+        ret_code = akns_scatter_matrix(D, q, r, eps_t, n, lam, M,
+            akns_discretization_BO);
+        CHECK_RETCODE(ret_code, leave_fun);
+        for (i=0; i<n; i++) {
+            f[i] = M[8*i] + M[8*i + 3] + rhs; // f = a(lam) + atil(lam) + rhs
+            f_prime[i] = 2.0*( M[8*i + 4] + M[8*i + 7] ); // f'=2*[a'+atil']
+        }
+    }
+
+leave_fun:
+    return ret_code;
+}
+
+// Uses Newton's method for roots of unknown multiplicity to refine the main
+// spectrum. The functions values at all candidate points of all main
+// spectrum estimates are computed in one call of mainspec_eval per stage.
+// At most max_iter iterations are carried out. If p is not NULL, the main
+// spectrum points have to be provided in the z-domain, and the roots of the
+// polynomial p(z) of degree deg are refined instead.
 static inline INT refine_mainspec(
     const UINT D, COMPLEX const * const q,
     const REAL eps_t, const UINT K,
     COMPLEX * const mainspec,
-    const UINT max_evals, const REAL rhs, const INT kappa)
+    const UINT max_evals, const UINT max_iter, const REAL rhs,
+    const INT kappa, const UINT deg, COMPLEX const * const p)
 {
-    UINT k;
-    COMPLEX M[8];
-    COMPLEX lam, f, f_prime, incr, tmp, next_f, next_f_prime;
-    REAL cur_abs, min_abs;
-    UINT nevals;
-    INT ret_code;
-    UINT m, best_m;
     const UINT max_m = 4; // led to the lowest number of function evals in
                             // an example
+    COMPLEX *r = NULL, *buf = NULL, *M, *lam, *cand_f, *cand_f_prime;
+    COMPLEX *f, *f_prime, *incr;
+    COMPLEX *next_f, *next_f_prime, *prev_lam, *prev_incr;
+    REAL *min_abs = NULL;
+    UINT *nevals = NULL, *active, *m_est, *best_m, *owner, *mult;
+    UINT i, k, m, n, stage, iter, nactive = 0;
+    REAL cur_abs;
+    INT ret_code = SUCCESS;
+
+    if (K == 0)
+        return SUCCESS;
+
+    // Allocate memory. The array r is only needed for the BO scheme. It is
+    // filled only once.
+    if (p == NULL) {
+        r = malloc(D * sizeof(COMPLEX));
+        if (r == NULL) {
+            ret_code = E_NOMEM;
+            goto release_mem;
+        }
+    }
+    buf = malloc(K*(11*max_m + 7) * sizeof(COMPLEX));
+    min_abs = malloc(K * sizeof(REAL));
+    nevals = malloc(K*(4 + 2*max_m) * sizeof(UINT));
+    if (buf == NULL || min_abs == NULL || nevals == NULL) {
+        ret_code = E_NOMEM;
+        goto release_mem;
+    }
+    M = buf;                    // 8*K*max_m monodromy matrices
+    lam = M + 8*K*max_m;        // K*max_m candidate points
+    cand_f = lam + K*max_m;     // K*max_m values of f at the candidates
+    cand_f_prime = cand_f + K*max_m;
+    f = cand_f_prime + K*max_m;
+    f_prime = f + K;
+    incr = f_prime + K;
+    next_f = incr + K;
+    next_f_prime = next_f + K;
+    prev_lam = next_f_prime + K;
+    prev_incr = prev_lam + K;
+    active = nevals + K;
+    m_est = active + K;
+    best_m = m_est + K;
+    owner = best_m + K;         // K*max_m owners of the candidate points
+    mult = owner + K*max_m;     // K*max_m multiples of the candidates
+
+    if (r != NULL) {
+        for (i = 0; i < D; i++)
+            r[i] = (kappa == 1) ? -CONJ(q[i]) : CONJ(q[i]);
+    }
 
-    for (k=0; k<K; k++) { // Iterate over the provided main spectrum estimates.
-
-        // Initilization. Computes the monodromy matrix at the current main
-        // spectrum estimate lam and determines the value of
-        // f=a(lam)+a~(lam)+rhs as well as of f' = df/dlam. (The main spectrum
-        // consists of the roots of f for rhs=+/- 2.0.)
-
-        ret_code = nse_scatter_matrix(D, q, eps_t, kappa, 1,
-            &mainspec[k], M, nse_discretization_BO);
-        if (ret_code != SUCCESS)
-            return E_SUBROUTINE(ret_code);
-        next_f = M[0] + M[3] + rhs; // f = a(lam) + atil(lam) + rhs
-        next_f_prime = 2.0*( M[4] + M[7] ); // f' = 2*[a'(lam) + atil'(lam)]
-
-        // Iteratively refine the current main spectrum poINT by applying
-        // Newton's method for higher order roots: next_x=x-m*f/f', where
-        // m is the order of the root. Since we do not know m, several values
-        // are tested in a line search-like procedure. Per iterion, max_m
-        // values of m are tested, leading to max_m monodromoy mat evaluations.
-        for (nevals=1; nevals<=max_evals; nevals+=max_m) {
-
-            // The current values of f and f' at lam = mainspec[k] 
-            f = next_f;
-            f_prime = next_f_prime;
-            if (f_prime == 0.0)
-                return E_DIV_BY_ZERO;
-            incr = f / f_prime;
-          
-            // Test different increments to deal with the many higher order
-            // roots (Newton's method for a root of order m is x<-x-m*f/f').
-            min_abs = INFINITY;
-            best_m = 1;
-            for (m=1; m<=max_m; m++) {
-                lam = mainspec[k] - m*incr;
-                ret_code = nse_scatter_matrix(D, q, eps_t, kappa, 1, &lam, M, nse_discretization_BO);
-                if (ret_code != SUCCESS)
-                    return E_SUBROUTINE(ret_code);
-                tmp = M[0] + M[3] + rhs;
-                cur_abs = CABS(tmp);
-                // keep this m if the new value of |f| would be lower than the
-                // ones for the previously tested values of m
-                if ( cur_abs < min_abs ) {
-                    min_abs = cur_abs;
-                    best_m = m;
-                    next_f = tmp;
-                    next_f_prime = 2.0*( M[4] + M[7] );
-                } 
+    // Initilization. Computes the monodromy matrices at the main spectrum
+    // estimates lam and determines the values of f=a(lam)+a~(lam)+rhs as well
+    // as of f' = df/dlam. (The main spectrum consists of the roots of f for
+    // rhs=+/- 2.0.)
+    ret_code = mainspec_eval(D, q, r, eps_t, rhs, deg, p, K, mainspec, f,
+        f_prime, M);
+    CHECK_RETCODE(ret_code, release_mem);
+    for (k=0; k<K; k++) {
+        prev_lam[k] = NAN;
+        prev_incr[k] = NAN;
+        nevals[k] = 1;
+        active[k] = nevals[k] <= max_evals;
+        nactive += active[k];
+    }
+
+    // Iteratively refine the main spectrum points by applying Newton's
+    // method for higher order roots: next_x=x-m*f/f', where m is the order
+    // of the root. The value of m is estimated from f*f''/f'^2 (see
+    // multiplicity_estimate) once two iterates are available. If there is no
+    // estimate or it does not decrease |f| sufficiently, the values
+    // m=1,...,max_m are tested in a line search-like procedure.
+    for (iter=0; iter<max_iter && nactive>0; iter++) {
+
+        for (k=0; k<K; k++) {
+            if (!active[k])
+                continue;
+            if (f_prime[k] == 0.0) {
+                ret_code = E_DIV_BY_ZERO;
+                goto release_mem;
             }
+            incr[k] = f[k] / f_prime[k];
+            m_est[k] = multiplicity_estimate(incr[k], mainspec[k],
+                prev_incr[k], prev_lam[k], max_m);
+            min_abs[k] = INFINITY;
+            best_m[k] = 1;
+        }
 
-            //printf("MAIN k=%zu, nevals=%zu: lam=%g+%gj, |f|=%g, |f_prime|=%g, |incr|=%g\n", k, nevals, CREAL(mainspec[k]), CIMAG(mainspec[k]), CABS(f), CABS(f_prime),CABS(incr));
-            if ( min_abs >= CABS(f) ) // stop if no improvement
-                break;
+        // Stage 0 tests the estimated multiples. Stage 1 tests all other
+        // multiples if the estimated one did not reduce |f| by at least an
+        // order of magnitude.
+        for (stage=0; stage<2; stage++) {
+
+            n = 0;
+            for (k=0; k<K; k++) {
+                if (!active[k])
+                    continue;
+                for (m=1; m<=max_m; m++) {
+                    if (stage == 0 && m_est[k] != 0 && m != m_est[k])
+                        continue;
+                    if (stage == 1 && (m_est[k] == 0 || m == m_est[k]
+                        || min_abs[k] < 0.1*CABS(f[k])))
+                        continue;
+                    lam[n] = mainspec[k] - m*incr[k];
+                    owner[n] = k;
+                    mult[n] = m;
+                    n++;
+                }
+            }
+            if (n == 0)
+                continue;
+
+            ret_code = mainspec_eval(D, q, r, eps_t, rhs, deg, p, n, lam,
+                cand_f, cand_f_prime, M);
+            CHECK_RETCODE(ret_code, release_mem);
+
+            // Keep the multiple for which the new value of |f| is lowest
+            for (i=0; i<n; i++) {
+                k = owner[i];
+                nevals[k]++;
+                cur_abs = CABS(cand_f[i]);
+                if ( cur_abs < min_abs[k] ) {
+                    min_abs[k] = cur_abs;
+                    best_m[k] = mult[i];
+                    next_f[k] = cand_f[i];
+                    next_f_prime[k] = cand_f_prime[i];
+                }
+            }
+        }
 
-            mainspec[k] -= best_m*incr;
-        };
-        //printf("==> used %zu evaluations\n", nevals);
+        // Update the estimates. An estimate is not refined further if there
+        // has been no improvement or the maximum number of evaluations has
+        // been reached.
+        nactive = 0;
+        for (k=0; k<K; k++) {
+            if (!active[k])
+                continue;
+            if ( min_abs[k] >= CABS(f[k]) ) { // stop if no improvement
+                active[k] = 0;
+                continue;
+            }
+            prev_lam[k] = mainspec[k];
+            prev_incr[k] = incr[k];
+            mainspec[k] -= best_m[k]*incr[k];
+            f[k] = next_f[k];
+            f_prime[k] = next_f_prime[k];
+            active[k] = nevals[k] <= max_evals;
+            nactive += active[k];
+        }
     }
-    return SUCCESS;
+
+release_mem:
+    free(r);
+    free(buf);
+    free(min_abs);
+    free(nevals);
+    return ret_code;
 }
 
-// Uses Newton's method to refine the aux spectrum.
+// Uses Newton's method to refine the aux spectrum. The points are refined
+// independently of each other, so the loop can be parallelized.
 static inline INT refine_auxspec(
     const UINT D, COMPLEX const * const q,
     const REAL eps_t, const UINT K,
     COMPLEX * const auxspec, const UINT max_evals,
     const INT kappa)
 {
-    UINT k, nevals;
-    COMPLEX M[8];
-    COMPLEX f, f_prime, prev_f;
-    INT ret_code;
+    UINT k;
+    INT ret_code = SUCCESS;
 
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
     for (k=0; k<K; k++) {
 
+        UINT nevals;
+        COMPLEX M[8];
+        COMPLEX f, f_prime, prev_f;
+        INT ret_code_k = SUCCESS;
+
         prev_f = NAN;
         for (nevals=0; nevals<max_evals; nevals++) {
 
-            ret_code = nse_scatter_matrix(D, q, eps_t, kappa, 1,
+            ret_code_k = nse_scatter_matrix(D, q, eps_t, kappa, 1,
                 &auxspec[k], M, nse_discretization_BO);
-            if (ret_code != SUCCESS)
-                return E_SUBROUTINE(ret_code);
-           
+            if (ret_code_k != SUCCESS) {
+                ret_code_k = E_SUBROUTINE(ret_code_k);
+                break;
+            }
+
             f = M[2]; // f = b(lam)
             f_prime = M[6]; // f' = b'(lam)
-            if (f_prime == 0.0)
-                return E_DIV_BY_ZERO;
+            if (f_prime == 0.0) {
+                ret_code_k = E_DIV_BY_ZERO;
+                break;
+            }
 
             if ( CABS(f) >= CABS(prev_f) ) // stop if no improvement
                 break;
 
-            // printf("AUX k=%zu, iter=%zu: lam=%g+%gj, |f|=%g, |f_prime|=%g\n", k, iter, CREAL(auxspec[k]), CIMAG(auxspec[k]), CABS(f), CABS(f_prime));
-
             auxspec[k] -= f / f_prime;
             prev_f = f;
-       }
+        }
+
+        if (ret_code_k != SUCCESS) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+            ret_code = ret_code_k;
+        }
+    }
+
+    return ret_code;
+}
+
+// Uses Newton's method to refine the aux spectrum in the z-domain, where
+// b(lam) is replaced by the polynomial p(z) of degree deg. All points that
+// have not yet converged are evaluated together in one call to
+// poly_evalderiv.
+static inline INT refine_auxspec_poly(const UINT deg,
+    COMPLEX const * const p, const UINT K, COMPLEX * const z,
+    const UINT max_evals)
+{
+    COMPLEX *vals = NULL, *derivs, *prev_f;
+    UINT *active = NULL;
+    UINT i, j, k, n, nevals;
+    INT ret_code = SUCCESS;
+
+    if (K == 0)
+        return SUCCESS;
+
+    // Allocate memory
+    vals = malloc(3*K * sizeof(COMPLEX));
+    active = malloc(K * sizeof(UINT));
+    if (vals == NULL || active == NULL) {
+        ret_code = E_NOMEM;
+        goto release_mem;
+    }
+    derivs = vals + K;
+    prev_f = derivs + K;
+    for (k=0; k<K; k++) {
+        active[k] = k;
+        prev_f[k] = NAN;
+    }
+    n = K;
+
+    for (nevals=0; nevals<max_evals && n>0; nevals++) {
+
+        // Evaluate f=p(z) and f'=p'(z) at all points that are still active
+        for (i=0; i<n; i++)
+            vals[i] = z[active[i]];
+        ret_code = poly_evalderiv(deg, p, n, vals, derivs);
+        CHECK_RETCODE(ret_code, release_mem);
+
+        // Newton updates. Points for which there has been no improvement
+        // are not refined further.
+        for (i=0, j=0; i<n; i++) {
+            k = active[i];
+            if (derivs[i] == 0.0) {
+                ret_code = E_DIV_BY_ZERO;
+                goto release_mem;
+            }
+            if ( CABS(vals[i]) >= CABS(prev_f[k]) ) // stop if no improvement
+                continue;
+            z[k] -= vals[i] / derivs[i];
+            prev_f[k] = vals[i];
+            active[j++] = k;
+        }
+        n = j;
     }
 
-    return SUCCESS;
+release_mem:
+    free(vals);
+    free(active);
+    return ret_code;
 }
 
 static inline void update_bounding_box_if_auto(const REAL eps_t,
@@ -767,3 +1043,18 @@ static inline void update_bounding_box_if_auto(const REAL eps_t,
     }
 }
 
+
+// Auxiliary function: Computes the roots of a polynomial using the root
+// finder specified in the options.
+static inline INT poly_roots(const UINT deg, COMPLEX const * const p,
+    COMPLEX * const roots, fnft_nsep_opts_t const * const opts_ptr)
+{
+    switch (opts_ptr->root_finder) {
+    case fnft_nsep_rootfind_FAST_EIGENVALUE:
+        return poly_roots_fasteigen(deg, p, roots);
+    case fnft_nsep_rootfind_ABERTH:
+        return poly_roots_aberth(deg, p, roots);
+    default:
+        return E_INVALID_ARGUMENT(opts_ptr->root_finder);
+    }
+}
@@ -0,0 +1,281 @@
+/*
+ * This file is part of FNFT.
+ *
+ * FNFT is free software; you can redistribute it and/or
+ * modify it under the terms of the version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * FNFT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contributors:
+ * Sander Wahls (TU Delft) 2017-2018.
+ * Shrinivas Chimmalgi (TU Delft) 2017-2018.
+ * Marius Brehler (TU Dortmund) 2018.
+ */
+
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <string.h> // for memcpy
+#include "fnft__errwarn.h"
+#include "fnft__poly_fmult.h"
+#include "fnft_nsev.h"
+#include "fnft__nse_fscatter.h"
+#include "fnft__nse_discretization.h"
+#include "fnft__sample_desc.h"
+#include "fnft__nsev.h"
+
+// Maximum number of partial transfer matrices on the stack of the
+// accumulator. Since the stack works like a binary counter, this limits the
+// number of chunks to 2^ACCUM_MAX_NODES-1.
+#define ACCUM_MAX_NODES 64
+
+/**
+ * State of the streaming accumulator. The partial transfer matrices on the
+ * stack are ordered from old (bottom) to new (top). A partial transfer
+ * matrix at level l is the product of 2^l chunks.
+ */
+struct fnft_nsev_accum_s {
+    UINT D;
+    UINT D_pushed;
+    REAL T[2];
+    INT kappa;
+    fnft_nsev_opts_t opts;
+    COMPLEX *q;
+    UINT n_nodes;
+    struct {
+        COMPLEX *tm;
+        UINT deg;
+        INT W;
+        UINT level;
+    } nodes[ACCUM_MAX_NODES];
+};
+
+/**
+ * Creates an accumulator for the streaming computation of fnft_nsev.
+ * See the header file for documentation.
+ */
+INT fnft_nsev_accum_init(
+    const UINT D,
+    REAL const * const T,
+    const INT kappa,
+    fnft_nsev_opts_t const * opts,
+    fnft_nsev_accum_t ** const accum_ptr)
+{
+    fnft_nsev_accum_t *accum = NULL;
+    fnft_nsev_opts_t default_opts;
+
+    // Check inputs
+    if (D < 2)
+        return E_INVALID_ARGUMENT(D);
+    if (T == NULL || T[0] >= T[1])
+        return E_INVALID_ARGUMENT(T);
+    if (abs(kappa) != 1)
+        return E_INVALID_ARGUMENT(kappa);
+    if (accum_ptr == NULL)
+        return E_INVALID_ARGUMENT(accum_ptr);
+    if (opts == NULL) {
+        default_opts = fnft_nsev_default_opts();
+        opts = &default_opts;
+    }
+    if (nse_discretization_degree(opts->discretization) == 0)
+        return E_INVALID_ARGUMENT(opts->discretization);
+
+    // Allocate memory
+    accum = malloc(sizeof(fnft_nsev_accum_t));
+    if (accum == NULL)
+        return E_NOMEM;
+    accum->q = malloc(D * sizeof(COMPLEX));
+    if (accum->q == NULL) {
+        free(accum);
+        return E_NOMEM;
+    }
+
+    accum->D = D;
+    accum->D_pushed = 0;
+    accum->T[0] = T[0];
+    accum->T[1] = T[1];
+    accum->kappa = kappa;
+    accum->opts = *opts;
+    accum->n_nodes = 0;
+    *accum_ptr = accum;
+    return SUCCESS;
+}
+
+// Auxiliary function: Replaces the two partial transfer matrices on top of
+// the stack with their product.
+static INT accum_merge(fnft_nsev_accum_t * const accum)
+{
+    COMPLEX *tm = NULL;
+    INT W = 0;
+    INT ret_code = SUCCESS;
+
+    // The newer partial transfer matrix b is multiplied from the left
+    const UINT n = accum->n_nodes;
+    const UINT deg_a = accum->nodes[n-2].deg;
+    const UINT deg_b = accum->nodes[n-1].deg;
+
+    tm = malloc(4*(deg_a + deg_b + 1) * sizeof(COMPLEX));
+    if (tm == NULL)
+        return E_NOMEM;
+    ret_code = poly_fmult2x2_pair(deg_b, accum->nodes[n-1].tm, deg_a,
+        accum->nodes[n-2].tm, tm,
+        accum->opts.normalization_flag ? &W : NULL);
+    if (ret_code != SUCCESS) {
+        free(tm);
+        return E_SUBROUTINE(ret_code);
+    }
+
+    free(accum->nodes[n-2].tm);
+    free(accum->nodes[n-1].tm);
+    accum->nodes[n-2].tm = tm;
+    accum->nodes[n-2].deg = deg_a + deg_b;
+    accum->nodes[n-2].W += accum->nodes[n-1].W + W;
+    accum->nodes[n-2].level++;
+    accum->n_nodes--;
+    return SUCCESS;
+}
+
+/**
+ * Adds a chunk of samples to the accumulator.
+ * See the header file for documentation.
+ */
+INT fnft_nsev_accum_push(
+    fnft_nsev_accum_t * const accum,
+    const UINT D_chunk,
+    COMPLEX const * const q_chunk)
+{
+    COMPLEX *tm = NULL;
+    UINT i, deg;
+    INT W = 0;
+    INT ret_code = SUCCESS;
+
+    // Check inputs
+    if (accum == NULL)
+        return E_INVALID_ARGUMENT(accum);
+    if (D_chunk == 0 || D_chunk > accum->D - accum->D_pushed)
+        return E_INVALID_ARGUMENT(D_chunk);
+    if (q_chunk == NULL)
+        return E_INVALID_ARGUMENT(q_chunk);
+    if (accum->n_nodes >= ACCUM_MAX_NODES)
+        return E_OTHER("Too many chunks.");
+
+    // The samples are kept since the discrete spectrum is refined using
+    // the full signal
+    COMPLEX * const q = accum->q + accum->D_pushed;
+    memcpy(q, q_chunk, D_chunk * sizeof(COMPLEX));
+
+    // Transfer matrix of the chunk
+    i = nse_fscatter_numel(D_chunk, accum->opts.discretization);
+    tm = malloc(i * sizeof(COMPLEX));
+    if (tm == NULL)
+        return E_NOMEM;
+    const REAL eps_t = (accum->T[1] - accum->T[0])/(accum->D - 1);
+    ret_code = nse_fscatter(D_chunk, q, eps_t, accum->kappa, tm, &deg,
+        accum->opts.normalization_flag ? &W : NULL,
+        accum->opts.discretization);
+    CHECK_RETCODE(ret_code, release_mem);
+
+    // Push it on the stack and merge partial transfer matrices of the same
+    // level, like the carries of a binary counter
+    accum->nodes[accum->n_nodes].tm = tm;
+    accum->nodes[accum->n_nodes].deg = deg;
+    accum->nodes[accum->n_nodes].W = W;
+    accum->nodes[accum->n_nodes].level = 0;
+    accum->n_nodes++;
+    accum->D_pushed += D_chunk;
+    tm = NULL;
+    while (accum->n_nodes >= 2 && accum->nodes[accum->n_nodes-1].level
+        == accum->nodes[accum->n_nodes-2].level) {
+        ret_code = accum_merge(accum);
+        CHECK_RETCODE(ret_code, release_mem);
+    }
+
+release_mem:
+    free(tm);
+    return ret_code;
+}
+
+/**
+ * Computes the nonlinear Fourier spectrum of the samples that have been
+ * pushed into the accumulator.
+ * See the header file for documentation.
+ */
+INT fnft_nsev_accum_finalize(
+    fnft_nsev_accum_t * const accum,
+    const UINT M,
+    COMPLEX * const contspec,
+    REAL const * const XI,
+    UINT * const K_ptr,
+    COMPLEX * const bound_states,
+    COMPLEX * const normconsts_or_residues)
+{
+    COMPLEX *transfer_matrix = NULL;
+    sample_desc_t q_desc;
+    UINT i;
+    INT ret_code = SUCCESS;
+
+    // Check inputs
+    if (accum == NULL)
+        return E_INVALID_ARGUMENT(accum);
+    if (accum->D_pushed != accum->D)
+        return E_OTHER("Not all samples have been pushed.");
+    if (contspec != NULL) {
+        if (XI == NULL || XI[0] >= XI[1])
+            return E_INVALID_ARGUMENT(XI);
+    }
+    if (bound_states != NULL) {
+        if (K_ptr == NULL)
+            return E_INVALID_ARGUMENT(K_ptr);
+    }
+
+    // Multiply the remaining partial transfer matrices
+    while (accum->n_nodes >= 2) {
+        ret_code = accum_merge(accum);
+        CHECK_RETCODE(ret_code, release_mem);
+    }
+    const UINT deg = accum->nodes[0].deg;
+
+    // The auxiliary routines use parts of the transfer matrix as buffers
+    // (see fnft_nsev_desc), so it is copied into an array of the usual size
+    i = nse_fscatter_numel(accum->D, accum->opts.discretization);
+    transfer_matrix = malloc(i * sizeof(COMPLEX));
+    if (transfer_matrix == NULL) {
+        ret_code = E_NOMEM;
+        goto release_mem;
+    }
+    memcpy(transfer_matrix, accum->nodes[0].tm,
+        4*(deg + 1) * sizeof(COMPLEX));
+
+    // Compute the nonlinear Fourier spectrum from the transfer matrix
+    q_desc = sample_desc_complex(accum->q);
+    ret_code = nsev_tf2nfs(accum->D, &q_desc, accum->T, deg,
+        accum->nodes[0].W, transfer_matrix, M, contspec, XI, K_ptr,
+        bound_states, normconsts_or_residues, accum->kappa, &accum->opts);
+    CHECK_RETCODE(ret_code, release_mem);
+
+release_mem:
+    free(transfer_matrix);
+    return ret_code;
+}
+
+/**
+ * Frees the memory used by an accumulator.
+ * See the header file for documentation.
+ */
+void fnft_nsev_accum_free(fnft_nsev_accum_t * const accum)
+{
+    UINT i;
+
+    if (accum == NULL)
+        return;
+    for (i=0; i<accum->n_nodes; i++)
+        free(accum->nodes[i].tm);
+    free(accum->q);
+    free(accum);
+}
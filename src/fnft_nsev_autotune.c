@@ -0,0 +1,352 @@
+/*
+ * This file is part of FNFT.
+ *
+ * FNFT is free software; you can redistribute it and/or
+ * modify it under the terms of the version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * FNFT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contributors:
+ * Sander Wahls (TU Delft) 2017-2018.
+ * Shrinivas Chimmalgi (TU Delft) 2017-2018.
+ * Marius Brehler (TU Dortmund) 2018.
+ */
+
+#define FNFT_ENABLE_SHORT_NAMES
+#define _POSIX_C_SOURCE 199309L // for clock_gettime
+
+#include <time.h> // for clock_gettime
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "fnft__errwarn.h"
+#include "fnft_nsev.h"
+#include "fnft__nse_discretization.h"
+#include "fnft__misc.h"
+
+// Candidates of fnft_nsev_autotune in the order of increasing degree
+static const nse_discretization_t autotune_candidates[] = {
+    nse_discretization_2SPLIT2_MODAL,
+    nse_discretization_2SPLIT1A,
+    nse_discretization_2SPLIT1B,
+    nse_discretization_2SPLIT2A,
+    nse_discretization_2SPLIT2B,
+    nse_discretization_2SPLIT2S,
+    nse_discretization_2SPLIT3S,
+    nse_discretization_2SPLIT4B,
+    nse_discretization_2SPLIT3A,
+    nse_discretization_2SPLIT3B,
+    nse_discretization_2SPLIT4A,
+    nse_discretization_2SPLIT6B,
+    nse_discretization_2SPLIT6A,
+    nse_discretization_2SPLIT8B,
+    nse_discretization_2SPLIT5A,
+    nse_discretization_2SPLIT5B,
+    nse_discretization_2SPLIT8A,
+    nse_discretization_2SPLIT7A,
+    nse_discretization_2SPLIT7B
+};
+#define AUTOTUNE_NCANDIDATES \
+    (sizeof(autotune_candidates)/sizeof(autotune_candidates[0]))
+
+// Minimum number of samples and maximum number of decimation levels that
+// are used for the error estimates
+#define AUTOTUNE_MIN_SAMPLES 64
+#define AUTOTUNE_MAX_LEVELS 8
+
+// Auxiliary function: Returns the time in seconds of a monotonic wall clock.
+// The CPU time is used if no such clock is available.
+static inline REAL autotune_wtime()
+{
+#if defined(_OPENMP)
+    return omp_get_wtime();
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (REAL)ts.tv_sec + 1e-9*(REAL)ts.tv_nsec;
+#else
+    return (REAL)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+// Auxiliary function: Index of the tolerance bucket [2^k, 2^(k+1)) that
+// contains err_tol. The decisions are made for the lower end of the bucket,
+// so that they are valid for all tolerances in it.
+static inline INT autotune_tol_bucket(const REAL err_tol)
+{
+    return (INT)FLOOR(LOG2(err_tol));
+}
+
+/**
+ * Decisions of fnft_nsev_autotune for different signal classes and error
+ * tolerances. See the header file for documentation.
+ */
+struct fnft_nsev_autotune_cache_s {
+    UINT len;
+    UINT capacity;
+    UINT * signal_classes;
+    INT * tol_buckets;
+    nse_discretization_t * discretizations;
+    UINT * Ds;
+};
+
+/**
+ * Creates a cache for fnft_nsev_autotune. See the header file for
+ * documentation.
+ */
+INT fnft_nsev_autotune_cache_init(fnft_nsev_autotune_cache_t ** const
+    cache_ptr)
+{
+    fnft_nsev_autotune_cache_t *cache;
+
+    if (cache_ptr == NULL)
+        return E_INVALID_ARGUMENT(cache_ptr);
+
+    cache = malloc(sizeof(fnft_nsev_autotune_cache_t));
+    if (cache == NULL)
+        return E_NOMEM;
+    cache->len = 0;
+    cache->capacity = 0;
+    cache->signal_classes = NULL;
+    cache->tol_buckets = NULL;
+    cache->discretizations = NULL;
+    cache->Ds = NULL;
+
+    *cache_ptr = cache;
+    return SUCCESS;
+}
+
+// Auxiliary function: Appends a decision to the cache.
+static INT autotune_cache_add(fnft_nsev_autotune_cache_t * const cache,
+    const UINT signal_class, const INT tol_bucket,
+    const nse_discretization_t discretization, const UINT D)
+{
+    UINT capacity;
+    void *ptr;
+
+    if (cache->len == cache->capacity) {
+        capacity = (cache->capacity == 0) ? 8 : 2*cache->capacity;
+        ptr = realloc(cache->signal_classes, capacity * sizeof(UINT));
+        if (ptr == NULL)
+            return E_NOMEM;
+        cache->signal_classes = ptr;
+        ptr = realloc(cache->tol_buckets, capacity * sizeof(INT));
+        if (ptr == NULL)
+            return E_NOMEM;
+        cache->tol_buckets = ptr;
+        ptr = realloc(cache->discretizations,
+            capacity * sizeof(nse_discretization_t));
+        if (ptr == NULL)
+            return E_NOMEM;
+        cache->discretizations = ptr;
+        ptr = realloc(cache->Ds, capacity * sizeof(UINT));
+        if (ptr == NULL)
+            return E_NOMEM;
+        cache->Ds = ptr;
+        cache->capacity = capacity;
+    }
+
+    cache->signal_classes[cache->len] = signal_class;
+    cache->tol_buckets[cache->len] = tol_bucket;
+    cache->discretizations[cache->len] = discretization;
+    cache->Ds[cache->len] = D;
+    cache->len++;
+    return SUCCESS;
+}
+
+/**
+ * Selects a discretization and a number of samples for fnft_nsev. See the
+ * header file for documentation.
+ */
+INT fnft_nsev_autotune(
+    const UINT D,
+    COMPLEX * const q,
+    REAL const * const T,
+    const UINT M,
+    REAL const * const XI,
+    const INT kappa,
+    const REAL err_tol,
+    const REAL time_budget,
+    fnft_nsev_autotune_cache_t * const cache,
+    const UINT signal_class,
+    fnft_nsev_opts_t * const opts,
+    UINT * const D_ptr)
+{
+    COMPLEX *qsub = NULL, *buf = NULL, *contspec, *contspec_prev, *tmp;
+    fnft_nsev_opts_t opts_c;
+    UINT c, i, l, L, Dl, stride, order, D_pred, D_best = 0;
+    REAL Tl[2], t, t_pred, t_best = INFINITY, err, D_real, elapsed = 0;
+    REAL q_max = 0, start, tol;
+    INT prev_flag, tol_bucket, found_flag = 0;
+    nse_discretization_t disc_best = 0;
+    INT ret_code = SUCCESS;
+
+    // Check inputs
+    if (q == NULL)
+        return E_INVALID_ARGUMENT(q);
+    if (T == NULL || T[0] >= T[1])
+        return E_INVALID_ARGUMENT(T);
+    if (M == 0)
+        return E_INVALID_ARGUMENT(M);
+    if (XI == NULL || XI[0] >= XI[1])
+        return E_INVALID_ARGUMENT(XI);
+    if (abs(kappa) != 1)
+        return E_INVALID_ARGUMENT(kappa);
+    if (!(err_tol > 0))
+        return E_INVALID_ARGUMENT(err_tol);
+    if (opts == NULL)
+        return E_INVALID_ARGUMENT(opts);
+    if (D_ptr == NULL)
+        return E_INVALID_ARGUMENT(D_ptr);
+
+    // Look up a previous decision
+    tol_bucket = autotune_tol_bucket(err_tol);
+    tol = POW(2.0, tol_bucket);
+    if (cache != NULL) {
+        for (i = 0; i < cache->len; i++) {
+            if (cache->signal_classes[i] == signal_class
+                && cache->tol_buckets[i] == tol_bucket) {
+                opts->discretization = cache->discretizations[i];
+                *D_ptr = cache->Ds[i];
+                return SUCCESS;
+            }
+        }
+    }
+
+    // Number of decimation levels. Level l keeps every 2^l-th sample.
+    for (L = 0; L < AUTOTUNE_MAX_LEVELS
+        && (D - 1)/((UINT)1 << (L + 1)) + 1 >= AUTOTUNE_MIN_SAMPLES; L++);
+    if (L == 0)
+        return E_INVALID_ARGUMENT(D);
+    const REAL eps_t = (T[1] - T[0])/(D - 1);
+
+    qsub = malloc(((D - 1)/2 + 1) * sizeof(COMPLEX));
+    buf = malloc(2*M * sizeof(COMPLEX));
+    if (qsub == NULL || buf == NULL) {
+        ret_code = E_NOMEM;
+        goto release_mem;
+    }
+
+    // The modified Ablowitz-Ladik discretization requires eps_t*|q[i]|<1
+    // (at least in the defocusing case)
+    for (i = 0; i < D; i++) {
+        if (CABS(q[i]) > q_max)
+            q_max = CABS(q[i]);
+    }
+
+    // Only the reflection coefficient is needed for the error estimates
+    opts_c = *opts;
+    opts_c.contspec_type = nsev_cstype_REFLECTION_COEFFICIENT;
+    opts_c.richardson_extrapolation_flag = 0;
+
+    for (c = 0; c < AUTOTUNE_NCANDIDATES; c++) {
+        opts_c.discretization = autotune_candidates[c];
+        order = nse_discretization_order(opts_c.discretization);
+        contspec = buf;
+        contspec_prev = buf + M;
+        prev_flag = 0;
+
+        // Compute the reflection coefficient from coarse to fine. The
+        // difference between two consecutive levels is (2^order-1) times
+        // the error of the finer one since the error of a discretization of
+        // order p behaves like C*eps_t^p.
+        for (l = L + 1; l-- > 0; ) {
+            stride = (UINT)1 << l;
+            Dl = (D - 1)/stride + 1;
+            if (opts_c.discretization == nse_discretization_2SPLIT2_MODAL
+                && stride*eps_t*q_max >= 1)
+                continue;
+            if (l > 0) {
+                for (i = 0; i < Dl; i++)
+                    qsub[i] = q[i*stride];
+            }
+            Tl[0] = T[0];
+            Tl[1] = T[0] + (Dl - 1)*stride*eps_t;
+
+            start = autotune_wtime();
+            ret_code = fnft_nsev(Dl, (l > 0) ? qsub : q, Tl, M, contspec, XI,
+                NULL, NULL, NULL, kappa, &opts_c);
+            CHECK_RETCODE(ret_code, release_mem);
+            t = autotune_wtime() - start;
+            elapsed += t;
+
+            if (prev_flag) {
+                err = misc_rel_err(M, contspec, contspec_prev)
+                    / (POW(2.0, order) - 1);
+
+                // Predict the number of samples for which the estimated
+                // error meets the tolerance and the corresponding run time,
+                // assuming that it grows like D*log2(D)^2
+                D_real = Dl * POW(err/tol, 1.0/order);
+                if (D_real < (Dl + 1)/2)
+                    D_real = (Dl + 1)/2;
+                D_pred = (UINT)CEIL(D_real);
+                t_pred = t * ((REAL)D_pred / Dl)
+                    * POW(LOG2(D_pred) / LOG2(Dl), 2);
+
+                // Stop refining if the tolerance is met or if this
+                // candidate cannot be cheaper than the best one so far.
+                // Only candidates whose estimated error meets the
+                // tolerance are accepted. The time budget does not apply
+                // to the first candidate.
+                if (err <= tol && t_pred < t_best) {
+                    t_best = t_pred;
+                    D_best = D_pred;
+                    disc_best = opts_c.discretization;
+                    found_flag = 1;
+                }
+                if (err <= tol || t_pred >= t_best || l == 0
+                    || (c > 0 && elapsed > time_budget))
+                    break;
+            }
+
+            tmp = contspec_prev;
+            contspec_prev = contspec;
+            contspec = tmp;
+            prev_flag = 1;
+        }
+
+        if (elapsed > time_budget)
+            break;
+    }
+
+    if (!found_flag) {
+        ret_code = E_OTHER("No discretization meets the error tolerance.");
+        goto release_mem;
+    }
+    opts->discretization = disc_best;
+    *D_ptr = D_best;
+
+    if (cache != NULL) {
+        ret_code = autotune_cache_add(cache, signal_class, tol_bucket,
+            disc_best, D_best);
+        CHECK_RETCODE(ret_code, release_mem);
+    }
+
+release_mem:
+    free(qsub);
+    free(buf);
+    return ret_code;
+}
+
+/**
+ * Releases a cache for fnft_nsev_autotune. See the header file for
+ * documentation.
+ */
+void fnft_nsev_autotune_cache_free(fnft_nsev_autotune_cache_t * const cache)
+{
+    if (cache == NULL)
+        return;
+    free(cache->signal_classes);
+    free(cache->tol_buckets);
+    free(cache->discretizations);
+    free(cache->Ds);
+    free(cache);
+}
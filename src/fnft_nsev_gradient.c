@@ -0,0 +1,404 @@
+/*
+ * This file is part of FNFT.
+ *
+ * FNFT is free software; you can redistribute it and/or
+ * modify it under the terms of the version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * FNFT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contributors:
+ * Sander Wahls (TU Delft) 2017-2018.
+ * Shrinivas Chimmalgi (TU Delft) 2017-2018.
+ * Marius Brehler (TU Dortmund) 2018.
+ */
+
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <string.h> // for memcpy
+#include "fnft__errwarn.h"
+#include "fnft__poly_chirpz.h"
+#include "fnft__poly_fmult.h"
+#include "fnft_nsev.h"
+#include "fnft__akns_fscatter.h"
+#include "fnft__nse_discretization.h"
+#include "fnft__akns_discretization.h"
+#include "fnft__nsev.h"
+
+// Number of points on the circle that is used to differentiate the
+// transfer matrices of the samples in fnft_nsev_gradient. Each sample
+// requires 2*GRADIENT_NCONTOUR single-sample transfer matrices.
+#define GRADIENT_NCONTOUR 16
+
+// Auxiliary function: Adds the derivatives of a real-valued function L of
+// the continuous spectrum w.r.t. the conjugated coefficients of the
+// transfer matrix to tm_bar, given contspec_bar = dL/d(conj(contspec)).
+// This is the adjoint of tf2contspec. The adjoint of the chirp transform
+// is again a chirp transform since all z are on the unit circle.
+static INT contspec_adjoint(
+    const UINT deg,
+    const INT W,
+    COMPLEX const * const transfer_matrix,
+    REAL const * const T,
+    const UINT D,
+    REAL const * const XI,
+    const UINT M,
+    COMPLEX const * const contspec_bar,
+    COMPLEX * const tm_bar,
+    fnft_nsev_opts_t * const opts)
+{
+    COMPLEX *H11_vals = NULL, *H21_vals, *H11_bar, *H21_bar, *buf;
+    COMPLEX A, V, z0, rho, e;
+    REAL xi, scale, phase_factor_rho, phase_factor_a, phase_factor_b;
+    UINT i, j, offset = 0;
+    INT ret_code = SUCCESS;
+
+    const REAL eps_t = (T[1] - T[0])/(D - 1);
+    const REAL eps_xi = (XI[1] - XI[0])/(M - 1);
+
+    H11_vals = malloc((4*M + deg + 1) * sizeof(COMPLEX));
+    if (H11_vals == NULL)
+        return E_NOMEM;
+    H21_vals = H11_vals + M;
+    H11_bar = H21_vals + M;
+    H21_bar = H11_bar + M;
+    buf = H21_bar + M;
+
+    // Values of the transfer matrix as in tf2contspec. The z at which the
+    // transfer matrix is evaluated are z(i) = z0*V^i.
+    V = eps_xi;
+    ret_code = nse_lambda_to_z(1, eps_t, &V, opts->discretization);
+    CHECK_RETCODE(ret_code, release_mem);
+    A = -XI[0];
+    ret_code = nse_lambda_to_z(1, eps_t, &A, opts->discretization);
+    CHECK_RETCODE(ret_code, release_mem);
+    z0 = 1.0/A;
+    ret_code = poly_chirpz(deg, transfer_matrix, A, V, M, H11_vals);
+    CHECK_RETCODE(ret_code, release_mem);
+    ret_code = poly_chirpz(deg, transfer_matrix+2*(deg+1), A, V, M,
+        H21_vals);
+    CHECK_RETCODE(ret_code, release_mem);
+
+    // Derivatives w.r.t. the conjugated values of the transfer matrix
+    for (i=0; i<M; i++) {
+        H11_bar[i] = 0.0;
+        H21_bar[i] = 0.0;
+    }
+    switch (opts->contspec_type) {
+
+    case nsev_cstype_BOTH:
+
+        offset = M;
+        // fall through
+
+    case nsev_cstype_REFLECTION_COEFFICIENT:
+
+        ret_code = nse_phase_factor_rho(eps_t, T[1], &phase_factor_rho,
+            opts->discretization);
+        CHECK_RETCODE(ret_code, release_mem);
+        for (i=0; i<M; i++) {
+            if (H11_vals[i] == 0.0) {
+                ret_code = E_DIV_BY_ZERO;
+                goto release_mem;
+            }
+            xi = XI[0] + i*eps_xi;
+            e = CEXP(I*xi*phase_factor_rho);
+            rho = H21_vals[i] * e / H11_vals[i];
+            H21_bar[i] += CONJ(e / H11_vals[i]) * contspec_bar[i];
+            H11_bar[i] -= CONJ(rho / H11_vals[i]) * contspec_bar[i];
+        }
+        if (opts->contspec_type == nsev_cstype_REFLECTION_COEFFICIENT)
+            break;
+        // fall through
+
+    case nsev_cstype_AB:
+
+        scale = POW(2.0, W);
+        ret_code = nse_phase_factor_a(eps_t, D, T, &phase_factor_a,
+            opts->discretization);
+        CHECK_RETCODE(ret_code, release_mem);
+        ret_code = nse_phase_factor_b(eps_t, D, T, &phase_factor_b,
+            opts->discretization);
+        CHECK_RETCODE(ret_code, release_mem);
+        for (i=0; i<M; i++) {
+            xi = XI[0] + i*eps_xi;
+            H11_bar[i] += scale * CEXP(-I*xi*phase_factor_a)
+                * contspec_bar[offset + i];
+            H21_bar[i] += scale * CEXP(-I*xi*phase_factor_b)
+                * contspec_bar[offset + M + i];
+        }
+        break;
+
+    default:
+
+        ret_code = E_INVALID_ARGUMENT(opts->contspec_type);
+        goto release_mem;
+    }
+
+    // Adjoint of the chirp transform: The coefficient of z^j receives
+    // sum_i H_bar[i]*conj(z(i))^j = conj(z0)^j * P(conj(V)^j), where
+    // P(x) = sum_i H_bar[i]*x^i.
+    for (i=0; i<M; i++)
+        H11_vals[i] = H11_bar[M - 1 - i];
+    ret_code = poly_chirpz(M - 1, H11_vals, 1.0, CONJ(V), deg + 1, buf);
+    CHECK_RETCODE(ret_code, release_mem);
+    for (j=0; j<=deg; j++)
+        tm_bar[deg - j] += CPOW(CONJ(z0), j) * buf[j];
+    for (i=0; i<M; i++)
+        H21_vals[i] = H21_bar[M - 1 - i];
+    ret_code = poly_chirpz(M - 1, H21_vals, 1.0, CONJ(V), deg + 1, buf);
+    CHECK_RETCODE(ret_code, release_mem);
+    for (j=0; j<=deg; j++)
+        tm_bar[2*(deg + 1) + deg - j] += CPOW(CONJ(z0), j) * buf[j];
+
+release_mem:
+    free(H11_vals);
+    return ret_code;
+}
+
+// Auxiliary function: Adds the derivatives of a real-valued function L of
+// the bound states w.r.t. the conjugated coefficients of the transfer matrix
+// to tm_bar. The bound states are the roots of a(lambda), which is
+// proportional to H11(z(lambda)).
+static INT boundstates_adjoint(
+    const UINT deg,
+    COMPLEX const * const transfer_matrix,
+    const REAL eps_t,
+    const UINT K,
+    COMPLEX const * const bound_states,
+    COMPLEX const * const bound_states_bar,
+    COMPLEX * const tm_bar,
+    fnft_nsev_opts_t * const opts)
+{
+    COMPLEX z, pw, H11, dH11, dz, c;
+    UINT i, j, k;
+    INT ret_code = SUCCESS;
+
+    const REAL map_coeff = 2.0/nse_discretization_degree(opts->discretization);
+
+    for (k=0; k<K; k++) {
+        z = bound_states[k];
+        ret_code = nse_lambda_to_z(1, eps_t, &z, opts->discretization);
+        CHECK_RETCODE(ret_code, leave_fun);
+
+        // Evaluate H11 and its derivative at z using Horner's method
+        H11 = transfer_matrix[0];
+        dH11 = 0.0;
+        for (i=1; i<=deg; i++) {
+            dH11 = dH11*z + H11;
+            H11 = H11*z + transfer_matrix[i];
+        }
+        dz = I*map_coeff*eps_t*z; // dz/dlambda
+        if (dH11 == 0.0) {
+            ret_code = E_DIV_BY_ZERO;
+            goto leave_fun;
+        }
+
+        // H11(z(lambda))=0 implies dlambda = -dH11(z)/(H11'(z)*dz/dlambda),
+        // where dH11(z) = sum_j z^j*(change of the coefficient of z^j)
+        c = CONJ(-1.0/(dH11*dz)) * bound_states_bar[k];
+        pw = 1.0;
+        for (j=0; j<=deg; j++) {
+            tm_bar[deg - j] += CONJ(pw) * c;
+            pw *= z;
+        }
+    }
+
+leave_fun:
+    return ret_code;
+}
+
+/**
+ * Gradient of a real-valued function of the nonlinear Fourier spectrum
+ * w.r.t. the signal.
+ * See the header file for documentation.
+ */
+INT fnft_nsev_gradient(
+    const UINT D,
+    COMPLEX * const q,
+    REAL const * const T,
+    const UINT M,
+    COMPLEX const * const contspec_bar,
+    REAL const * const XI,
+    const UINT K,
+    COMPLEX const * const bound_states,
+    COMPLEX const * const bound_states_bar,
+    const INT kappa,
+    fnft_nsev_opts_t *opts,
+    COMPLEX * const grad)
+{
+    fnft_nsev_tree_t *tree = NULL;
+    fnft_nsev_opts_t default_opts;
+    COMPLEX **bars = NULL, **bars_next = NULL, *tm = NULL;
+    COMPLEX qk, rk, w, alpha, beta;
+    akns_discretization_t akns_discretization;
+    UINT i, j, k, l = 0, n, deg;
+    INT ret_code = SUCCESS;
+
+    // Check inputs
+    if (D < 2)
+        return E_INVALID_ARGUMENT(D);
+    if (q == NULL)
+        return E_INVALID_ARGUMENT(q);
+    if (T == NULL || T[0] >= T[1])
+        return E_INVALID_ARGUMENT(T);
+    if (contspec_bar != NULL) {
+        if (XI == NULL || XI[0] >= XI[1])
+            return E_INVALID_ARGUMENT(XI);
+        if (M < 2)
+            return E_INVALID_ARGUMENT(M);
+    }
+    if (K > 0 && bound_states_bar != NULL) {
+        if (bound_states == NULL)
+            return E_INVALID_ARGUMENT(bound_states);
+    }
+    if (abs(kappa) != 1)
+        return E_INVALID_ARGUMENT(kappa);
+    if (grad == NULL)
+        return E_INVALID_ARGUMENT(grad);
+    if (opts == NULL) {
+        default_opts = fnft_nsev_default_opts();
+        opts = &default_opts;
+    }
+    ret_code = nse_discretization_to_akns_discretization(opts->discretization,
+        &akns_discretization);
+    CHECK_RETCODE(ret_code, release_mem);
+    const UINT deg1 = nse_discretization_degree(opts->discretization);
+    const REAL eps_t = (T[1] - T[0])/(D - 1);
+
+    // Forward pass: Product tree with one sample per leaf
+    ret_code = fnft_nsev_tree_init(D, q, T, 1, kappa, opts, &tree);
+    CHECK_RETCODE(ret_code, release_mem);
+    l = tree->n_levels - 1;
+    deg = tree->nodes[l][0].deg;
+
+    // Derivatives w.r.t. the conjugated coefficients of the root
+    bars = calloc(1, sizeof(COMPLEX *));
+    if (bars == NULL) {
+        ret_code = E_NOMEM;
+        goto release_mem;
+    }
+    bars[0] = calloc(4*(deg + 1), sizeof(COMPLEX));
+    if (bars[0] == NULL) {
+        ret_code = E_NOMEM;
+        goto release_mem;
+    }
+    if (contspec_bar != NULL) {
+        ret_code = contspec_adjoint(deg, tree->nodes[l][0].W,
+            tree->nodes[l][0].tm, T, D, XI, M, contspec_bar, bars[0], opts);
+        CHECK_RETCODE(ret_code, release_mem);
+    }
+    if (K > 0 && bound_states_bar != NULL) {
+        ret_code = boundstates_adjoint(deg, tree->nodes[l][0].tm, eps_t, K,
+            bound_states, bound_states_bar, bars[0], opts);
+        CHECK_RETCODE(ret_code, release_mem);
+    }
+
+    // Backward pass through the tree. Normalized nodes are 2^-w times the
+    // product of their children.
+    for (; l>0; l--) {
+        bars_next = calloc(tree->n_nodes[l-1], sizeof(COMPLEX *));
+        if (bars_next == NULL) {
+            ret_code = E_NOMEM;
+            goto release_mem;
+        }
+        for (i=0; i<tree->n_nodes[l]; i++) {
+            const UINT deg_a = tree->nodes[l-1][2*i].deg;
+            bars_next[2*i] = malloc(4*(deg_a + 1) * sizeof(COMPLEX));
+            if (bars_next[2*i] == NULL) {
+                ret_code = E_NOMEM;
+                goto release_mem;
+            }
+            if (2*i + 1 >= tree->n_nodes[l-1]) {
+                memcpy(bars_next[2*i], bars[i],
+                    4*(deg_a + 1) * sizeof(COMPLEX));
+            } else {
+                const UINT deg_b = tree->nodes[l-1][2*i + 1].deg;
+                const REAL scl = POW(2.0, -(tree->nodes[l][i].W
+                    - tree->nodes[l-1][2*i].W - tree->nodes[l-1][2*i + 1].W));
+                bars_next[2*i + 1] = malloc(4*(deg_b + 1) * sizeof(COMPLEX));
+                if (bars_next[2*i + 1] == NULL) {
+                    ret_code = E_NOMEM;
+                    goto release_mem;
+                }
+                for (j=0; j<4*(deg_a + deg_b + 1); j++)
+                    bars[i][j] *= scl;
+                ret_code = poly_fmult2x2_pair_adjoint(deg_b,
+                    tree->nodes[l-1][2*i + 1].tm, deg_a,
+                    tree->nodes[l-1][2*i].tm, bars[i], bars_next[2*i + 1],
+                    bars_next[2*i]);
+                CHECK_RETCODE(ret_code, release_mem);
+            }
+            free(bars[i]);
+            bars[i] = NULL;
+        }
+        free(bars);
+        bars = bars_next;
+        bars_next = NULL;
+    }
+
+    // Leaves: The transfer matrix of a sample is an analytic function of
+    // q and r=-kappa*conj(q), so that its derivatives can be computed
+    // accurately with Cauchy's integral formula on a circle. The radius is
+    // chosen such that eps_t*q and eps_t^2*q*r change only moderately.
+    tm = malloc(akns_fscatter_numel(1, akns_discretization)
+        * sizeof(COMPLEX));
+    if (tm == NULL) {
+        ret_code = E_NOMEM;
+        goto release_mem;
+    }
+    for (n=0; n<D; n++) {
+        const COMPLEX r = -kappa*CONJ(q[n]);
+        const REAL h_q = 0.1/(eps_t*(1.0 + eps_t*CABS(r)));
+        const REAL h_r = 0.1/(eps_t*(1.0 + eps_t*CABS(q[n])));
+        alpha = 0.0;
+        beta = 0.0;
+        for (k=0; k<GRADIENT_NCONTOUR; k++) {
+            w = CEXP(2*PI*I*k/GRADIENT_NCONTOUR);
+
+            // dL/dq
+            qk = q[n] + h_q*w;
+            rk = r;
+            ret_code = akns_fscatter(1, &qk, &rk, eps_t, tm, &deg, NULL,
+                akns_discretization);
+            CHECK_RETCODE(ret_code, release_mem);
+            for (j=0; j<4*(deg1 + 1); j++)
+                alpha += CONJ(bars[n][j]) * tm[j] / (w*h_q);
+
+            // dL/dr
+            qk = q[n];
+            rk = r + h_r*w;
+            ret_code = akns_fscatter(1, &qk, &rk, eps_t, tm, &deg, NULL,
+                akns_discretization);
+            CHECK_RETCODE(ret_code, release_mem);
+            for (j=0; j<4*(deg1 + 1); j++)
+                beta += CONJ(bars[n][j]) * tm[j] / (w*h_r);
+        }
+        alpha /= GRADIENT_NCONTOUR;
+        beta /= GRADIENT_NCONTOUR;
+
+        // dL = 2*Re(alpha*dq + beta*dr) with dr=-kappa*conj(dq)
+        grad[n] = CONJ(alpha) - kappa*beta;
+    }
+
+release_mem:
+    if (bars != NULL) {
+        for (i=0; i<tree->n_nodes[l]; i++)
+            free(bars[i]);
+        free(bars);
+    }
+    if (bars_next != NULL) {
+        for (i=0; i<tree->n_nodes[l-1]; i++)
+            free(bars_next[i]);
+        free(bars_next);
+    }
+    free(tm);
+    fnft_nsev_tree_free(tree);
+    return ret_code;
+}
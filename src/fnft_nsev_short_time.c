@@ -0,0 +1,211 @@
+/*
+ * This file is part of FNFT.
+ *
+ * FNFT is free software; you can redistribute it and/or
+ * modify it under the terms of the version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * FNFT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contributors:
+ * Sander Wahls (TU Delft) 2017-2018.
+ * Shrinivas Chimmalgi (TU Delft) 2017-2018.
+ * Marius Brehler (TU Dortmund) 2018.
+ */
+
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <string.h> // for memcpy
+#include "fnft__errwarn.h"
+#include "fnft__poly_fmult.h"
+#include "fnft_nsev.h"
+#include "fnft__nse_fscatter.h"
+#include "fnft__nse_discretization.h"
+#include "fnft__nsev.h"
+
+// Maximum number of levels of the segment tree used by
+// fnft_nsev_short_time
+#define SHORT_TIME_MAX_LEVELS 64
+
+/**
+ * Short-time nonlinear Fourier transform for the nonlinear Schroedinger
+ * equation with vanishing boundary conditions.
+ * See the header file for documentation.
+ */
+INT fnft_nsev_short_time(
+    const UINT D,
+    COMPLEX * const q,
+    REAL const * const T,
+    const UINT window_len,
+    const UINT hop,
+    const UINT M,
+    COMPLEX * const contspec,
+    REAL const * const XI,
+    const INT kappa,
+    fnft_nsev_opts_t *opts)
+{
+    COMPLEX *nodes[SHORT_TIME_MAX_LEVELS] = { NULL };
+    INT *nodes_W[SHORT_TIME_MAX_LEVELS] = { NULL };
+    COMPLEX *buf = NULL, *tm = NULL, *tm_tmp = NULL, *swap;
+    fnft_nsev_opts_t default_opts;
+    UINT i, l, L, w, pos, deg, deg_l, n_l, len;
+    INT W, W_tmp, *W_ptr = NULL;
+    INT ret_code = SUCCESS;
+
+    // Check inputs
+    if (D < 2)
+        return E_INVALID_ARGUMENT(D);
+    if (q == NULL)
+        return E_INVALID_ARGUMENT(q);
+    if (T == NULL || T[0] >= T[1])
+        return E_INVALID_ARGUMENT(T);
+    if (window_len < 2 || window_len > D)
+        return E_INVALID_ARGUMENT(window_len);
+    if (hop == 0 || window_len % hop != 0)
+        return E_INVALID_ARGUMENT(hop);
+    if (contspec == NULL || M == 0)
+        return E_INVALID_ARGUMENT(contspec);
+    if (XI == NULL || XI[0] >= XI[1])
+        return E_INVALID_ARGUMENT(XI);
+    if (abs(kappa) != 1)
+        return E_INVALID_ARGUMENT(kappa);
+    if (opts == NULL) {
+        default_opts = fnft_nsev_default_opts();
+        opts = &default_opts;
+    }
+    const UINT deg1 = nse_discretization_degree(opts->discretization);
+    if (deg1 == 0)
+        return E_INVALID_ARGUMENT(opts->discretization);
+    if (opts->normalization_flag)
+        W_ptr = &W_tmp;
+
+    // Each window consists of nb consecutive blocks of hop samples. Level l
+    // of the segment tree contains the transfer matrices of 2^l blocks that
+    // start at multiples of 2^l. Levels that are longer than a window are
+    // never needed.
+    const REAL eps_t = (T[1] - T[0])/(D - 1);
+    const UINT n_windows = (D - window_len)/hop + 1;
+    const UINT nb = window_len/hop;
+    const UINT n_blocks = n_windows - 1 + nb;
+    for (L = 0; L+1 < SHORT_TIME_MAX_LEVELS && ((UINT)2 << L) <= nb; L++)
+        ;
+
+    // Level zero: transfer matrices of the blocks
+    deg_l = hop*deg1;
+    nodes[0] = malloc(n_blocks*4*(deg_l + 1) * sizeof(COMPLEX));
+    nodes_W[0] = malloc(n_blocks * sizeof(INT));
+    buf = malloc(nse_fscatter_numel(hop, opts->discretization)
+        * sizeof(COMPLEX));
+    if (nodes[0] == NULL || nodes_W[0] == NULL || buf == NULL) {
+        ret_code = E_NOMEM;
+        goto release_mem;
+    }
+    for (i=0; i<n_blocks; i++) {
+        W_tmp = 0;
+        ret_code = nse_fscatter(hop, q + i*hop, eps_t, kappa, buf, &deg,
+            W_ptr, opts->discretization);
+        CHECK_RETCODE(ret_code, release_mem);
+        memcpy(nodes[0] + i*4*(deg_l + 1), buf,
+            4*(deg_l + 1) * sizeof(COMPLEX));
+        nodes_W[0][i] = W_tmp;
+    }
+
+    // Higher levels: products of pairs of nodes on the level below
+    for (l=1; l<=L; l++) {
+        const UINT deg_prev = deg_l;
+        deg_l *= 2;
+        n_l = n_blocks >> l;
+        nodes[l] = malloc(n_l*4*(deg_l + 1) * sizeof(COMPLEX));
+        nodes_W[l] = malloc(n_l * sizeof(INT));
+        if (nodes[l] == NULL || nodes_W[l] == NULL) {
+            ret_code = E_NOMEM;
+            goto release_mem;
+        }
+        for (i=0; i<n_l; i++) {
+            W_tmp = 0;
+            ret_code = poly_fmult2x2_pair(deg_prev,
+                nodes[l-1] + (2*i + 1)*4*(deg_prev + 1), deg_prev,
+                nodes[l-1] + 2*i*4*(deg_prev + 1),
+                nodes[l] + i*4*(deg_l + 1), W_ptr);
+            CHECK_RETCODE(ret_code, release_mem);
+            nodes_W[l][i] = nodes_W[l-1][2*i] + nodes_W[l-1][2*i + 1]
+                + W_tmp;
+        }
+    }
+
+    // Buffers for the transfer matrices of the windows. They have the usual
+    // size since tf2contspec uses parts of them as buffers.
+    i = nse_fscatter_numel(window_len, opts->discretization);
+    tm = malloc(i * sizeof(COMPLEX));
+    tm_tmp = malloc(i * sizeof(COMPLEX));
+    if (tm == NULL || tm_tmp == NULL) {
+        ret_code = E_NOMEM;
+        goto release_mem;
+    }
+    switch (opts->contspec_type) {
+    case nsev_cstype_REFLECTION_COEFFICIENT:
+        len = M;
+        break;
+    case nsev_cstype_AB:
+        len = 2*M;
+        break;
+    case nsev_cstype_BOTH:
+        len = 3*M;
+        break;
+    default:
+        ret_code = E_INVALID_ARGUMENT(opts->contspec_type);
+        goto release_mem;
+    }
+
+    for (w=0; w<n_windows; w++) {
+
+        // Multiply the nodes that cover the blocks w,...,w+nb-1 from right
+        // to left, using the largest node that fits at each position
+        deg = 0;
+        W = 0;
+        for (pos=w; pos<w+nb; pos+=((UINT)1 << l)) {
+            for (l=0; l<L && pos%((UINT)2 << l) == 0
+                && pos + ((UINT)2 << l) <= w+nb; l++)
+                ;
+            deg_l = (hop << l)*deg1;
+            COMPLEX const * const node = nodes[l] + (pos >> l)*4*(deg_l + 1);
+            if (pos == w) {
+                memcpy(tm, node, 4*(deg_l + 1) * sizeof(COMPLEX));
+                W = nodes_W[l][pos >> l];
+            } else {
+                W_tmp = 0;
+                ret_code = poly_fmult2x2_pair(deg_l, node, deg, tm, tm_tmp,
+                    W_ptr);
+                CHECK_RETCODE(ret_code, release_mem);
+                W += nodes_W[l][pos >> l] + W_tmp;
+                swap = tm;
+                tm = tm_tmp;
+                tm_tmp = swap;
+            }
+            deg += deg_l;
+        }
+
+        // Continuous spectrum of the window
+        REAL const T_window[2] = { T[0] + w*hop*eps_t,
+            T[0] + (w*hop + window_len - 1)*eps_t };
+        ret_code = nsev_tf2contspec(deg, W, tm, T_window, window_len, XI, M,
+            contspec + w*len, opts);
+        CHECK_RETCODE(ret_code, release_mem);
+    }
+
+release_mem:
+    for (l=0; l<SHORT_TIME_MAX_LEVELS; l++) {
+        free(nodes[l]);
+        free(nodes_W[l]);
+    }
+    free(buf);
+    free(tm);
+    free(tm_tmp);
+    return ret_code;
+}
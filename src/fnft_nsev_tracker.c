@@ -0,0 +1,268 @@
+/*
+ * This file is part of FNFT.
+ *
+ * FNFT is free software; you can redistribute it and/or
+ * modify it under the terms of the version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * FNFT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contributors:
+ * Sander Wahls (TU Delft) 2017-2018.
+ * Shrinivas Chimmalgi (TU Delft) 2017-2018.
+ * Marius Brehler (TU Dortmund) 2018.
+ */
+
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <string.h> // for memcpy
+#include "fnft__errwarn.h"
+#include "fnft_nsev.h"
+#include "fnft__nse_fscatter.h"
+#include "fnft__nse_discretization.h"
+#include "fnft__misc.h"
+#include "fnft__sample_desc.h"
+#include "fnft__nsev.h"
+
+/**
+ * Tracker for the bound states of consecutive frames. Only the bound states
+ * of the last frame are stored. See the header file for documentation.
+ */
+struct fnft_nsev_tracker_s {
+    UINT K;
+    COMPLEX * bound_states;
+    INT valid_flag;
+};
+
+/**
+ * Creates a tracker. See the header file for documentation.
+ */
+INT fnft_nsev_tracker_init(fnft_nsev_tracker_t ** const tracker_ptr)
+{
+    fnft_nsev_tracker_t *tracker;
+
+    if (tracker_ptr == NULL)
+        return E_INVALID_ARGUMENT(tracker_ptr);
+
+    tracker = malloc(sizeof(fnft_nsev_tracker_t));
+    if (tracker == NULL)
+        return E_NOMEM;
+    tracker->K = 0;
+    tracker->bound_states = NULL;
+    tracker->valid_flag = 0;
+
+    *tracker_ptr = tracker;
+    return SUCCESS;
+}
+
+// Auxiliary function: Refines the bound states of the previous frame, which
+// are copied into buffer, with Newton's method. *tracked_flag is set if none
+// of the iterations left the region in which the full filter accepts bound
+// states, no two of them converged to the same root, and the number of roots
+// of a(lam) in this region, computed with the argument principle, did not
+// change. Otherwise, the bound states have to be localized from scratch.
+static INT tracker_refine(
+    fnft_nsev_tracker_t const * const tracker,
+    const UINT D,
+    sample_desc_t const * const q,
+    REAL const * const T,
+    const UINT deg,
+    COMPLEX * const transfer_matrix,
+    const REAL eps_t,
+    COMPLEX * const buffer,
+    INT * const tracked_flag,
+    fnft_nsev_opts_t * const opts)
+{
+    REAL bounding_box[4];
+    REAL degree1step;
+    UINT K, N;
+    INT ret_code = SUCCESS;
+
+    *tracked_flag = 0;
+    degree1step = nse_discretization_degree(opts->discretization);
+    if (degree1step == 0)
+        return E_INVALID_ARGUMENT(opts->discretization);
+
+    // Newton's method, initialized with the bound states of the last frame
+    K = tracker->K;
+    memcpy(buffer, tracker->bound_states, K * sizeof(COMPLEX));
+    ret_code = nsev_refine_bound_states(D, q, T, deg, transfer_matrix, eps_t, K,
+        buffer, opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Remove diverged and duplicate bound states
+    bounding_box[1] = nsev_re_bound(eps_t, 2/degree1step);
+    bounding_box[0] = -bounding_box[1];
+    bounding_box[2] = 0.0;
+    bounding_box[3] = nsev_im_bound(D, q, T);
+    ret_code = misc_filter_merge(&K, buffer, bounding_box, SQRT(EPSILON),
+        0.0);
+    CHECK_RETCODE(ret_code, leave_fun);
+    if (K != tracker->K)
+        goto leave_fun;
+
+    // Completeness check
+    ret_code = nsev_count_bound_states(D, q, T, deg, transfer_matrix, eps_t, &N,
+        opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+    if (N == K)
+        *tracked_flag = 1;
+
+leave_fun:
+    return ret_code;
+}
+
+/**
+ * Computes the nonlinear Fourier spectrum of the next frame. See the header
+ * file for documentation.
+ */
+INT fnft_nsev_tracker_step(
+    fnft_nsev_tracker_t * const tracker,
+    const UINT D,
+    COMPLEX * const q,
+    REAL const * const T,
+    const UINT M,
+    COMPLEX * const contspec,
+    REAL const * const XI,
+    UINT * const K_ptr,
+    COMPLEX * const bound_states,
+    COMPLEX * const normconsts_or_residues,
+    const INT kappa,
+    fnft_nsev_opts_t *opts,
+    INT * const relocalized_flag_ptr)
+{
+    COMPLEX *transfer_matrix = NULL, *buffer = NULL;
+    sample_desc_t q_desc;
+    fnft_nsev_opts_t default_opts;
+    UINT deg, K;
+    INT W = 0, *W_ptr = NULL;
+    INT tracked_flag = 0, relocalized_flag = 0;
+    INT ret_code = SUCCESS;
+    UINT i;
+
+    // Check inputs
+    if (tracker == NULL)
+        return E_INVALID_ARGUMENT(tracker);
+    if (D < 2)
+        return E_INVALID_ARGUMENT(D);
+    if (q == NULL)
+        return E_INVALID_ARGUMENT(q);
+    if (T == NULL || T[0] >= T[1])
+        return E_INVALID_ARGUMENT(T);
+    if (contspec != NULL) {
+        if (XI == NULL || XI[0] >= XI[1])
+            return E_INVALID_ARGUMENT(XI);
+    }
+    if (abs(kappa) != 1)
+        return E_INVALID_ARGUMENT(kappa);
+    if (bound_states != NULL) {
+        if (K_ptr == NULL)
+            return E_INVALID_ARGUMENT(K_ptr);
+    }
+    if (opts == NULL) {
+        default_opts = fnft_nsev_default_opts();
+        opts = &default_opts;
+    }
+
+    // Compute the transfer matrix as in fnft_nsev
+    i = nse_fscatter_numel(D, opts->discretization);
+    if (i == 0) {
+        ret_code = E_INVALID_ARGUMENT(opts->discretization);
+        goto release_mem;
+    }
+    transfer_matrix = malloc(i*sizeof(COMPLEX));
+    if (transfer_matrix == NULL) {
+        ret_code = E_NOMEM;
+        goto release_mem;
+    }
+    const REAL eps_t = (T[1] - T[0])/(D - 1);
+    if (opts->normalization_flag)
+        W_ptr = &W;
+    ret_code = nse_fscatter(D, q, eps_t, kappa, transfer_matrix, &deg, W_ptr,
+        opts->discretization);
+    CHECK_RETCODE(ret_code, release_mem);
+
+    // Compute the continuous spectrum
+    q_desc = sample_desc_complex(q);
+    ret_code = nsev_tf2nfs(D, &q_desc, T, deg, W, transfer_matrix, M, contspec,
+        XI, NULL, NULL, NULL, kappa, opts);
+    CHECK_RETCODE(ret_code, release_mem);
+
+    if (kappa == +1 && bound_states != NULL) {
+
+        // Try to track the bound states of the last frame
+        if (tracker->valid_flag) {
+            buffer = malloc((tracker->K + 1) * sizeof(COMPLEX));
+            if (buffer == NULL) {
+                ret_code = E_NOMEM;
+                goto release_mem;
+            }
+            ret_code = tracker_refine(tracker, D, &q_desc, T, deg,
+                transfer_matrix, eps_t, buffer, &tracked_flag, opts);
+            CHECK_RETCODE(ret_code, release_mem);
+        }
+
+        if (tracked_flag) {
+            K = tracker->K;
+            if (*K_ptr < K) {
+                WARN("Found more than *K_ptr bound states. Returning as many as possible.");
+                K = *K_ptr;
+            }
+            memcpy(bound_states, buffer, K * sizeof(COMPLEX));
+            *K_ptr = K;
+            if (normconsts_or_residues != NULL && K != 0) {
+                ret_code = nsev_tf2normconsts_or_residues(D, &q_desc, T, K,
+                    transfer_matrix, deg, bound_states,
+                    normconsts_or_residues, opts);
+                CHECK_RETCODE(ret_code, release_mem);
+            }
+        } else {
+            // Localize the bound states with the method in opts
+            ret_code = nsev_tf2nfs(D, &q_desc, T, deg, W, transfer_matrix, 0,
+                NULL, XI, K_ptr, bound_states, normconsts_or_residues, kappa,
+                opts);
+            CHECK_RETCODE(ret_code, release_mem);
+            relocalized_flag = 1;
+        }
+
+        // Remember the bound states for the next frame
+        free(tracker->bound_states);
+        tracker->valid_flag = 0;
+        tracker->bound_states = malloc((*K_ptr + 1) * sizeof(COMPLEX));
+        if (tracker->bound_states == NULL) {
+            ret_code = E_NOMEM;
+            goto release_mem;
+        }
+        memcpy(tracker->bound_states, bound_states, *K_ptr * sizeof(COMPLEX));
+        tracker->K = *K_ptr;
+        tracker->valid_flag = 1;
+
+    } else if (K_ptr != NULL) {
+        *K_ptr = 0;
+    }
+
+    if (relocalized_flag_ptr != NULL)
+        *relocalized_flag_ptr = relocalized_flag;
+
+release_mem:
+    free(transfer_matrix);
+    free(buffer);
+    return ret_code;
+}
+
+/**
+ * Releases a tracker. See the header file for documentation.
+ */
+void fnft_nsev_tracker_free(fnft_nsev_tracker_t * const tracker)
+{
+    if (tracker == NULL)
+        return;
+    free(tracker->bound_states);
+    free(tracker);
+}
@@ -0,0 +1,300 @@
+/*
+ * This file is part of FNFT.
+ *
+ * FNFT is free software; you can redistribute it and/or
+ * modify it under the terms of the version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * FNFT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contributors:
+ * Sander Wahls (TU Delft) 2017-2018.
+ * Shrinivas Chimmalgi (TU Delft) 2017-2018.
+ * Marius Brehler (TU Dortmund) 2018.
+ */
+
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <string.h> // for memcpy
+#include "fnft__errwarn.h"
+#include "fnft__poly_fmult.h"
+#include "fnft_nsev.h"
+#include "fnft__nse_fscatter.h"
+#include "fnft__nse_discretization.h"
+#include "fnft__sample_desc.h"
+#include "fnft__nsev.h"
+
+// Auxiliary function: Recomputes node i on level l of the tree from the
+// samples (l=0) or from its children (l>0).
+static INT tree_update_node(fnft_nsev_tree_t * const tree, const UINT l,
+    const UINT i)
+{
+    COMPLEX *tm = NULL;
+    UINT deg;
+    INT W = 0;
+    INT * const W_ptr = tree->opts.normalization_flag ? &W : NULL;
+    INT ret_code = SUCCESS;
+
+    if (l == 0) {
+        const UINT first = i*tree->block_len;
+        const UINT len = (tree->D - first < tree->block_len) ?
+            tree->D - first : tree->block_len;
+        const REAL eps_t = (tree->T[1] - tree->T[0])/(tree->D - 1);
+        tm = malloc(nse_fscatter_numel(len, tree->opts.discretization)
+            * sizeof(COMPLEX));
+        if (tm == NULL)
+            return E_NOMEM;
+        ret_code = nse_fscatter(len, tree->q + first, eps_t, tree->kappa, tm,
+            &deg, W_ptr, tree->opts.discretization);
+        CHECK_RETCODE(ret_code, release_mem);
+    } else if (2*i + 1 >= tree->n_nodes[l-1]) {
+        deg = tree->nodes[l-1][2*i].deg;
+        W = tree->nodes[l-1][2*i].W;
+        tm = malloc(4*(deg + 1) * sizeof(COMPLEX));
+        if (tm == NULL)
+            return E_NOMEM;
+        memcpy(tm, tree->nodes[l-1][2*i].tm, 4*(deg + 1) * sizeof(COMPLEX));
+    } else {
+        const UINT deg_a = tree->nodes[l-1][2*i].deg;
+        const UINT deg_b = tree->nodes[l-1][2*i + 1].deg;
+        deg = deg_a + deg_b;
+        tm = malloc(4*(deg + 1) * sizeof(COMPLEX));
+        if (tm == NULL)
+            return E_NOMEM;
+        ret_code = poly_fmult2x2_pair(deg_b, tree->nodes[l-1][2*i + 1].tm,
+            deg_a, tree->nodes[l-1][2*i].tm, tm, W_ptr);
+        CHECK_RETCODE(ret_code, release_mem);
+        W += tree->nodes[l-1][2*i].W + tree->nodes[l-1][2*i + 1].W;
+    }
+
+    free(tree->nodes[l][i].tm);
+    tree->nodes[l][i].tm = tm;
+    tree->nodes[l][i].deg = deg;
+    tree->nodes[l][i].W = W;
+    return SUCCESS;
+
+release_mem:
+    free(tm);
+    return ret_code;
+}
+
+/**
+ * Creates a persistent product tree.
+ * See the header file for documentation.
+ */
+INT fnft_nsev_tree_init(
+    const UINT D,
+    COMPLEX const * const q,
+    REAL const * const T,
+    const UINT block_len,
+    const INT kappa,
+    fnft_nsev_opts_t const * opts,
+    fnft_nsev_tree_t ** const tree_ptr)
+{
+    fnft_nsev_tree_t *tree = NULL;
+    fnft_nsev_opts_t default_opts;
+    UINT i, l, n;
+    INT ret_code = SUCCESS;
+
+    // Check inputs
+    if (D < 2)
+        return E_INVALID_ARGUMENT(D);
+    if (q == NULL)
+        return E_INVALID_ARGUMENT(q);
+    if (T == NULL || T[0] >= T[1])
+        return E_INVALID_ARGUMENT(T);
+    if (block_len == 0)
+        return E_INVALID_ARGUMENT(block_len);
+    if (abs(kappa) != 1)
+        return E_INVALID_ARGUMENT(kappa);
+    if (tree_ptr == NULL)
+        return E_INVALID_ARGUMENT(tree_ptr);
+    if (opts == NULL) {
+        default_opts = fnft_nsev_default_opts();
+        opts = &default_opts;
+    }
+    if (nse_discretization_degree(opts->discretization) == 0)
+        return E_INVALID_ARGUMENT(opts->discretization);
+
+    // Allocate memory
+    tree = calloc(1, sizeof(fnft_nsev_tree_t));
+    if (tree == NULL)
+        return E_NOMEM;
+    tree->q = malloc(D * sizeof(COMPLEX));
+    if (tree->q == NULL) {
+        ret_code = E_NOMEM;
+        goto release_mem;
+    }
+    memcpy(tree->q, q, D * sizeof(COMPLEX));
+    tree->D = D;
+    tree->block_len = block_len;
+    tree->T[0] = T[0];
+    tree->T[1] = T[1];
+    tree->kappa = kappa;
+    tree->opts = *opts;
+
+    // Compute the nodes level by level until only the root is left
+    n = (D + block_len - 1)/block_len;
+    for (l=0; l<FNFT__NSEV_TREE_MAX_LEVELS; l++) {
+        tree->nodes[l] = calloc(n, sizeof(*tree->nodes[l]));
+        if (tree->nodes[l] == NULL) {
+            ret_code = E_NOMEM;
+            goto release_mem;
+        }
+        tree->n_nodes[l] = n;
+        tree->n_levels = l + 1;
+        for (i=0; i<n; i++) {
+            ret_code = tree_update_node(tree, l, i);
+            CHECK_RETCODE(ret_code, release_mem);
+        }
+        if (n == 1)
+            break;
+        n = (n + 1)/2;
+    }
+
+    *tree_ptr = tree;
+    return SUCCESS;
+
+release_mem:
+    fnft_nsev_tree_free(tree);
+    return ret_code;
+}
+
+/**
+ * Changes samples and updates the product tree.
+ * See the header file for documentation.
+ */
+INT fnft_nsev_tree_update(
+    fnft_nsev_tree_t * const tree,
+    const UINT n_updates,
+    UINT const * const idx,
+    COMPLEX const * const q_new)
+{
+    INT *dirty = NULL;
+    UINT i, l;
+    INT ret_code = SUCCESS;
+
+    // Check inputs
+    if (tree == NULL)
+        return E_INVALID_ARGUMENT(tree);
+    if (n_updates == 0)
+        return SUCCESS;
+    if (idx == NULL)
+        return E_INVALID_ARGUMENT(idx);
+    if (q_new == NULL)
+        return E_INVALID_ARGUMENT(q_new);
+    for (i=0; i<n_updates; i++) {
+        if (idx[i] >= tree->D)
+            return E_INVALID_ARGUMENT(idx);
+    }
+
+    // Change the samples and mark the blocks that contain them
+    dirty = calloc(tree->n_nodes[0], sizeof(INT));
+    if (dirty == NULL)
+        return E_NOMEM;
+    for (i=0; i<n_updates; i++) {
+        tree->q[idx[i]] = q_new[i];
+        dirty[idx[i]/tree->block_len] = 1;
+    }
+
+    // Recompute the marked nodes and mark their parents, so that each
+    // ancestor is recomputed only once even if several samples changed
+    for (l=0; l<tree->n_levels; l++) {
+        if (l > 0) {
+            for (i=0; i<tree->n_nodes[l]; i++)
+                dirty[i] = dirty[2*i] || (2*i + 1 < tree->n_nodes[l-1]
+                    && dirty[2*i + 1]);
+        }
+        for (i=0; i<tree->n_nodes[l]; i++) {
+            if (dirty[i]) {
+                ret_code = tree_update_node(tree, l, i);
+                CHECK_RETCODE(ret_code, release_mem);
+            }
+        }
+    }
+
+release_mem:
+    free(dirty);
+    return ret_code;
+}
+
+/**
+ * Computes the nonlinear Fourier spectrum of the current samples in the
+ * product tree.
+ * See the header file for documentation.
+ */
+INT fnft_nsev_tree_query(
+    fnft_nsev_tree_t * const tree,
+    const UINT M,
+    COMPLEX * const contspec,
+    REAL const * const XI,
+    UINT * const K_ptr,
+    COMPLEX * const bound_states,
+    COMPLEX * const normconsts_or_residues)
+{
+    COMPLEX *transfer_matrix = NULL;
+    sample_desc_t q_desc;
+    UINT i;
+    INT ret_code = SUCCESS;
+
+    // Check inputs
+    if (tree == NULL)
+        return E_INVALID_ARGUMENT(tree);
+    if (contspec != NULL) {
+        if (XI == NULL || XI[0] >= XI[1])
+            return E_INVALID_ARGUMENT(XI);
+    }
+    if (bound_states != NULL) {
+        if (K_ptr == NULL)
+            return E_INVALID_ARGUMENT(K_ptr);
+    }
+
+    // The auxiliary routines use parts of the transfer matrix as buffers
+    // (see fnft_nsev_desc), so the root is copied into an array of the usual size
+    const UINT l = tree->n_levels - 1;
+    const UINT deg = tree->nodes[l][0].deg;
+    i = nse_fscatter_numel(tree->D, tree->opts.discretization);
+    transfer_matrix = malloc(i * sizeof(COMPLEX));
+    if (transfer_matrix == NULL)
+        return E_NOMEM;
+    memcpy(transfer_matrix, tree->nodes[l][0].tm,
+        4*(deg + 1) * sizeof(COMPLEX));
+
+    // Compute the nonlinear Fourier spectrum from the transfer matrix
+    q_desc = sample_desc_complex(tree->q);
+    ret_code = nsev_tf2nfs(tree->D, &q_desc, tree->T, deg, tree->nodes[l][0].W,
+        transfer_matrix, M, contspec, XI, K_ptr, bound_states,
+        normconsts_or_residues, tree->kappa, &tree->opts);
+    CHECK_RETCODE(ret_code, release_mem);
+
+release_mem:
+    free(transfer_matrix);
+    return ret_code;
+}
+
+/**
+ * Frees the memory used by a product tree.
+ * See the header file for documentation.
+ */
+void fnft_nsev_tree_free(fnft_nsev_tree_t * const tree)
+{
+    UINT i, l;
+
+    if (tree == NULL)
+        return;
+    for (l=0; l<tree->n_levels; l++) {
+        if (tree->nodes[l] == NULL)
+            continue;
+        for (i=0; i<tree->n_nodes[l]; i++)
+            free(tree->nodes[l][i].tm);
+        free(tree->nodes[l]);
+    }
+    free(tree->q);
+    free(tree);
+}
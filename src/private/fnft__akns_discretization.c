@@ -64,6 +64,41 @@ UINT fnft__akns_discretization_degree(akns_discretization_t
     }
 }
 
+/**
+ * This routine returns the order of accuracy of the discretization or zero
+ * if the discretization is unknown.
+ */
+UINT fnft__akns_discretization_order(akns_discretization_t discretization)
+{
+    switch (discretization) {
+        case akns_discretization_2SPLIT1A:
+        case akns_discretization_2SPLIT1B:
+            return 1;
+        case akns_discretization_2SPLIT2A:
+        case akns_discretization_2SPLIT2B:
+        case akns_discretization_2SPLIT2S:
+        case akns_discretization_2SPLIT2_MODAL:
+        case akns_discretization_2SPLIT3A:
+        case akns_discretization_2SPLIT3B:
+        case akns_discretization_2SPLIT3S:
+        case akns_discretization_2SPLIT4A:
+        case akns_discretization_2SPLIT4B:
+        case akns_discretization_2SPLIT5A:
+        case akns_discretization_2SPLIT5B:
+        case akns_discretization_2SPLIT6A:
+        case akns_discretization_2SPLIT6B:
+        case akns_discretization_2SPLIT7A:
+        case akns_discretization_2SPLIT7B:
+        case akns_discretization_2SPLIT8A:
+        case akns_discretization_2SPLIT8B:
+        case akns_discretization_BO:
+            return 2;
+
+        default: // Unknown discretization
+            return 0;
+    }
+}
+
 /**
  * This routine returns the boundary coefficient based on the discretization.
  */
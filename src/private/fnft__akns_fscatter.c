@@ -28,6 +28,7 @@
 #include "fnft__akns_discretization.h"
 #include "fnft__akns_discretization_t.h"
 #include "fnft__misc.h"
+#include "fnft__sample_desc.h"
 
 /**
  * Returns the length of array to be allocated based on the number
@@ -61,18 +62,38 @@ static inline void akns_fscatter_zero_freq_scatter_matrix(COMPLEX * const M,
 
 }
 /**
- * Fast computation of polynomial approximation of the combined scattering
- * matrix.
+ * Reads the n-th samples of q and r. If r is NULL, r[n]=r_coeff*conj(q[n]),
+ * and r[n]=r_coeff*r->data[n] otherwise.
  */
-INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r,
+static inline void akns_fscatter_get_samples(sample_desc_t const * const q,
+    sample_desc_t const * const r, const COMPLEX r_coeff, const UINT n,
+    COMPLEX * const qn, COMPLEX * const rn)
+{
+    *qn = sample_desc_get(q, n);
+    if (r == NULL)
+        *rn = r_coeff * CONJ(*qn);
+    else
+        *rn = r_coeff * sample_desc_get(r, n);
+}
+
+/**
+ * Implements akns_fscatter, akns_fscatter_const_r and akns_fscatter_desc.
+ * The samples are read through the descriptors q and r while the individual
+ * scattering matrices are set up, see akns_fscatter_get_samples. If
+ * real_flag is set and all coefficients of the individual scattering
+ * matrices are real, they are multiplied with poly_fmult2x2_real.
+ */
+static INT akns_fscatter_impl(const UINT D, sample_desc_t const * const q,
+                 sample_desc_t const * const r, const COMPLEX r_coeff,
                  const REAL eps_t, COMPLEX * const result, UINT * const deg_ptr,
-                 INT * const W_ptr, akns_discretization_t discretization)
+                 INT * const W_ptr, akns_discretization_t discretization,
+                 INT real_flag)
 {
     
     INT i, ret_code;
     COMPLEX *p, *p11, *p12, *p21, *p22;
-    UINT n, len;
-    COMPLEX e_Bstorage[21], scl;
+    UINT n, k, len;
+    COMPLEX e_Bstorage[21], scl, qn, rn;
     // These variables are used to store the values of matrix exponentials
     // e_aB = expm([0,q;r,0]*a*eps_t/degree1step)
     COMPLEX *e_0_5B, *e_1B, *e_1_5B, *e_2B, *e_3B, *e_4B, *e_5B, *e_6B, *e_8B,
@@ -82,9 +103,9 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
     // Check inputs
     if (D == 0)
         return E_INVALID_ARGUMENT(D);
-    if (q == NULL)
+    if (!sample_desc_valid(q))
         return E_INVALID_ARGUMENT(q);
-    if (r == NULL)
+    if (r != NULL && !sample_desc_valid(r))
         return E_INVALID_ARGUMENT(r);
     if (eps_t <= 0.0)
         return E_INVALID_ARGUMENT(eps_t);
@@ -121,23 +142,24 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
         case akns_discretization_2SPLIT2_MODAL: // Modified Ablowitz-Ladik discretization
 
             for (i=D-1; i>=0; i--) {
-                scl = eps_t*CABS(q[i]);
-		if (CREAL(q[i]) == CREAL(r[i])) {
+                akns_fscatter_get_samples(q, r, r_coeff, i, &qn, &rn);
+                scl = eps_t*CABS(qn);
+		if (CREAL(qn) == CREAL(rn)) {
                     if ((double)scl >= 1.0) {
-                        ret_code = E_OTHER("kappa == -1 but eps_t*|q[i]|>=1 ... decrease step size");
+                        ret_code = E_OTHER("kappa == -1 but eps_t*|qn|>=1 ... decrease step size");
                         goto release_mem;
                     }
-                    scl = 1.0/CSQRT(1-eps_t*q[i]*eps_t*r[i]);
+                    scl = 1.0/CSQRT(1-eps_t*qn*eps_t*rn);
                 } else
-                    scl = 1.0/CSQRT(1-eps_t*q[i]*eps_t*r[i]);
+                    scl = 1.0/CSQRT(1-eps_t*qn*eps_t*rn);
               
                 // construct the scattering matrix for the i-th sample
                 p11[0] = 0.0;
                 p11[1] = scl;
-                p12[0] = scl*eps_t*q[i];
+                p12[0] = scl*eps_t*qn;
                 p12[1] = 0.0;
                 p21[0] = 0.0;
-                p21[1] = scl*eps_t*r[i];
+                p21[1] = scl*eps_t*rn;
                 p22[0] = scl;
                 p22[1] = 0.0;
 
@@ -155,9 +177,10 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_1B = &e_Bstorage[0];
             
             for (i=D-1; i>=0; i--) {
+                akns_fscatter_get_samples(q, r, r_coeff, i, &qn, &rn);
                 
-                //e_1B = expm([0,q[i];r[i],0]*1*eps_t/deg)
-                akns_fscatter_zero_freq_scatter_matrix(e_1B, eps_t/ deg, q[i], r[i]);
+                //e_1B = expm([0,qn;rn,0]*1*eps_t/deg)
+                akns_fscatter_zero_freq_scatter_matrix(e_1B, eps_t/ deg, qn, rn);
                 
                 
                 // construct the scattering matrix for the i-th sample
@@ -184,8 +207,9 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_1B = &e_Bstorage[0];
             
             for (i=D-1; i>=0; i--) {
+                akns_fscatter_get_samples(q, r, r_coeff, i, &qn, &rn);
                 
-                akns_fscatter_zero_freq_scatter_matrix(e_1B, eps_t/ deg, q[i], r[i]);
+                akns_fscatter_zero_freq_scatter_matrix(e_1B, eps_t/ deg, qn, rn);
                 
                 // construct the scattering matrix for the i-th sample
                 p11[0] = 0.0;
@@ -209,8 +233,9 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_0_5B = &e_Bstorage[0];
 
             for (i=D-1; i>=0; i--) {
-                //e_0_5B = expm([0,q[i];r[i],0]*0.5*eps_t/deg)
-                akns_fscatter_zero_freq_scatter_matrix(e_0_5B, 0.5*eps_t/ deg, q[i], r[i]);
+                akns_fscatter_get_samples(q, r, r_coeff, i, &qn, &rn);
+                //e_0_5B = expm([0,qn;rn,0]*0.5*eps_t/deg)
+                akns_fscatter_zero_freq_scatter_matrix(e_0_5B, 0.5*eps_t/ deg, qn, rn);
 
                 // construct the scattering matrix for the i-th sample
                 p11[0] = e_0_5B[1]*e_0_5B[2];
@@ -235,8 +260,9 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_1B = &e_Bstorage[0];
             
             for (i=D-1; i>=0; i--) {
+                akns_fscatter_get_samples(q, r, r_coeff, i, &qn, &rn);
                 
-                akns_fscatter_zero_freq_scatter_matrix(e_1B, eps_t/ deg, q[i], r[i]);
+                akns_fscatter_zero_freq_scatter_matrix(e_1B, eps_t/ deg, qn, rn);
                 
                 // construct the scattering matrix for the i-th sample
                 p11[0] = 0.0;
@@ -263,10 +289,11 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_3B = &e_Bstorage[6];
 
             for (i=D-1; i>=0; i--) {
+                akns_fscatter_get_samples(q, r, r_coeff, i, &qn, &rn);
 
-                akns_fscatter_zero_freq_scatter_matrix(e_1B, eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_2B, 2*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_3B, 3*eps_t/ deg, q[i], r[i]);
+                akns_fscatter_zero_freq_scatter_matrix(e_1B, eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_2B, 2*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_3B, 3*eps_t/ deg, qn, rn);
 
                 // construct the scattering matrix for the i-th sample
                 p11[0] = 0.0;
@@ -301,10 +328,11 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_3B = &e_Bstorage[6];
 
             for (i=D-1; i>=0; i--) {
+                akns_fscatter_get_samples(q, r, r_coeff, i, &qn, &rn);
 
-                akns_fscatter_zero_freq_scatter_matrix(e_1B, eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_2B, 2*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_3B, 3*eps_t/ deg, q[i], r[i]);
+                akns_fscatter_zero_freq_scatter_matrix(e_1B, eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_2B, 2*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_3B, 3*eps_t/ deg, qn, rn);
 
                 // construct the scattering matrix for the i-th sample
                 p11[0] = 0.0;
@@ -337,9 +365,10 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_2B = &e_Bstorage[3];
 
             for (i=D-1; i>=0; i--) {
+                akns_fscatter_get_samples(q, r, r_coeff, i, &qn, &rn);
                 
-                akns_fscatter_zero_freq_scatter_matrix(e_1B, eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_2B, 2*eps_t/ deg, q[i], r[i]);
+                akns_fscatter_zero_freq_scatter_matrix(e_1B, eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_2B, 2*eps_t/ deg, qn, rn);
 
                 // construct the scattering matrix for the i-th sample
                 p11[0] = 2*e_1B[1]*e_1B[2]/3;
@@ -368,9 +397,10 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_4B = &e_Bstorage[3];
             
             for (i=D-1; i>=0; i--) {
+                akns_fscatter_get_samples(q, r, r_coeff, i, &qn, &rn);
                 
-                akns_fscatter_zero_freq_scatter_matrix(e_2B, 2*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_4B, 4*eps_t/ deg, q[i], r[i]);
+                akns_fscatter_zero_freq_scatter_matrix(e_2B, 2*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_4B, 4*eps_t/ deg, qn, rn);
                 
                 // construct the scattering matrix for the i-th sample
                 p11[0] = 0.0;
@@ -407,9 +437,10 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_1B = &e_Bstorage[3];
             
             for (i=D-1; i>=0; i--) {
+                akns_fscatter_get_samples(q, r, r_coeff, i, &qn, &rn);
                 
-                akns_fscatter_zero_freq_scatter_matrix(e_0_5B, 0.5*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_1B, eps_t/ deg, q[i], r[i]);
+                akns_fscatter_zero_freq_scatter_matrix(e_0_5B, 0.5*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_1B, eps_t/ deg, qn, rn);
                 
                 // construct the scattering matrix for the i-th sample
                 p11[0] = (4*e_1B[0]*e_0_5B[1]*e_0_5B[2] - e_1B[1]*e_1B[2])/3;
@@ -445,12 +476,13 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_15B = &e_Bstorage[12];
             
             for (i=D-1; i>=0; i--) {
+                akns_fscatter_get_samples(q, r, r_coeff, i, &qn, &rn);
                 
-                akns_fscatter_zero_freq_scatter_matrix(e_3B, 3*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_5B, 5*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_6B, 6*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_10B, 10*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_15B, 15*eps_t/ deg, q[i], r[i]);
+                akns_fscatter_zero_freq_scatter_matrix(e_3B, 3*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_5B, 5*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_6B, 6*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_10B, 10*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_15B, 15*eps_t/ deg, qn, rn);
                 
                 // construct the scattering matrix for the i-th sample
                 
@@ -498,12 +530,13 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_15B = &e_Bstorage[12];
             
             for (i=D-1; i>=0; i--) {
+                akns_fscatter_get_samples(q, r, r_coeff, i, &qn, &rn);
                 
-                akns_fscatter_zero_freq_scatter_matrix(e_3B, 3*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_5B, 5*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_6B, 6*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_10B, 10*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_15B, 15*eps_t/ deg, q[i], r[i]);
+                akns_fscatter_zero_freq_scatter_matrix(e_3B, 3*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_5B, 5*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_6B, 6*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_10B, 10*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_15B, 15*eps_t/ deg, qn, rn);
                 
                 // construct the scattering matrix for the i-th sample
                 
@@ -549,10 +582,11 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_12B = &e_Bstorage[6];
 
             for (i=D-1; i>=0; i--) {
+                akns_fscatter_get_samples(q, r, r_coeff, i, &qn, &rn);
 
-                akns_fscatter_zero_freq_scatter_matrix(e_4B, 4*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_6B, 6*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_12B, 12*eps_t/ deg, q[i], r[i]);
+                akns_fscatter_zero_freq_scatter_matrix(e_4B, 4*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_6B, 6*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_12B, 12*eps_t/ deg, qn, rn);
 
                 // construct the scattering matrix for the i-th sample
                 //p11
@@ -600,11 +634,12 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_3B = &e_Bstorage[9];
 
             for (i=D-1; i>=0; i--) {
+                akns_fscatter_get_samples(q, r, r_coeff, i, &qn, &rn);
 
-                akns_fscatter_zero_freq_scatter_matrix(e_1B, eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_1_5B, 1.5*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_2B, 2*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_3B, 3*eps_t/ deg, q[i], r[i]);
+                akns_fscatter_zero_freq_scatter_matrix(e_1B, eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_1_5B, 1.5*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_2B, 2*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_3B, 3*eps_t/ deg, qn, rn);
 
                 // construct the scattering matrix for the i-th sample
 
@@ -658,14 +693,15 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_105B = &e_Bstorage[18];
             
             for (i=D-1; i>=0; i--) {
+                akns_fscatter_get_samples(q, r, r_coeff, i, &qn, &rn);
                 
-                akns_fscatter_zero_freq_scatter_matrix(e_15B, 15*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_21B, 21*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_30B, 30*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_35B, 35*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_42B, 42*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_70B, 70*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_105B, 105*eps_t/ deg, q[i], r[i]);
+                akns_fscatter_zero_freq_scatter_matrix(e_15B, 15*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_21B, 21*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_30B, 30*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_35B, 35*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_42B, 42*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_70B, 70*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_105B, 105*eps_t/ deg, qn, rn);
                 
                 // construct the scattering matrix for the i-th sample
                 
@@ -727,14 +763,15 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_105B = &e_Bstorage[18];
             
             for (i=D-1; i>=0; i--) {
+                akns_fscatter_get_samples(q, r, r_coeff, i, &qn, &rn);
                 
-                akns_fscatter_zero_freq_scatter_matrix(e_15B, 15*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_21B, 21*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_30B, 30*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_35B, 35*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_42B, 42*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_70B, 70*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_105B, 105*eps_t/ deg, q[i], r[i]);
+                akns_fscatter_zero_freq_scatter_matrix(e_15B, 15*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_21B, 21*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_30B, 30*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_35B, 35*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_42B, 42*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_70B, 70*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_105B, 105*eps_t/ deg, qn, rn);
                 
                 // construct the scattering matrix for the i-th sample
                 
@@ -793,11 +830,12 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_24B = &e_Bstorage[9];
 
             for (i=D-1; i>=0; i--) {
+                akns_fscatter_get_samples(q, r, r_coeff, i, &qn, &rn);
                 
-                akns_fscatter_zero_freq_scatter_matrix(e_6B, 6*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_8B, 8*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_12B, 12*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_24B, 24*eps_t/ deg, q[i], r[i]);
+                akns_fscatter_zero_freq_scatter_matrix(e_6B, 6*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_8B, 8*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_12B, 12*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_24B, 24*eps_t/ deg, qn, rn);
 
                 // construct the scattering matrix for the i-th sample
  
@@ -859,12 +897,13 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             e_6B = &e_Bstorage[12];
 
             for (i=D-1; i>=0; i--) {
+                akns_fscatter_get_samples(q, r, r_coeff, i, &qn, &rn);
 
-                akns_fscatter_zero_freq_scatter_matrix(e_1_5B, 1.5*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_2B, 2*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_3B, 3*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_4B, 4*eps_t/ deg, q[i], r[i]);
-                akns_fscatter_zero_freq_scatter_matrix(e_6B, 6*eps_t/ deg, q[i], r[i]);
+                akns_fscatter_zero_freq_scatter_matrix(e_1_5B, 1.5*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_2B, 2*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_3B, 3*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_4B, 4*eps_t/ deg, qn, rn);
+                akns_fscatter_zero_freq_scatter_matrix(e_6B, 6*eps_t/ deg, qn, rn);
 
                 // construct the scattering matrix for the i-th sample
                 
@@ -916,11 +955,103 @@ INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r
             ret_code = E_INVALID_ARGUMENT(discretization);
             goto release_mem;
     }
+
+    // Samples with negligible q and r (e.g., in guard intervals) are
+    // replaced by the pure shift diag(1, z^deg) to which all discretizations
+    // reduce for q=r=0. The products with these matrices are computed by
+    // index shifts instead of FFTs in poly_fmult2x2. The threshold ensures
+    // that the neglected off-diagonal entries are below machine precision.
+    p11 = p;
+    p12 = p11 + D*(deg+1);
+    p21 = p12 + D*(deg+1);
+    p22 = p21 + D*(deg+1);
+    for (n=0; n<D; n++) {
+        akns_fscatter_get_samples(q, r, r_coeff, n, &qn, &rn);
+        if (eps_t*CABS(qn) > EPSILON || eps_t*CABS(rn) > EPSILON)
+            continue;
+        const UINT o = (D - 1 - n)*(deg + 1); // sample n is stored reversed
+        for (k=0; k<=deg; k++) {
+            p11[o+k] = 0.0;
+            p12[o+k] = 0.0;
+            p21[o+k] = 0.0;
+            p22[o+k] = 0.0;
+        }
+        p11[o+deg] = 1.0;
+        p22[o] = 1.0;
+    }
+
+    // Check if all coefficients are real (e.g., for real q and r)
+    if (real_flag) {
+        for (n=0; n<4*D*(deg+1); n++) {
+            if (CIMAG(p[n]) != 0.0) {
+                real_flag = 0;
+                break;
+            }
+        }
+    }
+
     // Multiply the individual scattering matrices
-    ret_code = poly_fmult2x2(deg_ptr, D, p, result, W_ptr);
+    if (real_flag)
+        ret_code = poly_fmult2x2_real(deg_ptr, D, p, result, W_ptr);
+    else
+        ret_code = poly_fmult2x2(deg_ptr, D, p, result, W_ptr);
     CHECK_RETCODE(ret_code, release_mem);
 
 release_mem:
     free(p);
     return ret_code;
 }
+
+/**
+ * Fast computation of polynomial approximation of the combined scattering
+ * matrix.
+ */
+INT akns_fscatter(const UINT D, COMPLEX const * const q, COMPLEX const * const r,
+                 const REAL eps_t, COMPLEX * const result, UINT * const deg_ptr,
+                 INT * const W_ptr, akns_discretization_t discretization)
+{
+    sample_desc_t q_desc, r_desc;
+
+    if (q == NULL)
+        return E_INVALID_ARGUMENT(q);
+    if (r == NULL)
+        return E_INVALID_ARGUMENT(r);
+    q_desc = sample_desc_complex(q);
+    r_desc = sample_desc_complex(r);
+    return akns_fscatter_impl(D, &q_desc, &r_desc, 1.0, eps_t, result,
+        deg_ptr, W_ptr, discretization, 0);
+}
+
+/**
+ * Fast computation of polynomial approximation of the combined scattering
+ * matrix for constant r.
+ */
+INT akns_fscatter_const_r(const UINT D, COMPLEX const * const q,
+                 const COMPLEX r, const REAL eps_t, COMPLEX * const result,
+                 UINT * const deg_ptr, INT * const W_ptr,
+                 akns_discretization_t discretization)
+{
+    sample_desc_t q_desc, r_desc;
+
+    if (q == NULL)
+        return E_INVALID_ARGUMENT(q);
+    q_desc = sample_desc_complex(q);
+    r_desc = sample_desc_complex(&r);
+    r_desc.stride = 0;
+    return akns_fscatter_impl(D, &q_desc, &r_desc, 1.0, eps_t, result,
+        deg_ptr, W_ptr, discretization, 1);
+}
+
+/**
+ * Fast computation of polynomial approximation of the combined scattering
+ * matrix for samples described by sample descriptors.
+ */
+INT akns_fscatter_desc(const UINT D, sample_desc_t const * const q,
+                 sample_desc_t const * const r, const COMPLEX r_coeff,
+                 const REAL eps_t, COMPLEX * const result,
+                 UINT * const deg_ptr, INT * const W_ptr,
+                 akns_discretization_t discretization)
+{
+    return akns_fscatter_impl(D, q, r, r_coeff, eps_t, result, deg_ptr,
+        W_ptr, discretization, 0);
+}
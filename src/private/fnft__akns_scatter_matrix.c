@@ -21,6 +21,7 @@
 
 #include "fnft__errwarn.h"
 #include "fnft__akns_scatter.h"
+#include "fnft__sample_desc.h"
 #include <stdio.h>
 
 /**
@@ -35,6 +36,28 @@ INT akns_scatter_matrix(const UINT D, COMPLEX const * const q,
     const UINT K, COMPLEX const * const lambda,
     COMPLEX * const result, akns_discretization_t discretization)
 {
+    sample_desc_t q_desc, r_desc;
+
+    if (q == NULL)
+        return E_INVALID_ARGUMENT(q);
+    if (r == NULL)
+        return E_INVALID_ARGUMENT(r);
+    q_desc = sample_desc_complex(q);
+    r_desc = sample_desc_complex(r);
+    return akns_scatter_matrix_desc(D, &q_desc, &r_desc, 1.0, eps_t, K,
+        lambda, result, discretization);
+}
+
+/**
+ * Same as akns_scatter_matrix, but the samples are read through sample
+ * descriptors. If r is NULL, r[n]=r_coeff*conj(q[n]), and
+ * r[n]=r_coeff*r->data[n] otherwise.
+ */
+INT akns_scatter_matrix_desc(const UINT D, sample_desc_t const * const q,
+    sample_desc_t const * const r, const COMPLEX r_coeff, const REAL eps_t,
+    const UINT K, COMPLEX const * const lambda,
+    COMPLEX * const result, akns_discretization_t discretization)
+{
      
     INT ret_code = SUCCESS;
     UINT  neig;
@@ -45,9 +68,9 @@ INT akns_scatter_matrix(const UINT D, COMPLEX const * const q,
     // Check inputs
     if (D == 0)
         return E_INVALID_ARGUMENT(D);
-    if (q == NULL)
+    if (!sample_desc_valid(q))
         return E_INVALID_ARGUMENT(q);
-    if (r == NULL)
+    if (r != NULL && !sample_desc_valid(r))
         return E_INVALID_ARGUMENT(r);
     if (!(eps_t > 0))
         return E_INVALID_ARGUMENT(eps_t);
@@ -62,6 +85,12 @@ INT akns_scatter_matrix(const UINT D, COMPLEX const * const q,
         
         case akns_discretization_BO: // Bofetta-Osborne scheme
             
+            // The values of lambda are processed independently, so the loop
+            // can be parallelized
+#ifdef _OPENMP
+#pragma omp parallel for if(K > 1) firstprivate(sum) \
+    private(l, qn, rn, ks, k, TM, ch, chi, sh, u1, ud1, ud2, n, c1, c2, c3)
+#endif
             for (neig = 0; neig < K; neig++) { // iterate over lambda
                 l = lambda[neig];
                 
@@ -70,9 +99,12 @@ INT akns_scatter_matrix(const UINT D, COMPLEX const * const q,
                 COMPLEX U[4][4] = {{ 0 }};
                
                 for (n = D-1; n >= 0; n--){
-                    qn = q[n];
-                    rn = r[n];
-                    ks = ((q[n]*r[n])-(l*l));
+                    qn = sample_desc_get(q, n);
+                    if (r == NULL)
+                        rn = r_coeff * CONJ(qn);
+                    else
+                        rn = r_coeff * sample_desc_get(r, n);
+                    ks = ((qn*rn)-(l*l));
                     k = CSQRT(ks);
                     ch = CCOSH(k*eps_t);
                     chi = ch/ks;
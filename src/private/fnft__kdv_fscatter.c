@@ -47,9 +47,7 @@ INT kdv_fscatter(const UINT D, COMPLEX const * const q,
                  INT * const W_ptr, kdv_discretization_t discretization)
 {
     INT ret_code;
-    UINT i;
     fnft__akns_discretization_t akns_discretization;
-    COMPLEX *r = NULL;
     // Check inputs
     if (D == 0)
         return E_INVALID_ARGUMENT(D);
@@ -65,19 +63,10 @@ INT kdv_fscatter(const UINT D, COMPLEX const * const q,
     ret_code = kdv_discretization_to_akns_discretization(discretization, &akns_discretization);
     CHECK_RETCODE(ret_code, leave_fun);   
     
-    
-    r = malloc(D*sizeof(COMPLEX));
-    if (r == NULL) {
-        ret_code = E_NOMEM;
-        goto leave_fun;
-    }
-    
-    for (i = 0; i < D; i++)
-        r[i] = -1;
-    
-    ret_code = akns_fscatter(D, q, r, eps_t, result, deg_ptr, W_ptr, akns_discretization);
+    // The KdV corresponds to r=-1. For real q, the coefficients of all
+    // scattering matrices are real, which akns_fscatter_const_r exploits.
+    ret_code = akns_fscatter_const_r(D, q, -1.0, eps_t, result, deg_ptr, W_ptr, akns_discretization);
 
 leave_fun:
-    free(r);
     return ret_code;
 }
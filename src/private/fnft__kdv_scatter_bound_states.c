@@ -0,0 +1,160 @@
+/*
+* This file is part of FNFT.  
+*                                                                  
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*                                                                      
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* Sander Wahls (TU Delft) 2017-2018.
+* Shrinivas Chimmalgi (TU Delft) 2017-2018.
+*/
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include "fnft__errwarn.h"
+#include "fnft__kdv_scatter.h"
+
+/**
+ * Returns a, a_prime and b computed using the chosen scheme. The signal is
+ * split into a left and a right part, whose scattering matrices are
+ * computed with kdv_scatter_matrix. See the header file for details.
+ */
+INT kdv_scatter_bound_states(const UINT D, COMPLEX const * const q,
+    REAL const * const T, UINT * const trunc_index_ptr, const UINT K,
+    COMPLEX const * const bound_states, COMPLEX * const a_vals,
+    COMPLEX * const aprime_vals, COMPLEX * const b,
+    kdv_discretization_t discretization)
+{
+    COMPLEX *SL = NULL, *SR;
+    COMPLEX l, S11, S12, S11p, S12p, v1, v2, w1, w2, nrm;
+    REAL norm_left, norm_right;
+    UINT i0, i1, neig;
+    INT ret_code = SUCCESS;
+
+    // Check inputs
+    if (D < 2)
+        return E_INVALID_ARGUMENT(D);
+    if (q == NULL)
+        return E_INVALID_ARGUMENT(q);
+    if (T == NULL || T[0] >= T[1])
+        return E_INVALID_ARGUMENT(T);
+    if (trunc_index_ptr == NULL || *trunc_index_ptr > D)
+        return E_INVALID_ARGUMENT(trunc_index_ptr);
+    if (K == 0)
+        return E_INVALID_ARGUMENT(K);
+    if (bound_states == NULL)
+        return E_INVALID_ARGUMENT(bound_states);
+    if (a_vals == NULL)
+        return E_INVALID_ARGUMENT(a_vals);
+    if (aprime_vals == NULL)
+        return E_INVALID_ARGUMENT(aprime_vals);
+    if (b == NULL)
+        return E_INVALID_ARGUMENT(b);
+    for (neig = 0; neig < K; neig++) {
+        if (bound_states[neig] == 0.0)
+            return E_INVALID_ARGUMENT(bound_states);
+    }
+
+    const REAL eps_t = (T[1] - T[0])/(D - 1);
+
+    if (*trunc_index_ptr == D) {
+        // Heuristic for where to split the potential: Find the point where
+        // the L1 norm of the left half is equal to that of the right half
+        i0 = 0;
+        i1 = D-1;
+        norm_left = 0.0;
+        norm_right = 0.0;
+        while (i0 < i1) {
+            if (norm_left < norm_right) {
+                i0++;
+                norm_left += eps_t*CABS(q[i0]);
+            } else {
+                i1--;
+                norm_right += eps_t*CABS(q[i1]);
+            }
+        }
+        *trunc_index_ptr = i0;
+    } else {
+        i0 = *trunc_index_ptr;
+    }
+    if (i0 >= D)
+        i0 = D - 1; // the right part must not be empty
+
+    // Allocate memory for the scattering matrices [S11 S12 S21 S22 S11'
+    // S12' S21' S22'] of the left part q[0],...,q[i0-1] and of the right
+    // part q[i0],...,q[D-1]
+    SL = malloc(16*K * sizeof(COMPLEX));
+    if (SL == NULL)
+        return E_NOMEM;
+    SR = SL + 8*K;
+
+    if (i0 > 0) {
+        ret_code = kdv_scatter_matrix(i0, q, eps_t, K, bound_states, SL,
+            discretization);
+        CHECK_RETCODE(ret_code, release_mem);
+    } else {
+        for (neig = 0; neig < K; neig++) {
+            SL[8*neig] = 1.0;
+            SL[8*neig + 1] = 0.0;
+            SL[8*neig + 2] = 0.0;
+            SL[8*neig + 3] = 1.0;
+            SL[8*neig + 4] = 0.0;
+            SL[8*neig + 5] = 0.0;
+            SL[8*neig + 6] = 0.0;
+            SL[8*neig + 7] = 0.0;
+        }
+    }
+    ret_code = kdv_scatter_matrix(D - i0, q + i0, eps_t, K, bound_states, SR,
+        discretization);
+    CHECK_RETCODE(ret_code, release_mem);
+
+    // The scattering matrices cover [T[0]-eps_t/2, T[1]+eps_t/2]
+    const REAL t0 = T[0] - eps_t/2;
+    const REAL t1 = T[1] + eps_t/2;
+
+    for (neig = 0; neig < K; neig++) {
+        COMPLEX const * const L = SL + 8*neig;
+        COMPLEX const * const R = SR + 8*neig;
+        l = bound_states[neig];
+
+        // Entries in the first row of S=R*L and of its derivative
+        S11 = R[0]*L[0] + R[1]*L[2];
+        S12 = R[0]*L[1] + R[1]*L[3];
+        S11p = R[4]*L[0] + R[5]*L[2] + R[0]*L[4] + R[1]*L[6];
+        S12p = R[4]*L[1] + R[5]*L[3] + R[0]*L[5] + R[1]*L[7];
+
+        // The Jost solution that behaves like exp(-j*l*t) for t->-infinity
+        // is [2*j*l; 1]*exp(-j*l*t) for vanishing q. For t->+infinity, it
+        // becomes a(l)*[2*j*l; 1]*exp(-j*l*t)+b(l)*[0; 1]*exp(j*l*t).
+        a_vals[neig] = (S11 + S12/(2.0*I*l)) * CEXP(I*l*(t1 - t0));
+        aprime_vals[neig] = (I*(t1 - t0)*(S11 + S12/(2.0*I*l)) + S11p
+            + S12p/(2.0*I*l) - S12/(2.0*I*l*l)) * CEXP(I*l*(t1 - t0));
+
+        // b(l) is the ratio of the Jost solution from the left, v, and the
+        // one from the right, w, at the split point, which is less affected
+        // by the exponential growth of the solutions than evaluating the
+        // full scattering matrix (forward-backward scheme)
+        v1 = (2.0*I*l*L[0] + L[1]) * CEXP(-I*l*t0);
+        v2 = (2.0*I*l*L[2] + L[3]) * CEXP(-I*l*t0);
+        w1 = -R[1] * CEXP(I*l*t1);
+        w2 = R[0] * CEXP(I*l*t1);
+        nrm = CONJ(w1)*w1 + CONJ(w2)*w2;
+        if (nrm == 0.0) {
+            ret_code = E_DIV_BY_ZERO;
+            goto release_mem;
+        }
+        b[neig] = (CONJ(w1)*v1 + CONJ(w2)*v2) / nrm;
+    }
+
+release_mem:
+    free(SL);
+    return ret_code;
+}
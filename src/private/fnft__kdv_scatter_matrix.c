@@ -21,6 +21,7 @@
 
 #include "fnft__errwarn.h"
 #include "fnft__kdv_scatter.h"
+#include "fnft__sample_desc.h"
 #include <stdio.h>
 
 /**
@@ -37,9 +38,9 @@ INT kdv_scatter_matrix(const UINT D, COMPLEX const * const q,
 {
      
     INT ret_code = SUCCESS;
-    UINT i;
     akns_discretization_t akns_discretization;
-    COMPLEX *r = NULL;
+    const COMPLEX r = -1.0;
+    sample_desc_t q_desc, r_desc;
     
     // Check inputs
     if (D == 0)
@@ -59,19 +60,13 @@ INT kdv_scatter_matrix(const UINT D, COMPLEX const * const q,
     CHECK_RETCODE(ret_code, leave_fun);   
     
     
-    r = malloc(D*sizeof(COMPLEX));
-    if (r == NULL) {
-        ret_code = E_NOMEM;
-        goto leave_fun;
-    }
-    
-    for (i = 0; i < D; i++)
-        r[i] = -1;
-
-    
-    ret_code = akns_scatter_matrix(D, q, r, eps_t, K, lambda, result, akns_discretization);
+    // The constant r=-1 is read with stride zero
+    q_desc = sample_desc_complex(q);
+    r_desc = sample_desc_complex(&r);
+    r_desc.stride = 0;
+    ret_code = akns_scatter_matrix_desc(D, &q_desc, &r_desc, 1.0, eps_t, K,
+        lambda, result, akns_discretization);
 
 leave_fun:
-    free(r);
     return ret_code;
 }
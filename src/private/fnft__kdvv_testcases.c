@@ -41,10 +41,6 @@ INT fnft__kdvv_testcases(kdvv_testcases_t tc, const UINT D,
     
     // Avoid not used warnings. Not yet used, but will be in the future.
     (void) ab_ptr;
-    (void) K_ptr;
-    (void) bound_states_ptr;
-    (void) normconsts_ptr;
-    (void) residues_ptr;
 
     // Check inputs
     if (D < 2)
@@ -57,15 +53,32 @@ INT fnft__kdvv_testcases(kdvv_testcases_t tc, const UINT D,
         return E_INVALID_ARGUMENT(M_ptr);
     if (contspec_ptr == NULL)
         return E_INVALID_ARGUMENT(contspec_ptr);
+    if (K_ptr == NULL)
+        return E_INVALID_ARGUMENT(K_ptr);
+    if (bound_states_ptr == NULL)
+        return E_INVALID_ARGUMENT(bound_states_ptr);
+    if (normconsts_ptr == NULL)
+        return E_INVALID_ARGUMENT(normconsts_ptr);
+    if (residues_ptr == NULL)
+        return E_INVALID_ARGUMENT(residues_ptr);
 
     // Set the number of points in the continuous spectrum *M_ptr and the
     // number of bound states *K_ptr (needed for proper allocation)
     switch (tc) {
 
     case kdvv_testcases_SECH:
+        *M_ptr = 16;
+        *K_ptr = 2;
+        break;
+
     case kdvv_testcases_RECT:
+        *M_ptr = 16;
+        *K_ptr = 1;
+        break;
+
     case kdvv_testcases_NEGATIVE_RECT:
         *M_ptr = 16;
+        *K_ptr = 0;
         break;
 
     default:
@@ -83,6 +96,27 @@ INT fnft__kdvv_testcases(kdvv_testcases_t tc, const UINT D,
         ret_code = E_NOMEM;
         goto release_mem_2;
     }
+    if (*K_ptr > 0) {
+        *bound_states_ptr = malloc((*K_ptr) * sizeof(COMPLEX));
+        if (*bound_states_ptr == NULL) {
+            ret_code = E_NOMEM;
+            goto release_mem_3;
+        }
+        *normconsts_ptr = malloc((*K_ptr) * sizeof(COMPLEX));
+        if (*normconsts_ptr == NULL) {
+            ret_code = E_NOMEM;
+            goto release_mem_4;
+        }
+        *residues_ptr = malloc((*K_ptr) * sizeof(COMPLEX));
+        if (*residues_ptr == NULL) {
+            ret_code = E_NOMEM;
+            goto release_mem_5;
+        }
+    } else {
+        *bound_states_ptr = NULL;
+        *normconsts_ptr = NULL;
+        *residues_ptr = NULL;
+    }
 
     // generate test case
     switch (tc) {
@@ -138,6 +172,25 @@ INT fnft__kdvv_testcases(kdvv_testcases_t tc, const UINT D,
         (*contspec_ptr)[14] =  0.00002748286948200803407581026489337631688606 - 0.00002228910643157474631983979506634092581568*I;
         (*contspec_ptr)[15] =0.000005195158073745829592578906521934403128604 - 0.000005207592023284621408556242469680129799988*I;
 
+        // The bound states are j*(s-n), where s=(sqrt(1+4*A)-1)/2, A=3.2,
+        // and n=0,1,... is such that s-n>0. Since the potential is even, the
+        // norming constants are (-1)^n. The residues have been computed with
+        // the following MATLAB code.
+        /*
+        s = (sqrt(1 + 4*sym(16)/5) - 1)/2;
+        n = sym(0:1);
+        res = 1j*gamma(1+2*s-n) ./ (factorial(n).*gamma(s-n).*gamma(1+s-n));
+        digits(40);
+        bound_states_exact = vpa(1j*(s-n)).'
+        residues_exact = vpa(res).'
+        */
+        (*bound_states_ptr)[0] = 1.357417562100671*I;
+        (*bound_states_ptr)[1] = 0.357417562100671*I;
+        (*normconsts_ptr)[0] = 1.0;
+        (*normconsts_ptr)[1] = -1.0;
+        (*residues_ptr)[0] = 3.943032222028475*I;
+        (*residues_ptr)[1] = 0.7046544820409046*I;
+
         break;
     case kdvv_testcases_RECT:
         
@@ -203,6 +256,23 @@ INT fnft__kdvv_testcases(kdvv_testcases_t tc, const UINT D,
         (*contspec_ptr)[13] = - 0.07904675065447655160606575367154906844081 + 0.2208632106193342065286853347418631953582*I;
         (*contspec_ptr)[14] = - 0.06579630203367370114917406544589095133598 + 0.1969199678363887603437522689507922888574*I;
         (*contspec_ptr)[15] = - 0.05487470411329939736278578609268675453902 + 0.1750134338640520324045894423655821274481*I;
+
+        // The only bound state is j*kappa, where kappa is the root of
+        // a(j*kappa) = exp(-2*kappa*ell)*(cos(2*k*ell) + (kappa/k-k/kappa)/2
+        // *sin(2*k*ell)), k=sqrt(ampl-kappa^2), in (0,1). Since the potential
+        // is even, the norming constant is one. The residue is 1/a'(j*kappa).
+        /*
+         syms x
+         k = sqrt(ampl - x^2);
+         f = exp(-2*x*ell)*(cos(2*k*ell) + (x/k-k/x)/2*sin(2*k*ell));
+         kappa = vpasolve(f, x, [0 1]);
+         res = 1/(-1i*subs(diff(f, x), x, kappa));
+         bound_states_exact = vpa(1i*kappa)
+         residues_exact = vpa(res)
+         */
+        (*bound_states_ptr)[0] = 0.43513085903670945*I;
+        (*normconsts_ptr)[0] = 1.0;
+        (*residues_ptr)[0] = 0.4476533709132368*I;
        
         break;
         case kdvv_testcases_NEGATIVE_RECT:
@@ -281,6 +351,11 @@ INT fnft__kdvv_testcases(kdvv_testcases_t tc, const UINT D,
 
     // the code below is only executed if an error occurs
 
+release_mem_5:
+    free(*normconsts_ptr);
+release_mem_4:
+    free(*bound_states_ptr);
+release_mem_3:
 release_mem_2:
     free(*contspec_ptr);
 release_mem_1:
@@ -289,23 +364,85 @@ release_mem_1:
     return ret_code;
 }
 
+// Compares computed with exact discrete spectrum. The norming constants and
+// residues are matched via the closest exact bound states.
+static INT kdvv_compare_discspec(const UINT K1, const UINT K2,
+    COMPLEX const * const bound_states_1,
+    COMPLEX const * const bound_states_2,
+    COMPLEX const * const normconsts_1,
+    COMPLEX const * const normconsts_2,
+    COMPLEX const * const residues_1,
+    COMPLEX const * const residues_2,
+    REAL dists[3])
+{
+    UINT i, j, min_j;
+    REAL dist, min_dist, nrm[2];
+
+    if (K1 == 0 && K2 == 0) {
+        dists[0] = 0.0;
+        dists[1] = 0.0;
+        dists[2] = 0.0;
+        return SUCCESS;
+    }
+    if (K1 == 0 || K2 == 0) {
+        dists[0] = NAN;
+        dists[1] = NAN;
+        dists[2] = NAN;
+        return SUCCESS;
+    }
+
+    dists[0] = misc_hausdorff_dist(K1, bound_states_1, K2, bound_states_2);
+    dists[1] = 0.0;
+    dists[2] = 0.0;
+    nrm[0] = 0.0;
+    nrm[1] = 0.0;
+    for (i=0; i<K1; i++) {
+        min_j = 0;
+        min_dist = INFINITY;
+        for (j=0; j<K2; j++) {
+            dist = CABS(bound_states_1[i] - bound_states_2[j]);
+            if (dist < min_dist) {
+                min_dist = dist;
+                min_j = j;
+            }
+        }
+        dists[1] += CABS(normconsts_1[i] - normconsts_2[min_j]);
+        nrm[0] += CABS(normconsts_2[min_j]);
+        dists[2] += CABS(residues_1[i] - residues_2[min_j]);
+        nrm[1] += CABS(residues_2[min_j]);
+    }
+    if (nrm[0] > 0)
+        dists[1] /= nrm[0];
+    if (nrm[1] > 0)
+        dists[2] /= nrm[1];
+
+    return SUCCESS;
+}
+
 INT kdvv_testcases_test_fnft(kdvv_testcases_t tc, UINT D,
     const REAL eb[6], fnft_kdvv_opts_t * const opts) {
     COMPLEX * q = NULL;
     COMPLEX * contspec = NULL;
+    COMPLEX * bound_states = NULL;
+    COMPLEX * normconsts_and_residues = NULL;
     REAL T[2], XI[2];
     COMPLEX * contspec_exact = NULL;
     COMPLEX * ab_exact = NULL;
     COMPLEX * bound_states_exact = NULL;
     COMPLEX * normconsts_exact = NULL;
     COMPLEX * residues_exact = NULL;
-    UINT M, K;
+    UINT M, K, K_exact;
+    UINT * K_ptr = NULL;
     REAL errs[6];
     INT ret_code;
 
+    // Check inputs
+    if (opts == NULL)
+        return E_INVALID_ARGUMENT(opts);
+
     // Load test case
     ret_code = kdvv_testcases(tc, D, &q, T, &M, &contspec_exact, &ab_exact,
-        XI, &K, &bound_states_exact, &normconsts_exact, &residues_exact);
+        XI, &K_exact, &bound_states_exact, &normconsts_exact, &residues_exact);
     CHECK_RETCODE(ret_code, release_mem);
  
     // Allocate memory
@@ -315,16 +452,42 @@ INT kdvv_testcases_test_fnft(kdvv_testcases_t tc, UINT D,
         goto release_mem;
     }
 
+    // The discrete spectrum is only computed if at least one of the
+    // corresponding error bounds is finite
+    if (eb[3] < FNFT_INF || eb[4] < FNFT_INF || eb[5] < FNFT_INF) {
+        K = D;
+        K_ptr = &K;
+        bound_states = malloc(K * sizeof(COMPLEX));
+        normconsts_and_residues = malloc(2*K * sizeof(COMPLEX));
+        if (bound_states == NULL || normconsts_and_residues == NULL) {
+            ret_code = E_NOMEM;
+            goto release_mem;
+        }
+        opts->discspec_type = kdvv_dstype_BOTH;
+    }
+
     // Compute the NFT
-    ret_code = fnft_kdvv(D, q, T, M, contspec, XI, NULL, NULL, NULL, opts);
+    ret_code = fnft_kdvv(D, q, T, M, contspec, XI, K_ptr, bound_states,
+        normconsts_and_residues, opts);
     CHECK_RETCODE(ret_code, release_mem);
 
-    // Compute the error(s). So far, only the error in the continuous spectrum
-    // is computed.
+    // Compute the error(s). The errors in a(xi) and b(xi) are not yet
+    // computed.
     errs[0] = misc_rel_err(M, contspec, contspec_exact);
     for (UINT i=1; i<6; i++)
         errs[i] = FNFT_INF;
+    if (K_ptr != NULL) {
+        ret_code = kdvv_compare_discspec(K, K_exact, bound_states,
+            bound_states_exact, normconsts_and_residues, normconsts_exact,
+            normconsts_and_residues + K, residues_exact, errs + 3);
+        CHECK_RETCODE(ret_code, release_mem);
+    }
     printf("kdvv_testcases_test_fnft: %2.1e <= %2.1e\n", errs[0], eb[0]);
+    if (K_ptr != NULL) {
+        for (UINT i=3; i<6; i++)
+            printf("kdvv_testcases_test_fnft: %2.1e <= %2.1e\n", errs[i],
+                eb[i]);
+    }
     //print_buf2(M, contspec, "contspec_test");
     //print_buf2(M, contspec_exact, "contspec_exact");
 
@@ -362,6 +525,11 @@ release_mem:
     free(q);
     free(contspec);
     free(contspec_exact);
+    free(bound_states);
+    free(normconsts_and_residues);
+    free(bound_states_exact);
+    free(normconsts_exact);
+    free(residues_exact);
 
     return ret_code;
 }
@@ -21,6 +21,7 @@
 
 #include "fnft__errwarn.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include "fnft__misc.h"
 
 void misc_print_buf(const INT len, COMPLEX const * const buf,
@@ -48,7 +49,9 @@ REAL misc_rel_err(const INT len, COMPLEX const * const vec_numer,
     return n/d;
 }
 
-REAL misc_hausdorff_dist(const UINT lenA,
+// Auxiliary function: Straight-forward O(lenA*lenB) computation of the
+// Hausdorff distance.
+static REAL hausdorff_dist_direct(const UINT lenA,
     COMPLEX const * const vecA, const UINT lenB,
     COMPLEX const * const vecB)
 {
@@ -80,6 +83,146 @@ REAL misc_hausdorff_dist(const UINT lenA,
     return max_dist;
 }
 
+// Auxiliary function: Computes the directed Hausdorff distance
+// max_i min_j |vecA[i]-vecB[j]| using a uniform grid of about lenB cells
+// that covers the bounding box of vecB. The points in vecB are sorted into
+// the cells using counting sort. For each point in vecA, the cells are then
+// visited in rings of increasing distance around the cell that is closest
+// to the point, until the remaining rings cannot contain closer points.
+// The search also stops once the distance drops below the maximum found so
+// far, since the point cannot increase the maximum anymore. All values
+// have to be finite. Returns NAN if the memory allocation fails.
+static REAL hausdorff_dist_directed_grid(const UINT lenA,
+    COMPLEX const * const vecA, const UINT lenB,
+    COMPLEX const * const vecB)
+{
+    REAL x0, x1, y0, y1, h, qx, qy, dist, best, max_dist = -1.0;
+    UINT *cell_start = NULL, *order = NULL;
+    UINT i, j, k, gx, gy, cx, cy, r, r_max, ix, iy, ix_lo, ix_hi, iy_lo, iy_hi;
+
+    // Bounding box of vecB
+    x0 = x1 = CREAL(vecB[0]);
+    y0 = y1 = CIMAG(vecB[0]);
+    for (j=1; j<lenB; j++) {
+        if (CREAL(vecB[j]) < x0) x0 = CREAL(vecB[j]);
+        if (CREAL(vecB[j]) > x1) x1 = CREAL(vecB[j]);
+        if (CIMAG(vecB[j]) < y0) y0 = CIMAG(vecB[j]);
+        if (CIMAG(vecB[j]) > y1) y1 = CIMAG(vecB[j]);
+    }
+
+    // Cell size. The second term takes care of (almost) collinear points.
+    h = SQRT((x1 - x0)*(y1 - y0)/lenB);
+    if ((x1 - x0)/lenB > h)
+        h = (x1 - x0)/lenB;
+    if ((y1 - y0)/lenB > h)
+        h = (y1 - y0)/lenB;
+    if (!(h > 0.0))
+        h = 1.0;
+    gx = (UINT)((x1 - x0)/h) + 1;
+    gy = (UINT)((y1 - y0)/h) + 1;
+
+    // Sort vecB into the cells
+    cell_start = calloc(gx*gy + 1, sizeof(UINT));
+    order = malloc(lenB * sizeof(UINT));
+    if (cell_start == NULL || order == NULL) {
+        max_dist = NAN;
+        goto release_mem;
+    }
+    for (j=0; j<lenB; j++) {
+        ix = (UINT)((CREAL(vecB[j]) - x0)/h);
+        iy = (UINT)((CIMAG(vecB[j]) - y0)/h);
+        if (ix >= gx) ix = gx - 1;
+        if (iy >= gy) iy = gy - 1;
+        cell_start[iy*gx + ix + 1]++;
+    }
+    for (k=0; k<gx*gy; k++)
+        cell_start[k+1] += cell_start[k];
+    for (j=0; j<lenB; j++) {
+        ix = (UINT)((CREAL(vecB[j]) - x0)/h);
+        iy = (UINT)((CIMAG(vecB[j]) - y0)/h);
+        if (ix >= gx) ix = gx - 1;
+        if (iy >= gy) iy = gy - 1;
+        order[cell_start[iy*gx + ix]++] = j;
+    }
+    for (k=gx*gy; k>0; k--)
+        cell_start[k] = cell_start[k-1];
+    cell_start[0] = 0;
+
+    r_max = (gx > gy) ? gx : gy;
+    for (i=0; i<lenA; i++) {
+
+        // Cell that is closest to the point. Distances to the projection
+        // of the point onto the bounding box are lower bounds.
+        qx = CREAL(vecA[i]);
+        qy = CIMAG(vecA[i]);
+        qx = (qx < x0) ? x0 : ((qx > x1) ? x1 : qx);
+        qy = (qy < y0) ? y0 : ((qy > y1) ? y1 : qy);
+        cx = (UINT)((qx - x0)/h);
+        cy = (UINT)((qy - y0)/h);
+        if (cx >= gx) cx = gx - 1;
+        if (cy >= gy) cy = gy - 1;
+
+        best = INFINITY;
+        for (r=0; r<=r_max; r++) {
+            ix_lo = (cx >= r) ? cx - r : 0;
+            ix_hi = (cx + r < gx) ? cx + r : gx - 1;
+            iy_lo = (cy >= r) ? cy - r : 0;
+            iy_hi = (cy + r < gy) ? cy + r : gy - 1;
+            for (iy=iy_lo; iy<=iy_hi; iy++) {
+                for (ix=ix_lo; ix<=ix_hi; ix++) {
+                    // Only visit the cells on the boundary of the ring
+                    if (ix + r != cx && ix != cx + r && iy + r != cy
+                        && iy != cy + r)
+                        continue;
+                    k = iy*gx + ix;
+                    for (j=cell_start[k]; j<cell_start[k+1]; j++) {
+                        dist = CABS(vecA[i] - vecB[order[j]]);
+                        if (dist < best)
+                            best = dist;
+                    }
+                }
+            }
+            // Points in the following rings are at least r*h away
+            if (best <= r*h || best <= max_dist)
+                break;
+        }
+        if (best > max_dist)
+            max_dist = best;
+    }
+
+release_mem:
+    free(cell_start);
+    free(order);
+    return max_dist;
+}
+
+REAL misc_hausdorff_dist(const UINT lenA,
+    COMPLEX const * const vecA, const UINT lenB,
+    COMPLEX const * const vecB)
+{
+    REAL dist_AB, dist_BA;
+    UINT i;
+
+    // Use the direct approach for small problems and if there are
+    // non-finite values (which it treats correctly)
+    if (lenA == 0 || lenB == 0 || lenA*lenB <= 1024)
+        return hausdorff_dist_direct(lenA, vecA, lenB, vecB);
+    for (i=0; i<lenA; i++) {
+        if (!isfinite(CREAL(vecA[i])) || !isfinite(CIMAG(vecA[i])))
+            return hausdorff_dist_direct(lenA, vecA, lenB, vecB);
+    }
+    for (i=0; i<lenB; i++) {
+        if (!isfinite(CREAL(vecB[i])) || !isfinite(CIMAG(vecB[i])))
+            return hausdorff_dist_direct(lenA, vecA, lenB, vecB);
+    }
+
+    dist_AB = hausdorff_dist_directed_grid(lenA, vecA, lenB, vecB);
+    dist_BA = hausdorff_dist_directed_grid(lenB, vecB, lenA, vecA);
+    if (isnan(dist_AB) || isnan(dist_BA)) // out of memory
+        return hausdorff_dist_direct(lenA, vecA, lenB, vecB);
+    return (dist_AB > dist_BA) ? dist_AB : dist_BA;
+}
+
 COMPLEX misc_sech(COMPLEX Z)
 {
     return 2.0 / (CEXP(Z) + CEXP(-Z));
@@ -223,10 +366,116 @@ INT misc_filter_nonreal(UINT *N_ptr, COMPLEX * const vals, const REAL tol_im)
     return SUCCESS;
 }
 
+// Auxiliary data structure for misc_merge and misc_filter_merge: Hash
+// table that maps the cells of a uniform grid with cell size tol to lists
+// of the values in vals that lie in the cell and have been kept. Since
+// values that are closer than tol lie in the same or in neighboring cells,
+// it suffices to check 3x3 cells for each new value.
+typedef struct {
+    int64_t *keys;  // 2 keys (cell coordinates) per slot
+    UINT *head;     // first value in each slot, or N if the slot is empty
+    UINT *next;     // next value in the same cell, or N
+    UINT mask;      // number of slots minus one (a power of two)
+    UINT N;
+    COMPLEX const *vals;
+    REAL tol;
+} merge_grid_t;
+
+// Cell coordinates larger than this are not hashed
+#define MERGE_GRID_MAX_COORD 4.0e18
+
+static INT merge_grid_init(merge_grid_t * const grid, const UINT N,
+    COMPLEX const * const vals, const REAL tol)
+{
+    UINT k, slots = 2;
+
+    while (slots < 2*N)
+        slots *= 2;
+    grid->keys = malloc(2*slots * sizeof(int64_t));
+    grid->head = malloc(slots * sizeof(UINT));
+    grid->next = malloc(N * sizeof(UINT));
+    if (grid->keys == NULL || grid->head == NULL || grid->next == NULL)
+        return E_NOMEM;
+    for (k=0; k<slots; k++)
+        grid->head[k] = N;
+    grid->mask = slots - 1;
+    grid->N = N;
+    grid->vals = vals;
+    grid->tol = tol;
+    return SUCCESS;
+}
+
+static void merge_grid_free(merge_grid_t * const grid)
+{
+    free(grid->keys);
+    free(grid->head);
+    free(grid->next);
+}
+
+// Computes the cell coordinates of val. Returns 0 if the value cannot be
+// hashed (non-finite values, huge values, tol=0).
+static inline INT merge_grid_cell(merge_grid_t const * const grid,
+    const COMPLEX val, int64_t * const cx, int64_t * const cy)
+{
+    const REAL x = FLOOR(CREAL(val) / grid->tol);
+    const REAL y = FLOOR(CIMAG(val) / grid->tol);
+    if (!(FABS(x) < MERGE_GRID_MAX_COORD) || !(FABS(y) < MERGE_GRID_MAX_COORD))
+        return 0;
+    *cx = (int64_t)x;
+    *cy = (int64_t)y;
+    return 1;
+}
+
+// Returns the slot of the cell (cx,cy). If the cell is not in the table,
+// the empty slot in which it would be stored is returned.
+static inline UINT merge_grid_slot(merge_grid_t const * const grid,
+    const int64_t cx, const int64_t cy)
+{
+    UINT k = (UINT)(((uint64_t)cx*UINT64_C(0x9E3779B97F4A7C15))
+        ^ ((uint64_t)cy*UINT64_C(0xC2B2AE3D27D4EB4F))) & grid->mask;
+    while (grid->head[k] != grid->N
+        && (grid->keys[2*k] != cx || grid->keys[2*k+1] != cy))
+        k = (k + 1) & grid->mask;
+    return k;
+}
+
+// Checks whether val is closer than tol to a value in the table. If not,
+// the value with index idx (i.e., vals[idx]=val) is added to the table and
+// 1 is returned. Otherwise, 0 is returned.
+static inline INT merge_grid_add_if_new(merge_grid_t * const grid,
+    const COMPLEX val, const UINT idx)
+{
+    int64_t cx, cy, dx, dy;
+    UINT k, j;
+
+    if (!merge_grid_cell(grid, val, &cx, &cy))
+        return 1;
+
+    for (dx=-1; dx<=1; dx++) {
+        for (dy=-1; dy<=1; dy++) {
+            k = merge_grid_slot(grid, cx + dx, cy + dy);
+            for (j=grid->head[k]; j!=grid->N; j=grid->next[j]) {
+                if (CABS(grid->vals[j] - val) < grid->tol)
+                    return 0;
+            }
+        }
+    }
+
+    k = merge_grid_slot(grid, cx, cy);
+    if (grid->head[k] == grid->N) {
+        grid->keys[2*k] = cx;
+        grid->keys[2*k+1] = cy;
+    }
+    grid->next[idx] = grid->head[k];
+    grid->head[k] = idx;
+    return 1;
+}
+
 INT misc_merge(UINT *N_ptr, COMPLEX * const vals, REAL tol)
 {
-    REAL dist = -1.0;
-    UINT i, j, N, N_filtered;
+    merge_grid_t grid = { 0 };
+    UINT i, N, N_filtered;
+    INT ret_code = SUCCESS;
 
     if (N_ptr == NULL)
         return E_INVALID_ARGUMENT(N_ptr);
@@ -238,22 +487,75 @@ INT misc_merge(UINT *N_ptr, COMPLEX * const vals, REAL tol)
         return E_INVALID_ARGUMENT(tol);
 
     N = *N_ptr;
-    N_filtered = 1;
-    for (i=1; i<N; i++) {
-        for (j = 0; j < i; j++) {
-            dist = CABS(vals[j] - vals[i]);
-            if (dist < tol)
-                break;
-        }
-        if (dist < tol)
+    ret_code = merge_grid_init(&grid, N, vals, tol);
+    CHECK_RETCODE(ret_code, release_mem);
+
+    N_filtered = 0;
+    for (i=0; i<N; i++) {
+        // Keep value if it is not close to previously kept values
+        if (merge_grid_add_if_new(&grid, vals[i], N_filtered))
+            vals[N_filtered++] = vals[i];
+    }
+    *N_ptr = N_filtered;
+
+release_mem:
+    merge_grid_free(&grid);
+    return ret_code;
+}
+
+INT misc_filter_merge(UINT * const N_ptr, COMPLEX * const vals,
+    REAL const * const bounding_box, const REAL tol, const COMPLEX log_coeff)
+{
+    merge_grid_t grid = { 0 };
+    UINT i, N, N_filtered;
+    COMPLEX val;
+    INT ret_code = SUCCESS;
+
+    if (N_ptr == NULL)
+        return E_INVALID_ARGUMENT(N_ptr);
+    if (*N_ptr == 0)
+        return SUCCESS;
+    if (vals == NULL)
+        return E_INVALID_ARGUMENT(vals);
+    if (bounding_box == NULL)
+        return E_INVALID_ARGUMENT(bounding_box);
+    if ( !(bounding_box[0] <= bounding_box[1]) //!(...) ensures error with NANs
+        || !(bounding_box[2] <= bounding_box[3]) )
+        return E_INVALID_ARGUMENT(bounding_box);
+    if (!(tol >= 0.0))
+        return E_INVALID_ARGUMENT(tol);
+
+    N = *N_ptr;
+    ret_code = merge_grid_init(&grid, N, vals, tol);
+    CHECK_RETCODE(ret_code, release_mem);
+
+    N_filtered = 0;
+    for (i=0; i<N; i++) {
+
+        // Coordinate transform
+        val = vals[i];
+        if (log_coeff != 0.0)
+            val = log_coeff * CLOG(val);
+
+        // Skip values outside of the bounding box (including NANs)
+        if (! (CREAL(val) >= bounding_box[0]) )
+            continue;
+        if (! (CREAL(val) <= bounding_box[1]) )
+            continue;
+        if (! (CIMAG(val) >= bounding_box[2]) )
+            continue;
+        if (! (CIMAG(val) <= bounding_box[3]) )
             continue;
 
-        // Keep bound value since it is not close to previous values
-        vals[N_filtered++] = vals[i];
+        // Keep value if it is not close to previously kept values
+        if (merge_grid_add_if_new(&grid, val, N_filtered))
+            vals[N_filtered++] = val;
     }
     *N_ptr = N_filtered;
 
-    return SUCCESS;
+release_mem:
+    merge_grid_free(&grid);
+    return ret_code;
 }
 
 INT misc_downsample(const UINT D, COMPLEX const * const q,
@@ -40,6 +40,23 @@ UINT fnft__nse_discretization_degree(nse_discretization_t
 }
 
 
+/**
+ * Returns the order of accuracy of the discretization or zero if the
+ * discretization is unknown.
+ */
+UINT fnft__nse_discretization_order(nse_discretization_t
+        nse_discretization)
+{
+    akns_discretization_t akns_discretization = 0;
+    INT ret_code;
+    UINT order = 0;
+    ret_code = nse_discretization_to_akns_discretization(nse_discretization, &akns_discretization);
+    CHECK_RETCODE(ret_code, leave_fun);
+    order = akns_discretization_order(akns_discretization);
+    leave_fun:
+        return order;
+}
+
 /**
  * This routine returns the boundary coefficient based on the discretization.
  */
@@ -27,6 +27,7 @@
 #include "fnft__nse_discretization.h"
 #include "fnft__akns_discretization.h"
 #include "fnft__misc.h"
+#include "fnft__sample_desc.h"
 
 /**
  * Returns the length of array to be allocated based on the number
@@ -47,16 +48,28 @@ INT nse_fscatter(const UINT D, COMPLEX const * const q,
         const REAL eps_t, const INT kappa,
         COMPLEX * const result, UINT * const deg_ptr,
         INT * const W_ptr, nse_discretization_t discretization)
+{
+    sample_desc_t q_desc;
+
+    if (q == NULL)
+        return E_INVALID_ARGUMENT(q);
+    q_desc = sample_desc_complex(q);
+    return nse_fscatter_desc(D, &q_desc, eps_t, kappa, result, deg_ptr,
+        W_ptr, discretization);
+}
+
+INT nse_fscatter_desc(const UINT D, sample_desc_t const * const q,
+        const REAL eps_t, const INT kappa,
+        COMPLEX * const result, UINT * const deg_ptr,
+        INT * const W_ptr, nse_discretization_t discretization)
 {
     INT ret_code = SUCCESS;
-    UINT i;
     akns_discretization_t akns_discretization;
-    COMPLEX *r = NULL;
     
     // Check inputs
     if (D == 0)
         return E_INVALID_ARGUMENT(D);
-    if (q == NULL)
+    if (!sample_desc_valid(q))
         return E_INVALID_ARGUMENT(q);
     if (eps_t <= 0.0)
         return E_INVALID_ARGUMENT(eps_t);
@@ -70,24 +83,11 @@ INT nse_fscatter(const UINT D, COMPLEX const * const q,
     ret_code = nse_discretization_to_akns_discretization(discretization, &akns_discretization);
     CHECK_RETCODE(ret_code, leave_fun);   
     
-    r = malloc(D*sizeof(COMPLEX));
-    if (r == NULL) {
-        ret_code = E_NOMEM;
-        goto leave_fun;
-    }
-    
-    if (kappa == 1){
-        for (i = 0; i < D; i++)
-            r[i] = -CONJ(q[i]);
-        }
-    else{
-        for (i = 0; i < D; i++)
-            r[i] = CONJ(q[i]);
-        }
-    
-    ret_code = akns_fscatter(D, q, r, eps_t, result, deg_ptr, W_ptr, akns_discretization);
+    // r = -kappa*conj(q) is formed on the fly while the individual
+    // scattering matrices are set up
+    ret_code = akns_fscatter_desc(D, q, NULL, -kappa, eps_t, result, deg_ptr,
+        W_ptr, akns_discretization);
 
 leave_fun:
-    free(r);
     return ret_code;
 }
@@ -22,6 +22,7 @@
 
 #include "fnft__errwarn.h"
 #include "fnft__nse_scatter.h"
+#include "fnft__sample_desc.h"
 #include <stdio.h>
 
 /**
@@ -34,6 +35,25 @@ INT nse_scatter_bound_states(const UINT D, COMPLEX const *const q,
         COMPLEX *aprime_vals, COMPLEX *b,
         nse_discretization_t discretization)
 {
+    sample_desc_t q_desc;
+
+    if (q == NULL)
+        return E_INVALID_ARGUMENT(q);
+    q_desc = sample_desc_complex(q);
+    return nse_scatter_bound_states_desc(D, &q_desc, T, trunc_index_ptr, K,
+        bound_states, a_vals, aprime_vals, b, discretization);
+}
+
+/**
+ * Same as nse_scatter_bound_states, but the samples are read through a
+ * sample descriptor.
+ */
+INT nse_scatter_bound_states_desc(const UINT D, sample_desc_t const * const q,
+        REAL const *const T,  UINT *trunc_index_ptr, UINT K,
+        COMPLEX *bound_states, COMPLEX *a_vals,
+        COMPLEX *aprime_vals, COMPLEX *b,
+        nse_discretization_t discretization)
+{
      
     INT ret_code = SUCCESS;
     REAL norm_left, norm_right;
@@ -44,7 +64,7 @@ INT nse_scatter_bound_states(const UINT D, COMPLEX const *const q,
     // Check inputs
     if (D == 0)
         return E_INVALID_ARGUMENT(D);
-    if (q == NULL)
+    if (!sample_desc_valid(q))
         return E_INVALID_ARGUMENT(q);
     if (T == NULL)
         return E_INVALID_ARGUMENT(eps_t);
@@ -74,10 +94,10 @@ INT nse_scatter_bound_states(const UINT D, COMPLEX const *const q,
         while (i0 < i1) {
             if (norm_left < norm_right) {
                 i0++;
-                norm_left += eps_t*CABS(q[i0]);
+                norm_left += eps_t*CABS(sample_desc_get(q, i0));
             } else {
                 i1--;
-                norm_right += eps_t*CABS(q[i1]);
+                norm_right += eps_t*CABS(sample_desc_get(q, i1));
             }
         }
         // i0 is now the index where we will split
@@ -99,7 +119,7 @@ INT nse_scatter_bound_states(const UINT D, COMPLEX const *const q,
                 COMPLEX U[4][4] = {{0}};
                 
                 for (n = D-1; n >= i0; n--){
-                    qn = q[n];
+                    qn = sample_desc_get(q, n);
                     qnc = CONJ(qn);
                     ks = (-(CABS(qn)*CABS(qn))-(l*l));
                     k = CSQRT(ks);
@@ -143,7 +163,7 @@ INT nse_scatter_bound_states(const UINT D, COMPLEX const *const q,
                     n = i0;
                     do {
                         n--;
-                        qn = q[n];
+                        qn = sample_desc_get(q, n);
                         qnc = CONJ(qn);
                         ks = (-(CABS(qn)*CABS(qn))-(l*l));
                         k = CSQRT(ks);
@@ -22,6 +22,7 @@
 #include "fnft__errwarn.h"
 #include "fnft__nse_scatter.h"
 #include "fnft__nse_discretization.h"
+#include "fnft__sample_desc.h"
 #include <stdio.h>
 
 /**
@@ -38,9 +39,8 @@ INT nse_scatter_matrix(const UINT D, COMPLEX const * const q,
 {
      
     INT ret_code = SUCCESS;
-    UINT i;
     akns_discretization_t akns_discretization;
-    COMPLEX *r = NULL;
+    sample_desc_t q_desc;
     
     // Check inputs
     if (D == 0)
@@ -61,24 +61,11 @@ INT nse_scatter_matrix(const UINT D, COMPLEX const * const q,
     ret_code = nse_discretization_to_akns_discretization(discretization, &akns_discretization);
     CHECK_RETCODE(ret_code, leave_fun);
     
-    r = malloc(D*sizeof(COMPLEX));
-    if (r == NULL) {
-        ret_code = E_NOMEM;
-        goto leave_fun;
-    }
-    
-    if (kappa == 1){
-        for (i = 0; i < D; i++)
-            r[i] = -CONJ(q[i]);
-        }
-    else{
-        for (i = 0; i < D; i++)
-            r[i] = CONJ(q[i]);
-        }
-    
-    ret_code = akns_scatter_matrix(D, q, r, eps_t, K, lambda, result, akns_discretization);
+    // r = -kappa*conj(q) is formed on the fly
+    q_desc = sample_desc_complex(q);
+    ret_code = akns_scatter_matrix_desc(D, &q_desc, NULL, -kappa, eps_t, K,
+        lambda, result, akns_discretization);
 
 leave_fun:
-    free(r);
     return ret_code;
 }
@@ -0,0 +1,378 @@
+/*
+ * This file is part of FNFT.
+ *
+ * FNFT is free software; you can redistribute it and/or
+ * modify it under the terms of the version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * FNFT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contributors:
+ * Sander Wahls (TU Delft) 2017-2018.
+ * Shrinivas Chimmalgi (TU Delft) 2017-2018.
+ * Marius Brehler (TU Dortmund) 2018.
+ */
+
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <string.h> // for memcpy
+#include "fnft__errwarn.h"
+#include "fnft__poly_roots_fasteigen.h"
+#include "fnft__poly_chirpz.h"
+#include "fnft__poly_eval_multipoint.h"
+#include "fnft__nse_discretization.h"
+#include "fnft__misc.h"
+#include "fnft__nsev.h"
+
+// Parameters of the argument principle-based localization of bound states:
+// Number of moments used by the Delves-Lyness method, maximum depth of the
+// subdivision and maximum number of intervals per vertical edge (see
+// argprinc_edge).
+#define ARGPRINC_NMOM 4
+#define ARGPRINC_MAX_DEPTH 20
+#define ARGPRINC_MAX_INTERVALS 4096
+
+// Auxiliary data type: Bundles the data that is needed to evaluate a(lam)
+// along the edges of the boxes used by argprinc_localize, as well as the
+// roots that have been found so far.
+typedef struct {
+    UINT deg;
+    COMPLEX const * H11; // coefficients of H11(z)
+    COMPLEX * dH11; // coefficients of H11'(z)
+    REAL eps_t;
+    REAL map_coeff; // z = exp(j*map_coeff*eps_t*lam)
+    REAL phase_factor_a;
+    nse_discretization_t discretization;
+    UINT K;
+    UINT K_max;
+    COMPLEX * roots;
+} argprinc_data_t;
+
+// Auxiliary function: Integrates along the edge from lam_a to lam_b of a
+// box. The change of the argument of a(lam) is added to *winding. The
+// integrals of (lam - lam_c)^k * a'(lam)/a(lam), k=0,...,ARGPRINC_NMOM, are
+// added to moments. The number of intervals is doubled until the argument
+// of a(lam) changes by less than pi/3 between two consecutive points.
+static INT argprinc_edge(
+    argprinc_data_t const * const ap,
+    const COMPLEX lam_a,
+    const COMPLEX lam_b,
+    const COMPLEX lam_c,
+    REAL * const winding,
+    COMPLEX * const moments)
+{
+    COMPLEX *lam = NULL, *z, *vals, *derivs;
+    COMPLEX A, W, v, v_prev = 1.0, g, pw, delta = 0.0;
+    REAL dphi, max_dphi, sum_dphi;
+    UINT M, m, k, max_intervals;
+    INT ret_code = SUCCESS;
+
+    // The cost of the chirp transform used for horizontal edges is
+    // dominated by the degree, so that many points can be used from start.
+    // For the same reason, the maximum number of intervals on horizontal
+    // edges grows with the degree.
+    M = 32;
+    max_intervals = ARGPRINC_MAX_INTERVALS;
+    if (CIMAG(lam_b - lam_a) == 0.0) {
+        M = misc_nextpowerof2(ap->deg);
+        if (max_intervals < 4*M)
+            max_intervals = 4*M;
+    }
+    if (M > max_intervals)
+        M = max_intervals;
+    for ( ; ; M *= 2) {
+
+        // Allocate memory
+        free(lam);
+        lam = malloc(4*(M+1) * sizeof(COMPLEX));
+        if (lam == NULL) {
+            ret_code = E_NOMEM;
+            goto leave_fun;
+        }
+        z = lam + (M+1);
+        vals = z + (M+1);
+        derivs = vals + (M+1);
+
+        // Points on the edge and their counterparts in the z-domain
+        delta = (lam_b - lam_a) / M;
+        for (m = 0; m <= M; m++) {
+            lam[m] = lam_a + m*delta;
+            z[m] = lam[m];
+        }
+        ret_code = nse_lambda_to_z(M+1, ap->eps_t, z, ap->discretization);
+        CHECK_RETCODE(ret_code, leave_fun);
+
+        // Evaluate H11(z) and H11'(z) at these points
+        if (CIMAG(delta) == 0.0) {
+            // Horizontal edge: z[m] = z[0]*W^m with |W|=1, use the chirp
+            // transform
+            A = 1.0 / z[0];
+            W = delta;
+            ret_code = nse_lambda_to_z(1, ap->eps_t, &W, ap->discretization);
+            CHECK_RETCODE(ret_code, leave_fun);
+            ret_code = poly_chirpz(ap->deg, ap->H11, A, W, M+1, vals);
+            CHECK_RETCODE(ret_code, leave_fun);
+            ret_code = poly_chirpz(ap->deg - 1, ap->dH11, A, W, M+1, derivs);
+            CHECK_RETCODE(ret_code, leave_fun);
+        } else {
+            // Vertical edge: z[m] = z[0]*W^m with a real W. The chirp
+            // transform cannot be used since the factors W^(n^2/2) over-
+            // or underflow for large degrees. The values on the circles
+            // through the points are computed with chirp transforms
+            // instead, see poly_eval_multipoint_rings.
+            memcpy(vals, z, (M+1) * sizeof(COMPLEX));
+            memcpy(derivs, z, (M+1) * sizeof(COMPLEX));
+            ret_code = poly_eval_multipoint_rings(ap->deg, ap->H11, M+1,
+                vals);
+            CHECK_RETCODE(ret_code, leave_fun);
+            ret_code = poly_eval_multipoint_rings(ap->deg - 1, ap->dH11, M+1,
+                derivs);
+            CHECK_RETCODE(ret_code, leave_fun);
+        }
+
+        // Track the argument of a(lam). The factor
+        // exp(j*Re(lam)*phase_factor_a) removes the fast rotation of H11(z)
+        // that does not contribute to the winding number.
+        max_dphi = 0.0;
+        sum_dphi = 0.0;
+        for (m = 0; m <= M; m++) {
+            v = vals[m] * CEXP(I*CREAL(lam[m])*ap->phase_factor_a);
+            if (!(CABS(v) > 0.0) || CABS(v) == INFINITY) {
+                max_dphi = INFINITY;
+                break;
+            }
+            if (m > 0) {
+                dphi = CARG(v / v_prev);
+                sum_dphi += dphi;
+                if (FABS(dphi) > max_dphi)
+                    max_dphi = FABS(dphi);
+            }
+            v_prev = v;
+        }
+        if (max_dphi <= PI/3)
+            break;
+        if (2*M > max_intervals) {
+            if (max_dphi == INFINITY) {
+                ret_code = E_OTHER("a(lam) vanishes or overflows on a contour");
+                goto leave_fun;
+            }
+            WARN("Argument of a(lam) not resolved on a contour. Number of bound states might be wrong.");
+            break;
+        }
+    }
+    *winding += sum_dphi;
+
+    // Integrate (lam - lam_c)^k * a'(lam)/a(lam) using Simpson's rule. Since
+    // a(lam) = 2^W * H11(z) * exp(j*lam*phase_factor_a), the logarithmic
+    // derivative is a'/a = j*phase_factor_a + j*map_coeff*eps_t*z*H11'/H11.
+    // The constant term integrates to zero along closed contours.
+    for (m = 0; m <= M; m++) {
+        g = I * ap->map_coeff * ap->eps_t * z[m] * derivs[m] / vals[m];
+        g *= delta * ((m == 0 || m == M) ? 1.0 : ((m % 2) ? 4.0 : 2.0)) / 3.0;
+        pw = 1.0;
+        for (k = 0; k <= ARGPRINC_NMOM; k++) {
+            moments[k] += pw * g;
+            pw *= lam[m] - lam_c;
+        }
+    }
+
+leave_fun:
+    free(lam);
+    return ret_code;
+}
+
+// Auxiliary function: Integrates along the boundary of the box
+// [x0,x1]x[y0,y1] in counter-clockwise direction. By the argument
+// principle, the winding number *N_ptr is the number of roots in the box.
+// The moments are as in argprinc_edge.
+static INT argprinc_contour(
+    argprinc_data_t const * const ap,
+    const REAL x0,
+    const REAL x1,
+    const REAL y0,
+    const REAL y1,
+    const COMPLEX lam_c,
+    INT * const N_ptr,
+    COMPLEX * const moments)
+{
+    COMPLEX const corners[5] = { x0 + I*y0, x1 + I*y0, x1 + I*y1,
+        x0 + I*y1, x0 + I*y0 };
+    REAL winding = 0.0;
+    UINT i;
+    INT ret_code = SUCCESS;
+
+    for (i = 0; i < 4; i++) {
+        ret_code = argprinc_edge(ap, corners[i], corners[i+1], lam_c,
+            &winding, moments);
+        CHECK_RETCODE(ret_code, leave_fun);
+    }
+    *N_ptr = ROUND(winding / (2*PI));
+
+leave_fun:
+    return ret_code;
+}
+
+// Auxiliary function: Localizes the roots of a(lam) in the box
+// [x0,x1]x[y0,y1] by recursive subdivision. Boxes without roots are
+// discarded. The roots in a box are computed with the method of Delves and
+// Lyness once the box contains only a single root (or the maximum depth
+// is reached).
+static INT argprinc_box(
+    argprinc_data_t * const ap,
+    const REAL x0,
+    const REAL x1,
+    const REAL y0,
+    const REAL y1,
+    const UINT depth)
+{
+    const COMPLEX lam_c = 0.5*(x0 + x1) + 0.5*I*(y0 + y1);
+    COMPLEX moments[ARGPRINC_NMOM+1] = { 0.0 };
+    COMPLEX e[ARGPRINC_NMOM+1], p[ARGPRINC_NMOM+1], r[ARGPRINC_NMOM+1];
+    INT N, ret_code = SUCCESS;
+    UINT i, k, n;
+
+    ret_code = argprinc_contour(ap, x0, x1, y0, y1, lam_c, &N, moments);
+    CHECK_RETCODE(ret_code, leave_fun);
+    if (N <= 0)
+        return SUCCESS;
+    for (k = 0; k <= ARGPRINC_NMOM; k++)
+        moments[k] /= 2*PI*I;
+
+    // Subdivide unless there is only a single root in the box. The zeroth
+    // moment, which should also be N, serves as a check of the accuracy of
+    // the quadrature. The boxes are not split in the middle since bound
+    // states often are located on symmetry axes.
+    if (depth < ARGPRINC_MAX_DEPTH
+        && (N > 1 || CABS(moments[0] - N) > 0.1)) {
+        const REAL xs = x0 + 0.4721*(x1 - x0);
+        const REAL ys = y0 + 0.5279*(y1 - y0);
+        ret_code = argprinc_box(ap, x0, xs, y0, ys, depth + 1);
+        CHECK_RETCODE(ret_code, leave_fun);
+        ret_code = argprinc_box(ap, xs, x1, y0, ys, depth + 1);
+        CHECK_RETCODE(ret_code, leave_fun);
+        ret_code = argprinc_box(ap, x0, xs, ys, y1, depth + 1);
+        CHECK_RETCODE(ret_code, leave_fun);
+        ret_code = argprinc_box(ap, xs, x1, ys, y1, depth + 1);
+        CHECK_RETCODE(ret_code, leave_fun);
+        return SUCCESS;
+    }
+
+    // The moments are the power sums of the shifted roots lam_j - lam_c.
+    // Newton's identities provide the elementary symmetric polynomials e_k,
+    // which are up to signs the coefficients of the polynomial with these
+    // roots.
+    n = (N > ARGPRINC_NMOM) ? ARGPRINC_NMOM : N;
+    e[0] = 1.0;
+    p[0] = 1.0;
+    for (k = 1; k <= n; k++) {
+        e[k] = 0.0;
+        for (i = 1; i <= k; i++)
+            e[k] += ((i % 2) ? 1.0 : -1.0) * e[k-i] * moments[i];
+        e[k] /= k;
+        p[k] = (k % 2) ? -e[k] : e[k];
+    }
+    if (n == 1) {
+        r[0] = moments[1];
+    } else {
+        ret_code = poly_roots_fasteigen(n, p, r);
+        CHECK_RETCODE(ret_code, leave_fun);
+    }
+    for (i = 0; i < n && ap->K < ap->K_max; i++)
+        ap->roots[ap->K++] = lam_c + r[i];
+
+leave_fun:
+    return ret_code;
+}
+
+// Auxiliary function: Localizes the roots of a(lam) in the box
+// [-re_bound_val,re_bound_val]x[0,im_bound_val] using the argument
+// principle. Upon entry, *K_ptr is the length of bound_states. Upon exit,
+// it is the number of roots that have been found. If count_only is set,
+// the roots are only counted and bound_states is not used.
+INT nsev_argprinc_localize(
+    const UINT D,
+    REAL const * const T,
+    const UINT deg,
+    COMPLEX const * const transfer_matrix,
+    const REAL eps_t,
+    const REAL re_bound_val,
+    const REAL im_bound_val,
+    UINT * const K_ptr,
+    COMPLEX * const bound_states,
+    const INT count_only,
+    fnft_nsev_opts_t * const opts)
+{
+    argprinc_data_t ap;
+    COMPLEX moments[ARGPRINC_NMOM+1] = { 0.0 };
+    INT N;
+    REAL degree1step;
+    UINT i;
+    INT ret_code = SUCCESS;
+
+    degree1step = nse_discretization_degree(opts->discretization);
+    if (degree1step == 0)
+        return E_INVALID_ARGUMENT(opts->discretization);
+
+    ap.deg = deg;
+    ap.H11 = transfer_matrix;
+    ap.dH11 = malloc(deg * sizeof(COMPLEX));
+    if (ap.dH11 == NULL)
+        return E_NOMEM;
+    for (i = 0; i < deg; i++)
+        ap.dH11[i] = (deg - i) * transfer_matrix[i];
+    ap.eps_t = eps_t;
+    ap.map_coeff = 2/degree1step;
+    ap.discretization = opts->discretization;
+    ap.K = 0;
+    ap.K_max = *K_ptr;
+    ap.roots = bound_states;
+    ret_code = nse_phase_factor_a(eps_t, D, T, &ap.phase_factor_a,
+        opts->discretization);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    if (count_only) {
+        ret_code = argprinc_contour(&ap, -re_bound_val, re_bound_val, 0.0,
+            im_bound_val, 0.0, &N, moments);
+        CHECK_RETCODE(ret_code, leave_fun);
+        *K_ptr = (N > 0) ? N : 0;
+    } else {
+        ret_code = argprinc_box(&ap, -re_bound_val, re_bound_val, 0.0,
+            im_bound_val, 0);
+        CHECK_RETCODE(ret_code, leave_fun);
+        *K_ptr = ap.K;
+    }
+
+leave_fun:
+    free(ap.dH11);
+    return ret_code;
+}
+
+// Auxiliary function: Counts the bound states that can pass the
+// fnft_nsev_bsfilt_FULL filter, i.e., the zeros of a(lam) in the box
+// [-re_bound,re_bound]x[0,im_bound], using the argument principle. The
+// boundary of the box includes the real axis.
+INT nsev_count_bound_states(
+    const UINT D,
+    sample_desc_t const * const q,
+    REAL const * const T,
+    const UINT deg,
+    COMPLEX const * const transfer_matrix,
+    const REAL eps_t,
+    UINT * const K_ptr,
+    fnft_nsev_opts_t * const opts)
+{
+    REAL degree1step;
+
+    degree1step = nse_discretization_degree(opts->discretization);
+    if (degree1step == 0)
+        return E_INVALID_ARGUMENT(opts->discretization);
+    return nsev_argprinc_localize(D, T, deg, transfer_matrix, eps_t,
+        nsev_re_bound(eps_t, 2/degree1step), nsev_im_bound(D, q, T), K_ptr,
+        NULL, 1, opts);
+}
@@ -0,0 +1,178 @@
+/*
+ * This file is part of FNFT.
+ *
+ * FNFT is free software; you can redistribute it and/or
+ * modify it under the terms of the version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * FNFT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contributors:
+ * Sander Wahls (TU Delft) 2017-2018.
+ * Shrinivas Chimmalgi (TU Delft) 2017-2018.
+ * Marius Brehler (TU Dortmund) 2018.
+ */
+
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <string.h> // for memcpy
+#include "fnft__errwarn.h"
+#include "fnft__nse_fscatter.h"
+#include "fnft__nse_discretization.h"
+#include "fnft__sample_desc.h"
+#include "fnft__nsev.h"
+
+// Auxiliary function: Improves the continuous spectrum and the K bound
+// states computed by fnft_nsev using Richardson extrapolation. Both are
+// recomputed for the signal decimated by a factor of two, i.e., for the step
+// size 2*eps_t. Since the error of a discretization of order p behaves like
+// C*eps_t^p, the combination (2^p*x - x_sub)/(2^p - 1) cancels the leading
+// error term. The bound states of the decimated signal are obtained by
+// refining the bound states of the full signal with Newton's method. Bound
+// states for which this refinement diverges or converges to another bound
+// state are not changed. The decimated signal only covers the same interval
+// if D is odd. For even D, a warning is issued and the spectra are not
+// changed.
+INT nsev_richardson_extrapolation(
+    const UINT D,
+    sample_desc_t const * const q,
+    REAL const * const T,
+    const UINT M,
+    COMPLEX * const contspec,
+    REAL const * const XI,
+    const UINT K,
+    COMPLEX * const bound_states,
+    const INT kappa,
+    fnft_nsev_opts_t * const opts)
+{
+    COMPLEX *transfer_matrix = NULL, *buf = NULL;
+    sample_desc_t qsub;
+    fnft_nsev_opts_t opts_sub;
+    UINT Dsub, deg, order, len, i, j;
+    UINT first_last_index[2];
+    INT W = 0, *W_ptr = NULL;
+    REAL f, dist;
+    INT ret_code = SUCCESS;
+
+    if (D < 4)
+        return E_INVALID_ARGUMENT(D);
+    if (D % 2 == 0) {
+        WARN("Richardson extrapolation requires an odd number of samples D. Skipping it.");
+        return SUCCESS;
+    }
+
+    // Decimate the signal by a factor of two. The decimated signal consists
+    // of the samples q[0], q[2], ..., q[2*(Dsub-1)].
+    Dsub = (D + 1)/2;
+    sample_desc_downsample(D, q, &Dsub, &qsub, first_last_index);
+    if (first_last_index[1] + 1 != 2*Dsub) {
+        ret_code = E_ASSERTION_FAILED;
+        goto release_mem;
+    }
+    const REAL eps_t = (T[1] - T[0])/(D - 1);
+    REAL const Tsub[2] = { T[0], T[0] + 2*(Dsub - 1)*eps_t };
+
+    // Compute the transfer matrix of the decimated signal
+    i = nse_fscatter_numel(Dsub, opts->discretization);
+    if (i == 0) {
+        ret_code = E_INVALID_ARGUMENT(opts->discretization);
+        goto release_mem;
+    }
+    transfer_matrix = malloc(i*sizeof(COMPLEX));
+    if (transfer_matrix == NULL) {
+        ret_code = E_NOMEM;
+        goto release_mem;
+    }
+    if (opts->normalization_flag)
+        W_ptr = &W;
+    ret_code = nse_fscatter_desc(Dsub, &qsub, 2*eps_t, kappa, transfer_matrix,
+        &deg, W_ptr, opts->discretization);
+    CHECK_RETCODE(ret_code, release_mem);
+
+    // Extrapolate the continuous spectrum
+    if (contspec != NULL && M > 0) {
+        switch (opts->contspec_type) {
+            case nsev_cstype_REFLECTION_COEFFICIENT:
+                len = M;
+                break;
+            case nsev_cstype_AB:
+                len = 2*M;
+                break;
+            case nsev_cstype_BOTH:
+                len = 3*M;
+                break;
+            default:
+                ret_code = E_INVALID_ARGUMENT(opts->contspec_type);
+                goto release_mem;
+        }
+        order = nse_discretization_order(opts->discretization);
+        if (order == 0) {
+            ret_code = E_INVALID_ARGUMENT(opts->discretization);
+            goto release_mem;
+        }
+        buf = malloc(len * sizeof(COMPLEX));
+        if (buf == NULL) {
+            ret_code = E_NOMEM;
+            goto release_mem;
+        }
+        ret_code = nsev_tf2contspec(deg, W, transfer_matrix, Tsub, Dsub, XI, M,
+            buf, opts);
+        CHECK_RETCODE(ret_code, release_mem);
+        f = POW(2.0, order);
+        for (i = 0; i < len; i++)
+            contspec[i] = (f*contspec[i] - buf[i]) / (f - 1);
+        free(buf);
+        buf = NULL;
+    }
+
+    // Extrapolate the bound states. Their order is the one of the
+    // discretization that has been used to refine them, or the one of the
+    // polynomial if they have not been refined.
+    if (kappa == +1 && bound_states != NULL && K > 0) {
+        opts_sub = *opts;
+        if (opts->bound_state_localization == nsev_bsloc_FAST_EIGENVALUE)
+            opts_sub.bound_state_refinement = nsev_bsref_POLY;
+        if (opts_sub.bound_state_refinement == nsev_bsref_POLY)
+            order = nse_discretization_order(opts->discretization);
+        else
+            order = nse_discretization_order(nse_discretization_BO);
+        if (order == 0) {
+            ret_code = E_INVALID_ARGUMENT(opts->discretization);
+            goto release_mem;
+        }
+        buf = malloc(K * sizeof(COMPLEX));
+        if (buf == NULL) {
+            ret_code = E_NOMEM;
+            goto release_mem;
+        }
+        memcpy(buf, bound_states, K * sizeof(COMPLEX));
+        ret_code = nsev_refine_bound_states(Dsub, &qsub, Tsub, deg,
+            transfer_matrix, 2*eps_t, K, buf, &opts_sub);
+        CHECK_RETCODE(ret_code, release_mem);
+
+        f = POW(2.0, order);
+        for (i = 0; i < K; i++) {
+            dist = CABS(buf[i] - bound_states[i]);
+            for (j = 0; j < K; j++) {
+                if (j != i && !(dist < CABS(buf[i] - bound_states[j])))
+                    break;
+            }
+            if (j == K && dist < INFINITY)
+                buf[i] = (f*bound_states[i] - buf[i]) / (f - 1);
+            else
+                buf[i] = bound_states[i];
+        }
+        memcpy(bound_states, buf, K * sizeof(COMPLEX));
+    }
+
+release_mem:
+    free(transfer_matrix);
+    free(buf);
+    return ret_code;
+}
@@ -0,0 +1,791 @@
+/*
+ * This file is part of FNFT.
+ *
+ * FNFT is free software; you can redistribute it and/or
+ * modify it under the terms of the version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * FNFT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contributors:
+ * Sander Wahls (TU Delft) 2017-2018.
+ * Shrinivas Chimmalgi (TU Delft) 2017-2018.
+ * Marius Brehler (TU Dortmund) 2018.
+ */
+
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <string.h> // for memcpy
+#include "fnft__errwarn.h"
+#include "fnft__poly_roots_fasteigen.h"
+#include "fnft__poly_roots_aberth.h"
+#include "fnft__poly_chirpz.h"
+#include "fnft__poly_specfact.h"
+#include "fnft__poly_eval_multipoint.h"
+#include "fnft__nse_scatter.h"
+#include "fnft__nse_discretization.h"
+#include "fnft__misc.h"
+#include "fnft__sample_desc.h"
+#include "fnft__nsev.h"
+
+/**
+ * Declare an auxiliary routine that is used before its body.
+ */
+static inline INT tf2boundstates(
+    const UINT D,
+    sample_desc_t const * const q,
+    const UINT deg,
+    COMPLEX * const transfer_matrix,
+    REAL const * const T,
+    const REAL eps_t,
+    UINT * const K_ptr,
+    COMPLEX * const bound_states,
+    fnft_nsev_opts_t * const opts);
+
+// Auxiliary function: Computes the continuous and/or discrete spectrum
+// from a transfer matrix that has been computed with nse_fscatter. Used by
+// fnft_nsev, fnft_nsev_accum_finalize, fnft_nsev_tree_query and
+// fnft_nsev_tracker_step.
+INT nsev_tf2nfs(
+    const UINT D,
+    sample_desc_t const * const q,
+    REAL const * const T,
+    const UINT deg,
+    const INT W,
+    COMPLEX * const transfer_matrix,
+    const UINT M,
+    COMPLEX * const contspec,
+    REAL const * const XI,
+    UINT * const K_ptr,
+    COMPLEX * const bound_states,
+    COMPLEX * const normconsts_or_residues,
+    const INT kappa,
+    fnft_nsev_opts_t * const opts)
+{
+    sample_desc_t qsub;
+    UINT K_count = 0, K_max = 0;
+    INT count_flag = 0;
+    INT ret_code = SUCCESS;
+
+    // Determine step size
+    const REAL eps_t = (T[1] - T[0])/(D - 1);
+
+    // Compute the continuous spectrum
+    if (contspec != NULL && M > 0) {
+        ret_code = nsev_tf2contspec(deg, W, transfer_matrix, T, D, XI, M,
+            contspec, opts);
+        CHECK_RETCODE(ret_code, release_mem);
+    }
+    
+    // Compute the discrete spectrum
+    if (kappa == +1 && bound_states != NULL) {
+
+        // Count the bound states that can pass the full filter first if
+        // desired. The localization is skipped if there are none.
+        K_max = *K_ptr;
+        count_flag = opts->bound_state_counting_flag != 0
+            && opts->bound_state_filtering == nsev_bsfilt_FULL;
+        if (count_flag) {
+            ret_code = nsev_count_bound_states(D, q, T, deg, transfer_matrix,
+                eps_t, &K_count, opts);
+            CHECK_RETCODE(ret_code, release_mem);
+            if (K_count == 0) {
+                *K_ptr = 0;
+                goto release_mem;
+            }
+        }
+
+        // Compute the bound states
+        if (opts->bound_state_localization == nsev_bsloc_SUBSAMPLE_AND_REFINE) {
+            // the mixed method gets special treatment
+            
+            // First step: Find initial guesses for the bound states using the
+            // fast eigenvalue method. To bound the complexity, a subsampled
+            // version of q, qsub, will be passed to the fast eigenroutine.
+            // Since qsub only differs from q in the stride, no samples are
+            // copied.
+            UINT Dsub = opts->Dsub;
+            if (Dsub == 0) // The user wants us to determine Dsub
+                Dsub = SQRT(D * LOG2(D) * LOG2(D));
+            UINT first_last_index[2];
+            sample_desc_downsample(D, q, &Dsub, &qsub, first_last_index);
+            REAL const Tsub[2] = { T[0] + first_last_index[0]*eps_t,
+                T[0] + first_last_index[1]*eps_t };
+          
+            // Fixed bound states of qsub using the fast eigenvalue method.
+            // The bound states of qsub are neither counted nor
+            // extrapolated since they are only initial guesses.
+            const INT counting_flag = opts->bound_state_counting_flag;
+            const INT richardson_flag = opts->richardson_extrapolation_flag;
+            opts->bound_state_localization = nsev_bsloc_FAST_EIGENVALUE;
+            opts->bound_state_counting_flag = 0;
+            opts->richardson_extrapolation_flag = 0;
+            ret_code = fnft_nsev_desc(Dsub, &qsub, Tsub, 0, NULL, XI, K_ptr,
+                bound_states, NULL, kappa, opts);
+            opts->bound_state_counting_flag = counting_flag;
+            opts->richardson_extrapolation_flag = richardson_flag;
+            CHECK_RETCODE(ret_code, release_mem);
+           
+            // Second step: Refine the found bound states using Newton's method
+            // on the full signal.
+            opts->bound_state_localization = nsev_bsloc_NEWTON;
+            ret_code = tf2boundstates(D, q, deg, transfer_matrix, T,
+                    eps_t, K_ptr, bound_states, opts);
+            CHECK_RETCODE(ret_code, release_mem);
+           
+            // If bound states have been missed on the subsampled signal or
+            // Newton's method did not converge to distinct bound states,
+            // apply the fast eigenvalue method to the full signal
+            if (count_flag && *K_ptr != K_count) {
+                *K_ptr = K_max;
+                opts->bound_state_localization = nsev_bsloc_FAST_EIGENVALUE;
+                ret_code = tf2boundstates(D, q, deg, transfer_matrix, T,
+                    eps_t, K_ptr, bound_states, opts);
+                CHECK_RETCODE(ret_code, release_mem);
+            }
+
+            // Restore original state of opts
+            opts->bound_state_localization = nsev_bsloc_SUBSAMPLE_AND_REFINE;
+            
+        } else { // any other method is handled directly by the subroutine
+            
+            ret_code = tf2boundstates(D, q, deg, transfer_matrix, T,
+                    eps_t, K_ptr, bound_states, opts);
+            CHECK_RETCODE(ret_code, release_mem);
+
+        }
+        if (count_flag && *K_ptr != K_count)
+            WARN("Number of bound states differs from the number of zeros of a(lam) in the search region.");
+
+        // Norming constants and/or residues)
+        if (normconsts_or_residues != NULL && *K_ptr != 0) {
+
+            ret_code = nsev_tf2normconsts_or_residues(D, q, T, *K_ptr,
+                transfer_matrix, deg, bound_states, normconsts_or_residues,
+                opts);
+            CHECK_RETCODE(ret_code, release_mem);
+
+        }
+    } else if (K_ptr != NULL) {
+        *K_ptr = 0;
+    }
+    
+release_mem:
+    return ret_code;
+}
+
+// Auxiliary function: Computes continuous spectrum on a frequency grid
+// from a given transfer matrix.
+INT nsev_tf2contspec(
+    const UINT deg,
+    const INT W,
+    COMPLEX * const transfer_matrix,
+    REAL const * const T,
+    const UINT D,
+    REAL const * const XI,
+    const UINT M,
+    COMPLEX * const result,
+    fnft_nsev_opts_t * const opts)
+{
+    COMPLEX *H11_vals, *H21_vals;
+    COMPLEX A, V;
+    REAL xi, boundary_coeff, scale;
+    REAL phase_factor_rho, phase_factor_a, phase_factor_b;
+    INT ret_code;
+    UINT i, offset = 0;
+    
+    H11_vals = malloc(2*M * sizeof(COMPLEX));
+    if (H11_vals == NULL){
+        return E_NOMEM;
+        goto leave_fun;}
+    H21_vals = H11_vals + M;
+ 
+    
+
+    // Set step sizes
+    const REAL eps_t = (T[1] - T[0])/(D - 1);
+    const REAL eps_xi = (XI[1] - XI[0])/(M - 1);
+
+
+    // Determine discretization-specific coefficients
+    boundary_coeff = nse_discretization_boundary_coeff(opts->discretization);
+    if (boundary_coeff == NAN){
+        return E_INVALID_ARGUMENT(opts->discretization);
+        goto leave_fun;
+    }
+
+
+    // Prepare the use of the chirp transform. The entries of the transfer
+    // matrix that correspond to a and b will be evaluated on the frequency
+    // grid xi(i) = XI1 + i*eps_xi, where i=0,...,M-1. Since
+    // z=exp(2.0*I*XI*eps_t/degree1step), we find that the z at which z the transfer
+    // matrix has to be evaluated are given by z(i) = 1/(A * V^-i), where:
+    V = eps_xi;
+    ret_code = nse_lambda_to_z(1, eps_t, &V, opts->discretization);
+    CHECK_RETCODE(ret_code, leave_fun);
+    A = -XI[0];
+    ret_code = nse_lambda_to_z(1, eps_t, &A, opts->discretization);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    ret_code = poly_chirpz(deg, transfer_matrix, A, V, M, H11_vals);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    ret_code = poly_chirpz(deg, transfer_matrix+2*(deg+1), A, V, M,
+         H21_vals);
+    CHECK_RETCODE(ret_code, leave_fun);    
+
+    // Compute the continuous spectrum
+    switch (opts->contspec_type) {
+
+    case nsev_cstype_BOTH:
+
+        offset = M;
+        // fall through
+
+    case nsev_cstype_REFLECTION_COEFFICIENT:
+
+        
+        ret_code = nse_phase_factor_rho(eps_t, T[1], &phase_factor_rho,opts->discretization);
+        CHECK_RETCODE(ret_code, leave_fun);
+
+
+        for (i = 0; i < M; i++) {
+            xi = XI[0] + i*eps_xi;
+            if (H11_vals[i] == 0.0){
+                return E_DIV_BY_ZERO;
+                goto leave_fun;
+            }
+            result[i] = H21_vals[i] * CEXP(I*xi*phase_factor_rho) / H11_vals[i];
+        }
+
+        if (opts->contspec_type == nsev_cstype_REFLECTION_COEFFICIENT)
+            break;
+        // fall through
+
+    case nsev_cstype_AB:
+
+        scale = POW(2.0, W); // needed since the transfer matrix might
+                                  // have been scaled by nse_fscatter
+  
+        ret_code = nse_phase_factor_a(eps_t, D, T, &phase_factor_a,opts->discretization);
+        CHECK_RETCODE(ret_code, leave_fun);
+        
+        ret_code = nse_phase_factor_b(eps_t, D, T, &phase_factor_b,opts->discretization);
+        CHECK_RETCODE(ret_code, leave_fun);
+
+
+        for (i = 0; i < M; i++) {
+            xi = XI[0] + i*eps_xi;       
+            result[offset + i] = H11_vals[i] * scale * CEXP(I*xi*phase_factor_a);
+        	result[offset + M + i] = H21_vals[i] * scale * CEXP(I*xi*phase_factor_b);
+        }
+
+        break;
+
+    default:
+
+        ret_code = E_INVALID_ARGUMENT(opts->contspec_type);
+        goto leave_fun;
+    }
+    
+
+
+leave_fun:
+    free(H11_vals);
+
+    return ret_code;
+}
+
+// Auxiliary function for filtering: We assume that bound states must have
+// real part in the interval [-re_bound, re_bound].
+REAL nsev_re_bound(const REAL eps_t, const REAL map_coeff)
+{
+    // At least for discretizations in which the continuous-time
+    // spectral parameter lam is mapped to z=exp(map_coeff*j*lam*eps_t), we
+    // can only resolve the region
+    // -pi/(map_coeff*eps_t)<Re(lam)<pi/(map_coeff*eps_t).
+    // Numerical artefacts often occur close to the border of this
+    // region, which is why we filter such bound_states
+    return 0.9*PI/FABS(map_coeff * eps_t);
+}
+
+// Auxiliary function for filtering: We assume that bound states must have
+// imaginary part in the interval [0, im_bound].
+REAL nsev_im_bound(const UINT D, sample_desc_t const * const q,
+    REAL const * const T)
+{
+    // The nonlinear Parseval relation tells us that the squared L2 norm of
+    // q(t) is >= 4*(sum of the imaginary parts of the bound states). Thus,
+    // any bound state with an imaginary part greater than four times the
+    // squared L2 norm of q(t) can be removed. A factor of 1.5 has been
+    // added to account for numerical discrepancies when computing the norm
+    // numerically (e.g., truncation errors or large step sizes).
+    return 1.5 * 0.25 * sample_desc_l2norm2(D, q, T[0], T[1]);
+}
+
+
+// Auxiliary function: Computes the bound states from a given transfer matrix.
+static inline INT tf2boundstates(
+    const UINT D,
+    sample_desc_t const * const q,
+    const UINT deg,
+    COMPLEX * const transfer_matrix,
+    REAL const * const T,
+    const REAL eps_t,
+    UINT * const K_ptr,
+    COMPLEX * const bound_states,
+    fnft_nsev_opts_t * const opts)
+{
+    REAL degree1step, map_coeff, r_in;
+    UINT K;
+    REAL bounding_box[4] = { NAN };
+    COMPLEX * buffer = NULL;
+    COMPLEX * p = NULL;
+    COMPLEX log_coeff = 0.0;
+    INT ret_code = SUCCESS;
+
+    degree1step = nse_discretization_degree(opts->discretization);
+    if (degree1step == 0)
+        return E_INVALID_ARGUMENT(opts->discretization);
+    map_coeff = 2/degree1step;
+
+    // Localize bound states ...
+    switch (opts->bound_state_localization) {
+        
+        // ... using Newton's method
+        case nsev_bsloc_NEWTON:
+
+            K = *K_ptr;
+            buffer = bound_states; // Store intermediate results directly
+
+            // Perform Newton iterations. Initial guesses of bound-states
+            // should be in the continuous-time domain.
+            ret_code = nsev_refine_bound_states(D, q, T, deg, transfer_matrix,
+                eps_t, K, buffer, opts);
+            CHECK_RETCODE(ret_code, leave_fun);
+
+            break;
+
+        // ... using the fast eigenvaluebased root finding
+        case nsev_bsloc_FAST_EIGENVALUE:
+
+            // Split off the factor of a(z) whose roots can survive the
+            // filtering if desired. Only this factor, which is stored in the
+            // unused last part of the transfer matrix, is passed to the root
+            // finder. Bound states are located inside the unit circle, and
+            // the full filter additionally removes roots z with
+            // |z|<exp(-map_coeff*eps_t*im_bound).
+            p = transfer_matrix;
+            K = deg;
+            if (opts->spectral_splitting_flag != 0
+                && opts->bound_state_filtering != nsev_bsfilt_NONE) {
+
+                r_in = 0.0;
+                if (opts->bound_state_filtering == nsev_bsfilt_FULL)
+                    r_in = EXP(-map_coeff*eps_t*nsev_im_bound(D, q, T));
+                p = transfer_matrix + 3*(deg+1);
+                ret_code = poly_specfact_annulus(deg, transfer_matrix, r_in,
+                    1.0, 4, &K, p);
+                CHECK_RETCODE(ret_code, leave_fun);
+            }
+
+            if (*K_ptr >= K) {
+                buffer = bound_states;
+            } else {
+                // Store intermediate results in unused part of transfer matrix.
+                // This buffer is large enough to store all deg roots of the
+                // polynomial, while bound_states provided by the user might be
+                // smaller. The latter only needs to store the bound states that
+                // survive the filtering.
+                buffer = transfer_matrix + (deg+1);
+            }
+
+            if (K > 0) {
+                switch (opts->root_finder) {
+                case nsev_rootfind_FAST_EIGENVALUE:
+                    ret_code = poly_roots_fasteigen(K, p, buffer);
+                    break;
+                case nsev_rootfind_ABERTH:
+                    ret_code = poly_roots_aberth(K, p, buffer);
+                    break;
+                default:
+                    return E_INVALID_ARGUMENT(opts->root_finder);
+                }
+                CHECK_RETCODE(ret_code, leave_fun);
+            }
+
+            // Roots are returned in discrete-time domain -> coordinate
+            // transform (from discrete-time to continuous-time domain).
+            // If the roots are filtered, the transform is carried out
+            // together with the filtering below.
+            if (opts->bound_state_filtering != nsev_bsfilt_NONE) {
+                log_coeff = degree1step/(2*I*eps_t);
+            } else {
+                ret_code = nse_z_to_lambda(K, eps_t, buffer,
+                    opts->discretization);
+                CHECK_RETCODE(ret_code, leave_fun);
+            }
+            break;
+
+        // ... using the argument principle
+        case nsev_bsloc_ARGUMENT_PRINCIPLE:
+
+            // Store intermediate results in unused part of transfer matrix
+            // (see above)
+            K = deg;
+            buffer = transfer_matrix + (deg+1);
+
+            ret_code = nsev_argprinc_localize(D, T, deg, transfer_matrix, eps_t,
+                nsev_re_bound(eps_t, map_coeff), nsev_im_bound(D, q, T), &K,
+                buffer, 0, opts);
+            CHECK_RETCODE(ret_code, leave_fun);
+
+            // Refine the found bound states using Newton's method
+            ret_code = nsev_refine_bound_states(D, q, T, deg, transfer_matrix,
+                eps_t, K, buffer, opts);
+            CHECK_RETCODE(ret_code, leave_fun);
+            break;
+
+        default:
+            
+            return E_INVALID_ARGUMENT(opts->bound_state_localization);
+    }
+    
+    // Filter bound states (and apply the coordinate transform if the
+    // bound states are still in the z-domain). Merging and filtering are
+    // carried out in a single pass.
+    if (opts->bound_state_filtering != nsev_bsfilt_NONE) {
+
+        bounding_box[0] = -INFINITY;
+        bounding_box[1] = INFINITY;
+        bounding_box[2] = 0.0;
+        bounding_box[3] = INFINITY;
+        if (opts->bound_state_filtering == nsev_bsfilt_FULL) {
+            bounding_box[1] = nsev_re_bound(eps_t, map_coeff);
+            bounding_box[0] = -bounding_box[1];
+            bounding_box[3] = nsev_im_bound(D, q, T);
+        }
+        ret_code = misc_filter_merge(&K, buffer, bounding_box, SQRT(EPSILON),
+            log_coeff);
+        CHECK_RETCODE(ret_code, leave_fun);
+    }
+
+    // Copy result from buffer to user-supplied array (if not identical)
+    if (buffer != bound_states) {
+        if (*K_ptr < K) {
+            WARN("Found more than *K_ptr bound states. Returning as many as possible.");
+            K = *K_ptr;
+        }
+        memcpy(bound_states, buffer, K * sizeof(COMPLEX));
+    }
+    
+    // Update number of bound states
+    *K_ptr = K;
+
+leave_fun:    
+    return ret_code;
+}
+
+// Auxiliary function: Computes the norming constants and/or residues
+// using the BO scheme
+INT nsev_tf2normconsts_or_residues(
+    const UINT D,
+    sample_desc_t const * const q,
+    REAL const * const T,
+    const UINT K,
+    COMPLEX * const transfer_matrix,
+    const UINT deg,
+    COMPLEX * const bound_states,
+    COMPLEX * const normconsts_or_residues,
+    fnft_nsev_opts_t * const opts)
+{
+    
+    COMPLEX *a_vals = NULL, *aprime_vals = NULL;
+    UINT trunc_index;
+    UINT i, offset = 0;
+    INT ret_code = SUCCESS;
+   
+    // Check inputs
+    if (K == 0) // no bound states to refine
+        return SUCCESS;
+    if (D == 0)
+        return E_INVALID_ARGUMENT(D);
+    if (q == NULL)
+        return E_INVALID_ARGUMENT(q);
+    
+    // Reuse no longer used parts of the transfer matrix as buffers
+    a_vals = transfer_matrix + (deg+1);
+    aprime_vals = transfer_matrix + 3*(deg+1);
+    
+    // trunc_index is the index where we will split
+    // trunc_index should be integer between 0 and D-1
+    // trunc_index = D corresponds to splitting based on L1-norm
+    trunc_index = D;
+    ret_code = nse_scatter_bound_states_desc(D, q, T, &trunc_index, K,
+        bound_states, a_vals, aprime_vals, normconsts_or_residues, nse_discretization_BO);
+    CHECK_RETCODE(ret_code, leave_fun);    
+
+    // Update to or add residues if requested
+    if (opts->discspec_type != nsev_dstype_NORMING_CONSTANTS) {
+        
+        if (opts->discspec_type == nsev_dstype_RESIDUES) {
+            offset = 0;
+        } else if (opts->discspec_type == nsev_dstype_BOTH) {
+            offset = K;
+            memcpy(normconsts_or_residues + offset,
+                    normconsts_or_residues,
+                    offset*sizeof(complex double));
+        } else
+            return E_INVALID_ARGUMENT(opts->discspec_type);
+        
+        // Divide norming constants by derivatives to get residues
+        for (i = 0; i < K; i++) {
+            if (aprime_vals[i] == 0.0)
+                return E_DIV_BY_ZERO;
+            normconsts_or_residues[offset + i] /= aprime_vals[i];
+        }
+    }
+
+leave_fun:
+    return ret_code;
+}
+
+// Auxiliary function: Refines the bound-states using Newtons method
+static inline INT refine_roots_newton(
+    const UINT D,
+    sample_desc_t const * const q,
+    REAL const * const T,
+    const UINT K,
+    COMPLEX * bound_states,
+    nse_discretization_t discretization,
+    const UINT niter)     
+{
+    INT ret_code = SUCCESS;
+    UINT i, iter;
+    COMPLEX a_val, b_val, aprime_val, error;
+    REAL eprecision = EPSILON * 100;
+    REAL re_bound_val, im_bound_val;
+    UINT trunc_index;
+    trunc_index = D;
+    const REAL eps_t = (T[1] - T[0])/(D - 1);
+    
+    // Check inputs
+    if (K == 0) // no bound states to refine
+        return SUCCESS;
+    if (niter == 0) // no refinement requested
+        return SUCCESS;
+    if (bound_states == NULL)
+        return E_INVALID_ARGUMENT(bound_states);
+    if (q == NULL)
+        return E_INVALID_ARGUMENT(q);
+    if (T == NULL)
+        return E_INVALID_ARGUMENT(T);
+    
+    im_bound_val = nsev_im_bound(D, q, T);
+    if (im_bound_val == NAN)
+        return E_OTHER("Upper bound on imaginary part of bound states is NaN");
+    
+    re_bound_val = nsev_re_bound(eps_t, discretization);
+        
+    // Perform iterations of Newton's method
+    for (i = 0; i < K; i++) {
+        iter = 0;
+        do {
+            // Compute a(lam) and a'(lam) at the current root
+            ret_code = nse_scatter_bound_states_desc(D, q, T, &trunc_index, 1,
+                bound_states + i, &a_val, &aprime_val, &b_val, discretization);
+            if (ret_code != SUCCESS)
+                return E_SUBROUTINE(ret_code);
+
+            // Perform Newton updates: lam[i] <- lam[i] - a(lam[i])/a'(lam[i])
+            if (aprime_val == 0.0)
+                return E_DIV_BY_ZERO;
+            error = a_val / aprime_val;
+            bound_states[i] -= error;
+            iter++;
+
+            if (CIMAG(bound_states[i]) > im_bound_val
+                || CREAL(bound_states[i]) > re_bound_val
+                || CREAL(bound_states[i]) < -re_bound_val
+                || CIMAG(bound_states[i]) < 0.0)
+            break;
+
+        } while (CABS(error) > eprecision && iter < niter);       
+    }
+    
+    return SUCCESS;
+}
+
+// Auxiliary function: Refines the bound-states using Newtons method, where
+// a(lam) and a'(lam) are replaced by the polynomial H11(z) in the first
+// quarter of the transfer matrix and its derivative. Since
+// a(lam) = 2^W * H11(z) * exp(j*lam*phase_factor_a) with z=z(lam), and
+// neither the normalization factor 2^W nor the exponential vanish, the
+// roots of a(lam) are exactly the roots of H11(z). The iterations are
+// therefore performed in the z-domain, where the normalization cancels in
+// the Newton step H11(z)/H11'(z). All roots that have not yet converged are
+// evaluated together with poly_eval_multipoint_rings, which costs less than
+// Horner's method if there are many roots.
+static inline INT refine_roots_newton_poly(
+    const UINT deg,
+    COMPLEX const * const transfer_matrix,
+    const REAL eps_t,
+    const UINT K,
+    COMPLEX * bound_states,
+    REAL const * const bounding_box,
+    nse_discretization_t discretization,
+    const UINT niter)
+{
+    COMPLEX *z = NULL, *vals = NULL, *derivs = NULL, *dH11 = NULL;
+    UINT *active = NULL;
+    UINT i, j, n, iter;
+    COMPLEX lam;
+    REAL eprecision = EPSILON * 100;
+    INT ret_code = SUCCESS;
+
+    // Check inputs
+    if (K == 0) // no bound states to refine
+        return SUCCESS;
+    if (niter == 0) // no refinement requested
+        return SUCCESS;
+    if (bound_states == NULL)
+        return E_INVALID_ARGUMENT(bound_states);
+    if (transfer_matrix == NULL)
+        return E_INVALID_ARGUMENT(transfer_matrix);
+
+    // Allocate memory
+    z = malloc(3*K * sizeof(COMPLEX));
+    dH11 = malloc((deg + 1) * sizeof(COMPLEX));
+    active = malloc(K * sizeof(UINT));
+    if (z == NULL || dH11 == NULL || active == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+    vals = z + K;
+    derivs = vals + K;
+
+    // Coefficients of H11'(z)
+    for (i = 0; i < deg; i++)
+        dH11[i] = (deg - i) * transfer_matrix[i];
+
+    // Coordinate transform (from continuous-time to discrete-time domain)
+    memcpy(z, bound_states, K * sizeof(COMPLEX));
+    ret_code = nse_lambda_to_z(K, eps_t, z, discretization);
+    CHECK_RETCODE(ret_code, leave_fun);
+    n = K;
+    for (i = 0; i < K; i++)
+        active[i] = i;
+
+    // Perform iterations of Newton's method
+    for (iter = 0; iter < niter && n > 0; iter++) {
+
+        // Evaluate H11(z) and H11'(z) at all roots that are still active
+        for (i = 0; i < n; i++) {
+            vals[i] = z[active[i]];
+            derivs[i] = z[active[i]];
+        }
+        ret_code = poly_eval_multipoint_rings(deg, transfer_matrix, n, vals);
+        CHECK_RETCODE(ret_code, leave_fun);
+        ret_code = poly_eval_multipoint_rings(deg - 1, dH11, n, derivs);
+        CHECK_RETCODE(ret_code, leave_fun);
+
+        // Perform Newton updates: z[i] <- z[i] - H11(z[i])/H11'(z[i])
+        for (i = 0; i < n; i++) {
+            if (derivs[i] == 0.0) {
+                ret_code = E_DIV_BY_ZERO;
+                goto leave_fun;
+            }
+            z[active[i]] -= vals[i] / derivs[i];
+        }
+
+        // Map back to the continuous-time domain and check for convergence.
+        // Roots that have converged or left the bounding box are no longer
+        // updated.
+        for (i = 0, j = 0; i < n; i++) {
+            lam = z[active[i]];
+            ret_code = nse_z_to_lambda(1, eps_t, &lam, discretization);
+            CHECK_RETCODE(ret_code, leave_fun);
+
+            const REAL error = CABS(lam - bound_states[active[i]]);
+            bound_states[active[i]] = lam;
+
+            if (CREAL(lam) < bounding_box[0]
+                || CREAL(lam) > bounding_box[1]
+                || CIMAG(lam) < bounding_box[2]
+                || CIMAG(lam) > bounding_box[3]
+                || error <= eprecision)
+                continue;
+            active[j++] = active[i];
+        }
+        n = j;
+    }
+
+leave_fun:
+    free(z);
+    free(dH11);
+    free(active);
+    return ret_code;
+}
+
+// Auxiliary function: Refines the bound-states using Newton's method as
+// specified by opts->bound_state_refinement.
+INT nsev_refine_bound_states(
+    const UINT D,
+    sample_desc_t const * const q,
+    REAL const * const T,
+    const UINT deg,
+    COMPLEX * const transfer_matrix,
+    const REAL eps_t,
+    const UINT K,
+    COMPLEX * const bound_states,
+    fnft_nsev_opts_t * const opts)
+{
+    REAL bounding_box[4];
+    REAL degree1step;
+    INT ret_code = SUCCESS;
+
+    switch (opts->bound_state_refinement) {
+
+        case nsev_bsref_BO:
+            ret_code = refine_roots_newton(D, q, T, K, bound_states,
+                nse_discretization_BO, opts->niter);
+            CHECK_RETCODE(ret_code, leave_fun);
+            break;
+
+        case nsev_bsref_POLY:
+        case nsev_bsref_POLY_AND_BO:
+            // Iterations are restricted to the region in which the full
+            // filter would accept bound states
+            degree1step = nse_discretization_degree(opts->discretization);
+            if (degree1step == 0)
+                return E_INVALID_ARGUMENT(opts->discretization);
+            bounding_box[1] = nsev_re_bound(eps_t, 2/degree1step);
+            bounding_box[0] = -bounding_box[1];
+            bounding_box[2] = 0.0;
+            bounding_box[3] = nsev_im_bound(D, q, T);
+            ret_code = refine_roots_newton_poly(deg, transfer_matrix, eps_t,
+                K, bound_states, bounding_box, opts->discretization,
+                opts->niter);
+            CHECK_RETCODE(ret_code, leave_fun);
+
+            // Polish using a single step of the BO scheme
+            if (opts->bound_state_refinement == nsev_bsref_POLY_AND_BO) {
+                ret_code = refine_roots_newton(D, q, T, K, bound_states,
+                    nse_discretization_BO, 1);
+                CHECK_RETCODE(ret_code, leave_fun);
+            }
+            break;
+
+        default:
+            return E_INVALID_ARGUMENT(opts->bound_state_refinement);
+    }
+
+leave_fun:
+    return ret_code;
+}
@@ -0,0 +1,180 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* Sander Wahls (TU Delft) 2017-2018.
+*/
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <stdlib.h>
+#include <string.h>
+#include "fnft__errwarn.h"
+#include "fnft__poly_eval.h"
+#include "fnft__poly_eval_multipoint.h"
+#include "fnft__poly_chirpz.h"
+#include "fnft__fft_wrapper.h"
+#include "fnft__misc.h"
+
+// Rings with at most this many points, and polynomials with at most this
+// degree, are evaluated using Horner's method.
+#define SMALL_LEN 32
+
+// Auxiliary data type and comparison function used to sort the points
+// with respect to their absolute values.
+typedef struct {
+    REAL log_abs;
+    UINT idx;
+} point_t;
+
+static int cmp_points(const void *a, const void *b)
+{
+    const REAL x = ((point_t const *)a)->log_abs;
+    const REAL y = ((point_t const *)b)->log_abs;
+    return (x > y) - (x < y);
+}
+
+INT poly_eval_multipoint_rings(const UINT deg, COMPLEX const * const p,
+    const UINT nz, COMPLEX * const z)
+{
+    point_t *points = NULL;
+    COMPLEX *c = NULL, *vals = NULL, *delta = NULL, *pows = NULL, *acc;
+    UINT *grid_idx = NULL;
+    UINT i, j, k, m, n, N, J, fft_len, nrem;
+    REAL log_r0, r0, x, term;
+    INT ret_code = SUCCESS;
+
+    // Maximum number of terms in the Taylor series
+    const UINT J_max = 64;
+
+    // Check inputs
+    if (p == NULL)
+        return E_INVALID_ARGUMENT(p);
+    if (z == NULL)
+        return E_INVALID_ARGUMENT(z);
+
+    // Horner's method is faster for small problems
+    if (nz <= SMALL_LEN || deg <= SMALL_LEN)
+        return poly_eval(deg, p, nz, z);
+
+    // Number of grid points per ring and length of the FFTs used by
+    // poly_chirpz
+    N = fft_wrapper_next_fft_length(4*(deg + 1));
+    fft_len = fft_wrapper_next_fft_length(N + deg);
+    const COMPLEX W = CEXP(2*PI*I/N);
+    const REAL width = 2*PI/N;
+
+    // Allocate memory
+    points = malloc(nz * sizeof(point_t));
+    c = malloc((deg + 1) * sizeof(COMPLEX));
+    vals = malloc(N * sizeof(COMPLEX));
+    delta = malloc(3*nz * sizeof(COMPLEX));
+    grid_idx = malloc(nz * sizeof(UINT));
+    if (points == NULL || c == NULL || vals == NULL || delta == NULL
+        || grid_idx == NULL) {
+        ret_code = E_NOMEM;
+        goto release_mem;
+    }
+    pows = delta + nz;
+    acc = pows + nz;
+
+    // Sort points by their absolute values. The value at zero is known.
+    n = 0;
+    for (i = 0; i < nz; i++) {
+        if (z[i] == 0.0) {
+            z[i] = p[deg];
+        } else {
+            points[n].log_abs = LOG(CABS(z[i]));
+            points[n].idx = i;
+            n++;
+        }
+    }
+    qsort(points, n, sizeof(point_t), cmp_points);
+
+    // Process the rings one by one
+    for (i = 0; i < n; i = j) {
+
+        // Points i,...,j-1 form the current ring
+        j = i + 1;
+        while (j < n && points[j].log_abs <= points[i].log_abs + width)
+            j++;
+        log_r0 = 0.5*(points[i].log_abs + points[j - 1].log_abs);
+        r0 = EXP(log_r0);
+
+        // Determine the closest grid points r0*W^m and the distances to them
+        x = 0.0;
+        for (k = i; k < j; k++) {
+            const COMPLEX zk = z[points[k].idx];
+            REAL phi = CARG(zk);
+            if (phi < 0)
+                phi += 2*PI;
+            m = (UINT)ROUND(phi / width) % N;
+            grid_idx[k - i] = m;
+            delta[k - i] = zk - r0*CEXP(I*width*m);
+            if (CABS(delta[k - i]) > x)
+                x = CABS(delta[k - i]);
+        }
+
+        // Determine the number of terms in the Taylor series. Since
+        // |p^(j)(w)/j!|*|delta|^j <= (deg*|delta|/r0)^j/j! * sum_k |p_k|r0^k,
+        // it suffices that the bound x^j/j! falls below machine precision.
+        x *= deg/r0;
+        term = 1.0;
+        for (J = 1; J < J_max && (term > EPSILON || J <= x); J++)
+            term *= x/J;
+        if (J > deg + 1)
+            J = deg + 1;
+
+        // Use Horner's method if the ring contains only few points
+        nrem = j - i;
+        if (J == J_max || (REAL)nrem*(deg + 1)
+            < 3.0*J*fft_len*LOG2(fft_len)) {
+            for (k = i; k < j; k++)
+                acc[k - i] = z[points[k].idx];
+            ret_code = poly_eval(deg, p, nrem, acc);
+            CHECK_RETCODE(ret_code, release_mem);
+            for (k = i; k < j; k++)
+                z[points[k].idx] = acc[k - i];
+            continue;
+        }
+
+        // Sum up the Taylor series around the grid points. In iteration
+        // m, the array c contains the coefficients of p^(m)(z)/m!.
+        memcpy(c, p, (deg + 1) * sizeof(COMPLEX));
+        for (k = 0; k < nrem; k++) {
+            acc[k] = 0.0;
+            pows[k] = 1.0;
+        }
+        for (m = 0; m < J; m++) {
+            ret_code = poly_chirpz(deg - m, c, 1.0/r0, W, N, vals);
+            CHECK_RETCODE(ret_code, release_mem);
+            for (k = 0; k < nrem; k++) {
+                acc[k] += vals[grid_idx[k]] * pows[k];
+                pows[k] *= delta[k];
+            }
+            for (k = 0; k < deg - m; k++)
+                c[k] *= (REAL)(deg - m - k) / (m + 1);
+        }
+        for (k = i; k < j; k++)
+            z[points[k].idx] = acc[k - i];
+    }
+
+release_mem:
+    free(points);
+    free(c);
+    free(vals);
+    free(delta);
+    free(grid_idx);
+    return ret_code;
+}
@@ -268,6 +268,202 @@ leave_fun:
     return ret_code;
 }
 
+// Auxiliary function: Packs the real parts of the coefficients of the two
+// polynomials a(z) and b(z) of degree deg into buf=a+j*b and pads with zeros.
+static inline void poly_pack_real(const UINT deg, const UINT len,
+    COMPLEX const * const a, COMPLEX const * const b, COMPLEX * const buf)
+{
+    UINT i;
+    for (i = 0; i <= deg; i++)
+        buf[i] = CREAL(a[i]) + I*CREAL(b[i]);
+    for (i = deg + 1; i < len; i++)
+        buf[i] = 0.0;
+}
+
+// Auxiliary function: Same as poly_fmult_two_polys2x2, but for matrices of
+// polynomials with real coefficients. The imaginary parts of the coefficients
+// are ignored. Since the FFT of a real sequence is conjugate symmetric, the
+// FFTs of two real polynomials a(z) and b(z) can be recovered from the FFT X
+// of a+j*b via A[k]=(X[k]+conj(X[len-k]))/2 and
+// B[k]=(X[k]-conj(X[len-k]))/(2j). The rows of the first factor and the
+// columns of the second factor are packed in this way. The real rows of the
+// product are packed in the same way before the inverse FFTs. A product thus
+// requires six FFTs instead of the 24 FFTs in poly_fmult_two_polys2x2. The
+// five buffers have to be of the length returned by poly_fmult_two_polys_len.
+static INT poly_fmult_two_polys2x2_real(const UINT deg,
+    COMPLEX const * const p1_11,
+    const UINT p1_stride,
+    COMPLEX const * const p2_11,
+    const UINT p2_stride,
+    COMPLEX * const result_11,
+    const UINT result_stride,
+    fft_wrapper_plan_t plan_fwd,
+    fft_wrapper_plan_t plan_inv,
+    COMPLEX * const buf0,
+    COMPLEX * const X1,
+    COMPLEX * const X2,
+    COMPLEX * const Y1,
+    COMPLEX * const Y2)
+{
+    UINT i, k, m;
+    COMPLEX a11, a12, a21, a22, b11, b12, b21, b22;
+    COMPLEX r11, r12, r21, r22;
+    INT ret_code;
+
+    const UINT len = poly_fmult_two_polys_len(deg);
+
+    COMPLEX const * const p1_12 = p1_11 + p1_stride;
+    COMPLEX const * const p1_21 = p1_12 + p1_stride;
+    COMPLEX const * const p1_22 = p1_21 + p1_stride;
+
+    COMPLEX const * const p2_12 = p2_11 + p2_stride;
+    COMPLEX const * const p2_21 = p2_12 + p2_stride;
+    COMPLEX const * const p2_22 = p2_21 + p2_stride;
+
+    COMPLEX * const result_12 = result_11 + result_stride;
+    COMPLEX * const result_21 = result_12 + result_stride;
+    COMPLEX * const result_22 = result_21 + result_stride;
+
+    // FFTs of the rows of p1 and of the columns of p2
+    poly_pack_real(deg, len, p1_11, p1_12, buf0);
+    ret_code = fft_wrapper_execute_plan(plan_fwd, buf0, X1);
+    CHECK_RETCODE(ret_code, leave_fun);
+    poly_pack_real(deg, len, p1_21, p1_22, buf0);
+    ret_code = fft_wrapper_execute_plan(plan_fwd, buf0, X2);
+    CHECK_RETCODE(ret_code, leave_fun);
+    poly_pack_real(deg, len, p2_11, p2_21, buf0);
+    ret_code = fft_wrapper_execute_plan(plan_fwd, buf0, Y1);
+    CHECK_RETCODE(ret_code, leave_fun);
+    poly_pack_real(deg, len, p2_12, p2_22, buf0);
+    ret_code = fft_wrapper_execute_plan(plan_fwd, buf0, Y2);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Unpack, multiply and pack the rows of the product. The values at
+    // len-k are the complex conjugates of those at k, so that both can be
+    // overwritten in the same iteration.
+    for (k = 0; k <= len/2; k++) {
+        m = (len - k) % len;
+
+        a11 = (X1[k] + CONJ(X1[m]))/2;
+        a12 = (X1[k] - CONJ(X1[m]))/(2*I);
+        a21 = (X2[k] + CONJ(X2[m]))/2;
+        a22 = (X2[k] - CONJ(X2[m]))/(2*I);
+        b11 = (Y1[k] + CONJ(Y1[m]))/2;
+        b21 = (Y1[k] - CONJ(Y1[m]))/(2*I);
+        b12 = (Y2[k] + CONJ(Y2[m]))/2;
+        b22 = (Y2[k] - CONJ(Y2[m]))/(2*I);
+
+        r11 = a11*b11 + a12*b21;
+        r12 = a11*b12 + a12*b22;
+        r21 = a21*b11 + a22*b21;
+        r22 = a21*b12 + a22*b22;
+
+        X1[k] = r11 + I*r12;
+        X1[m] = CONJ(r11) + I*CONJ(r12);
+        X2[k] = r21 + I*r22;
+        X2[m] = CONJ(r21) + I*CONJ(r22);
+    }
+
+    // Inverse FFTs and extraction of the result
+    ret_code = fft_wrapper_execute_plan(plan_inv, X1, buf0);
+    CHECK_RETCODE(ret_code, leave_fun);
+    for (i = 0; i < 2*deg + 1; i++) {
+        result_11[i] = CREAL(buf0[i])/len;
+        result_12[i] = CIMAG(buf0[i])/len;
+    }
+    ret_code = fft_wrapper_execute_plan(plan_inv, X2, buf0);
+    CHECK_RETCODE(ret_code, leave_fun);
+    for (i = 0; i < 2*deg + 1; i++) {
+        result_21[i] = CREAL(buf0[i])/len;
+        result_22[i] = CIMAG(buf0[i])/len;
+    }
+
+leave_fun:
+    return ret_code;
+}
+
+// Auxiliary function: Checks if the 2x2 matrix of polynomials of degree deg
+// that starts at p11 is of the form diag(c[0]*z^(deg-j[0]), c[1]*z^(deg-j[1])).
+// Such factors occur for example for zero samples and as padding in
+// fnft__poly_fmult2x2. Zero polynomials are represented by c=0.
+static INT poly_is_diag_monomial2x2(const UINT deg,
+    COMPLEX const * const p11, const UINT stride, COMPLEX * const c,
+    UINT * const j)
+{
+    COMPLEX const * const p12 = p11 + stride;
+    COMPLEX const * const p21 = p12 + stride;
+    COMPLEX const * const p22 = p21 + stride;
+    UINT i;
+
+    c[0] = 0.0;
+    c[1] = 0.0;
+    j[0] = 0;
+    j[1] = 0;
+    for (i=0; i<=deg; i++) {
+        if (p12[i] != 0.0 || p21[i] != 0.0)
+            return 0;
+        if (p11[i] != 0.0) {
+            if (c[0] != 0.0)
+                return 0;
+            c[0] = p11[i];
+            j[0] = i;
+        }
+        if (p22[i] != 0.0) {
+            if (c[1] != 0.0)
+                return 0;
+            c[1] = p22[i];
+            j[1] = i;
+        }
+    }
+    return 1;
+}
+
+// Auxiliary function: Multiplies the polynomial p of degree deg with the
+// monomial c*z^(deg-j). The product of degree 2*deg is stored in result.
+// This is just an index shift.
+static void poly_mult_monomial(const UINT deg, const COMPLEX c,
+    const UINT j, COMPLEX const * const p, COMPLEX * const result)
+{
+    UINT i;
+
+    for (i=0; i<=2*deg; i++)
+        result[i] = 0.0;
+    if (c == 0.0)
+        return;
+    for (i=0; i<=deg; i++)
+        result[j+i] = c*p[i];
+}
+
+// Auxiliary function: Computes the product of the 2x2 matrices of
+// polynomials of degree deg that start at p1 and p2 if one of them is a
+// diagonal matrix of monomials. Returns 0 without touching result
+// otherwise.
+static INT poly_mult2x2_diag_monomial(const UINT deg,
+    COMPLEX const * const p1, COMPLEX const * const p2, const UINT p_stride,
+    COMPLEX * const result, const UINT r_stride)
+{
+    COMPLEX c[2];
+    UINT j[2];
+
+    if (poly_is_diag_monomial2x2(deg, p1, p_stride, c, j)) {
+        // Left factor diagonal: rows of p2 are shifted
+        poly_mult_monomial(deg, c[0], j[0], p2, result);
+        poly_mult_monomial(deg, c[0], j[0], p2+p_stride, result+r_stride);
+        poly_mult_monomial(deg, c[1], j[1], p2+2*p_stride, result+2*r_stride);
+        poly_mult_monomial(deg, c[1], j[1], p2+3*p_stride, result+3*r_stride);
+        return 1;
+    }
+    if (poly_is_diag_monomial2x2(deg, p2, p_stride, c, j)) {
+        // Right factor diagonal: columns of p1 are shifted
+        poly_mult_monomial(deg, c[0], j[0], p1, result);
+        poly_mult_monomial(deg, c[1], j[1], p1+p_stride, result+r_stride);
+        poly_mult_monomial(deg, c[0], j[0], p1+2*p_stride, result+2*r_stride);
+        poly_mult_monomial(deg, c[1], j[1], p1+3*p_stride, result+3*r_stride);
+        return 1;
+    }
+    return 0;
+}
+
 static inline INT poly_rescale2x2(const UINT d,
     COMPLEX * const p11,
     COMPLEX * const p12,
@@ -319,8 +515,12 @@ static inline INT poly_rescale2x2(const UINT d,
 * length of result = m*m*(n/2)*(2*deg+1)
 * WARNING: p is overwritten
 */
-INT fnft__poly_fmult2x2(UINT * const d, UINT n, COMPLEX * const p,
-    COMPLEX * const result, INT * const W_ptr)
+// Auxiliary function: Implements fnft__poly_fmult2x2 and
+// fnft__poly_fmult2x2_real. If real_flag is set, all coefficients are
+// assumed to be real and the products are computed with
+// poly_fmult_two_polys2x2_real.
+static INT poly_fmult2x2_impl(UINT * const d, UINT n, COMPLEX * const p,
+    COMPLEX * const result, INT * const W_ptr, const INT real_flag)
 {
     UINT i, j, deg, lenmem, len;
     UINT o1, o2, or; // pointer offsets
@@ -331,6 +531,7 @@ INT fnft__poly_fmult2x2(UINT * const d, UINT n, COMPLEX * const p,
     fft_wrapper_plan_t plan_fwd = fft_wrapper_safe_plan_init();
     fft_wrapper_plan_t plan_inv = fft_wrapper_safe_plan_init();
     COMPLEX *buf0 = NULL, *buf1 = NULL, *buf2 = NULL;
+    COMPLEX *buf3 = NULL, *buf4 = NULL;
     INT W = 0;
     INT ret_code;
 
@@ -340,6 +541,14 @@ INT fnft__poly_fmult2x2(UINT * const d, UINT n, COMPLEX * const p,
     p12 = p11 + n*(deg+1);
     p21 = p12 + n*(deg+1);
     p22 = p21 + n*(deg+1);
+
+    // Nothing to multiply if there is only one matrix
+    if (n == 1) {
+        memcpy(result, p, 4*(deg+1)*sizeof(COMPLEX));
+        if (W_ptr != NULL)
+            *W_ptr = 0;
+        return SUCCESS;
+    }
    
     // Pad if n is not a power of two
     const UINT n_excess = misc_nextpowerof2(n) - n;
@@ -394,6 +603,14 @@ INT fnft__poly_fmult2x2(UINT * const d, UINT n, COMPLEX * const p,
         ret_code = E_NOMEM;
         goto release_mem;
     }
+    if (real_flag) {
+        buf3 = fft_wrapper_malloc(lenmem);
+        buf4 = fft_wrapper_malloc(lenmem);
+        if (buf3 == NULL || buf4 == NULL) {
+            ret_code = E_NOMEM;
+            goto release_mem;
+        }
+    }
 
     const UINT p_stride = n*(deg + 1);
 
@@ -422,10 +639,21 @@ INT fnft__poly_fmult2x2(UINT * const d, UINT n, COMPLEX * const p,
         // Multiply all pairs of polynomials, normalize if desired
         for (i=0; i<n; i+=2) {
 
-            ret_code = poly_fmult_two_polys2x2(deg, p+o1, p_stride, p+o2,
-                p_stride, result+or, r_stride, plan_fwd, plan_inv, buf0, buf1,
-                buf2);
-            CHECK_RETCODE(ret_code, release_mem);
+            // Products with diagonal monomial matrices (e.g., from runs of
+            // zero samples or from padding) reduce to index shifts of the
+            // rows or columns of the other factor. Otherwise, use FFTs.
+            if (!poly_mult2x2_diag_monomial(deg, p+o1, p+o2, p_stride,
+                result+or, r_stride)) {
+                if (real_flag)
+                    ret_code = poly_fmult_two_polys2x2_real(deg, p+o1,
+                        p_stride, p+o2, p_stride, result+or, r_stride,
+                        plan_fwd, plan_inv, buf0, buf1, buf2, buf3, buf4);
+                else
+                    ret_code = poly_fmult_two_polys2x2(deg, p+o1, p_stride,
+                        p+o2, p_stride, result+or, r_stride, plan_fwd,
+                        plan_inv, buf0, buf1, buf2);
+                CHECK_RETCODE(ret_code, release_mem);
+            }
 
             // Normalize if desired
             if (W_ptr != NULL)
@@ -481,6 +709,173 @@ release_mem:
     fft_wrapper_free(buf0);
     fft_wrapper_free(buf1);
     fft_wrapper_free(buf2);
+    fft_wrapper_free(buf3);
+    fft_wrapper_free(buf4);
     return ret_code;
 }
 
+INT fnft__poly_fmult2x2(UINT * const d, UINT n, COMPLEX * const p,
+    COMPLEX * const result, INT * const W_ptr)
+{
+    return poly_fmult2x2_impl(d, n, p, result, W_ptr, 0);
+}
+
+INT fnft__poly_fmult2x2_real(UINT * const d, UINT n, COMPLEX * const p,
+    COMPLEX * const result, INT * const W_ptr)
+{
+    return poly_fmult2x2_impl(d, n, p, result, W_ptr, 1);
+}
+
+/*
+* length of p1 = 4*(deg1+1), length of p2 = 4*(deg2+1)
+* length of result = 4*(deg1+deg2+1)
+*/
+INT fnft__poly_fmult2x2_pair(const UINT deg1, COMPLEX const * const p1,
+    const UINT deg2, COMPLEX const * const p2, COMPLEX * const result,
+    INT * const W_ptr)
+{
+    COMPLEX *p = NULL, *r = NULL;
+    UINT i, k, deg;
+    INT ret_code = SUCCESS;
+
+    // Check inputs
+    if (p1 == NULL)
+        return E_INVALID_ARGUMENT(p1);
+    if (p2 == NULL)
+        return E_INVALID_ARGUMENT(p2);
+    if (result == NULL)
+        return E_INVALID_ARGUMENT(result);
+
+    // Allocate memory
+    deg = (deg1 > deg2) ? deg1 : deg2;
+    i = poly_fmult2x2_numel(deg, 2);
+    p = malloc(i * sizeof(COMPLEX));
+    r = malloc(i * sizeof(COMPLEX));
+    if (p == NULL || r == NULL) {
+        ret_code = E_NOMEM;
+        goto release_mem;
+    }
+
+    // Each of the four blocks of p contains the corresponding polynomial
+    // of p1 followed by the one of p2. Both are padded with leading zeros
+    // to the same degree.
+    for (k=0; k<4; k++) {
+        COMPLEX * const q1 = p + 2*k*(deg + 1);
+        COMPLEX * const q2 = q1 + (deg + 1);
+        for (i=0; i<deg-deg1; i++)
+            q1[i] = 0.0;
+        memcpy(q1 + deg - deg1, p1 + k*(deg1 + 1),
+            (deg1 + 1) * sizeof(COMPLEX));
+        for (i=0; i<deg-deg2; i++)
+            q2[i] = 0.0;
+        memcpy(q2 + deg - deg2, p2 + k*(deg2 + 1),
+            (deg2 + 1) * sizeof(COMPLEX));
+    }
+    ret_code = poly_fmult2x2(&deg, 2, p, r, W_ptr);
+    CHECK_RETCODE(ret_code, release_mem);
+
+    // Remove the leading zeros caused by the padding
+    for (k=0; k<4; k++)
+        memcpy(result + k*(deg1 + deg2 + 1),
+            r + k*(deg + 1) + (deg - deg1 - deg2),
+            (deg1 + deg2 + 1) * sizeof(COMPLEX));
+
+release_mem:
+    free(p);
+    free(r);
+    return ret_code;
+}
+
+/*
+* length of p1 = 4*(deg1+1), length of p2 = 4*(deg2+1)
+* length of result_bar = 4*(deg1+deg2+1)
+*/
+INT fnft__poly_fmult2x2_pair_adjoint(const UINT deg1, COMPLEX const * const p1,
+    const UINT deg2, COMPLEX const * const p2,
+    COMPLEX const * const result_bar, COMPLEX * const p1_bar,
+    COMPLEX * const p2_bar)
+{
+    COMPLEX *buf = NULL, *F1, *F2, *Fr, *tmp;
+    fft_wrapper_plan_t plan_fwd = fft_wrapper_safe_plan_init();
+    fft_wrapper_plan_t plan_inv = fft_wrapper_safe_plan_init();
+    UINT i, k, p, q, r;
+    INT ret_code = SUCCESS;
+
+    // Check inputs
+    if (p1 == NULL)
+        return E_INVALID_ARGUMENT(p1);
+    if (p2 == NULL)
+        return E_INVALID_ARGUMENT(p2);
+    if (result_bar == NULL)
+        return E_INVALID_ARGUMENT(result_bar);
+    if (p1_bar == NULL)
+        return E_INVALID_ARGUMENT(p1_bar);
+    if (p2_bar == NULL)
+        return E_INVALID_ARGUMENT(p2_bar);
+
+    // The cross-correlations only need the lags 0,...,deg1 resp. deg2, so
+    // circular correlations of length deg1+deg2+1 do not wrap around
+    const UINT deg = deg1 + deg2;
+    const UINT len = fft_wrapper_next_fft_length(deg + 1);
+    buf = fft_wrapper_malloc(14*len * sizeof(COMPLEX));
+    if (buf == NULL) {
+        ret_code = E_NOMEM;
+        goto release_mem;
+    }
+    F1 = buf;
+    F2 = F1 + 4*len;
+    Fr = F2 + 4*len;
+    tmp = Fr + 4*len;
+    ret_code = fft_wrapper_create_plan(&plan_fwd, len, tmp, tmp + len, -1);
+    CHECK_RETCODE(ret_code, release_mem);
+    ret_code = fft_wrapper_create_plan(&plan_inv, len, tmp, tmp + len, 1);
+    CHECK_RETCODE(ret_code, release_mem);
+
+    // FFTs of the elements of p1, p2 and result_bar
+    for (k=0; k<4; k++) {
+        for (i=0; i<len; i++)
+            tmp[i] = (i <= deg1) ? p1[k*(deg1 + 1) + i] : 0.0;
+        ret_code = fft_wrapper_execute_plan(plan_fwd, tmp, F1 + k*len);
+        CHECK_RETCODE(ret_code, release_mem);
+        for (i=0; i<len; i++)
+            tmp[i] = (i <= deg2) ? p2[k*(deg2 + 1) + i] : 0.0;
+        ret_code = fft_wrapper_execute_plan(plan_fwd, tmp, F2 + k*len);
+        CHECK_RETCODE(ret_code, release_mem);
+        for (i=0; i<len; i++)
+            tmp[i] = (i <= deg) ? result_bar[k*(deg + 1) + i] : 0.0;
+        ret_code = fft_wrapper_execute_plan(plan_fwd, tmp, Fr + k*len);
+        CHECK_RETCODE(ret_code, release_mem);
+    }
+
+    // Since result_pq = sum_r p1_pr*p2_rq, we have
+    // p1_bar_pr = sum_q corr(result_bar_pq, p2_rq) and
+    // p2_bar_rq = sum_p corr(result_bar_pq, p1_pr)
+    for (p=0; p<2; p++) {
+        for (r=0; r<2; r++) {
+            for (i=0; i<len; i++)
+                tmp[i] = Fr[(2*p)*len + i]*CONJ(F2[(2*r)*len + i])
+                    + Fr[(2*p + 1)*len + i]*CONJ(F2[(2*r + 1)*len + i]);
+            ret_code = fft_wrapper_execute_plan(plan_inv, tmp, tmp + len);
+            CHECK_RETCODE(ret_code, release_mem);
+            for (i=0; i<=deg1; i++)
+                p1_bar[(2*p + r)*(deg1 + 1) + i] = tmp[len + i]/len;
+        }
+    }
+    for (r=0; r<2; r++) {
+        for (q=0; q<2; q++) {
+            for (i=0; i<len; i++)
+                tmp[i] = Fr[q*len + i]*CONJ(F1[r*len + i])
+                    + Fr[(2 + q)*len + i]*CONJ(F1[(2 + r)*len + i]);
+            ret_code = fft_wrapper_execute_plan(plan_inv, tmp, tmp + len);
+            CHECK_RETCODE(ret_code, release_mem);
+            for (i=0; i<=deg2; i++)
+                p2_bar[(2*r + q)*(deg2 + 1) + i] = tmp[len + i]/len;
+        }
+    }
+
+release_mem:
+    fft_wrapper_destroy_plan(&plan_fwd);
+    fft_wrapper_destroy_plan(&plan_inv);
+    fft_wrapper_free(buf);
+    return ret_code;
+}
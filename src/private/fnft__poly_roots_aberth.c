@@ -0,0 +1,244 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* Sander Wahls (TU Delft) 2017-2018.
+*/
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <stdlib.h>
+#include "fnft__errwarn.h"
+#include "fnft__poly_roots_aberth.h"
+#include "fnft__poly_eval_multipoint.h"
+
+// Maximum number of iterations
+#define MAX_ITER 500
+
+// Auxiliary function: Evaluates the polynomial with the coefficients c at
+// the nonnegative real point x using Horner's method.
+static inline REAL horner_real(const UINT deg, REAL const * const c,
+    const REAL x)
+{
+    REAL val = c[0];
+    UINT i;
+    for (i = 1; i <= deg; i++)
+        val = val*x + c[i];
+    return val;
+}
+
+// Auxiliary function: Computes the Newton corrections p(z)/p'(z) at the n
+// points z. Points outside of the unit circle are handled using the
+// reversed polynomial rp(w)=w^deg*p(1/w) since
+// p(z)/p'(z) = z*rp(w)/(deg*rp(w)-w*rp'(w)), where w=1/z. The arrays
+// dp, rp and drp contain the coefficients of p'(z), rp(w) and rp'(w), and
+// the arrays ap and arp contain the absolute values of the coefficients of
+// p(z) and rp(w). The flag small[i] is set if |p(z[i])| (or |rp(w)|) is
+// below a bound on the rounding errors that occur during its evaluation
+// (Bini 1996, Sec. 2.2). The buffer buf has to provide space for 3*n
+// elements.
+static INT newton_corrections(const UINT deg, COMPLEX const * const p,
+    COMPLEX const * const dp, COMPLEX const * const rp,
+    COMPLEX const * const drp, REAL const * const ap,
+    REAL const * const arp, const UINT n, COMPLEX const * const z,
+    COMPLEX * const result, INT * const small, UINT * const idx,
+    COMPLEX * const buf)
+{
+    COMPLEX * const vals = buf;
+    COMPLEX * const ders = buf + n;
+    COMPLEX * const w = buf + 2*n;
+    const REAL tol = 4*deg*EPSILON;
+    UINT i, n_in, n_out;
+    INT ret_code = SUCCESS;
+
+    // Sort points: Points inside the unit circle are stored at the
+    // beginning of idx, points outside at the end
+    n_in = 0;
+    n_out = 0;
+    for (i = 0; i < n; i++) {
+        if (CABS(z[i]) <= 1.0)
+            idx[n_in++] = i;
+        else
+            idx[n - 1 - n_out++] = i;
+    }
+
+    // Points inside the unit circle
+    for (i = 0; i < n_in; i++) {
+        vals[i] = z[idx[i]];
+        ders[i] = z[idx[i]];
+    }
+    ret_code = poly_eval_multipoint_rings(deg, p, n_in, vals);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = poly_eval_multipoint_rings(deg - 1, dp, n_in, ders);
+    CHECK_RETCODE(ret_code, leave_fun);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (i = 0; i < n_in; i++) {
+        result[idx[i]] = vals[i] / ders[i];
+        small[idx[i]] = CABS(vals[i])
+            <= tol*horner_real(deg, ap, CABS(z[idx[i]]));
+    }
+
+    // Points outside the unit circle
+    for (i = n_in; i < n; i++) {
+        w[i] = 1.0 / z[idx[i]];
+        vals[i] = w[i];
+        ders[i] = w[i];
+    }
+    ret_code = poly_eval_multipoint_rings(deg, rp, n_out, vals + n_in);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = poly_eval_multipoint_rings(deg - 1, drp, n_out, ders + n_in);
+    CHECK_RETCODE(ret_code, leave_fun);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for (i = n_in; i < n; i++) {
+        result[idx[i]] = z[idx[i]] * vals[i] / (deg*vals[i] - w[i]*ders[i]);
+        small[idx[i]] = CABS(vals[i])
+            <= tol*horner_real(deg, arp, CABS(w[i]));
+    }
+
+leave_fun:
+    return ret_code;
+}
+
+// Auxiliary function: Aberth-Ehrlich iteration for a polynomial with
+// nonzero leading coefficient.
+static INT aberth(const UINT deg, COMPLEX const * const p,
+    COMPLEX * const roots)
+{
+    COMPLEX *dp = NULL, *rp, *drp, *z, *corr, *buf;
+    REAL *ap = NULL, *arp;
+    UINT *active = NULL, *idx;
+    INT *small = NULL;
+    UINT i, j, k, n, iter;
+    REAL r;
+    INT ret_code = SUCCESS;
+
+    if (deg == 0)
+        return SUCCESS;
+
+    // Allocate memory
+    dp = malloc((8*deg + 1) * sizeof(COMPLEX));
+    ap = malloc(2*(deg + 1) * sizeof(REAL));
+    active = malloc(2*deg * sizeof(UINT));
+    small = malloc(deg * sizeof(INT));
+    if (dp == NULL || ap == NULL || active == NULL || small == NULL) {
+        ret_code = E_NOMEM;
+        goto release_mem;
+    }
+    rp = dp + deg;
+    drp = rp + (deg + 1);
+    z = drp + deg;
+    corr = z + deg;
+    buf = corr + deg;
+    arp = ap + (deg + 1);
+    idx = active + deg;
+
+    // Coefficients of the derivative, of the reversed polynomial and of its
+    // derivative
+    for (i = 0; i < deg; i++)
+        dp[i] = (deg - i) * p[i];
+    for (i = 0; i <= deg; i++)
+        rp[i] = p[deg - i];
+    for (i = 0; i < deg; i++)
+        drp[i] = (deg - i) * rp[i];
+    for (i = 0; i <= deg; i++) {
+        ap[i] = CABS(p[i]);
+        arp[i] = CABS(rp[i]);
+    }
+
+    // Initial approximations on a circle whose radius is the geometric mean
+    // of the absolute values of the roots. The offset of the angles avoids
+    // symmetries w.r.t. the real axis.
+    r = (p[deg] != 0.0) ? POW(CABS(p[deg] / p[0]), 1.0/deg) : 1.0;
+    for (i = 0; i < deg; i++) {
+        roots[i] = r * CEXP(I*(2*PI*i/deg + 0.4));
+        active[i] = i;
+    }
+    n = deg;
+
+    for (iter = 0; iter < MAX_ITER && n > 0; iter++) {
+
+        // Newton corrections for the roots that have not yet converged
+        for (i = 0; i < n; i++)
+            z[i] = roots[active[i]];
+        ret_code = newton_corrections(deg, p, dp, rp, drp, ap, arp, n, z,
+            corr, small, idx, buf);
+        CHECK_RETCODE(ret_code, release_mem);
+
+        // Aberth corrections. They are computed for all roots before any of
+        // the roots is updated, so that the loop can be parallelized.
+#ifdef _OPENMP
+#pragma omp parallel for private(j, k)
+#endif
+        for (i = 0; i < n; i++) {
+            COMPLEX s = 0.0;
+            k = active[i];
+            for (j = 0; j < deg; j++) {
+                if (j != k)
+                    s += 1.0 / (roots[k] - roots[j]);
+            }
+            corr[i] = corr[i] / (1.0 - corr[i]*s);
+        }
+
+        // Update the roots. Roots for which the polynomial is already
+        // within the rounding errors or whose corrections are negligible
+        // are no longer updated.
+        for (i = 0, j = 0; i < n; i++) {
+            k = active[i];
+            if (small[i])
+                continue;
+            roots[k] -= corr[i];
+            if (CABS(corr[i]) > 4*EPSILON*CABS(roots[k])
+                && corr[i] == corr[i]) // also stop if NaN
+                active[j++] = k;
+        }
+        n = j;
+    }
+    if (n > 0)
+        WARN("Aberth iteration did not converge for all roots.");
+
+release_mem:
+    free(dp);
+    free(ap);
+    free(active);
+    free(small);
+    return ret_code;
+}
+
+// Aberth-Ehrlich root finder. See the header file for details.
+INT poly_roots_aberth(const UINT deg, COMPLEX const * const p,
+    COMPLEX * const roots)
+{
+    UINT i, m;
+
+    // Check inputs
+    if (p == NULL)
+        return E_INVALID_ARGUMENT(p);
+    if (roots == NULL)
+        return E_INVALID_ARGUMENT(roots);
+
+    // Leading zero coefficients correspond to roots at infinity
+    for (m = 0; m < deg && p[m] == 0.0; m++)
+        roots[deg - 1 - m] = INFINITY;
+    if (m == deg) {
+        for (i = 0; i < deg; i++)
+            roots[i] = NAN;
+        return SUCCESS;
+    }
+
+    return aberth(deg - m, p + m, roots);
+}
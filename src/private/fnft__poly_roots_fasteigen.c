@@ -30,6 +30,7 @@ INT poly_roots_fasteigen(const UINT deg,
     COMPLEX const * const p, COMPLEX * const roots)
 {
     INT int_deg, info;
+    UINT i, m, n;
     double threshold = 1e8;
     // This threshold was used in the original routine. Set to INFINITY to
     // enforce QR. Set to 0 to enforce QZ.
@@ -40,9 +41,25 @@ INT poly_roots_fasteigen(const UINT deg,
 	if (roots == NULL)
 		return E_INVALID_ARGUMENT(roots);
 
+    // Leading zero coefficients correspond to roots at infinity and trailing
+    // zero coefficients to roots at zero. They occur, e.g., in transfer
+    // matrices of signals with zero guard intervals and are removed since
+    // the Fortran routine does not accept them.
+    for (m = 0; m < deg && p[m] == 0.0; m++)
+        roots[deg - 1 - m] = INFINITY;
+    if (m == deg) {
+        for (i = 0; i < deg; i++)
+            roots[i] = NAN;
+        return SUCCESS;
+    }
+    for (n = 0; n < deg - m && p[deg - n] == 0.0; n++)
+        roots[deg - m - 1 - n] = 0.0;
+    if (n == deg - m)
+        return SUCCESS;
+
     // Call Fortran root finding routine
-    int_deg = (int)deg;
-    z_poly_roots_modified_(&int_deg, p, roots, &threshold, &info);
+    int_deg = (int)(deg - m - n);
+    z_poly_roots_modified_(&int_deg, p + m, roots, &threshold, &info);
     
     if (info == 0)
         return SUCCESS;
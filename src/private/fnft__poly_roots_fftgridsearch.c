@@ -19,79 +19,75 @@
 */
 #define FNFT_ENABLE_SHORT_NAMES
 
+#include <string.h>
 #include "fnft__errwarn.h"
 #include "fnft__poly_roots_fftgridsearch.h"
 #include "fnft__poly_chirpz.h"
 
-// Computation of polynomial roots on the unit circle via gridsearch.
-// *M_ptr is the number of points in the grid. The array roots
-// must be preallocated by the user with *M_ptr entries. Upon exit, *M_ptr
-// contains the number of found roots, which are located in the beginning of
-// the array roots. Returns SUCCESS or an error code.
-INT poly_roots_fftgridsearch(const UINT deg,
-    COMPLEX const * const p, UINT * const M_ptr,
-    REAL const * const PHI, COMPLEX * const roots)  
-{
-    INT ret_code;
-    COMPLEX A, W, c, zi, z0, yi, y0, zr;
-    UINT i, j, M, nroots = 0;
-    INT k;
-    COMPLEX * vals;
-    REAL tmp;
+// Parameters of poly_roots_fftgridsearch_adaptive: number of points of the
+// coarse grid per 2*PI/deg, maximum Newton step (in coarse grid spacings) at
+// candidates for roots, and number of coarse grid points around a candidate
+// at which the fine grid is evaluated.
+#define ADAPTIVE_COARSE_DENSITY 8
+#define ADAPTIVE_NEWTON 1
+#define ADAPTIVE_WINDOW 2
 
-	// Check inputs
-    if ( deg < 2 )
-        return E_INVALID_ARGUMENT(deg);
-	if (p == NULL)
-		return E_INVALID_ARGUMENT(p);
-    if (M_ptr == NULL || *M_ptr < 2)
- 		return E_INVALID_ARGUMENT(M_ptr);      
-    if (PHI == NULL || !(PHI[0] < PHI[1]) || PHI[0] == -INFINITY
-    || PHI[1] == INFINITY)
-        return E_INVALID_ARGUMENT(PHI);
-	if (roots == NULL)
-		return E_INVALID_ARGUMENT(roots);
+// Minimum number of interior grid points per tile in
+// poly_roots_fftgridsearch and poly_roots_fftgridsearch_paraherm
+#define GRIDSEARCH_TILE_LEN 16384
 
-    // Allocate memory
-    M = *M_ptr;
-    vals = malloc(3*M * sizeof(COMPLEX));
-    if (vals == NULL) {
-        ret_code = E_NOMEM;
-        goto release_mem;
-    }
+// Auxiliary function: Scans the values vals of a polynomial on the three
+// rings of the grid, see poly_roots_fftgridsearch, for roots. The detected
+// roots are appended to the array roots, which has space for capacity
+// entries. *nroots_ptr is the number of roots in the array and is updated.
+static INT gridsearch_scan(const UINT M, COMPLEX const * const vals,
+    REAL const * const PHI, const UINT capacity, COMPLEX * const roots,
+    UINT * const nroots_ptr)
+{
+    COMPLEX c, zi, z0, yi, y0, zr;
+    UINT i, j, nroots = *nroots_ptr;
+    INT k;
+    REAL tmp, mag[3][3];
+    UINT l, l_prev, l_next;
 
-    // Evaluate polynomial using the Chirp transform on three rings
     const REAL eps = (PHI[1] - PHI[0]) / (M - 1);
-    W = CEXP(I*eps);
-    for (k=-1; k<=1; k++) {
 
-        A = (1.0 + k*eps) * CEXP(-I*PHI[0]);
-        ret_code = poly_chirpz(deg, p, A, W, M, vals + (k+1)*M);
-        CHECK_RETCODE(ret_code, release_mem);
+    // The absolute values of the three columns of the moving grid of nine
+    // points around the current test point are kept in mag[ring][i%3], so
+    // that each absolute value is only computed once
+    for (k=0; k<3; k++) {
+        mag[k][0] = CABS(vals[k*M]);
+        mag[k][1] = CABS(vals[k*M + 1]);
     }
 
     // Approximate the roots
     for (i=1; i<M-1; i++) {
 
+        l_prev = (i - 1) % 3;
+        l = i % 3;
+        l_next = (i + 1) % 3;
+        for (k=0; k<3; k++)
+            mag[k][l_next] = CABS(vals[k*M + i + 1]);
+
         // Minimum modulus theorem => minimum absolute value must be on the
         // boundary of a domain around the current test poINT unless there is a
         // root. Keep track of absolute values of moving grid of nine points.
-        tmp = CABS( vals[M + i] );
-        if ( tmp > CABS(vals[i - 1]) )
+        tmp = mag[1][l];
+        if ( tmp > mag[0][l_prev] )
             continue;
-        if ( tmp > CABS(vals[i]) )
+        if ( tmp > mag[0][l] )
             continue;
-        if ( tmp > CABS(vals[i + 1]) )
+        if ( tmp > mag[0][l_next] )
             continue;
-        if ( tmp > CABS(vals[M + i - 1]) )
+        if ( tmp > mag[1][l_prev] )
             continue;
-        if ( tmp > CABS(vals[M + i + 1]) )
+        if ( tmp > mag[1][l_next] )
             continue;
-        if ( tmp > CABS(vals[2*M + i - 1]) )
+        if ( tmp > mag[2][l_prev] )
             continue;
-        if ( tmp > CABS(vals[2*M + i]) )
+        if ( tmp > mag[2][l] )
             continue;
-        if ( tmp > CABS(vals[2*M + i + 1]) )
+        if ( tmp > mag[2][l_next] )
             continue;
 
         // Let z0 be the center point of the current grid such that
@@ -115,10 +111,8 @@ INT poly_roots_fftgridsearch(const UINT deg,
                 tmp += CABS( zi - z0 )*CABS( zi - z0 );
             }
         }
-        if (tmp == 0.0) { // This should never happen ...
-            ret_code = E_DIV_BY_ZERO;
-            goto release_mem;
-        }
+        if (tmp == 0.0) // This should never happen ...
+            return E_DIV_BY_ZERO;
         c /= tmp;
 
         // Find the root zr of the linear approximation y0+c(z-z0)
@@ -139,34 +133,152 @@ INT poly_roots_fftgridsearch(const UINT deg,
         }
 
         // Save the root
+        if (nroots >= capacity)
+            return E_OTHER("Found more roots than memory is available.");
         roots[nroots++] = zr;
     }
 
-    // Save the number of detected roots
-    *M_ptr = nroots;
+    *nroots_ptr = nroots;
+    return SUCCESS;
+}
+
+// Auxiliary function: Evaluates the polynomial on the three rings of the
+// grid, see poly_roots_fftgridsearch, using the Chirp transform. The array
+// vals has to provide space for 3*M values.
+static INT gridsearch_eval(const UINT deg, COMPLEX const * const p,
+    const UINT M, REAL const * const PHI, COMPLEX * const vals)
+{
+    COMPLEX A, W;
+    INT k;
+    INT ret_code = SUCCESS;
+
+    const REAL eps = (PHI[1] - PHI[0]) / (M - 1);
+    W = CEXP(I*eps);
+    for (k=-1; k<=1; k++) {
+
+        A = (1.0 + k*eps) * CEXP(-I*PHI[0]);
+        ret_code = poly_chirpz(deg, p, A, W, M, vals + (k+1)*M);
+        CHECK_RETCODE(ret_code, leave_fun);
+    }
+
+leave_fun:
+    return ret_code;
+}
+
+// Auxiliary function: Adds delta*z^n to the values vals of a polynomial on
+// the grid, see poly_roots_fftgridsearch. If nrings is one, vals only
+// contains the M values on the unit circle, otherwise the values on all
+// three rings. The power z^n is computed with the same chirp factors that
+// poly_chirpz uses for the coefficient of z^n, since
+// nm=(n^2+m^2-(m-n)^2)/2. This keeps the rounding errors consistent with
+// those of the evaluation of the polynomial, which matters for (nearly)
+// multiple roots.
+static void gridsearch_add_shift(const UINT M, REAL const * const PHI,
+    const UINT nrings, const UINT n, const COMPLEX delta,
+    COMPLEX * const vals)
+{
+    COMPLEX W, An[3], zn;
+    REAL d;
+    UINT i;
+    INT k;
+
+    const INT k0 = (nrings == 1) ? 0 : -1;
+    const INT k1 = (nrings == 1) ? 0 : 1;
+    const REAL eps = (PHI[1] - PHI[0]) / (M - 1);
+    W = CEXP(I*eps);
+    for (k=k0; k<=k1; k++)
+        An[k-k0] = CPOW((1.0 + k*eps) * CEXP(-I*PHI[0]), -1.0*n)
+            * CPOW(W, 0.5*n*n);
+    for (i=0; i<M; i++) {
+        d = (i >= n) ? (REAL)(i - n) : (REAL)(n - i);
+        zn = delta * CPOW(W, 0.5*i*i) * CPOW(W, -0.5*d*d);
+        for (k=k0; k<=k1; k++)
+            vals[(k-k0)*M + i] += An[k-k0] * zn;
+    }
+}
+
+// Auxiliary function: Evaluates the polynomial on the three rings of the
+// part of the grid, see poly_roots_fftgridsearch, that belongs to the
+// interior points s,...,e (and their neighbors) and scans it for roots. The
+// detected roots are stored in the array roots, which has space for e-s+1
+// entries, and their number in *nroots_ptr.
+static INT gridsearch_tile(const UINT deg, COMPLEX const * const p,
+    const UINT M, REAL const * const PHI, const UINT s, const UINT e,
+    COMPLEX * const roots, UINT * const nroots_ptr)
+{
+    COMPLEX * vals;
+    REAL PHI_t[2];
+    UINT Mt;
+    INT ret_code = SUCCESS;
+
+    const REAL eps = (PHI[1] - PHI[0]) / (M - 1);
+    Mt = e - s + 3;
+    vals = malloc(3*Mt * sizeof(COMPLEX));
+    if (vals == NULL) {
+        ret_code = E_NOMEM;
+        goto release_mem;
+    }
+
+    PHI_t[0] = (s == 1) ? PHI[0] : PHI[0] + (s - 1)*eps;
+    PHI_t[1] = (e == M - 2) ? PHI[1] : PHI[0] + (e + 1)*eps;
+    ret_code = gridsearch_eval(deg, p, Mt, PHI_t, vals);
+    CHECK_RETCODE(ret_code, release_mem);
+
+    *nroots_ptr = 0;
+    ret_code = gridsearch_scan(Mt, vals, PHI_t, e - s + 1, roots,
+        nroots_ptr);
+    CHECK_RETCODE(ret_code, release_mem);
 
 release_mem:
     free(vals);
     return ret_code;
 }
 
+// Auxiliary function: Number of interior grid points per tile in
+// poly_roots_fftgridsearch and poly_roots_fftgridsearch_paraherm. Each tile
+// requires a Chirp transform with deg+1 coefficients, so tiles are longer
+// for large degrees.
+static inline UINT gridsearch_tile_len(const UINT deg)
+{
+    return (4*(deg + 1) > GRIDSEARCH_TILE_LEN) ? 4*(deg + 1)
+        : GRIDSEARCH_TILE_LEN;
+}
+
+// Auxiliary function: Moves the roots found in the ntiles tiles, which are
+// stored at roots+t*len for the t-th tile, to the beginning of roots.
+// Returns the total number of roots.
+static UINT gridsearch_merge_tiles(const UINT ntiles, const UINT len,
+    UINT const * const tile_nroots, COMPLEX * const roots)
+{
+    UINT t, nroots = 0;
+
+    for (t=0; t<ntiles; t++) {
+        memmove(roots + nroots, roots + t*len,
+            tile_nroots[t] * sizeof(COMPLEX));
+        nroots += tile_nroots[t];
+    }
+    return nroots;
+}
+
 // Computation of polynomial roots on the unit circle via gridsearch.
-// The degree must be odd, and p(z) * z^(N-1), where N=deg/2+1, must be
-// para-hermitian. *M_ptr is the number of points in the grid. The array roots
+// *M_ptr is the number of points in the grid. The array roots
 // must be preallocated by the user with *M_ptr entries. Upon exit, *M_ptr
 // contains the number of found roots, which are located in the beginning of
-// the array roots. Returns SUCCESS or an error code.
-INT poly_roots_fftgridsearch_paraherm(const UINT deg,
+// the array roots. The grid is processed in tiles, which run in parallel if
+// OpenMP is enabled. The roots of the t-th tile are stored in the part of
+// the array roots that corresponds to the interior points of the tile
+// before they are merged. Returns SUCCESS or an error code.
+INT poly_roots_fftgridsearch(const UINT deg,
     COMPLEX const * const p, UINT * const M_ptr,
     REAL const * const PHI, COMPLEX * const roots)  
 {
-    INT ret_code;
-    COMPLEX A, W;
-    REAL phi, phi1, phi2;
-    UINT i, N, M, nroots = 0;
+    INT ret_code = SUCCESS;
+    UINT M, t, ntiles, len;
+    UINT * tile_nroots = NULL;
+    INT * tile_ret = NULL;
 
 	// Check inputs
-    if ( deg%2 == 1 || deg < 2 ) // degree must be even and >= 2
+    if ( deg < 2 )
         return E_INVALID_ARGUMENT(deg);
 	if (p == NULL)
 		return E_INVALID_ARGUMENT(p);
@@ -178,39 +290,627 @@ INT poly_roots_fftgridsearch_paraherm(const UINT deg,
 	if (roots == NULL)
 		return E_INVALID_ARGUMENT(roots);
 
-    // Evaluate polynomial using the Chirp transform
+    // Allocate memory
     M = *M_ptr;
+    len = gridsearch_tile_len(deg);
+    ntiles = (M - 2 + len - 1) / len;
+    tile_nroots = calloc(ntiles + 1, sizeof(UINT)); // ntiles=0 if M=2
+    tile_ret = calloc(ntiles + 1, sizeof(INT));
+    if (tile_nroots == NULL || tile_ret == NULL) {
+        ret_code = E_NOMEM;
+        goto release_mem;
+    }
+
+    // Evaluate the polynomial using the Chirp transform on the three rings
+    // and approximate the roots, tile by tile
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for (t=0; t<ntiles; t++) {
+        const UINT s = 1 + t*len;
+        const UINT e = (M - 2 - s >= len) ? s + len - 1 : M - 2;
+        tile_ret[t] = gridsearch_tile(deg, p, M, PHI, s, e, roots + t*len,
+            &tile_nroots[t]);
+    }
+    for (t=0; t<ntiles; t++)
+        CHECK_RETCODE(tile_ret[t], release_mem);
+
+    // Save the number of detected roots
+    *M_ptr = gridsearch_merge_tiles(ntiles, len, tile_nroots, roots);
+
+release_mem:
+    free(tile_nroots);
+    free(tile_ret);
+    return ret_code;
+}
+
+// Auxiliary function: Evaluates the polynomial on the three rings of the
+// part of the grid, see poly_roots_fftgridsearch, that belongs to the
+// interior points s,...,e (and their neighbors), adds the shifts, see
+// poly_roots_fftgridsearch_shifts, and scans the values for each shift for
+// roots. The detected roots are stored one shift after another in an array
+// that is allocated by this function and returned in *roots_ptr. The number
+// of roots found for the j-th shift is stored in nroots[j].
+static INT gridsearch_shifts_tile(const UINT deg, COMPLEX const * const p,
+    const UINT pos, const UINT nshifts, COMPLEX const * const shifts,
+    const UINT M, REAL const * const PHI, const UINT s, const UINT e,
+    COMPLEX ** const roots_ptr, UINT * const nroots)
+{
+    COMPLEX * vals = NULL, * pows = NULL, * roots = NULL, * tmp;
+    COMPLEX delta;
+    REAL PHI_t[2];
+    UINT i, j, Mt, total = 0;
+    INT ret_code = SUCCESS;
+
     const REAL eps = (PHI[1] - PHI[0]) / (M - 1);
-    W = CEXP(I*eps);
+    Mt = e - s + 3;
+    vals = malloc(((nshifts > 1) ? 6 : 3)*Mt * sizeof(COMPLEX));
+    roots = malloc(nshifts*(e - s + 1) * sizeof(COMPLEX));
+    if (vals == NULL || roots == NULL) {
+        ret_code = E_NOMEM;
+        goto release_mem;
+    }
+
+    // Evaluate the polynomial without shift using the Chirp transform on
+    // three rings
+    PHI_t[0] = (s == 1) ? PHI[0] : PHI[0] + (s - 1)*eps;
+    PHI_t[1] = (e == M - 2) ? PHI[1] : PHI[0] + (e + 1)*eps;
+    ret_code = gridsearch_eval(deg, p, Mt, PHI_t, vals);
+    CHECK_RETCODE(ret_code, release_mem);
+
+    // The grid point z=exp(j*(PHI[0]+i*eps))/(1+k*eps) on the k-th ring
+    // contributes shifts[j]*z^(deg-pos) to the value of the shifted
+    // polynomial. The difference to the previous shift is added in place.
+    // For several shifts, the powers z^(deg-pos) are computed only once and
+    // stored behind the values.
+    if (nshifts > 1) {
+        pows = vals + 3*Mt;
+        for (i=0; i<3*Mt; i++)
+            pows[i] = 0.0;
+        gridsearch_add_shift(Mt, PHI_t, 3, deg - pos, 1.0, pows);
+    }
+    for (j=0; j<nshifts; j++) {
+        delta = (j == 0) ? shifts[0] : shifts[j] - shifts[j-1];
+        if (pows != NULL) {
+            for (i=0; i<3*Mt; i++)
+                vals[i] += delta * pows[i];
+        } else {
+            gridsearch_add_shift(Mt, PHI_t, 3, deg - pos, delta, vals);
+        }
+
+        nroots[j] = total;
+        ret_code = gridsearch_scan(Mt, vals, PHI_t, (j + 1)*(e - s + 1),
+            roots, &total);
+        CHECK_RETCODE(ret_code, release_mem);
+        nroots[j] = total - nroots[j];
+    }
+
+    // Release the unused memory since the roots of all tiles are kept
+    // until they are merged
+    if (total > 0) {
+        tmp = realloc(roots, total * sizeof(COMPLEX));
+        if (tmp != NULL)
+            roots = tmp;
+    }
+
+release_mem:
+    free(vals);
+    if (ret_code != SUCCESS) {
+        free(roots);
+        roots = NULL;
+    }
+    *roots_ptr = roots;
+    return ret_code;
+}
+
+// Computation of the unit circle roots of the polynomials
+// p(z)+shifts[j]*z^(deg-pos) via gridsearch. The polynomial p(z) is only
+// evaluated once, the shifts are added to its values before the scans.
+// *M_ptr is the number of points in the grid. The array roots must be
+// preallocated by the user with *M_ptr entries. Upon exit, the roots for
+// the different shifts are stored one after another at the beginning of
+// roots, nroots[j] contains the number of roots found for the j-th shift
+// and *M_ptr the total number of roots. The grid is processed in tiles as
+// in poly_roots_fftgridsearch, which run in parallel if OpenMP is enabled.
+// Returns SUCCESS or an error code.
+INT poly_roots_fftgridsearch_shifts(const UINT deg,
+    COMPLEX const * const p, const UINT pos, const UINT nshifts,
+    COMPLEX const * const shifts, UINT * const M_ptr,
+    REAL const * const PHI, COMPLEX * const roots, UINT * const nroots)
+{
+    INT ret_code = SUCCESS;
+    UINT j, l, t, M, ntiles, len, offset, total = 0;
+    COMPLEX ** tile_roots = NULL;
+    UINT * tile_nroots = NULL;
+    INT * tile_ret = NULL;
+
+	// Check inputs
+    if ( deg < 2 )
+        return E_INVALID_ARGUMENT(deg);
+	if (p == NULL)
+		return E_INVALID_ARGUMENT(p);
+    if (pos > deg)
+        return E_INVALID_ARGUMENT(pos);
+    if (nshifts > 0 && shifts == NULL)
+        return E_INVALID_ARGUMENT(shifts);
+    if (M_ptr == NULL || *M_ptr < 2)
+ 		return E_INVALID_ARGUMENT(M_ptr);      
+    if (PHI == NULL || !(PHI[0] < PHI[1]) || PHI[0] == -INFINITY
+    || PHI[1] == INFINITY)
+        return E_INVALID_ARGUMENT(PHI);
+	if (roots == NULL)
+		return E_INVALID_ARGUMENT(roots);
+    if (nshifts > 0 && nroots == NULL)
+        return E_INVALID_ARGUMENT(nroots);
+
+    // Nothing to scan without shifts
+    M = *M_ptr;
+    if (nshifts == 0) {
+        *M_ptr = 0;
+        return SUCCESS;
+    }
+
+    // Allocate memory
+    len = gridsearch_tile_len(deg);
+    ntiles = (M - 2 + len - 1) / len;
+    tile_roots = calloc(ntiles + 1, sizeof(COMPLEX *)); // ntiles=0 if M=2
+    tile_nroots = calloc(nshifts*(ntiles + 1), sizeof(UINT));
+    tile_ret = calloc(ntiles + 1, sizeof(INT));
+    if (tile_roots == NULL || tile_nroots == NULL || tile_ret == NULL) {
+        ret_code = E_NOMEM;
+        goto release_mem;
+    }
+
+    // Evaluate the polynomial, add the shifts and approximate the roots,
+    // tile by tile
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for (t=0; t<ntiles; t++) {
+        const UINT s = 1 + t*len;
+        const UINT e = (M - 2 - s >= len) ? s + len - 1 : M - 2;
+        tile_ret[t] = gridsearch_shifts_tile(deg, p, pos, nshifts, shifts,
+            M, PHI, s, e, &tile_roots[t], tile_nroots + t*nshifts);
+    }
+    for (t=0; t<ntiles; t++)
+        CHECK_RETCODE(tile_ret[t], release_mem);
+
+    // Merge the roots of the tiles shift by shift
+    for (j=0; j<nshifts; j++) {
+        nroots[j] = 0;
+        for (t=0; t<ntiles; t++) {
+            offset = 0;
+            for (l=0; l<j; l++)
+                offset += tile_nroots[t*nshifts + l];
+            if (total + tile_nroots[t*nshifts + j] > M) {
+                ret_code = E_OTHER(
+                    "Found more roots than memory is available.");
+                goto release_mem;
+            }
+            memcpy(roots + total, tile_roots[t] + offset,
+                tile_nroots[t*nshifts + j] * sizeof(COMPLEX));
+            total += tile_nroots[t*nshifts + j];
+            nroots[j] += tile_nroots[t*nshifts + j];
+        }
+    }
+
+    // Save the total number of detected roots
+    *M_ptr = total;
+
+release_mem:
+    if (tile_roots != NULL) {
+        for (t=0; t<ntiles; t++)
+            free(tile_roots[t]);
+    }
+    free(tile_roots);
+    free(tile_nroots);
+    free(tile_ret);
+    return ret_code;
+}
+
+// Auxiliary function: Evaluates the polynomial on the three rings of the
+// part of the fine grid that belongs to the interior points s,...,e and
+// scans it for the roots of the nshifts shifted polynomials (or of the
+// polynomial itself if nshifts is zero). Long parts are split into zoomed
+// Chirp transforms of at most len_max interior points each. The detected
+// roots are appended to roots, and tags contains the index of the
+// corresponding shift (if nshifts>1). The buffer vals has to provide space
+// for 3*(len_max+2) values, or for 6*(len_max+2) values if nshifts>1.
+static INT adaptive_scan_range(const UINT deg, COMPLEX const * const p,
+    const UINT n, const UINT nshifts, COMPLEX const * const shifts,
+    const REAL PHI0, const REAL eps, const UINT s, const UINT e,
+    const UINT len_max, COMPLEX * const vals, const UINT capacity,
+    COMPLEX * const roots, UINT * const tags, UINT * const total_ptr)
+{
+    UINT i, j, s2, e2, Mg, total;
+    REAL PHI_g[2];
+    COMPLEX delta;
+    INT ret_code = SUCCESS;
+
+    for (s2=s; s2<=e; s2+=len_max) {
+        e2 = (e - s2 >= len_max) ? s2 + len_max - 1 : e;
+
+        // Zoomed grid that contains the neighbors of the interior points
+        Mg = e2 - s2 + 3;
+        PHI_g[0] = PHI0 + (s2 - 1)*eps;
+        PHI_g[1] = PHI_g[0] + (Mg - 1)*eps;
+        ret_code = gridsearch_eval(deg, p, Mg, PHI_g, vals);
+        CHECK_RETCODE(ret_code, leave_fun);
+
+        if (nshifts == 0) {
+            ret_code = gridsearch_scan(Mg, vals, PHI_g, capacity, roots,
+                total_ptr);
+            CHECK_RETCODE(ret_code, leave_fun);
+            continue;
+        }
+        // For several shifts, the powers z^n are computed only once and
+        // stored behind the values
+        if (nshifts > 1) {
+            for (i=0; i<3*Mg; i++)
+                vals[3*(len_max + 2) + i] = 0.0;
+            gridsearch_add_shift(Mg, PHI_g, 3, n, 1.0,
+                vals + 3*(len_max + 2));
+        }
+        for (j=0; j<nshifts; j++) {
+            delta = (j == 0) ? shifts[0] : shifts[j] - shifts[j-1];
+            if (nshifts > 1) {
+                for (i=0; i<3*Mg; i++)
+                    vals[i] += delta * vals[3*(len_max + 2) + i];
+            } else {
+                gridsearch_add_shift(Mg, PHI_g, 3, n, delta, vals);
+            }
+            total = *total_ptr;
+            ret_code = gridsearch_scan(Mg, vals, PHI_g, capacity, roots,
+                total_ptr);
+            CHECK_RETCODE(ret_code, leave_fun);
+            if (tags != NULL) {
+                for (i=total; i<*total_ptr; i++)
+                    tags[i] = j;
+            }
+        }
+    }
+
+leave_fun:
+    return ret_code;
+}
+
+// Computation of the unit circle roots of the polynomials
+// p(z)+shifts[j]*z^(deg-pos) (or of p(z) if nshifts is zero) via an
+// adaptive gridsearch. A coarse grid on the unit circle is used to find the
+// parts of the fine grid that can contain roots, which are then evaluated
+// and scanned as in poly_roots_fftgridsearch_shifts. The array roots must be
+// preallocated by the user with capacity entries. See the header file for
+// details.
+INT poly_roots_fftgridsearch_adaptive(const UINT deg,
+    COMPLEX const * const p, const UINT pos, const UINT nshifts,
+    COMPLEX const * const shifts, UINT * const M_ptr,
+    REAL const * const PHI, const UINT capacity, COMPLEX * const roots,
+    UINT * const nroots)
+{
+    INT ret_code = SUCCESS;
+    UINT i, j, c, c0, c1, M, Mc, s, e, fs, fe, total = 0;
+    UINT n, nvals, len_max, gap_max, have_range;
+    UINT * tags = NULL;
+    char * covered = NULL;
+    COMPLEX * vals = NULL;
+    COMPLEX * dp, * tmp;
+    COMPLEX A, W, zn, f, f_prime;
+    REAL * mag = NULL;
+    REAL eps, a, phi, ratio;
+
+	// Check inputs
+    if ( deg < 2 )
+        return E_INVALID_ARGUMENT(deg);
+	if (p == NULL)
+		return E_INVALID_ARGUMENT(p);
+    if (pos > deg)
+        return E_INVALID_ARGUMENT(pos);
+    if (nshifts > 0 && shifts == NULL)
+        return E_INVALID_ARGUMENT(shifts);
+    if (M_ptr == NULL || *M_ptr < 3)
+ 		return E_INVALID_ARGUMENT(M_ptr);
+    if (PHI == NULL || !(PHI[0] < PHI[1]) || PHI[0] == -INFINITY
+    || PHI[1] == INFINITY)
+        return E_INVALID_ARGUMENT(PHI);
+	if (roots == NULL)
+		return E_INVALID_ARGUMENT(roots);
+    if (nshifts > 0 && nroots == NULL)
+        return E_INVALID_ARGUMENT(nroots);
+
+    // The coarse grid has ADAPTIVE_COARSE_DENSITY points per 2*PI/deg, but
+    // at least deg points since the Chirp transform costs O(deg*log(deg))
+    // operations anyway. It is not finer than the fine grid.
+    M = *M_ptr;
+    eps = (PHI[1] - PHI[0]) / (M - 1);
+    a = ADAPTIVE_COARSE_DENSITY*deg*(PHI[1] - PHI[0]) / (2*PI);
+    if (a < deg)
+        a = deg;
+    Mc = (a < M - 1) ? (UINT)a + 1 : M;
+    ratio = (REAL)(M - 1) / (Mc - 1);
+
+    // Parts of the fine grid are evaluated with at most len_max interior
+    // points. Parts that are separated by at most gap_max points are
+    // evaluated together since a Chirp transform costs at least
+    // O(deg*log(deg)) operations anyway. The choice of len_max trades the
+    // size of the workspace against the overhead of the zoomed transforms.
+    len_max = 4*deg;
+    gap_max = deg;
+
+    // Allocate memory. The buffer vals is first used for the values of the
+    // polynomial and its derivative on the coarse grid and for the
+    // coefficients of the derivative, then for the values on the zoomed
+    // grids.
+    nvals = (nshifts > 1 ? 6 : 3)*(len_max + 2);
+    if (nvals < 2*Mc + deg)
+        nvals = 2*Mc + deg;
+    vals = malloc(nvals * sizeof(COMPLEX));
+    mag = malloc(2*Mc * sizeof(REAL));
+    covered = calloc(Mc, sizeof(char));
+    if (nshifts > 1)
+        tags = malloc(capacity * sizeof(UINT));
+    if (vals == NULL || mag == NULL || covered == NULL
+        || (nshifts > 1 && tags == NULL)) {
+        ret_code = E_NOMEM;
+        goto release_mem;
+    }
+
+    // Evaluate the polynomial and its derivative on the coarse grid on the
+    // unit circle
+    dp = vals + 2*Mc;
+    for (i=0; i<deg; i++)
+        dp[i] = (deg - i) * p[i];
     A = CEXP(-I*PHI[0]);
-    ret_code = poly_chirpz(deg, p, A, W, M, roots);
-    if (ret_code != SUCCESS)
-        return E_SUBROUTINE(ret_code);
+    W = CEXP(I*ratio*eps);
+    ret_code = poly_chirpz(deg, p, A, W, Mc, vals);
+    CHECK_RETCODE(ret_code, release_mem);
+    ret_code = poly_chirpz(deg - 1, dp, A, W, Mc, vals + Mc);
+    CHECK_RETCODE(ret_code, release_mem);
+
+    // The neighborhoods of the coarse grid points at which the absolute
+    // value of one of the (shifted) polynomials f(z) is not larger than at
+    // the two neighboring points are marked as candidates for roots if the
+    // Newton step |f(z)/f'(z)| at the point or one of its neighbors is at
+    // most ADAPTIVE_NEWTON coarse grid spacings. (The Newton step is
+    // 1/|sum_k 1/(z-z_k)|, which is dominated by roots z_k close to z. The
+    // first condition excludes points where the step is small since many
+    // roots away from the unit circle contribute coherently to the sum.)
+    n = deg - pos;
+    for (j=0; j==0 || j<nshifts; j++) {
+        for (c=0; c<Mc; c++) {
+            f = vals[c];
+            f_prime = vals[Mc + c];
+            if (nshifts > 0) {
+                phi = PHI[0] + c*ratio*eps;
+                zn = shifts[j] * CEXP(I*n*phi);
+                f += zn;
+                f_prime += n*zn*CEXP(-I*phi);
+            }
+            mag[c] = CABS(f);
+            mag[Mc + c] = (mag[c] == 0.0) ? 0.0 : mag[c] / CABS(f_prime);
+        }
+        for (c=0; c<Mc; c++) {
+            if (c > 0 && mag[c] > mag[c-1])
+                continue;
+            if (c + 1 < Mc && mag[c] > mag[c+1])
+                continue;
+            c0 = (c > 0) ? c - 1 : 0;
+            c1 = (c + 1 < Mc) ? c + 1 : Mc - 1;
+            for (i=c0; i<=c1; i++) {
+                if (mag[Mc + i] <= ADAPTIVE_NEWTON*ratio*eps)
+                    break;
+            }
+            if (i > c1)
+                continue;
+            c0 = (c > ADAPTIVE_WINDOW) ? c - ADAPTIVE_WINDOW : 0;
+            c1 = (c + ADAPTIVE_WINDOW < Mc) ? c + ADAPTIVE_WINDOW : Mc - 1;
+            for (i=c0; i<=c1; i++)
+                covered[i] = 1;
+        }
+    }
+
+    // Evaluate the fine grid in the marked parts and scan it. Only the
+    // interior points 1,...,M-2 of the fine grid are tested, as in
+    // poly_roots_fftgridsearch.
+    have_range = 0;
+    s = 0;
+    e = 0;
+    c = 0;
+    while (1) {
+        while (c < Mc && !covered[c])
+            c++;
+        if (c == Mc)
+            break;
+        c0 = c;
+        while (c < Mc && covered[c])
+            c++;
+        c1 = c - 1;
+
+        fs = (UINT)FLOOR(c0*ratio);
+        fe = (UINT)CEIL(c1*ratio);
+        if (fs < 1)
+            fs = 1;
+        if (fe > M - 2)
+            fe = M - 2;
+        if (fs > fe)
+            continue;
+        if (have_range && fs <= e + gap_max + 1) {
+            e = fe;
+            continue;
+        }
+        if (have_range) {
+            ret_code = adaptive_scan_range(deg, p, deg - pos, nshifts, shifts,
+                PHI[0], eps, s, e, len_max, vals, capacity, roots, tags,
+                &total);
+            CHECK_RETCODE(ret_code, release_mem);
+        }
+        s = fs;
+        e = fe;
+        have_range = 1;
+    }
+    if (have_range) {
+        ret_code = adaptive_scan_range(deg, p, deg - pos, nshifts, shifts,
+            PHI[0], eps, s, e, len_max, vals, capacity, roots, tags, &total);
+        CHECK_RETCODE(ret_code, release_mem);
+    }
+
+    // Sort the roots by shift (the values are no longer needed)
+    if (nshifts == 1)
+        nroots[0] = total;
+    if (nshifts > 1) {
+        if (total > nvals) {
+            tmp = malloc(total * sizeof(COMPLEX));
+            if (tmp == NULL) {
+                ret_code = E_NOMEM;
+                goto release_mem;
+            }
+            free(vals);
+            vals = tmp;
+        }
+        c = 0;
+        for (j=0; j<nshifts; j++) {
+            nroots[j] = 0;
+            for (i=0; i<total; i++) {
+                if (tags[i] == j) {
+                    vals[c++] = roots[i];
+                    nroots[j]++;
+                }
+            }
+        }
+        memcpy(roots, vals, total * sizeof(COMPLEX));
+    }
+
+    // Save the total number of detected roots
+    *M_ptr = total;
+
+release_mem:
+    free(vals);
+    free(mag);
+    free(covered);
+    free(tags);
+    return ret_code;
+}
+
+// Auxiliary function: Evaluates the para-hermitian Laurent polynomial, see
+// poly_roots_fftgridsearch_paraherm, on the part of the grid that belongs
+// to the interior points s,...,e (and the point before s) and looks for
+// sign changes between consecutive points. The detected roots are stored in
+// the array roots, which has space for e-s+1 entries, and their number in
+// *nroots_ptr.
+static INT gridsearch_paraherm_tile(const UINT deg, COMPLEX const * const p,
+    const UINT M, REAL const * const PHI, const UINT s, const UINT e,
+    COMPLEX * const roots, UINT * const nroots_ptr)
+{
+    COMPLEX * vals;
+    COMPLEX A, W;
+    REAL phi, phi1, phi2, PHI_t0;
+    UINT i, N, Mt, nroots = 0;
+    INT ret_code = SUCCESS;
+
+    const REAL eps = (PHI[1] - PHI[0]) / (M - 1);
+    Mt = e - s + 2;
+    vals = malloc(Mt * sizeof(COMPLEX));
+    if (vals == NULL) {
+        ret_code = E_NOMEM;
+        goto release_mem;
+    }
+
+    // Evaluate polynomial using the Chirp transform
+    PHI_t0 = PHI[0] + (s - 1)*eps;
+    W = CEXP(I*eps);
+    A = CEXP(-I*PHI_t0);
+    ret_code = poly_chirpz(deg, p, A, W, Mt, vals);
+    if (ret_code != SUCCESS) {
+        ret_code = E_SUBROUTINE(ret_code);
+        goto release_mem;
+    }
 
     // Remove the phase factor
     N = deg/2 + 1; // remember: we checked that deg even
-    for (i=0; i<M; i++) {
-        phi = PHI[0] + eps*i; // angle of roots[i]
-        roots[i] *= CEXP(-I*phi*(N-1));
+    for (i=0; i<Mt; i++) {
+        phi = PHI_t0 + eps*i; // angle of vals[i]
+        vals[i] *= CEXP(-I*phi*(N-1));
     }
 
     // Approximate the roots
-    for (i=1; i<M; i++) {
+    for (i=1; i<Mt; i++) {
         // Mean value theorem => change of sign between two consecutive values
         // shows there is a root in between them
-        if (CREAL(roots[i-1])*CREAL(roots[i]) <= 0.0) {
+        if (CREAL(vals[i-1])*CREAL(vals[i]) <= 0.0) {
             // We approximate the polynomial linearly to estimate the location
             // of the root 
-            phi1 = PHI[0] + eps*(i - 1);
+            phi1 = PHI_t0 + eps*(i - 1);
             phi2 = phi1 + eps;
-            if (roots[i-1] != roots[i])
-                phi = phi1 - roots[i-1]*(phi2 - phi1)/(roots[i] - roots[i-1]);
+            if (vals[i-1] != vals[i])
+                phi = phi1 - vals[i-1]*(phi2 - phi1)/(vals[i] - vals[i-1]);
             else
                 phi = 0.5*(phi1 + phi2); // angle of the root estimate
             roots[nroots++] = CEXP(I*phi);
         }
     }
+    *nroots_ptr = nroots;
 
-    *M_ptr = nroots;
-    return SUCCESS;
+release_mem:
+    free(vals);
+    return ret_code;
+}
+
+// Computation of polynomial roots on the unit circle via gridsearch.
+// The degree must be odd, and p(z) * z^(N-1), where N=deg/2+1, must be
+// para-hermitian. *M_ptr is the number of points in the grid. The array roots
+// must be preallocated by the user with *M_ptr entries. Upon exit, *M_ptr
+// contains the number of found roots, which are located in the beginning of
+// the array roots. The grid is processed in tiles as in
+// poly_roots_fftgridsearch. Returns SUCCESS or an error code.
+INT poly_roots_fftgridsearch_paraherm(const UINT deg,
+    COMPLEX const * const p, UINT * const M_ptr,
+    REAL const * const PHI, COMPLEX * const roots)  
+{
+    INT ret_code = SUCCESS;
+    UINT M, t, ntiles, len;
+    UINT * tile_nroots = NULL;
+    INT * tile_ret = NULL;
+
+	// Check inputs
+    if ( deg%2 == 1 || deg < 2 ) // degree must be even and >= 2
+        return E_INVALID_ARGUMENT(deg);
+	if (p == NULL)
+		return E_INVALID_ARGUMENT(p);
+    if (M_ptr == NULL || *M_ptr < 2)
+ 		return E_INVALID_ARGUMENT(M_ptr);      
+    if (PHI == NULL || !(PHI[0] < PHI[1]) || PHI[0] == -INFINITY
+    || PHI[1] == INFINITY)
+        return E_INVALID_ARGUMENT(PHI);
+	if (roots == NULL)
+		return E_INVALID_ARGUMENT(roots);
+
+    // Allocate memory. The tiles cover the points 1,...,M-1, each of which
+    // is compared with its predecessor.
+    M = *M_ptr;
+    len = gridsearch_tile_len(deg);
+    ntiles = (M - 1 + len - 1) / len;
+    tile_nroots = calloc(ntiles, sizeof(UINT));
+    tile_ret = calloc(ntiles, sizeof(INT));
+    if (tile_nroots == NULL || tile_ret == NULL) {
+        ret_code = E_NOMEM;
+        goto release_mem;
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1)
+#endif
+    for (t=0; t<ntiles; t++) {
+        const UINT s = 1 + t*len;
+        const UINT e = (M - 1 - s >= len) ? s + len - 1 : M - 1;
+        tile_ret[t] = gridsearch_paraherm_tile(deg, p, M, PHI, s, e,
+            roots + t*len, &tile_nroots[t]);
+    }
+    for (t=0; t<ntiles; t++)
+        CHECK_RETCODE(tile_ret[t], release_mem);
+
+    *M_ptr = gridsearch_merge_tiles(ntiles, len, tile_nroots, roots);
+
+release_mem:
+    free(tile_nroots);
+    free(tile_ret);
+    return ret_code;
 }
@@ -145,3 +145,223 @@ leave_fun:
     fft_wrapper_destroy_plan(&plan_inv);
     return ret_code;
 }
+
+// Number of FFT lengths tried by poly_specfact_annulus
+#define MAX_SPLIT_ATTEMPTS 3
+
+// Auxiliary function: Computes the Fourier coefficients of the logarithmic
+// derivative u*P'(u)/P(u) of P(u)=poly(rho*u) on the unit circle. The
+// result is stored in d (coefficient n at index n mod M).
+static inline INT logderiv_coeffs(const UINT deg,
+                                  COMPLEX const * const poly,
+                                  const REAL rho, const UINT M,
+                                  fft_wrapper_plan_t plan_fwd,
+                                  fft_wrapper_plan_t plan_inv,
+                                  COMPLEX * const buf0,
+                                  COMPLEX * const buf1,
+                                  COMPLEX * const buf2,
+                                  COMPLEX * const d)
+{
+    REAL rho_k = 1.0;
+    UINT k;
+    INT ret_code = SUCCESS;
+
+    // Coefficients of P(u) and u*P'(u) in ascending order
+    for (k=0; k<=deg; k++) {
+        buf0[k] = poly[deg-k] * rho_k;
+        buf1[k] = k * buf0[k];
+        rho_k *= rho;
+    }
+    for (k=deg+1; k<M; k++) {
+        buf0[k] = 0.0;
+        buf1[k] = 0.0;
+    }
+
+    // Values at the points u_l = exp(2*pi*j*l/M)
+    ret_code = fft_wrapper_execute_plan(plan_inv, buf0, buf2);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = fft_wrapper_execute_plan(plan_inv, buf1, buf0);
+    CHECK_RETCODE(ret_code, leave_fun);
+    for (k=0; k<M; k++)
+        buf1[k] = buf0[k] / (buf2[k] * M);
+
+    ret_code = fft_wrapper_execute_plan(plan_fwd, buf1, d);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+leave_fun:
+    return ret_code;
+}
+
+// Auxiliary function: Carries out the splitting in
+// poly_specfact_annulus for the FFT length M. The flag *success_ptr is set
+// to zero if the results were found to be unreliable.
+static INT specfact_annulus_fixed_len(const UINT deg,
+                                      COMPLEX const * const poly,
+                                      const REAL r_in,
+                                      const REAL r_out,
+                                      const UINT M,
+                                      UINT * const deg_factor_ptr,
+                                      COMPLEX * const factor,
+                                      INT * const success_ptr)
+{
+    // Prepare buffers and (inverse) FFT's
+
+    fft_wrapper_plan_t plan_fwd = fft_wrapper_safe_plan_init();
+    fft_wrapper_plan_t plan_inv = fft_wrapper_safe_plan_init();
+
+    INT ret_code = SUCCESS;
+    UINT k, m_out, m_in, deg_factor;
+    REAL c_out, c_in, ratio_k, max_coeff;
+
+    *success_ptr = 0;
+
+    COMPLEX * const buf0 = fft_wrapper_malloc(M * sizeof(COMPLEX));
+    COMPLEX * const buf1 = fft_wrapper_malloc(M * sizeof(COMPLEX));
+    COMPLEX * const buf2 = fft_wrapper_malloc(M * sizeof(COMPLEX));
+    COMPLEX * const d_out = fft_wrapper_malloc(M * sizeof(COMPLEX));
+    COMPLEX * const d_in = fft_wrapper_malloc(M * sizeof(COMPLEX));
+    if (buf0 == NULL || buf1 == NULL || buf2 == NULL || d_out == NULL
+        || d_in == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+
+    ret_code = fft_wrapper_create_plan(&plan_fwd, M, buf0, buf1, -1);
+    CHECK_RETCODE(ret_code, leave_fun)
+    ret_code = fft_wrapper_create_plan(&plan_inv, M, buf0, buf1, +1);
+    CHECK_RETCODE(ret_code, leave_fun)
+
+    // Step 1: Compute the Fourier coefficients of the logarithmic derivative
+    // on both circles. If poly(z) = c*prod_k (z-a_k), then
+    //
+    //   z*poly'(z)/poly(z) = m + sum_{n>0} (sum_{|a_k|<rho} a_k^n) z^(-n)
+    //                          - sum_{n>0} (sum_{|a_k|>rho} a_k^(-n)) z^n
+    //
+    // on |z|=rho, where m is the number of roots inside the circle.
+
+    ret_code = logderiv_coeffs(deg, poly, r_out, M, plan_fwd, plan_inv,
+                               buf0, buf1, buf2, d_out);
+    CHECK_RETCODE(ret_code, leave_fun);
+    c_out = CREAL(d_out[0]);
+    if (r_in > 0.0) {
+        ret_code = logderiv_coeffs(deg, poly, r_in, M, plan_fwd, plan_inv,
+                                   buf0, buf1, buf2, d_in);
+        CHECK_RETCODE(ret_code, leave_fun);
+        c_in = CREAL(d_in[0]);
+    } else {
+        for (k=0; k<M; k++)
+            d_in[k] = 0.0;
+        c_in = 0.0;
+    }
+
+    // The root counts have to be (close to) integers. Otherwise, roots are
+    // too close to one of the circles. (The checks are written such that
+    // NaNs fail.)
+    m_out = (UINT)ROUND(c_out);
+    m_in = (UINT)ROUND(c_in);
+    if (!(FABS(c_out - m_out) <= 0.1) || !(FABS(c_in - m_in) <= 0.1)
+        || !(m_in <= m_out) || !(m_out <= deg))
+        goto leave_fun;
+    deg_factor = m_out - m_in;
+
+    // Step 2: The logarithm of the factor of degree m_out-m_in with the
+    // roots in the annulus, divided by u^(m_out-m_in), has the coefficients
+    // -(sum_{annulus} (a_k/r_out)^n)/n at the powers u^(-n), where u=z/r_out.
+
+    buf0[0] = 0.0;
+    ratio_k = 1.0;
+    for (k=1; k<M/2; k++) {
+        ratio_k *= r_in/r_out;
+        buf0[k] = -(d_out[M-k] - d_in[M-k]*ratio_k) / k;
+    }
+    for (k=M/2; k<M; k++)
+        buf0[k] = 0.0;
+
+    // Step 3: Exponentiate on the grid and apply the inverse FFT. The
+    // coefficients of the monic factor are (1/M)*sum_l exp(S_l)*u_l^j
+    // times r_out^j in descending order.
+
+    ret_code = fft_wrapper_execute_plan(plan_fwd, buf0, buf1);
+    CHECK_RETCODE(ret_code, leave_fun);
+    for (k=0; k<M; k++)
+        buf1[k] = CEXP(buf1[k]) / M;
+    ret_code = fft_wrapper_execute_plan(plan_inv, buf1, buf0);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // The coefficients of u^(-j) with j>m_out-m_in have to vanish
+    max_coeff = 0.0;
+    for (k=0; k<=deg_factor; k++) {
+        if (CABS(buf0[k]) > max_coeff)
+            max_coeff = CABS(buf0[k]);
+    }
+    for (k=deg_factor+1; k<M; k++) {
+        if (!(CABS(buf0[k]) <= SQRT(EPSILON)*max_coeff))
+            goto leave_fun;
+    }
+
+    ratio_k = 1.0;
+    for (k=0; k<=deg_factor; k++) {
+        factor[k] = buf0[k] * ratio_k;
+        ratio_k *= r_out;
+    }
+    *deg_factor_ptr = deg_factor;
+    *success_ptr = 1;
+
+leave_fun:
+    fft_wrapper_free(buf0);
+    fft_wrapper_free(buf1);
+    fft_wrapper_free(buf2);
+    fft_wrapper_free(d_out);
+    fft_wrapper_free(d_in);
+    fft_wrapper_destroy_plan(&plan_fwd);
+    fft_wrapper_destroy_plan(&plan_inv);
+    return ret_code;
+}
+
+INT poly_specfact_annulus(const UINT deg,
+                          COMPLEX const * const poly,
+                          const REAL r_in,
+                          const REAL r_out,
+                          const UINT oversampling_factor,
+                          UINT * const deg_factor_ptr,
+                          COMPLEX * const factor)
+{
+    UINT k, M;
+    INT success_flag = 0;
+    INT ret_code = SUCCESS;
+
+    if (deg == 0)
+        return E_INVALID_ARGUMENT(deg);
+    if (poly == NULL)
+        return E_INVALID_ARGUMENT(poly);
+    if (!(r_in >= 0.0))
+        return E_INVALID_ARGUMENT(r_in);
+    if (!(r_out > r_in))
+        return E_INVALID_ARGUMENT(r_out);
+    if (oversampling_factor == 0)
+        return E_INVALID_ARGUMENT(oversampling_factor);
+    if (deg_factor_ptr == NULL)
+        return E_INVALID_ARGUMENT(deg_factor_ptr);
+    if (factor == NULL)
+        return E_INVALID_ARGUMENT(factor);
+
+    // The aliasing errors decay with the FFT length. The length is therefore
+    // increased a few times before we fall back to the trivial splitting.
+    M = fft_wrapper_next_fft_length( (deg+1)*oversampling_factor );
+    for (k=0; k<MAX_SPLIT_ATTEMPTS && success_flag == 0; k++) {
+        ret_code = specfact_annulus_fixed_len(deg, poly, r_in, r_out, M,
+                                              deg_factor_ptr, factor,
+                                              &success_flag);
+        CHECK_RETCODE(ret_code, leave_fun);
+        M = fft_wrapper_next_fft_length(4*M);
+    }
+
+    if (success_flag == 0) {
+        for (k=0; k<=deg; k++)
+            factor[k] = poly[k];
+        *deg_factor_ptr = deg;
+    }
+
+leave_fun:
+    return ret_code;
+}
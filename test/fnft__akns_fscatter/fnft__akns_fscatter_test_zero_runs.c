@@ -0,0 +1,212 @@
+/*
+ * This file is part of FNFT.
+ *
+ * FNFT is free software; you can redistribute it and/or
+ * modify it under the terms of the version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * FNFT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contributors:
+ * Sander Wahls (TU Delft) 2018.
+ */
+
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <stdio.h>
+#include "fnft.h"
+#include "fnft__akns_fscatter.h"
+#include "fnft__poly_eval.h"
+#include "fnft__misc.h"
+#include "fnft__errwarn.h"
+
+// Computes the scattering matrix of a signal consisting of two segments
+// C1 and C2 that are surrounded by runs of zero samples,
+//   [L zeros, C1, M zeros, C2, R zeros],
+// with akns_fscatter. The result is compared with
+//   S^R*T(C2)*S^M*T(C1)*S^L, where S=diag(1,z^deg),
+// evaluated on the unit circle. The transfer matrices T(C1) and T(C2) of
+// the segments do not contain zero samples. Since this reference relies on
+// the same shift matrices S as akns_fscatter, the result is also compared
+// with the transfer matrix of a signal in which the zero samples have been
+// replaced by samples that are too large to be treated as zero. It is
+// computed with the general formulas for the scattering matrices.
+static INT akns_fscatter_test_zero_runs(
+    akns_discretization_t akns_discretization, INT normalize_flag)
+{
+    UINT i, j, k, deg, deg1, deg_seg[2];
+    INT W = 0, W_seg[2] = {0, 0};
+    const UINT nz = 5, D_seg = 3, L = 7, M = 4, R = 10;
+    const UINT D = L + D_seg + M + D_seg + R;
+    const REAL eps_t = 0.13;
+    COMPLEX z[5] = {1.0+0.0*I, CEXP(I*PI/4), CEXP(I*9*PI/14),
+        CEXP(I*4*PI/3), CEXP(I*-PI/5)};
+    COMPLEX q[31], r[31], q_pert[31], r_pert[31];
+    COMPLEX result[20], result_exact[20], result_pert[20], vals[2][20], zk;
+    COMPLEX *transfer_matrix = NULL, *tm_seg[2] = {NULL, NULL};
+    COMPLEX *tm_pert = NULL;
+    UINT deg_pert;
+    INT W_pert = 0;
+    const REAL delta = 1e-10;
+    COMPLEX A[4], B[4];
+    const REAL err_bnd = 1000*EPSILON;
+    REAL err;
+    INT ret_code = SUCCESS;
+
+    deg1 = akns_discretization_degree(akns_discretization);
+    if (deg1 == 0)
+        return E_INVALID_ARGUMENT(akns_discretization);
+
+    transfer_matrix = malloc(akns_fscatter_numel(D, akns_discretization)
+        * sizeof(COMPLEX));
+    tm_seg[0] = malloc(akns_fscatter_numel(D_seg, akns_discretization)
+        * sizeof(COMPLEX));
+    tm_seg[1] = malloc(akns_fscatter_numel(D_seg, akns_discretization)
+        * sizeof(COMPLEX));
+    tm_pert = malloc(akns_fscatter_numel(D, akns_discretization)
+        * sizeof(COMPLEX));
+    if (transfer_matrix == NULL || tm_seg[0] == NULL || tm_seg[1] == NULL
+        || tm_pert == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+
+    // Setup the signal. One sample in the interior run is tiny but not
+    // exactly zero.
+    for (i=0; i<D; i++) {
+        q[i] = 0.0;
+        r[i] = 0.0;
+    }
+    q[L + D_seg + 1] = 1e-20;
+    r[L + D_seg + 1] = -1e-20;
+    for (i=0; i<D_seg; i++) {
+        q[L+i] = (0.41*COS(i+1) + 0.59*I*SIN(0.28*(i+1)))*5;
+        r[L+i] = (0.33*SIN(i+1) + 0.85*I*COS(0.43*(i+1)))*2.5;
+        q[L+D_seg+M+i] = (0.27*SIN(i+2) - 0.61*I*COS(0.5*(i+2)))*4;
+        r[L+D_seg+M+i] = CONJ(q[L+D_seg+M+i]);
+    }
+    for (i=0; i<D; i++) {
+        q_pert[i] = (q[i] == 0.0) ? delta : q[i];
+        r_pert[i] = (r[i] == 0.0) ? -delta : r[i];
+    }
+
+    // Transfer matrices of the full signal and of the two segments
+    ret_code = akns_fscatter(D, q, r, eps_t, transfer_matrix, &deg,
+        normalize_flag ? &W : NULL, akns_discretization);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = akns_fscatter(D_seg, q+L, r+L, eps_t, tm_seg[0], &deg_seg[0],
+        normalize_flag ? &W_seg[0] : NULL, akns_discretization);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = akns_fscatter(D_seg, q+L+D_seg+M, r+L+D_seg+M, eps_t,
+        tm_seg[1], &deg_seg[1], normalize_flag ? &W_seg[1] : NULL,
+        akns_discretization);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = akns_fscatter(D, q_pert, r_pert, eps_t, tm_pert, &deg_pert,
+        normalize_flag ? &W_pert : NULL, akns_discretization);
+    CHECK_RETCODE(ret_code, leave_fun);
+    if (deg != D*deg1 || deg_pert != deg) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+
+    // Evaluate everything on the unit circle
+    for (i=0; i<4; i++) {
+        for (j=0; j<nz; j++) {
+            result[i*nz+j] = z[j];
+            result_pert[i*nz+j] = z[j];
+            vals[0][i*nz+j] = z[j];
+            vals[1][i*nz+j] = z[j];
+        }
+        ret_code = poly_eval(deg, transfer_matrix+i*(deg+1), nz,
+            result+i*nz);
+        CHECK_RETCODE(ret_code, leave_fun);
+        ret_code = poly_eval(deg, tm_pert+i*(deg+1), nz, result_pert+i*nz);
+        CHECK_RETCODE(ret_code, leave_fun);
+        for (k=0; k<2; k++) {
+            ret_code = poly_eval(deg_seg[k], tm_seg[k]+i*(deg_seg[k]+1), nz,
+                vals[k]+i*nz);
+            CHECK_RETCODE(ret_code, leave_fun);
+        }
+    }
+    for (i=0; i<4*nz; i++) {
+        result[i] *= POW(2.0, W);
+        result_pert[i] *= POW(2.0, W_pert);
+        vals[0][i] *= POW(2.0, W_seg[0]);
+        vals[1][i] *= POW(2.0, W_seg[1]);
+    }
+
+    // Combine the segments and the shifts
+    for (j=0; j<nz; j++) {
+        zk = CPOW(z[j], deg1);
+        // A = T(C1)*S^L
+        A[0] = vals[0][j];
+        A[1] = vals[0][nz+j] * CPOW(zk, L);
+        A[2] = vals[0][2*nz+j];
+        A[3] = vals[0][3*nz+j] * CPOW(zk, L);
+        // A = S^M*A
+        A[2] *= CPOW(zk, M);
+        A[3] *= CPOW(zk, M);
+        // B = T(C2)*A
+        B[0] = vals[1][j]*A[0] + vals[1][nz+j]*A[2];
+        B[1] = vals[1][j]*A[1] + vals[1][nz+j]*A[3];
+        B[2] = vals[1][2*nz+j]*A[0] + vals[1][3*nz+j]*A[2];
+        B[3] = vals[1][2*nz+j]*A[1] + vals[1][3*nz+j]*A[3];
+        // S^R*B
+        result_exact[j] = B[0];
+        result_exact[nz+j] = B[1];
+        result_exact[2*nz+j] = B[2] * CPOW(zk, R);
+        result_exact[3*nz+j] = B[3] * CPOW(zk, R);
+    }
+
+    err = misc_rel_err(4*nz, result, result_exact);
+#ifdef DEBUG
+    printf("discretization %d, normalization %d: error = %2.1e < %2.1e\n",
+        (int)akns_discretization, (int)normalize_flag, err, err_bnd);
+#endif
+    if (!(err <= err_bnd)) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+
+    // The perturbation changes the transfer matrix by O(delta)
+    err = misc_rel_err(4*nz, result, result_pert);
+#ifdef DEBUG
+    printf("discretization %d, normalization %d: difference to perturbed signal = %2.1e < %2.1e\n",
+        (int)akns_discretization, (int)normalize_flag, err, 10*delta);
+#endif
+    if (!(err <= 10*delta))
+        ret_code = E_TEST_FAILED;
+
+leave_fun:
+    free(transfer_matrix);
+    free(tm_seg[0]);
+    free(tm_seg[1]);
+    free(tm_pert);
+    return ret_code;
+}
+
+INT main()
+{
+    const akns_discretization_t discretizations[4] = {
+        akns_discretization_2SPLIT2_MODAL,
+        akns_discretization_2SPLIT4B,
+        akns_discretization_2SPLIT6B,
+        akns_discretization_2SPLIT8A
+    };
+    UINT i;
+
+    for (i=0; i<4; i++) {
+        if (akns_fscatter_test_zero_runs(discretizations[i], 0) != SUCCESS)
+            return EXIT_FAILURE;
+        if (akns_fscatter_test_zero_runs(discretizations[i], 1) != SUCCESS)
+            return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
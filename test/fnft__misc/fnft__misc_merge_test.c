@@ -0,0 +1,210 @@
+/*
+ * This file is part of FNFT.
+ *
+ * FNFT is free software; you can redistribute it and/or
+ * modify it under the terms of the version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * FNFT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contributors:
+ * Sander Wahls (TU Delft) 2018.
+ */
+
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <stdlib.h>
+#include <string.h>
+#include "fnft__misc.h"
+#include "fnft__errwarn.h"
+
+// Reference implementation: keep a value if no previously kept value is
+// closer than tol
+static UINT merge_ref(const UINT N, COMPLEX * const vals, const REAL tol)
+{
+    UINT i, j, N_filtered = 0;
+    for (i=0; i<N; i++) {
+        for (j=0; j<N_filtered; j++) {
+            if (CABS(vals[j] - vals[i]) < tol)
+                break;
+        }
+        if (j == N_filtered)
+            vals[N_filtered++] = vals[i];
+    }
+    return N_filtered;
+}
+
+// Reference implementation of the Hausdorff distance
+static REAL hausdorff_ref(const UINT lenA, COMPLEX const * const A,
+    const UINT lenB, COMPLEX const * const B)
+{
+    UINT i, j;
+    REAL d, dmin, dmax = 0.0;
+    for (i=0; i<lenA; i++) {
+        dmin = INFINITY;
+        for (j=0; j<lenB; j++) {
+            d = CABS(A[i] - B[j]);
+            if (d < dmin)
+                dmin = d;
+        }
+        if (dmin > dmax)
+            dmax = dmin;
+    }
+    for (j=0; j<lenB; j++) {
+        dmin = INFINITY;
+        for (i=0; i<lenA; i++) {
+            d = CABS(A[i] - B[j]);
+            if (d < dmin)
+                dmin = d;
+        }
+        if (dmin > dmax)
+            dmax = dmin;
+    }
+    return dmax;
+}
+
+static REAL rand_real()
+{
+    return (REAL)rand()/RAND_MAX - 0.5;
+}
+
+static INT misc_merge_test()
+{
+    const UINT N = 2000;
+    const REAL tol = 1e-3;
+    COMPLEX vals[2000], vals_ref[2000];
+    UINT i, K, K_ref;
+    INT ret_code = SUCCESS;
+
+    // Random values, every fifth one is close to a previous one. Some
+    // values are real, some are not finite.
+    srand(1);
+    for (i=0; i<N; i++) {
+        if (i > 0 && i % 5 == 0)
+            vals[i] = vals[rand() % i] + 0.9*tol*(rand_real() + I*rand_real());
+        else if (i % 7 == 0)
+            vals[i] = 10*rand_real();
+        else
+            vals[i] = 10*rand_real() + 10*I*rand_real();
+    }
+    vals[3] = NAN;
+    vals[4] = INFINITY;
+    memcpy(vals_ref, vals, N*sizeof(COMPLEX));
+
+    K = N;
+    ret_code = misc_merge(&K, vals, tol);
+    CHECK_RETCODE(ret_code, leave_fun);
+    K_ref = merge_ref(N, vals_ref, tol);
+    if (K != K_ref || K >= N) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+    for (i=0; i<K; i++) {
+        if (vals[i] != vals_ref[i] && vals[i] == vals[i]) {
+            ret_code = E_TEST_FAILED;
+            goto leave_fun;
+        }
+    }
+
+leave_fun:
+    return ret_code;
+}
+
+static INT misc_filter_merge_test()
+{
+    const UINT N = 1000;
+    const REAL tol = 1e-4;
+    const REAL bounding_box[4] = { -1.0, 1.0, 0.0, 2.0 };
+    const COMPLEX log_coeff = 0.7/(2*I);
+    COMPLEX vals[1000], vals_ref[1000];
+    UINT i, K, K_ref;
+    INT ret_code = SUCCESS;
+
+    srand(2);
+    for (i=0; i<N; i++) {
+        if (i > 0 && i % 3 == 0)
+            vals[i] = vals[i-1]*(1.0 + 0.1*tol*rand_real());
+        else
+            vals[i] = CEXP(2*rand_real() + 8*I*rand_real());
+    }
+
+    // Reference: transform, filter and merge separately
+    for (i=0; i<N; i++)
+        vals_ref[i] = log_coeff * CLOG(vals[i]);
+    K_ref = N;
+    ret_code = misc_filter(&K_ref, vals_ref, NULL, bounding_box);
+    CHECK_RETCODE(ret_code, leave_fun);
+    K_ref = merge_ref(K_ref, vals_ref, tol);
+
+    K = N;
+    ret_code = misc_filter_merge(&K, vals, bounding_box, tol, log_coeff);
+    CHECK_RETCODE(ret_code, leave_fun);
+    if (K != K_ref || K == 0) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+    for (i=0; i<K; i++) {
+        if (CABS(vals[i] - vals_ref[i]) > 100*EPSILON) {
+            ret_code = E_TEST_FAILED;
+            goto leave_fun;
+        }
+    }
+
+leave_fun:
+    return ret_code;
+}
+
+static INT misc_hausdorff_dist_test()
+{
+    COMPLEX A[1500], B[700];
+    const UINT lenA = 1500, lenB = 700;
+    UINT i;
+    REAL d, d_ref;
+
+    srand(3);
+    for (i=0; i<lenA; i++)
+        A[i] = rand_real() + I*rand_real();
+    for (i=0; i<lenB; i++)
+        B[i] = 1.5*rand_real() + 0.01*I*rand_real();
+
+    // Clustered versus spread out points
+    d = misc_hausdorff_dist(lenA, A, lenB, B);
+    d_ref = hausdorff_ref(lenA, A, lenB, B);
+    if (!(FABS(d - d_ref) <= 100*EPSILON))
+        return E_TEST_FAILED;
+
+    // Real points and a far away outlier
+    for (i=0; i<lenB; i++)
+        B[i] = 2*rand_real();
+    A[17] = 1e3 - 50*I;
+    d = misc_hausdorff_dist(lenA, A, lenB, B);
+    d_ref = hausdorff_ref(lenA, A, lenB, B);
+    if (!(FABS(d - d_ref) <= 100*EPSILON*d_ref))
+        return E_TEST_FAILED;
+
+    // Non-finite values
+    B[5] = NAN;
+    d = misc_hausdorff_dist(lenA, A, lenB, B);
+    if (d != INFINITY)
+        return E_TEST_FAILED;
+
+    return SUCCESS;
+}
+
+int main(void)
+{
+    if (misc_merge_test() != SUCCESS)
+        return EXIT_FAILURE;
+    if (misc_filter_merge_test() != SUCCESS)
+        return EXIT_FAILURE;
+    if (misc_hausdorff_dist_test() != SUCCESS)
+        return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,91 @@
+/*
+* This file is part of FNFT.  
+*                                                                  
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*                                                                      
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* Sander Wahls (TU Delft) 2017-2018.
+*/
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <stdio.h>
+#include <string.h>
+#include "fnft.h"
+#include "fnft__poly_eval.h"
+#include "fnft__poly_eval_multipoint.h"
+#include "fnft__misc.h"
+#include "fnft__errwarn.h"
+
+// Compares the multipoint evaluation routine with Horner's method for
+// nz points in an annulus around the circle with radius r.
+static INT poly_eval_multipoint_test(const UINT deg, const UINT nz,
+    const REAL r, const REAL error_bound)
+{
+    COMPLEX *p = NULL, *z = NULL, *result_exact;
+    REAL err;
+    UINT i;
+    INT ret_code = SUCCESS;
+
+    p = malloc((deg+1) * sizeof(COMPLEX));
+    z = malloc(2*nz * sizeof(COMPLEX));
+    if (p == NULL || z == NULL) {
+        ret_code = E_NOMEM;
+        goto release_mem;
+    }
+    result_exact = z + nz;
+
+    // Deterministic test polynomial and points. The angles of the points
+    // are multiples of the golden angle.
+    for (i=0; i<=deg; i++)
+        p[i] = SIN(0.7*i + 0.1) + I*COS(1.3*i*i + 0.2);
+    for (i=0; i<nz; i++)
+        z[i] = r*(1.0 + 1e-3*SIN(3.0*i)) * CEXP(I*PI*(3.0-SQRT(5.0))*i);
+
+    memcpy(result_exact, z, nz * sizeof(COMPLEX));
+    ret_code = poly_eval(deg, p, nz, result_exact);
+    CHECK_RETCODE(ret_code, release_mem);
+
+    ret_code = poly_eval_multipoint_rings(deg, p, nz, z);
+    CHECK_RETCODE(ret_code, release_mem);
+    err = misc_rel_err(nz, z, result_exact);
+#ifdef DEBUG
+    printf("poly_eval_multipoint_test: error = %2.1e <= %2.1e\n", err,
+        error_bound);
+#endif
+    if (!(err <= error_bound)) {
+        ret_code = E_TEST_FAILED;
+        goto release_mem;
+    }
+
+release_mem:
+    free(p);
+    free(z);
+    return ret_code;
+}
+
+int main()
+{
+    // Few points, most of the work is done by Horner's method
+    if (poly_eval_multipoint_test(10, 7, 0.9, 100*EPSILON) != SUCCESS)
+        return EXIT_FAILURE;
+
+    // Moderate number of points in an annulus
+    if (poly_eval_multipoint_test(300, 200, 0.95, 1e-12) != SUCCESS)
+        return EXIT_FAILURE;
+
+    // Many points close to the unit circle, so that the rings are used
+    if (poly_eval_multipoint_test(64, 5000, 1.0, 1e-12) != SUCCESS)
+        return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
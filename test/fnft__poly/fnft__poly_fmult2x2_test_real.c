@@ -0,0 +1,114 @@
+/*
+* This file is part of FNFT.  
+*                                                                  
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*                                                                      
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* Sander Wahls (TU Delft) 2017-2018.
+*/
+
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <stdio.h>
+#include <string.h>
+#include "fnft__poly_fmult.h"
+#include "fnft__misc.h"
+#include "fnft__errwarn.h"
+
+// Compares the results of poly_fmult2x2_real and poly_fmult2x2 for
+// matrices of polynomials with real coefficients.
+static INT poly_fmult2x2_test_real(const UINT deg, const UINT n,
+    INT normalize_flag)
+{
+    UINT i, d[2];
+    INT W[2] = {0, 0};
+    COMPLEX *p[2] = {NULL, NULL}, *result[2] = {NULL, NULL};
+    REAL err;
+    INT ret_code = SUCCESS;
+
+    const UINT memsize = poly_fmult2x2_numel(deg, n);
+    for (i=0; i<2; i++) {
+        p[i] = malloc(memsize * sizeof(COMPLEX));
+        result[i] = malloc(memsize * sizeof(COMPLEX));
+        if (p[i] == NULL || result[i] == NULL) {
+            ret_code = E_NOMEM;
+            goto leave_fun;
+        }
+    }
+
+    for (i=0; i<n*(deg+1); i++) {
+        p[0][i] = SQRT(i+1.0)*COS(i);
+        p[0][i+n*(deg+1)] = SQRT(i+1.0)*SIN(-2.0*i+0.1);
+        p[0][i+2*n*(deg+1)] = SQRT(i+1.0)*COS(i+0.2);
+        p[0][i+3*n*(deg+1)] = SQRT(i+1.0)*SIN(-2.0*i+0.3);
+    }
+    memcpy(p[1], p[0], 4*n*(deg+1) * sizeof(COMPLEX));
+
+    d[0] = deg;
+    ret_code = poly_fmult2x2_real(&d[0], n, p[0], result[0],
+        normalize_flag ? &W[0] : NULL);
+    CHECK_RETCODE(ret_code, leave_fun);
+    d[1] = deg;
+    ret_code = poly_fmult2x2(&d[1], n, p[1], result[1],
+        normalize_flag ? &W[1] : NULL);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    if (d[0] != d[1] || d[0] != n*deg || W[0] != W[1]) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+    for (i=0; i<4*(d[0]+1); i++) {
+        if (CIMAG(result[0][i]) != 0.0) {
+            ret_code = E_TEST_FAILED;
+            goto leave_fun;
+        }
+    }
+    err = misc_rel_err(4*(d[0]+1), result[0], result[1]);
+#ifdef DEBUG
+    printf("deg=%u, n=%u, normalize_flag=%d: err = %2.1e\n", (unsigned)deg,
+        (unsigned)n, (int)normalize_flag, err);
+#endif
+    if (!(err <= 1000*EPSILON))
+        ret_code = E_TEST_FAILED;
+
+leave_fun:
+    for (i=0; i<2; i++) {
+        free(p[i]);
+        free(result[i]);
+    }
+    return ret_code;
+}
+
+INT main(void)
+{
+    // The FFT lengths for deg = 1 and deg = 2 are odd if Kiss FFT is used
+    const UINT degs[3] = {1, 2, 12};
+    const UINT ns[3] = {5, 8, 37};
+    UINT i, j;
+    INT ret_code;
+
+    for (i=0; i<3; i++) {
+        for (j=0; j<3; j++) {
+            ret_code = poly_fmult2x2_test_real(degs[i], ns[j], 0);
+            CHECK_RETCODE(ret_code, leave_fun);
+            ret_code = poly_fmult2x2_test_real(degs[i], ns[j], 1);
+            CHECK_RETCODE(ret_code, leave_fun);
+        }
+    }
+
+leave_fun:
+    if (ret_code != SUCCESS)
+        return EXIT_FAILURE;
+    else
+        return EXIT_SUCCESS;
+}
@@ -0,0 +1,135 @@
+/*
+* This file is part of FNFT.  
+*                                                                  
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*                                                                      
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* Sander Wahls (TU Delft) 2017-2018.
+*/
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <stdlib.h>
+#include "fnft__poly_roots_aberth.h"
+#include "fnft__poly_roots_fasteigen.h"
+#include "fnft__misc.h"
+#include "fnft__errwarn.h"
+
+// Small polynomial with known roots
+INT poly_roots_aberth_test_small()
+{
+    const UINT deg = 3;
+    COMPLEX p[4] = { 1.0-2.0*I, 0.3+0.4*I, -2.0-2.0*I, -3.0+4.0*I };
+    COMPLEX roots[3];
+    COMPLEX roots_exact[3] = { \
+         -0.767344914566607 -      1.47758771489852*I, \
+           1.26733490516498 +     0.334189743482641*I, \
+         -0.399989990598367 +     0.943397971415882*I };
+    INT ret_code;
+
+    ret_code = poly_roots_aberth(deg, p, roots);
+    if (ret_code != SUCCESS)
+        return E_SUBROUTINE(ret_code);
+    if ( misc_hausdorff_dist(deg, roots, deg, roots_exact)
+    > 100*EPSILON )
+        return E_TEST_FAILED;
+
+    return SUCCESS;
+}
+
+// The roots of p(z)=z^deg-c are known analytically
+INT poly_roots_aberth_test_monomial(const UINT deg, const COMPLEX c)
+{
+    COMPLEX *p = NULL, *roots = NULL, *roots_exact = NULL;
+    UINT i;
+    INT ret_code = SUCCESS;
+
+    p = malloc((deg + 1) * sizeof(COMPLEX));
+    roots = malloc(deg * sizeof(COMPLEX));
+    roots_exact = malloc(deg * sizeof(COMPLEX));
+    if (p == NULL || roots == NULL || roots_exact == NULL) {
+        ret_code = E_NOMEM;
+        goto release_mem;
+    }
+
+    for (i = 0; i <= deg; i++)
+        p[i] = 0.0;
+    p[0] = 1.0;
+    p[deg] = -c;
+    for (i = 0; i < deg; i++)
+        roots_exact[i] = CPOW(c, 1.0/deg) * CEXP(2*PI*I*i/deg);
+
+    ret_code = poly_roots_aberth(deg, p, roots);
+    CHECK_RETCODE(ret_code, release_mem);
+    if ( misc_hausdorff_dist(deg, roots, deg, roots_exact)
+    > 100*EPSILON ) {
+        ret_code = E_TEST_FAILED;
+        goto release_mem;
+    }
+
+release_mem:
+    free(p);
+    free(roots);
+    free(roots_exact);
+    return ret_code;
+}
+
+// Compares with the eigenvalue-based root finder for a polynomial with
+// pseudo-random coefficients
+INT poly_roots_aberth_test_random(const UINT deg)
+{
+    COMPLEX *p = NULL, *roots = NULL, *roots_fasteigen = NULL;
+    UINT i;
+    INT ret_code = SUCCESS;
+
+    p = malloc((deg + 1) * sizeof(COMPLEX));
+    roots = malloc(deg * sizeof(COMPLEX));
+    roots_fasteigen = malloc(deg * sizeof(COMPLEX));
+    if (p == NULL || roots == NULL || roots_fasteigen == NULL) {
+        ret_code = E_NOMEM;
+        goto release_mem;
+    }
+
+    srand(1);
+    for (i = 0; i <= deg; i++)
+        p[i] = (REAL)rand()/RAND_MAX - 0.5 + I*((REAL)rand()/RAND_MAX - 0.5);
+
+    ret_code = poly_roots_aberth(deg, p, roots);
+    CHECK_RETCODE(ret_code, release_mem);
+    ret_code = poly_roots_fasteigen(deg, p, roots_fasteigen);
+    CHECK_RETCODE(ret_code, release_mem);
+    if ( misc_hausdorff_dist(deg, roots, deg, roots_fasteigen)
+    > 1e-10 ) {
+        ret_code = E_TEST_FAILED;
+        goto release_mem;
+    }
+
+release_mem:
+    free(p);
+    free(roots);
+    free(roots_fasteigen);
+    return ret_code;
+}
+
+INT main()
+{
+    if ( poly_roots_aberth_test_small() != SUCCESS )
+        return EXIT_FAILURE;
+    if ( poly_roots_aberth_test_monomial(300, 0.5) != SUCCESS )
+        return EXIT_FAILURE;
+    if ( poly_roots_aberth_test_monomial(257, 2.0 + I) != SUCCESS )
+        return EXIT_FAILURE;
+    if ( poly_roots_aberth_test_random(500) != SUCCESS )
+        return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
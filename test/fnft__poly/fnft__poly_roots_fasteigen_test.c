@@ -43,10 +43,39 @@ INT poly_roots_fasteigen_test()
     return SUCCESS;
 }
 
+// Same polynomial as above, but with two vanishing leading and one
+// vanishing trailing coefficient (i.e., multiplied with z and with two
+// additional roots at infinity)
+INT poly_roots_fasteigen_test_zero_coeffs()
+{
+    const UINT deg = 6;
+    COMPLEX p[7] = { 0.0, 0.0, 1.0-2.0*I, 0.3+0.4*I, -2.0-2.0*I, -3.0+4.0*I,
+        0.0 };
+    COMPLEX roots[6];
+    COMPLEX roots_exact[4] = { \
+         -0.767344914566607 -      1.47758771489852*I, \
+           1.26733490516498 +     0.334189743482641*I, \
+         -0.399989990598367 +     0.943397971415882*I, \
+         0.0 };
+    INT ret_code;
+
+    ret_code = poly_roots_fasteigen(deg, p, roots);
+    if (ret_code != SUCCESS)
+        return E_SUBROUTINE(ret_code);
+    if (roots[4] != INFINITY || roots[5] != INFINITY)
+        return E_TEST_FAILED;
+    if ( misc_hausdorff_dist(4, roots, 4, roots_exact) > 100*EPSILON )
+        return E_TEST_FAILED;
+
+    return SUCCESS;
+}
+
 INT main()
 {
     if ( poly_roots_fasteigen_test() != SUCCESS )
         return EXIT_FAILURE;
+    if ( poly_roots_fasteigen_test_zero_coeffs() != SUCCESS )
+        return EXIT_FAILURE;
 
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,179 @@
+/*
+* This file is part of FNFT.  
+*                                                                  
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*                                                                      
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* Sander Wahls (TU Delft) 2018.
+*/
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <stdio.h>
+
+#include "fnft__poly_roots_fftgridsearch.h"
+#include "fnft__misc.h"
+#include "fnft__errwarn.h"
+
+// Compares the roots found by poly_roots_fftgridsearch_adaptive with those
+// found by poly_roots_fftgridsearch_shifts (or poly_roots_fftgridsearch if
+// nshifts is zero) on the full grid. The zoomed Chirp transforms round
+// differently, which can change which one of two neighboring grid points is
+// used to estimate a root. The error bound therefore is the error of the
+// linear approximation, which is of the order of the squared grid spacing.
+static INT compare_with_full_grid(const UINT deg, COMPLEX const * const p,
+    const UINT pos, const UINT nshifts, COMPLEX const * const shifts,
+    const UINT M, REAL const * const PHI)
+{
+    COMPLEX *roots = NULL, *roots_full = NULL;
+    UINT j, n, n_full, nroots[3], nroots_full[3], offset;
+    REAL err;
+    INT ret_code;
+
+    const REAL eps = (PHI[1] - PHI[0]) / (M - 1);
+    roots = malloc(M * sizeof(COMPLEX));
+    roots_full = malloc(M * sizeof(COMPLEX));
+    if (roots == NULL || roots_full == NULL) {
+        ret_code = E_NOMEM;
+        goto release_mem;
+    }
+
+    n = M;
+    ret_code = poly_roots_fftgridsearch_adaptive(deg, p, pos, nshifts, shifts,
+        &n, PHI, M, roots, nroots);
+    CHECK_RETCODE(ret_code, release_mem);
+    n_full = M;
+    if (nshifts == 0) {
+        ret_code = poly_roots_fftgridsearch(deg, p, &n_full, PHI, roots_full);
+        CHECK_RETCODE(ret_code, release_mem);
+        nroots[0] = n;
+        nroots_full[0] = n_full;
+    } else {
+        ret_code = poly_roots_fftgridsearch_shifts(deg, p, pos, nshifts,
+            shifts, &n_full, PHI, roots_full, nroots_full);
+        CHECK_RETCODE(ret_code, release_mem);
+    }
+    if (n != n_full || n == 0) {
+        ret_code = E_TEST_FAILED;
+        goto release_mem;
+    }
+
+    offset = 0;
+    for (j=0; j==0 || j<nshifts; j++) {
+        if (nroots[j] != nroots_full[j]) {
+            ret_code = E_TEST_FAILED;
+            goto release_mem;
+        }
+        err = misc_hausdorff_dist(nroots[j], roots + offset, nroots[j],
+            roots_full + offset);
+#ifdef DEBUG
+        printf("deg=%i, M=%i, j=%i: %i roots, error = %2.1e\n", (int)deg,
+            (int)M, (int)j, (int)nroots[j], err);
+#endif
+        if (!(err <= eps*eps)) {
+            ret_code = E_TEST_FAILED;
+            goto release_mem;
+        }
+        offset += nroots[j];
+    }
+
+release_mem:
+    free(roots);
+    free(roots_full);
+    return ret_code;
+}
+
+// Polynomial with a few roots on the unit circle, whose other roots are
+// away from the unit circle. Only small parts of the grid are evaluated on
+// all three rings. The roots found on the unit circle are also compared with
+// the exact ones.
+static INT poly_roots_fftgridsearch_test_adaptive_sparse(const UINT M)
+{
+    const UINT deg = 200, nexact = 5;
+    const REAL phi_exact[5] = { -2.5, -0.3, 0.1, 1.0, 2.9 };
+    COMPLEX roots_exact[5];
+    COMPLEX *p = NULL, *roots = NULL;
+    REAL PHI[2] = { -PI, PI };
+    UINT i, k, n;
+    REAL err;
+    INT ret_code;
+
+    p = malloc((deg + 1) * sizeof(COMPLEX));
+    roots = malloc(M * sizeof(COMPLEX));
+    if (p == NULL || roots == NULL) {
+        ret_code = E_NOMEM;
+        goto release_mem;
+    }
+
+    // p(z) = (z^(deg-nexact) - r^(deg-nexact)) * prod_k (z-z_k), where the
+    // roots z_k are on the unit circle and the other roots on a circle with
+    // radius r=0.9
+    for (i=0; i<=deg; i++)
+        p[i] = 0.0;
+    p[0] = 1.0;
+    for (k=0; k<nexact; k++) {
+        roots_exact[k] = CEXP(I*phi_exact[k]);
+        for (i=k+1; i>0; i--)
+            p[i] -= roots_exact[k] * p[i-1];
+    }
+    for (i=0; i<=nexact; i++)
+        p[deg - nexact + i] -= POW(0.9, deg - nexact) * p[i];
+
+    ret_code = compare_with_full_grid(deg, p, 0, 0, NULL, M, PHI);
+    CHECK_RETCODE(ret_code, release_mem);
+
+    n = M;
+    ret_code = poly_roots_fftgridsearch_adaptive(deg, p, 0, 0, NULL, &n, PHI,
+        M, roots, NULL);
+    CHECK_RETCODE(ret_code, release_mem);
+    if (n != nexact) {
+        ret_code = E_TEST_FAILED;
+        goto release_mem;
+    }
+    err = misc_hausdorff_dist(n, roots, nexact, roots_exact);
+#ifdef DEBUG
+    printf("M=%i: error in roots = %2.1e\n", (int)M, err);
+#endif
+    if (!(err <= 2*PI/M)) {
+        ret_code = E_TEST_FAILED;
+        goto release_mem;
+    }
+
+release_mem:
+    free(p);
+    free(roots);
+    return ret_code;
+}
+
+int main()
+{
+    COMPLEX p[7] = { 4-5*I, 3-4*I, 2-3*I, 2, 2+3*I, 3+4*I, 4+5*I };
+    COMPLEX shifts[3] = { 2.0, -2.0, 1.0 };
+    REAL PHI[2] = { 0, 2.0*PI };
+    REAL PHI_part[2] = { -1.0, 2.0 };
+
+    if (compare_with_full_grid(6, p, 3, 3, shifts, 128, PHI) != SUCCESS)
+        return EXIT_FAILURE;
+    if (compare_with_full_grid(6, p, 3, 3, shifts, 1000, PHI) != SUCCESS)
+        return EXIT_FAILURE;
+    if (compare_with_full_grid(6, p, 3, 1, shifts, 1000, PHI_part)
+        != SUCCESS)
+        return EXIT_FAILURE;
+    if (compare_with_full_grid(6, p, 3, 0, NULL, 1000, PHI) != SUCCESS)
+        return EXIT_FAILURE;
+    if (poly_roots_fftgridsearch_test_adaptive_sparse(32*200) != SUCCESS)
+        return EXIT_FAILURE;
+    if (poly_roots_fftgridsearch_test_adaptive_sparse(10000) != SUCCESS)
+        return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
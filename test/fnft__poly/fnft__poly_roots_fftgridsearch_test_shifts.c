@@ -0,0 +1,96 @@
+/*
+* This file is part of FNFT.  
+*                                                                  
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*                                                                      
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* Sander Wahls (TU Delft) 2017-2018.
+*/
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <string.h> // for memcpy
+#include "fnft__poly_roots_fftgridsearch.h"
+#include "fnft__misc.h"
+#include "fnft__errwarn.h"
+
+// Compares the roots of p(z)+shifts[j]*z^(deg-pos) found by
+// poly_roots_fftgridsearch_shifts with those found by separate calls of
+// poly_roots_fftgridsearch for the shifted polynomials.
+static INT poly_roots_fftgridsearch_test_shifts(const UINT M)
+{
+    const UINT deg = 6, pos = 3, nshifts = 3;
+    COMPLEX p[7] = { 4-5*I, 3-4*I, 2-3*I, 2, 2+3*I, 3+4*I, 4+5*I };
+    COMPLEX shifts[3] = { 2.0, -2.0, 1.0 };
+    COMPLEX p_shifted[7];
+    COMPLEX *roots = NULL, *roots_exact = NULL;
+    REAL PHI[2] = { 0, 2.0*PI };
+    UINT j, n, nroots_total, nroots[3], offset;
+    REAL err;
+    INT ret_code;
+
+    roots = malloc(M * sizeof(COMPLEX));
+    roots_exact = malloc(M * sizeof(COMPLEX));
+    if (roots == NULL || roots_exact == NULL) {
+        ret_code = E_NOMEM;
+        goto release_mem;
+    }
+
+    nroots_total = M;
+    ret_code = poly_roots_fftgridsearch_shifts(deg, p, pos, nshifts, shifts,
+        &nroots_total, PHI, roots, nroots);
+    CHECK_RETCODE(ret_code, release_mem);
+    if (nroots_total != nroots[0] + nroots[1] + nroots[2]) {
+        ret_code = E_TEST_FAILED;
+        goto release_mem;
+    }
+
+    offset = 0;
+    for (j=0; j<nshifts; j++) {
+        memcpy(p_shifted, p, (deg + 1) * sizeof(COMPLEX));
+        p_shifted[pos] += shifts[j];
+        n = M;
+        ret_code = poly_roots_fftgridsearch(deg, p_shifted, &n, PHI,
+            roots_exact);
+        CHECK_RETCODE(ret_code, release_mem);
+        if (n != nroots[j] || n == 0) {
+            ret_code = E_TEST_FAILED;
+            goto release_mem;
+        }
+        err = misc_hausdorff_dist(n, roots + offset, n, roots_exact);
+        if (!(err <= 1e-12)) {
+            ret_code = E_TEST_FAILED;
+            goto release_mem;
+        }
+        offset += n;
+    }
+
+release_mem:
+    free(roots);
+    free(roots_exact);
+    return ret_code;
+}
+
+int main()
+{
+    if (poly_roots_fftgridsearch_test_shifts(128) != SUCCESS)
+        return EXIT_FAILURE;
+    if (poly_roots_fftgridsearch_test_shifts(1000) != SUCCESS)
+        return EXIT_FAILURE;
+    // Grids with several tiles of 16384 interior points
+    if (poly_roots_fftgridsearch_test_shifts(2*16384 + 1000) != SUCCESS)
+        return EXIT_FAILURE;
+    if (poly_roots_fftgridsearch_test_shifts(3*16384 + 2) != SUCCESS)
+        return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,143 @@
+/*
+* This file is part of FNFT.  
+*                                                                  
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*                                                                      
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* Sander Wahls (TU Delft) 2018.
+*/
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <stdio.h>
+#include "fnft__poly_roots_fftgridsearch.h"
+#include "fnft__misc.h"
+#include "fnft__errwarn.h"
+
+// The grid is processed in tiles of 16384 interior points. The roots of the
+// test polynomials are placed close to the tile boundaries, so that roots
+// that are lost or detected twice when the results of the tiles are merged
+// would be noticed.
+#define TILE_LEN 16384
+
+// Grid search for a polynomial of degree six with simple roots on the unit
+// circle, three of which are located at or next to tile boundaries.
+static INT fftgridsearch_test_tiles(const UINT M)
+{
+    const UINT deg = 6;
+    const REAL PHI[2] = { -PI, PI };
+    const REAL eps = (PHI[1] - PHI[0]) / (M - 1);
+    const REAL offsets[3] = { 0.0, 0.5, -0.3 };
+    const UINT idx[3] = { TILE_LEN, 2*TILE_LEN, 3*TILE_LEN + 1 };
+    COMPLEX roots_exact[6], p[7], *roots = NULL;
+    UINT i, j, nroots;
+    REAL err;
+    INT ret_code = SUCCESS;
+
+    roots = malloc(M * sizeof(COMPLEX));
+    if (roots == NULL)
+        return E_NOMEM;
+
+    // Three roots close to the boundaries of the first four tiles, three
+    // others in between
+    for (i=0; i<3; i++)
+        roots_exact[i] = CEXP(I*(PHI[0] + (idx[i] + offsets[i])*eps));
+    roots_exact[3] = CEXP(I*0.31);
+    roots_exact[4] = CEXP(I*1.7);
+    roots_exact[5] = CEXP(-I*2.2);
+
+    // Coefficients of the polynomial with these roots
+    p[0] = 1.0;
+    for (i=1; i<=deg; i++)
+        p[i] = 0.0;
+    for (i=0; i<deg; i++) {
+        for (j=i+1; j>0; j--)
+            p[j] -= roots_exact[i]*p[j-1];
+    }
+
+    nroots = M;
+    ret_code = poly_roots_fftgridsearch(deg, p, &nroots, PHI, roots);
+    CHECK_RETCODE(ret_code, release_mem);
+    err = misc_hausdorff_dist(nroots, roots, deg, roots_exact);
+#ifdef DEBUG
+    printf("fftgridsearch_test_tiles: M = %u, nroots = %u, error = %2.1e\n",
+        (unsigned int)M, (unsigned int)nroots, err);
+#endif
+    if (nroots != deg || !(err <= 10*eps*eps)) {
+        ret_code = E_TEST_FAILED;
+        goto release_mem;
+    }
+
+release_mem:
+    free(roots);
+    return ret_code;
+}
+
+// Grid search for the para-hermitian Laurent polynomial that is also used in
+// fnft__poly_roots_fftgridsearch_test_paraherm, on a grid with several tiles.
+static INT fftgridsearch_paraherm_test_tiles(const UINT M)
+{
+    const UINT deg = 6;
+    COMPLEX p[7] = { 4-5*I, 3-4*I, 2-3*I, 2, 2+3*I, 3+4*I, 4+5*I };
+    COMPLEX roots_exact[6] = {
+      3.992603696776205e-01 + 9.168375849652399e-01*I,
+     -3.932716698145485e-01 + 9.194223152182454e-01*I,
+      9.475398776668446e-01 - 3.196375763753407e-01*I,
+     -9.853253052543915e-01 + 1.706869732151292e-01*I,
+     -7.486910771535749e-01 - 6.629190531208312e-01*I,
+      4.384974884943283e-17 - 1.000000000000000e+00*I };
+    const REAL PHI[2] = { 0, 2.0*PI };
+    const REAL eps = (PHI[1] - PHI[0]) / (M - 1);
+    COMPLEX *roots = NULL;
+    UINT nroots;
+    REAL err;
+    INT ret_code = SUCCESS;
+
+    roots = malloc(M * sizeof(COMPLEX));
+    if (roots == NULL)
+        return E_NOMEM;
+
+    nroots = M;
+    ret_code = poly_roots_fftgridsearch_paraherm(deg, p, &nroots, PHI, roots);
+    CHECK_RETCODE(ret_code, release_mem);
+    err = misc_hausdorff_dist(nroots, roots, deg, roots_exact);
+#ifdef DEBUG
+    printf("fftgridsearch_paraherm_test_tiles: M = %u, nroots = %u, "
+        "error = %2.1e\n", (unsigned int)M, (unsigned int)nroots, err);
+#endif
+    if (nroots != deg || !(err <= 10*eps*eps)) {
+        ret_code = E_TEST_FAILED;
+        goto release_mem;
+    }
+
+release_mem:
+    free(roots);
+    return ret_code;
+}
+
+int main()
+{
+    INT ret_code;
+
+    ret_code = fftgridsearch_test_tiles(3*TILE_LEN + 1000);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = fftgridsearch_test_tiles(4*TILE_LEN + 2);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = fftgridsearch_paraherm_test_tiles(5*TILE_LEN + 17);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+leave_fun:
+    if (ret_code != SUCCESS)
+        return EXIT_FAILURE;
+    else
+        return EXIT_SUCCESS;
+}
@@ -0,0 +1,84 @@
+/*
+ * This file is part of FNFT.
+ *
+ * FNFT is free software; you can redistribute it and/or
+ * modify it under the terms of the version 2 of the GNU General
+ * Public License as published by the Free Software Foundation.
+ *
+ * FNFT is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ *
+ * Contributors:
+ * Sander Wahls (TU Delft) 2018.
+ */
+
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include "fnft__poly_specfact.h"
+#include "fnft__poly_roots_fasteigen.h"
+#include "fnft__errwarn.h"
+#include "fnft__misc.h"
+#ifdef DEBUG
+#include <stdio.h>
+#endif
+
+static INT poly_specfact_annulus_test(const REAL r_in,
+    const UINT deg_exact, COMPLEX const * const roots_exact)
+{
+    const COMPLEX roots_poly[7] = {
+        0.1, 0.5*I, -0.6+0.2*I, 0.85, 1.5, -2.0*I, 3.0 };
+    const UINT deg = sizeof(roots_poly)/sizeof(roots_poly[0]);
+    COMPLEX poly[8], factor[8], roots[7];
+    UINT i, j, deg_factor;
+    INT ret_code = SUCCESS;
+
+    // Expand the polynomial (coefficients in descending order)
+    poly[0] = 2.0 - I;
+    for (i=1; i<=deg; i++) {
+        poly[i] = -roots_poly[i-1]*poly[i-1];
+        for (j=i-1; j>0; j--)
+            poly[j] -= roots_poly[i-1]*poly[j-1];
+    }
+
+    ret_code = poly_specfact_annulus(deg, poly, r_in, 1.0, 4, &deg_factor,
+        factor);
+    CHECK_RETCODE(ret_code, leave_fun);
+    if (deg_factor != deg_exact) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+
+    ret_code = poly_roots_fasteigen(deg_factor, factor, roots);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    REAL err = misc_hausdorff_dist(deg_factor, roots, deg_exact,
+        roots_exact);
+#ifdef DEBUG
+    printf("err = %g\n", err);
+#endif
+    if (err > 1e-10) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+
+leave_fun:
+    return ret_code;
+}
+
+int main(void)
+{
+    const COMPLEX roots_annulus[3] = { 0.5*I, -0.6+0.2*I, 0.85 };
+    const COMPLEX roots_disk[4] = { 0.1, 0.5*I, -0.6+0.2*I, 0.85 };
+
+    if (poly_specfact_annulus_test(0.3, 3, roots_annulus) != SUCCESS)
+        return EXIT_FAILURE;
+    if (poly_specfact_annulus_test(0.0, 4, roots_disk) != SUCCESS)
+        return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
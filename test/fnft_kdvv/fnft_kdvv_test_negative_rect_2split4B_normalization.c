@@ -0,0 +1,116 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* Sander Wahls (TU Delft) 2018.
+*/
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <stdio.h>
+#include "fnft_kdvv.h"
+#include "fnft__misc.h"
+#include "fnft__errwarn.h"
+
+// Computes the reflection coefficient of the rectangle q(t)=ampl for
+// |t|<1/2 with fnft_kdvv and compares it with the exact one. For large
+// negative amplitudes, the entries of the transfer matrix grow like
+// exp(sqrt(-ampl)) and overflow unless normalization is enabled.
+static INT kdvv_test_negative_rect(const UINT D, const REAL ampl,
+    const REAL err_bnd, fnft_kdvv_opts_t * const opts)
+{
+    const UINT M = 16;
+    const REAL ell = 0.5;
+    REAL T[2] = { -1.0, 2.0 }, XI[2] = { 1.0, 16.0 };
+    COMPLEX *q = NULL, contspec[16], contspec_exact[16];
+    COMPLEX k, gamma, delta, e;
+    REAL t, xi, err;
+    UINT i;
+    INT ret_code = SUCCESS;
+
+    q = malloc(D * sizeof(COMPLEX));
+    if (q == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+    const REAL eps_t = (T[1] - T[0])/(D - 1);
+    for (i=0; i<D; i++) {
+        t = T[0] + i*eps_t;
+        if (FABS(t) == ell)
+            q[i] = ampl/2;
+        else if (FABS(t) < ell)
+            q[i] = ampl;
+        else
+            q[i] = 0.0;
+    }
+
+    // Exact reflection coefficient (Osborne, J. Comput. Phys. 94(2), 1991,
+    // Sec. 8), R = j*gamma*exp(-2j*xi*ell)/(cot(2*k*ell) - j*delta), where
+    // k=sqrt(ampl+xi^2). The cotangent is evaluated in a way that does not
+    // overflow when Im(k) is large.
+    for (i=0; i<M; i++) {
+        xi = XI[0] + i*(XI[1] - XI[0])/(M - 1);
+        k = CSQRT(ampl + xi*xi);
+        gamma = (k/xi - xi/k)/2;
+        delta = (k/xi + xi/k)/2;
+        e = CEXP(4.0*I*k*ell);
+        contspec_exact[i] = I*gamma*CEXP(-2.0*I*xi*ell)
+            / (I*(e + 1.0)/(e - 1.0) - I*delta);
+    }
+
+    ret_code = fnft_kdvv(D, q, T, M, contspec, XI, NULL, NULL, NULL, opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    err = misc_rel_err(M, contspec, contspec_exact);
+#ifdef DEBUG
+    printf("kdvv_test_negative_rect: D = %i, ampl = %g, error = %2.1e <= %2.1e\n",
+        (int)D, ampl, err, err_bnd);
+#endif
+    if (!(err <= err_bnd))
+        ret_code = E_TEST_FAILED;
+
+leave_fun:
+    free(q);
+    return ret_code;
+}
+
+INT main()
+{
+    fnft_kdvv_opts_t opts = fnft_kdvv_default_opts();
+    INT ret_code;
+
+    opts.discretization = kdv_discretization_2SPLIT4B;
+
+    // Moderate amplitude: The results with and without normalization agree
+    ret_code = kdvv_test_negative_rect(4096, -1e4, 1e-8, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+    opts.normalization_flag = 0;
+    ret_code = kdvv_test_negative_rect(4096, -1e4, 1e-8, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Large amplitude: The transfer matrix overflows without normalization
+    opts.normalization_flag = 1;
+    ret_code = kdvv_test_negative_rect(4096, -1e6, 3e-7, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Check for fourth order error decay
+    ret_code = kdvv_test_negative_rect(8192, -1e6, 3e-7/16, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+leave_fun:
+    if (ret_code != SUCCESS)
+        return EXIT_FAILURE;
+    else
+        return EXIT_SUCCESS;
+}
@@ -0,0 +1,62 @@
+/*
+* This file is part of FNFT.  
+*                                                                  
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*                                                                      
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* Sander Wahls (TU Delft) 2017-2018.
+*/
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include "fnft__kdvv_testcases.h"
+#include "fnft__errwarn.h"
+
+INT main()
+{
+    INT ret_code, i;
+    kdvv_opts_t opts = fnft_kdvv_default_opts();
+    const kdvv_testcases_t tc = kdvv_testcases_SECH;
+    opts.discretization = kdv_discretization_2SPLIT8B;
+    opts.bound_state_localization = kdvv_bsloc_SUBSAMPLE_AND_REFINE;
+    UINT D = 1024;
+    REAL eb[6] = {  // error bounds
+        5.78e-5,    // continuous spectrum
+        FNFT_INF,   // a(xi)
+        FNFT_INF,   // b(xi)
+        3.9e-5,     // bound states
+        4e-12,      // norming constants
+        6.4e-5      // residues
+    };
+
+    ret_code = kdvv_testcases_test_fnft(tc, D, eb, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    ret_code = kdvv_testcases_test_fnft(tc, D+1, eb, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+   
+    ret_code = kdvv_testcases_test_fnft(tc, D-1, eb, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // check for quadratic error decay
+    D *= 2;
+    for (i=0; i<6; i++)
+        eb[i] /= 4.0;
+    ret_code = kdvv_testcases_test_fnft(tc, D, eb, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+leave_fun:
+    if (ret_code != SUCCESS)
+        return EXIT_FAILURE;
+    else
+	    return EXIT_SUCCESS;
+}
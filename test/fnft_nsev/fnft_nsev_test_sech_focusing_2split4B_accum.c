@@ -0,0 +1,170 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* Sander Wahls (TU Delft) 2018.
+*/
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <stdio.h>
+#include "fnft__nsev_testcases.h"
+#include "fnft__misc.h"
+#include "fnft__errwarn.h"
+
+// Pushes the signal in chunks of irregular lengths into an accumulator and
+// compares the result with the one of fnft_nsev.
+static INT nsev_accum_test(const UINT D, fnft_nsev_opts_t * const opts)
+{
+    const UINT chunk_lens[6] = { 1, 2, 61, 128, 7, 300 };
+    COMPLEX *q = NULL, *contspec_exact = NULL, *ab_exact = NULL;
+    COMPLEX *bound_states_exact = NULL, *normconsts_exact = NULL;
+    COMPLEX *residues_exact = NULL;
+    COMPLEX *contspec[2] = { NULL, NULL }, *bound_states[2] = { NULL, NULL };
+    COMPLEX *normconsts[2] = { NULL, NULL }, *normconsts_matched = NULL;
+    fnft_nsev_accum_t *accum = NULL;
+    REAL T[2], XI[2], err;
+    UINT i, n, M, K[2], K_exact;
+    INT kappa;
+    INT ret_code;
+
+    ret_code = nsev_testcases(nsev_testcases_SECH_FOCUSING, D, &q, T, &M,
+        &contspec_exact, &ab_exact, XI, &K_exact, &bound_states_exact,
+        &normconsts_exact, &residues_exact, &kappa);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    for (i=0; i<2; i++) {
+        K[i] = D;
+        contspec[i] = malloc(M * sizeof(COMPLEX));
+        bound_states[i] = malloc(D * sizeof(COMPLEX));
+        normconsts[i] = malloc(D * sizeof(COMPLEX));
+        if (contspec[i] == NULL || bound_states[i] == NULL
+            || normconsts[i] == NULL) {
+            ret_code = E_NOMEM;
+            goto leave_fun;
+        }
+    }
+    normconsts_matched = malloc(D * sizeof(COMPLEX));
+    if (normconsts_matched == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+
+    // Reference
+    ret_code = fnft_nsev(D, q, T, M, contspec[0], XI, &K[0], bound_states[0],
+        normconsts[0], kappa, opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Streaming computation
+    ret_code = fnft_nsev_accum_init(D, T, kappa, opts, &accum);
+    CHECK_RETCODE(ret_code, leave_fun);
+    for (i=0, n=0; n<D; i++) {
+        UINT len = chunk_lens[i % 6];
+        if (len > D - n)
+            len = D - n;
+        ret_code = fnft_nsev_accum_push(accum, len, q + n);
+        CHECK_RETCODE(ret_code, leave_fun);
+        n += len;
+    }
+    ret_code = fnft_nsev_accum_finalize(accum, M, contspec[1], XI, &K[1],
+        bound_states[1], normconsts[1]);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Compare
+    if (K[0] != K_exact || K[1] != K[0]) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+    err = misc_rel_err(M, contspec[1], contspec[0]);
+#ifdef DEBUG
+    printf("nsev_accum_test: D = %i, error in contspec = %2.1e\n", (int)D,
+        err);
+#endif
+    if (!(err <= 1e-12)) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+    err = misc_hausdorff_dist(K[1], bound_states[1], K[0], bound_states[0]);
+#ifdef DEBUG
+    printf("nsev_accum_test: D = %i, error in bound states = %2.1e\n",
+        (int)D, err);
+#endif
+    if (!(err <= 1e-12)) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+    // The order of the bound states can differ since the fast eigenvalue
+    // method uses random shifts, so the norming constants are matched via
+    // the closest bound states
+    for (i=0; i<K[1]; i++) {
+        UINT j_min = 0;
+        for (n=1; n<K[0]; n++) {
+            if (CABS(bound_states[0][n] - bound_states[1][i])
+                < CABS(bound_states[0][j_min] - bound_states[1][i]))
+                j_min = n;
+        }
+        normconsts_matched[i] = normconsts[0][j_min];
+    }
+    err = misc_rel_err(K[1], normconsts[1], normconsts_matched);
+#ifdef DEBUG
+    printf("nsev_accum_test: D = %i, error in norming constants = %2.1e\n",
+        (int)D, err);
+#endif
+    if (!(err <= 1e-12)) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+
+    // Pushing more samples than announced must fail
+    if (fnft_nsev_accum_push(accum, 1, q) == SUCCESS)
+        ret_code = E_TEST_FAILED;
+
+leave_fun:
+    fnft_nsev_accum_free(accum);
+    free(q);
+    free(contspec_exact);
+    free(ab_exact);
+    free(bound_states_exact);
+    free(normconsts_exact);
+    free(residues_exact);
+    free(normconsts_matched);
+    for (i=0; i<2; i++) {
+        free(contspec[i]);
+        free(bound_states[i]);
+        free(normconsts[i]);
+    }
+    return ret_code;
+}
+
+INT main()
+{
+    fnft_nsev_opts_t opts;
+    INT ret_code;
+
+    opts = fnft_nsev_default_opts();
+    opts.discretization = nse_discretization_2SPLIT4B;
+
+    ret_code = nsev_accum_test(1000, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    opts.normalization_flag = 0;
+    ret_code = nsev_accum_test(1024, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+leave_fun:
+    if (ret_code != SUCCESS)
+        return EXIT_FAILURE;
+    else
+        return EXIT_SUCCESS;
+}
@@ -0,0 +1,62 @@
+/*
+* This file is part of FNFT.  
+*                                                                  
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*                                                                      
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* Sander Wahls (TU Delft) 2017-2018.
+* Shrinivas Chimmalgi (TU Delft) 2017-2018.
+*/
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include "fnft__nsev_testcases.h"
+#include "fnft__errwarn.h"
+
+INT main()
+{
+    INT ret_code;
+    fnft_nsev_opts_t opts;
+    UINT D = 4096;
+    const nsev_testcases_t tc = nsev_testcases_SECH_FOCUSING;
+    REAL error_bounds[6] = { 
+        3.9e-6,     // reflection coefficient
+        6.3e-6,     // a
+        2.0e-6,     // b
+        1.6e-5,     // bound states
+        5e-14,      // norming constants
+        2.1e-6      // residues
+    };
+
+    opts = fnft_nsev_default_opts();
+    opts.discretization = nse_discretization_2SPLIT4B;
+
+    // Newton iterations on the polynomial only. The bound states are then
+    // as accurate as the discretization, which is also seen in the norming
+    // constants.
+    opts.bound_state_refinement = nsev_bsref_POLY;
+    error_bounds[4] = 1e-6;
+    ret_code = nsev_testcases_test_fnft(tc, D, error_bounds, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Newton iterations on the polynomial followed by a single BO step
+    opts.bound_state_refinement = nsev_bsref_POLY_AND_BO;
+    error_bounds[4] = 5e-14;
+    ret_code = nsev_testcases_test_fnft(tc, D, error_bounds, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+leave_fun:
+    if (ret_code != SUCCESS)
+        return EXIT_FAILURE;
+    else
+	    return EXIT_SUCCESS;
+}
@@ -0,0 +1,129 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* Sander Wahls (TU Delft) 2018.
+*/
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <stdio.h>
+#include "fnft__nsev_testcases.h"
+#include "fnft__misc.h"
+#include "fnft__errwarn.h"
+
+// Compares the bound states computed with and without the counting
+// pre-check for the sech pulse scaled by scl, which has K_exact bound
+// states. The reference is computed with the fast eigenvalue method.
+static INT nsev_count_test(const UINT D, const REAL scl, const UINT K_exact,
+    fnft_nsev_opts_t * const opts)
+{
+    COMPLEX *q = NULL, *contspec_exact = NULL, *ab_exact = NULL;
+    COMPLEX *bound_states_exact = NULL, *normconsts_exact = NULL;
+    COMPLEX *residues_exact = NULL;
+    COMPLEX *bound_states[2] = { NULL, NULL };
+    fnft_nsev_opts_t opts_ref;
+    REAL T[2], XI[2], err;
+    UINT i, M, K[2], K_tc;
+    INT kappa;
+    INT ret_code;
+
+    ret_code = nsev_testcases(nsev_testcases_SECH_FOCUSING, D, &q, T, &M,
+        &contspec_exact, &ab_exact, XI, &K_tc, &bound_states_exact,
+        &normconsts_exact, &residues_exact, &kappa);
+    CHECK_RETCODE(ret_code, leave_fun);
+    for (i=0; i<D; i++)
+        q[i] *= scl;
+    for (i=0; i<2; i++) {
+        bound_states[i] = malloc(D * sizeof(COMPLEX));
+        if (bound_states[i] == NULL) {
+            ret_code = E_NOMEM;
+            goto leave_fun;
+        }
+    }
+
+    // Reference
+    opts_ref = *opts;
+    opts_ref.bound_state_localization = nsev_bsloc_FAST_EIGENVALUE;
+    opts_ref.bound_state_counting_flag = 0;
+    K[0] = D;
+    ret_code = fnft_nsev(D, q, T, 0, NULL, XI, &K[0], bound_states[0], NULL,
+        kappa, &opts_ref);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // With counting
+    opts->bound_state_counting_flag = 1;
+    K[1] = D;
+    ret_code = fnft_nsev(D, q, T, 0, NULL, XI, &K[1], bound_states[1], NULL,
+        kappa, opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+    if (opts->bound_state_counting_flag != 1) { // opts must be restored
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+
+    // Compare
+    if (K[0] != K_exact || K[1] != K[0]) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+    if (K_exact == 0)
+        goto leave_fun;
+    err = misc_hausdorff_dist(K[1], bound_states[1], K[0], bound_states[0]);
+#ifdef DEBUG
+    printf("nsev_count_test: D = %i, scl = %g, K = %i, error in bound states = %2.1e\n",
+        (int)D, scl, (int)K[1], err);
+#endif
+    if (!(err <= 1e-6))
+        ret_code = E_TEST_FAILED;
+
+leave_fun:
+    free(q);
+    free(contspec_exact);
+    free(ab_exact);
+    free(bound_states_exact);
+    free(normconsts_exact);
+    free(residues_exact);
+    for (i=0; i<2; i++)
+        free(bound_states[i]);
+    return ret_code;
+}
+
+INT main()
+{
+    fnft_nsev_opts_t opts;
+    INT ret_code;
+
+    opts = fnft_nsev_default_opts();
+    opts.discretization = nse_discretization_2SPLIT4B;
+    opts.bound_state_refinement = nsev_bsref_POLY;
+
+    // Signal with and without bound states
+    ret_code = nsev_count_test(1000, 1.0, 3, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = nsev_count_test(1000, 0.1, 0, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // The subsampled signal is too short to find all bound states, so that
+    // the fast eigenvalue method has to be applied to the full signal
+    opts.Dsub = 4;
+    ret_code = nsev_count_test(1000, 1.0, 3, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+leave_fun:
+    if (ret_code != SUCCESS)
+        return EXIT_FAILURE;
+    else
+        return EXIT_SUCCESS;
+}
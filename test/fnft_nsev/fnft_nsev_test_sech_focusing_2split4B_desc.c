@@ -0,0 +1,221 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* Sander Wahls (TU Delft) 2018.
+*/
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <stdio.h>
+#include "fnft__nsev_testcases.h"
+#include "fnft__nse_scatter.h"
+#include "fnft__sample_desc.h"
+#include "fnft__misc.h"
+#include "fnft__errwarn.h"
+
+// Passes the samples through the descriptor desc to fnft_nsev_desc and
+// compares the results with those of fnft_nsev for the contiguous array q
+// that contains the same samples. The bound states and norming constants
+// are also compared for nse_scatter_bound_states_desc.
+static INT nsev_desc_test(const UINT D, COMPLEX * const q,
+    sample_desc_t const * const desc, REAL const * const T, const UINT M,
+    REAL const * const XI, fnft_nsev_opts_t * const opts)
+{
+    COMPLEX *contspec[2] = { NULL, NULL }, *bound_states[2] = { NULL, NULL };
+    COMPLEX *normconsts[2] = { NULL, NULL }, *a_vals = NULL;
+    UINT i, K[2], trunc_index[2];
+    REAL err;
+    INT ret_code = SUCCESS;
+
+    for (i=0; i<2; i++) {
+        K[i] = D;
+        contspec[i] = malloc(M * sizeof(COMPLEX));
+        bound_states[i] = malloc(D * sizeof(COMPLEX));
+        normconsts[i] = malloc(2*D * sizeof(COMPLEX));
+        if (contspec[i] == NULL || bound_states[i] == NULL
+            || normconsts[i] == NULL) {
+            ret_code = E_NOMEM;
+            goto leave_fun;
+        }
+    }
+    a_vals = malloc(2*D * sizeof(COMPLEX));
+    if (a_vals == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+
+    // Continuous spectrum only. The samples are only read through the
+    // descriptor, so the results have to agree up to rounding.
+    ret_code = fnft_nsev(D, q, T, M, contspec[0], XI, NULL, NULL, NULL, 1,
+        opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = fnft_nsev_desc(D, desc, T, M, contspec[1], XI, NULL, NULL,
+        NULL, 1, opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+    err = misc_rel_err(M, contspec[1], contspec[0]);
+#ifdef DEBUG
+    printf("nsev_desc_test: error in contspec = %2.1e\n", err);
+#endif
+    if (!(err <= 10*EPSILON)) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+
+    // Full spectrum
+    ret_code = fnft_nsev(D, q, T, M, contspec[0], XI, &K[0], bound_states[0],
+        normconsts[0], 1, opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = fnft_nsev_desc(D, desc, T, M, contspec[1], XI, &K[1],
+        bound_states[1], normconsts[1], 1, opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+    if (K[0] == 0 || K[1] != K[0]) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+    err = misc_hausdorff_dist(K[1], bound_states[1], K[0], bound_states[0]);
+#ifdef DEBUG
+    printf("nsev_desc_test: error in bound states = %2.1e\n", err);
+#endif
+    if (!(err <= 1e-12)) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+
+    // Boffetta-Osborne scheme at the bound states
+    trunc_index[0] = D;
+    trunc_index[1] = D;
+    ret_code = nse_scatter_bound_states(D, q, T, &trunc_index[0], K[0],
+        bound_states[0], a_vals, a_vals + D, normconsts[0],
+        nse_discretization_BO);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = nse_scatter_bound_states_desc(D, desc, T, &trunc_index[1],
+        K[0], bound_states[0], a_vals, a_vals + D, normconsts[1],
+        nse_discretization_BO);
+    CHECK_RETCODE(ret_code, leave_fun);
+    if (trunc_index[1] != trunc_index[0]) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+    err = misc_rel_err(K[0], normconsts[1], normconsts[0]);
+#ifdef DEBUG
+    printf("nsev_desc_test: error in BO norming constants = %2.1e\n", err);
+#endif
+    if (!(err <= 10*EPSILON))
+        ret_code = E_TEST_FAILED;
+
+leave_fun:
+    for (i=0; i<2; i++) {
+        free(contspec[i]);
+        free(bound_states[i]);
+        free(normconsts[i]);
+    }
+    free(a_vals);
+    return ret_code;
+}
+
+INT main()
+{
+    const UINT D = 1024;
+    COMPLEX *q = NULL, *q_conv = NULL, *contspec_exact = NULL;
+    COMPLEX *ab_exact = NULL, *bound_states_exact = NULL;
+    COMPLEX *normconsts_exact = NULL, *residues_exact = NULL;
+    float *iq_float = NULL;
+    int16_t *iq_int16 = NULL;
+    sample_desc_t desc;
+    fnft_nsev_opts_t opts;
+    REAL T[2], XI[2], scale;
+    UINT i, M, K_exact;
+    INT kappa;
+    INT ret_code;
+
+    opts = fnft_nsev_default_opts();
+    opts.discretization = nse_discretization_2SPLIT4B;
+
+    ret_code = nsev_testcases(nsev_testcases_SECH_FOCUSING, D, &q, T, &M,
+        &contspec_exact, &ab_exact, XI, &K_exact, &bound_states_exact,
+        &normconsts_exact, &residues_exact, &kappa);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    q_conv = malloc(D * sizeof(COMPLEX));
+    iq_float = malloc(4*D * sizeof(float));
+    iq_int16 = malloc(2*D * sizeof(int16_t));
+    if (q_conv == NULL || iq_float == NULL || iq_int16 == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+
+    // Contiguous complex samples
+    desc = sample_desc_complex(q);
+    ret_code = nsev_desc_test(D, q, &desc, T, M, XI, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Interleaved float32 I/Q samples of the first of two polarizations
+    for (i=0; i<D; i++) {
+        iq_float[4*i] = (float)CREAL(q[i]);
+        iq_float[4*i + 1] = (float)CIMAG(q[i]);
+        iq_float[4*i + 2] = 0.5f;
+        iq_float[4*i + 3] = -0.5f;
+        q_conv[i] = (REAL)iq_float[4*i] + I*(REAL)iq_float[4*i + 1];
+    }
+    desc.type = sample_type_FLOAT32_IQ;
+    desc.data = iq_float;
+    desc.stride = 2;
+    desc.scale = 1.0;
+    ret_code = nsev_desc_test(D, q_conv, &desc, T, M, XI, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Interleaved int16 I/Q samples with a scale factor. The tails of the
+    // signal are quantized to zero.
+    scale = 0.0;
+    for (i=0; i<D; i++) {
+        if (CABS(q[i]) > scale)
+            scale = CABS(q[i]);
+    }
+    scale /= 32767;
+    for (i=0; i<D; i++) {
+        iq_int16[2*i] = (int16_t)ROUND(CREAL(q[i])/scale);
+        iq_int16[2*i + 1] = (int16_t)ROUND(CIMAG(q[i])/scale);
+        q_conv[i] = scale*((REAL)iq_int16[2*i] + I*(REAL)iq_int16[2*i + 1]);
+    }
+    desc.type = sample_type_INT16_IQ;
+    desc.data = iq_int16;
+    desc.stride = 1;
+    desc.scale = scale;
+    ret_code = nsev_desc_test(D, q_conv, &desc, T, M, XI, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Invalid descriptors must be rejected
+    desc.data = NULL;
+    if (fnft_nsev_desc(D, &desc, T, 0, NULL, XI, NULL, NULL, NULL, 1,
+        &opts) == SUCCESS) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+
+leave_fun:
+    free(q);
+    free(q_conv);
+    free(contspec_exact);
+    free(ab_exact);
+    free(bound_states_exact);
+    free(normconsts_exact);
+    free(residues_exact);
+    free(iq_float);
+    free(iq_int16);
+    if (ret_code != SUCCESS)
+        return EXIT_FAILURE;
+    else
+        return EXIT_SUCCESS;
+}
@@ -0,0 +1,182 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* Sander Wahls (TU Delft) 2018.
+*/
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <stdio.h>
+#include "fnft__nsev_testcases.h"
+#include "fnft__misc.h"
+#include "fnft__errwarn.h"
+
+#define NBS 8
+
+// Loss function L = sum_m |contspec[m] - c0|^2 + sum_k |bound_states[k] - l0|^2
+// for the spectrum of q. If K_ref > 0, the bound states are ordered like the
+// ones in bs_ref since the fast eigenvalue method can return them in any
+// order. On return, contspec and bound_states+NBS contain the derivatives of
+// L w.r.t. the conjugated continuous spectrum and bound states.
+static INT loss(const UINT D, COMPLEX * const q, REAL const * const T,
+    const UINT M, REAL const * const XI, fnft_nsev_opts_t * const opts,
+    const UINT K_ref, COMPLEX const * const bs_ref, COMPLEX * const contspec,
+    UINT * const K_ptr, COMPLEX * const bound_states, REAL * const L)
+{
+    const COMPLEX c0 = 0.3*I, l0 = 0.1 + 1.0*I;
+    COMPLEX bs[NBS];
+    UINT i, j, j_min;
+    INT ret_code;
+
+    *K_ptr = NBS;
+    ret_code = fnft_nsev(D, q, T, M, contspec, XI, K_ptr, bs, NULL, +1,
+        opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+    if (K_ref > 0 && *K_ptr != K_ref) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+    for (i=0; i<*K_ptr; i++) {
+        j_min = i;
+        if (K_ref > 0) {
+            for (j=0; j<*K_ptr; j++) {
+                if (CABS(bs[j] - bs_ref[i]) < CABS(bs[j_min] - bs_ref[i]))
+                    j_min = j;
+            }
+        }
+        bound_states[i] = bs[j_min];
+    }
+
+    *L = 0.0;
+    for (i=0; i<M; i++)
+        *L += CABS(contspec[i] - c0)*CABS(contspec[i] - c0);
+    for (i=0; i<*K_ptr; i++)
+        *L += CABS(bound_states[i] - l0)*CABS(bound_states[i] - l0);
+
+    for (i=0; i<M; i++)
+        contspec[i] -= c0;
+    for (i=0; i<*K_ptr; i++)
+        bound_states[i + NBS] = bound_states[i] - l0;
+
+leave_fun:
+    return ret_code;
+}
+
+// Compares the gradient of the loss with finite differences.
+static INT nsev_gradient_test(const UINT D, fnft_nsev_opts_t * const opts)
+{
+    COMPLEX *q = NULL, *contspec_exact = NULL, *ab_exact = NULL;
+    COMPLEX *bound_states_exact = NULL, *normconsts_exact = NULL;
+    COMPLEX *residues_exact = NULL, *contspec = NULL, *grad = NULL;
+    COMPLEX bound_states[2*NBS], bs_tmp[2*NBS], q0, dir;
+    const UINT idx[5] = { 0, D/3, D/2, D/2 + 1, D - 1 };
+    const REAL h = 1e-6;
+    REAL T[2], XI[2], L, Lp, Lm, fd, adj, err = 0.0, nrm = 0.0;
+    UINT i, j, M, K, K_tmp, K_exact;
+    INT kappa;
+    INT ret_code;
+
+    ret_code = nsev_testcases(nsev_testcases_SECH_FOCUSING, D, &q, T, &M,
+        &contspec_exact, &ab_exact, XI, &K_exact, &bound_states_exact,
+        &normconsts_exact, &residues_exact, &kappa);
+    CHECK_RETCODE(ret_code, leave_fun);
+    contspec = malloc(M * sizeof(COMPLEX));
+    grad = malloc(D * sizeof(COMPLEX));
+    if (contspec == NULL || grad == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+
+    // Gradient
+    ret_code = loss(D, q, T, M, XI, opts, 0, NULL, contspec, &K,
+        bound_states, &L);
+    CHECK_RETCODE(ret_code, leave_fun);
+    if (K != K_exact) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+    ret_code = fnft_nsev_gradient(D, q, T, M, contspec, XI, K, bound_states,
+        bound_states + NBS, kappa, opts, grad);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Central differences in the directions of the real and imaginary part
+    // of some samples. Since dL = 2*Re(conj(grad)*dq), the directional
+    // derivative in the direction dir is 2*Re(conj(grad)*dir).
+    for (i=0; i<5; i++) {
+        for (j=0; j<2; j++) {
+            dir = (j == 0) ? 1.0 : I;
+            q0 = q[idx[i]];
+            q[idx[i]] = q0 + h*dir;
+            ret_code = loss(D, q, T, M, XI, opts, K, bound_states, contspec,
+                &K_tmp, bs_tmp, &Lp);
+            CHECK_RETCODE(ret_code, leave_fun);
+            q[idx[i]] = q0 - h*dir;
+            ret_code = loss(D, q, T, M, XI, opts, K, bound_states, contspec,
+                &K_tmp, bs_tmp, &Lm);
+            CHECK_RETCODE(ret_code, leave_fun);
+            q[idx[i]] = q0;
+            fd = (Lp - Lm)/(2*h);
+            adj = 2*CREAL(CONJ(grad[idx[i]])*dir);
+#ifdef DEBUG
+            printf("nsev_gradient_test: n = %i, finite differences = %2.8e, gradient = %2.8e\n",
+                (int)idx[i], fd, adj);
+#endif
+            err += (fd - adj)*(fd - adj);
+            nrm += fd*fd;
+        }
+    }
+    err = SQRT(err/nrm);
+#ifdef DEBUG
+    printf("nsev_gradient_test: D = %i, relative error = %2.1e\n", (int)D, err);
+#endif
+    if (!(err <= 1e-6))
+        ret_code = E_TEST_FAILED;
+
+leave_fun:
+    free(q);
+    free(contspec_exact);
+    free(ab_exact);
+    free(bound_states_exact);
+    free(normconsts_exact);
+    free(residues_exact);
+    free(contspec);
+    free(grad);
+    return ret_code;
+}
+
+INT main()
+{
+    fnft_nsev_opts_t opts;
+    INT ret_code;
+
+    // The bound states are refined with the polynomial, so that they are
+    // the roots that are differentiated by fnft_nsev_gradient
+    opts = fnft_nsev_default_opts();
+    opts.discretization = nse_discretization_2SPLIT4B;
+    opts.bound_state_refinement = nsev_bsref_POLY;
+
+    ret_code = nsev_gradient_test(256, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    opts.normalization_flag = 0;
+    ret_code = nsev_gradient_test(512, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+leave_fun:
+    if (ret_code != SUCCESS)
+        return EXIT_FAILURE;
+    else
+        return EXIT_SUCCESS;
+}
@@ -0,0 +1,209 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* Sander Wahls (TU Delft) 2018.
+*/
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <stdio.h>
+#include "fnft__nsev_testcases.h"
+#include "fnft__misc.h"
+#include "fnft__errwarn.h"
+
+// Computes the errors of the continuous spectrum, the bound states and the
+// norming constants returned by fnft_nsev w.r.t. the exact values. Only the
+// reflection coefficient is checked if the continuous spectrum contains more.
+static INT nsev_errors(const UINT D, COMPLEX * const q, REAL const * const T,
+    const UINT M, COMPLEX const * const contspec_exact,
+    REAL const * const XI, const UINT K_exact,
+    COMPLEX const * const bound_states_exact,
+    COMPLEX const * const normconsts_exact, const INT kappa,
+    fnft_nsev_opts_t * const opts, REAL * const errs)
+{
+    COMPLEX *contspec = NULL, *bound_states = NULL, *normconsts = NULL;
+    COMPLEX *normconsts_matched = NULL;
+    UINT i, j, j_min, K = D;
+    INT ret_code;
+
+    contspec = malloc(3*M * sizeof(COMPLEX));
+    bound_states = malloc(D * sizeof(COMPLEX));
+    normconsts = malloc(D * sizeof(COMPLEX));
+    normconsts_matched = malloc(D * sizeof(COMPLEX));
+    if (contspec == NULL || bound_states == NULL || normconsts == NULL
+        || normconsts_matched == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+
+    ret_code = fnft_nsev(D, q, T, M, contspec, XI, &K, bound_states,
+        normconsts, kappa, opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+    if (K != K_exact) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+
+    // The bound states can be returned in any order, so the norming
+    // constants are matched via the closest exact bound states
+    for (i=0; i<K; i++) {
+        j_min = 0;
+        for (j=1; j<K_exact; j++) {
+            if (CABS(bound_states_exact[j] - bound_states[i])
+                < CABS(bound_states_exact[j_min] - bound_states[i]))
+                j_min = j;
+        }
+        normconsts_matched[i] = normconsts_exact[j_min];
+    }
+
+    errs[0] = misc_rel_err(M, contspec, contspec_exact);
+    errs[1] = misc_hausdorff_dist(K, bound_states, K_exact,
+        bound_states_exact);
+    errs[2] = misc_rel_err(K, normconsts, normconsts_matched);
+
+leave_fun:
+    free(contspec);
+    free(bound_states);
+    free(normconsts);
+    free(normconsts_matched);
+    return ret_code;
+}
+
+// Compares the errors of fnft_nsev with and without Richardson
+// extrapolation.
+static INT nsev_richardson_test(const UINT D, fnft_nsev_opts_t * const opts,
+    REAL const * const bnds)
+{
+    COMPLEX *q = NULL, *contspec_exact = NULL, *ab_exact = NULL;
+    COMPLEX *bound_states_exact = NULL, *normconsts_exact = NULL;
+    COMPLEX *residues_exact = NULL;
+    REAL T[2], XI[2], errs[2][3];
+    UINT i, M, K_exact;
+    INT kappa;
+    INT ret_code;
+
+    ret_code = nsev_testcases(nsev_testcases_SECH_FOCUSING, D, &q, T, &M,
+        &contspec_exact, &ab_exact, XI, &K_exact, &bound_states_exact,
+        &normconsts_exact, &residues_exact, &kappa);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    opts->richardson_extrapolation_flag = 0;
+    ret_code = nsev_errors(D, q, T, M, contspec_exact, XI, K_exact,
+        bound_states_exact, normconsts_exact, kappa, opts, errs[0]);
+    CHECK_RETCODE(ret_code, leave_fun);
+    opts->richardson_extrapolation_flag = 1;
+    ret_code = nsev_errors(D, q, T, M, contspec_exact, XI, K_exact,
+        bound_states_exact, normconsts_exact, kappa, opts, errs[1]);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    for (i=0; i<3; i++) {
+#ifdef DEBUG
+        printf("nsev_richardson_test: D = %i, error %i = %2.1e (without "
+            "extrapolation: %2.1e) <= %2.1e\n", (int)D, (int)i, errs[1][i],
+            errs[0][i], bnds[i]);
+#endif
+        if (!(errs[1][i] <= bnds[i])) {
+            ret_code = E_TEST_FAILED;
+            goto leave_fun;
+        }
+    }
+
+    // The extrapolation has to improve the continuous spectrum considerably.
+    // The improvement of the bound states is smaller if they are refined
+    // with the polynomial since its roots converge less regularly.
+    if (!(errs[1][0] <= 0.1*errs[0][0]) || !(errs[1][1] <= 0.5*errs[0][1]))
+        ret_code = E_TEST_FAILED;
+
+leave_fun:
+    free(q);
+    free(contspec_exact);
+    free(ab_exact);
+    free(bound_states_exact);
+    free(normconsts_exact);
+    free(residues_exact);
+    return ret_code;
+}
+
+// For an even number of samples, the decimated signal does not cover the
+// same interval. The extrapolation is then skipped, so that the errors are
+// the same as without extrapolation.
+static INT nsev_richardson_test_even_D(const UINT D,
+    fnft_nsev_opts_t * const opts)
+{
+    COMPLEX *q = NULL, *contspec_exact = NULL, *ab_exact = NULL;
+    COMPLEX *bound_states_exact = NULL, *normconsts_exact = NULL;
+    COMPLEX *residues_exact = NULL;
+    REAL T[2], XI[2], errs[2][3];
+    UINT i, M, K_exact;
+    INT kappa;
+    INT ret_code;
+
+    ret_code = nsev_testcases(nsev_testcases_SECH_FOCUSING, D, &q, T, &M,
+        &contspec_exact, &ab_exact, XI, &K_exact, &bound_states_exact,
+        &normconsts_exact, &residues_exact, &kappa);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    opts->richardson_extrapolation_flag = 0;
+    ret_code = nsev_errors(D, q, T, M, contspec_exact, XI, K_exact,
+        bound_states_exact, normconsts_exact, kappa, opts, errs[0]);
+    CHECK_RETCODE(ret_code, leave_fun);
+    opts->richardson_extrapolation_flag = 1;
+    ret_code = nsev_errors(D, q, T, M, contspec_exact, XI, K_exact,
+        bound_states_exact, normconsts_exact, kappa, opts, errs[1]);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    for (i=0; i<3; i++) {
+        if (errs[1][i] != errs[0][i]) {
+            ret_code = E_TEST_FAILED;
+            goto leave_fun;
+        }
+    }
+
+leave_fun:
+    free(q);
+    free(contspec_exact);
+    free(ab_exact);
+    free(bound_states_exact);
+    free(normconsts_exact);
+    free(residues_exact);
+    return ret_code;
+}
+
+INT main()
+{
+    const REAL bnds[3] = { 1e-5, 1e-4, 1e-4 };
+    fnft_nsev_opts_t opts;
+    INT ret_code;
+
+    opts = fnft_nsev_default_opts();
+    opts.discretization = nse_discretization_2SPLIT4B;
+
+    ret_code = nsev_richardson_test(1023, &opts, bnds);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    opts.bound_state_refinement = nsev_bsref_POLY;
+    opts.contspec_type = nsev_cstype_BOTH;
+    ret_code = nsev_richardson_test(1023, &opts, bnds);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    ret_code = nsev_richardson_test_even_D(1024, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+leave_fun:
+    if (ret_code != SUCCESS)
+        return EXIT_FAILURE;
+    else
+        return EXIT_SUCCESS;
+}
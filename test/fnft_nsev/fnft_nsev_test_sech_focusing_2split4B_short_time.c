@@ -0,0 +1,115 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* Sander Wahls (TU Delft) 2018.
+*/
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <stdio.h>
+#include "fnft__nsev_testcases.h"
+#include "fnft__misc.h"
+#include "fnft__errwarn.h"
+
+// Computes the short-time NFT of a signal and compares the spectrum of
+// every window with the one that fnft_nsev computes for the window.
+static INT nsev_short_time_test(const UINT D, const UINT window_len,
+    const UINT hop, fnft_nsev_opts_t * const opts)
+{
+    COMPLEX *q = NULL, *contspec_exact = NULL, *ab_exact = NULL;
+    COMPLEX *bound_states_exact = NULL, *normconsts_exact = NULL;
+    COMPLEX *residues_exact = NULL;
+    COMPLEX *contspec = NULL, *contspec_window = NULL;
+    REAL T[2], T_window[2], XI[2], eps_t, err;
+    UINT w, M, K_exact;
+    const UINT n_windows = (D - window_len)/hop + 1;
+    INT kappa;
+    INT ret_code;
+
+    ret_code = nsev_testcases(nsev_testcases_SECH_FOCUSING, D, &q, T, &M,
+        &contspec_exact, &ab_exact, XI, &K_exact, &bound_states_exact,
+        &normconsts_exact, &residues_exact, &kappa);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    contspec = malloc(n_windows*M * sizeof(COMPLEX));
+    contspec_window = malloc(M * sizeof(COMPLEX));
+    if (contspec == NULL || contspec_window == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+
+    ret_code = fnft_nsev_short_time(D, q, T, window_len, hop, M, contspec,
+        XI, kappa, opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    eps_t = (T[1] - T[0])/(D - 1);
+    for (w=0; w<n_windows; w++) {
+        T_window[0] = T[0] + w*hop*eps_t;
+        T_window[1] = T[0] + (w*hop + window_len - 1)*eps_t;
+        ret_code = fnft_nsev(window_len, q + w*hop, T_window, M,
+            contspec_window, XI, NULL, NULL, NULL, kappa, opts);
+        CHECK_RETCODE(ret_code, leave_fun);
+        err = misc_rel_err(M, contspec + w*M, contspec_window);
+#ifdef DEBUG
+        printf("nsev_short_time_test: window %i, error = %2.1e\n", (int)w,
+            err);
+#endif
+        if (!(err <= 1e-10)) {
+            ret_code = E_TEST_FAILED;
+            goto leave_fun;
+        }
+    }
+
+    // The window length has to be a multiple of the hop size
+    if (fnft_nsev_short_time(D, q, T, window_len, hop + 1, M, contspec, XI,
+        kappa, opts) == SUCCESS)
+        ret_code = E_TEST_FAILED;
+
+leave_fun:
+    free(q);
+    free(contspec_exact);
+    free(ab_exact);
+    free(bound_states_exact);
+    free(normconsts_exact);
+    free(residues_exact);
+    free(contspec);
+    free(contspec_window);
+    return ret_code;
+}
+
+INT main()
+{
+    fnft_nsev_opts_t opts;
+    INT ret_code;
+
+    opts = fnft_nsev_default_opts();
+    opts.discretization = nse_discretization_2SPLIT4B;
+
+    ret_code = nsev_short_time_test(1024, 256, 32, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    ret_code = nsev_short_time_test(1000, 120, 40, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    opts.normalization_flag = 0;
+    ret_code = nsev_short_time_test(1024, 256, 32, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+leave_fun:
+    if (ret_code != SUCCESS)
+        return EXIT_FAILURE;
+    else
+        return EXIT_SUCCESS;
+}
@@ -0,0 +1,146 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* Sander Wahls (TU Delft) 2018.
+*/
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <stdio.h>
+#include "fnft__nsev_testcases.h"
+#include "fnft__misc.h"
+#include "fnft__errwarn.h"
+
+#define NFRAMES 10
+
+// Processes frames with slowly changing amplitudes using a tracker and
+// compares the results with the ones of fnft_nsev. The amplitude of the
+// sech pulse drops between the frames 7 and 8 so much that one of the
+// three bound states disappears.
+static INT nsev_tracker_test(const UINT D, fnft_nsev_opts_t * const opts)
+{
+    const REAL scl[NFRAMES] = { 1.0, 0.99, 0.98, 0.97, 0.96, 0.95, 0.94,
+        0.93, 0.7, 0.69 };
+    const INT relocalized_exact[NFRAMES] = { 1, 0, 0, 0, 0, 0, 0, 0, 1, 0 };
+    const UINT K_frame_exact[NFRAMES] = { 3, 3, 3, 3, 3, 3, 3, 3, 2, 2 };
+    COMPLEX *q = NULL, *contspec_exact = NULL, *ab_exact = NULL;
+    COMPLEX *bound_states_exact = NULL, *normconsts_exact = NULL;
+    COMPLEX *residues_exact = NULL, *q_frame = NULL;
+    COMPLEX *contspec[2] = { NULL, NULL }, *bound_states[2] = { NULL, NULL };
+    fnft_nsev_tracker_t *tracker = NULL;
+    REAL T[2], XI[2], err;
+    UINT i, f, M, K[2], K_exact;
+    INT kappa, relocalized_flag;
+    INT ret_code;
+
+    ret_code = nsev_testcases(nsev_testcases_SECH_FOCUSING, D, &q, T, &M,
+        &contspec_exact, &ab_exact, XI, &K_exact, &bound_states_exact,
+        &normconsts_exact, &residues_exact, &kappa);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    q_frame = malloc(D * sizeof(COMPLEX));
+    if (q_frame == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+    for (i=0; i<2; i++) {
+        contspec[i] = malloc(M * sizeof(COMPLEX));
+        bound_states[i] = malloc(D * sizeof(COMPLEX));
+        if (contspec[i] == NULL || bound_states[i] == NULL) {
+            ret_code = E_NOMEM;
+            goto leave_fun;
+        }
+    }
+
+    ret_code = fnft_nsev_tracker_init(&tracker);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    for (f=0; f<NFRAMES; f++) {
+        for (i=0; i<D; i++)
+            q_frame[i] = scl[f]*q[i];
+
+        // Reference
+        K[0] = D;
+        ret_code = fnft_nsev(D, q_frame, T, M, contspec[0], XI, &K[0],
+            bound_states[0], NULL, kappa, opts);
+        CHECK_RETCODE(ret_code, leave_fun);
+
+        // Tracking
+        K[1] = D;
+        ret_code = fnft_nsev_tracker_step(tracker, D, q_frame, T, M,
+            contspec[1], XI, &K[1], bound_states[1], NULL, kappa, opts,
+            &relocalized_flag);
+        CHECK_RETCODE(ret_code, leave_fun);
+
+        // Compare
+        if (K[0] != K_frame_exact[f] || K[1] != K[0]
+            || relocalized_flag != relocalized_exact[f]) {
+            ret_code = E_TEST_FAILED;
+            goto leave_fun;
+        }
+        err = misc_rel_err(M, contspec[1], contspec[0]);
+        if (!(err <= 1e-14)) {
+            ret_code = E_TEST_FAILED;
+            goto leave_fun;
+        }
+        err = misc_hausdorff_dist(K[1], bound_states[1], K[0],
+            bound_states[0]);
+#ifdef DEBUG
+        printf("nsev_tracker_test: frame %i, relocalized = %i, error in bound states = %2.1e\n",
+            (int)f, (int)relocalized_flag, err);
+#endif
+        if (!(err <= 1e-10)) {
+            ret_code = E_TEST_FAILED;
+            goto leave_fun;
+        }
+    }
+
+leave_fun:
+    fnft_nsev_tracker_free(tracker);
+    free(q);
+    free(contspec_exact);
+    free(ab_exact);
+    free(bound_states_exact);
+    free(normconsts_exact);
+    free(residues_exact);
+    free(q_frame);
+    for (i=0; i<2; i++) {
+        free(contspec[i]);
+        free(bound_states[i]);
+    }
+    return ret_code;
+}
+
+INT main()
+{
+    fnft_nsev_opts_t opts;
+    INT ret_code;
+
+    opts = fnft_nsev_default_opts();
+    opts.discretization = nse_discretization_2SPLIT4B;
+
+    ret_code = nsev_tracker_test(1000, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    opts.bound_state_refinement = nsev_bsref_POLY;
+    ret_code = nsev_tracker_test(1024, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+leave_fun:
+    if (ret_code != SUCCESS)
+        return EXIT_FAILURE;
+    else
+        return EXIT_SUCCESS;
+}
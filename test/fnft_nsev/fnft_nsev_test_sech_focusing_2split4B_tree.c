@@ -0,0 +1,155 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* Sander Wahls (TU Delft) 2018.
+*/
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <stdio.h>
+#include "fnft__nsev_testcases.h"
+#include "fnft__misc.h"
+#include "fnft__errwarn.h"
+
+// Changes a few samples of a signal in a product tree in two rounds and
+// compares the spectra that are queried from the tree after each round
+// with the ones of fnft_nsev for the changed signal.
+static INT nsev_tree_test(const UINT D, const UINT block_len,
+    fnft_nsev_opts_t * const opts)
+{
+    UINT idx[2][4] = { { 0, 500, 501, 37 }, { 0, 999, 998, 250 } };
+    COMPLEX q_new[4];
+    COMPLEX *q = NULL, *contspec_exact = NULL, *ab_exact = NULL;
+    COMPLEX *bound_states_exact = NULL, *normconsts_exact = NULL;
+    COMPLEX *residues_exact = NULL;
+    COMPLEX *contspec[2] = { NULL, NULL }, *bound_states[2] = { NULL, NULL };
+    fnft_nsev_tree_t *tree = NULL;
+    REAL T[2], XI[2], err;
+    UINT i, k, M, K[2], K_exact;
+    INT kappa;
+    INT ret_code;
+
+    ret_code = nsev_testcases(nsev_testcases_SECH_FOCUSING, D, &q, T, &M,
+        &contspec_exact, &ab_exact, XI, &K_exact, &bound_states_exact,
+        &normconsts_exact, &residues_exact, &kappa);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    for (i=0; i<2; i++) {
+        contspec[i] = malloc(M * sizeof(COMPLEX));
+        bound_states[i] = malloc(D * sizeof(COMPLEX));
+        if (contspec[i] == NULL || bound_states[i] == NULL) {
+            ret_code = E_NOMEM;
+            goto leave_fun;
+        }
+    }
+
+    ret_code = fnft_nsev_tree_init(D, q, T, block_len, kappa, opts, &tree);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    for (k=0; k<2; k++) {
+
+        // Change some samples, including the first and the last one, in
+        // the signal and in the tree
+        for (i=0; i<4; i++) {
+            if (idx[k][i] >= D)
+                idx[k][i] = D - 1;
+            q_new[i] = q[idx[k][i]]*(1.0 + 0.1*(i+1)) + 0.02*I*(k+1);
+            q[idx[k][i]] = q_new[i];
+        }
+        ret_code = fnft_nsev_tree_update(tree, 4, idx[k], q_new);
+        CHECK_RETCODE(ret_code, leave_fun);
+
+        // Reference
+        K[0] = D;
+        ret_code = fnft_nsev(D, q, T, M, contspec[0], XI, &K[0],
+            bound_states[0], NULL, kappa, opts);
+        CHECK_RETCODE(ret_code, leave_fun);
+
+        // Tree
+        K[1] = D;
+        ret_code = fnft_nsev_tree_query(tree, M, contspec[1], XI, &K[1],
+            bound_states[1], NULL);
+        CHECK_RETCODE(ret_code, leave_fun);
+
+        // Compare
+        if (K[1] != K[0]) {
+            ret_code = E_TEST_FAILED;
+            goto leave_fun;
+        }
+        err = misc_rel_err(M, contspec[1], contspec[0]);
+#ifdef DEBUG
+        printf("nsev_tree_test: block_len = %i, round %i, error in contspec = %2.1e\n",
+            (int)block_len, (int)k, err);
+#endif
+        if (!(err <= 1e-12)) {
+            ret_code = E_TEST_FAILED;
+            goto leave_fun;
+        }
+        err = misc_hausdorff_dist(K[1], bound_states[1], K[0],
+            bound_states[0]);
+#ifdef DEBUG
+        printf("nsev_tree_test: block_len = %i, round %i, error in bound states = %2.1e\n",
+            (int)block_len, (int)k, err);
+#endif
+        if (!(err <= 1e-12)) {
+            ret_code = E_TEST_FAILED;
+            goto leave_fun;
+        }
+    }
+
+    // Out of range indices must be rejected
+    idx[0][0] = D;
+    if (fnft_nsev_tree_update(tree, 1, idx[0], q_new) == SUCCESS)
+        ret_code = E_TEST_FAILED;
+
+leave_fun:
+    fnft_nsev_tree_free(tree);
+    free(q);
+    free(contspec_exact);
+    free(ab_exact);
+    free(bound_states_exact);
+    free(normconsts_exact);
+    free(residues_exact);
+    for (i=0; i<2; i++) {
+        free(contspec[i]);
+        free(bound_states[i]);
+    }
+    return ret_code;
+}
+
+INT main()
+{
+    fnft_nsev_opts_t opts;
+    INT ret_code;
+
+    opts = fnft_nsev_default_opts();
+    opts.discretization = nse_discretization_2SPLIT4B;
+
+    ret_code = nsev_tree_test(1000, 1, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    ret_code = nsev_tree_test(1000, 16, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    opts.normalization_flag = 0;
+    ret_code = nsev_tree_test(1024, 7, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+leave_fun:
+    if (ret_code != SUCCESS)
+        return EXIT_FAILURE;
+    else
+        return EXIT_SUCCESS;
+}
@@ -0,0 +1,155 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* Sander Wahls (TU Delft) 2018.
+*/
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <stdio.h>
+#include "fnft_nsev.h"
+#include "fnft__misc.h"
+#include "fnft__errwarn.h"
+
+// Computes the nonlinear Fourier spectrum of a sech pulse whose tails have
+// been set to exactly zero, and compares it with the one of the nonzero part
+// of the signal. Since the scattering matrix for q=0 is a pure phase shift,
+// zero padding does not change the spectrum. The transfer matrix of the
+// padded signal has vanishing leading and trailing coefficients, which the
+// root finder has to cope with.
+static INT nsev_test_zero_tails(const UINT D, fnft_nsev_opts_t * const opts)
+{
+    const UINT M = 16;
+    REAL T[2] = { -20.0, 20.0 }, XI[2] = { -2.0, 2.0 };
+    COMPLEX *q = NULL, *bound_states[2] = { NULL, NULL };
+    COMPLEX *normconsts[2] = { NULL, NULL }, contspec[2][16];
+    UINT i, i0 = 0, i1 = 0, K[2];
+    REAL t, err;
+    INT ret_code = SUCCESS;
+
+    q = malloc(D * sizeof(COMPLEX));
+    for (i=0; i<2; i++) {
+        K[i] = D;
+        bound_states[i] = malloc(D * sizeof(COMPLEX));
+        normconsts[i] = malloc(D * sizeof(COMPLEX));
+        if (bound_states[i] == NULL || normconsts[i] == NULL) {
+            ret_code = E_NOMEM;
+            goto leave_fun;
+        }
+    }
+    if (q == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+
+    // Signal with zero tails. The nonzero samples are q[i0],...,q[i1].
+    const REAL eps_t = (T[1] - T[0])/(D - 1);
+    for (i=0; i<D; i++) {
+        t = T[0] + i*eps_t;
+        if (FABS(t) > 10.0) {
+            q[i] = 0.0;
+        } else {
+            q[i] = 1.5/COSH(t);
+            if (i0 == 0)
+                i0 = i;
+            i1 = i;
+        }
+    }
+    REAL const T_seg[2] = { T[0] + i0*eps_t, T[0] + i1*eps_t };
+
+    ret_code = fnft_nsev(D, q, T, M, contspec[0], XI, &K[0], bound_states[0],
+        normconsts[0], 1, opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = fnft_nsev(i1 - i0 + 1, q + i0, T_seg, M, contspec[1], XI, &K[1],
+        bound_states[1], normconsts[1], 1, opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // The signal has one bound state close to 1.0j
+    if (K[0] != 1 || K[1] != 1) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+    err = CABS(bound_states[0][0] - I);
+#ifdef DEBUG
+    printf("nsev_test_zero_tails: D = %i, distance to 1.0j = %2.1e\n",
+        (int)D, err);
+#endif
+    if (!(err <= 1e-3)) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+
+    err = CABS(bound_states[0][0] - bound_states[1][0]);
+#ifdef DEBUG
+    printf("nsev_test_zero_tails: D = %i, error in bound states = %2.1e\n",
+        (int)D, err);
+#endif
+    if (!(err <= 1e-11)) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+
+    err = misc_rel_err(1, normconsts[0], normconsts[1]);
+#ifdef DEBUG
+    printf("nsev_test_zero_tails: D = %i, error in norming constants = %2.1e\n",
+        (int)D, err);
+#endif
+    if (!(err <= 1e-10)) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+
+    err = misc_rel_err(M, contspec[0], contspec[1]);
+#ifdef DEBUG
+    printf("nsev_test_zero_tails: D = %i, error in contspec = %2.1e\n",
+        (int)D, err);
+#endif
+    if (!(err <= 1e-10))
+        ret_code = E_TEST_FAILED;
+
+leave_fun:
+    free(q);
+    for (i=0; i<2; i++) {
+        free(bound_states[i]);
+        free(normconsts[i]);
+    }
+    return ret_code;
+}
+
+INT main()
+{
+    fnft_nsev_opts_t opts;
+    INT ret_code;
+
+    // Default options, i.e., the fast eigenvalue root finder is applied to
+    // a subsampled signal whose tails are also exactly zero
+    opts = fnft_nsev_default_opts();
+    opts.discretization = nse_discretization_2SPLIT4B;
+    ret_code = nsev_test_zero_tails(1024, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = nsev_test_zero_tails(1023, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    // Fast eigenvalue method applied to the full signal
+    opts.bound_state_localization = nsev_bsloc_FAST_EIGENVALUE;
+    ret_code = nsev_test_zero_tails(1024, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+leave_fun:
+    if (ret_code != SUCCESS)
+        return EXIT_FAILURE;
+    else
+        return EXIT_SUCCESS;
+}
@@ -0,0 +1,152 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* Sander Wahls (TU Delft) 2018.
+*/
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <stdio.h>
+#include "fnft__nsev_testcases.h"
+#include "fnft__misc.h"
+#include "fnft__errwarn.h"
+
+// Selects a discretization and a number of samples for the error tolerance
+// err_tol and checks that fnft_nsev meets the tolerance up to a factor of
+// ten for this choice. The decision is cached and then looked up again,
+// also for a slightly larger tolerance in the same bucket. There is no time
+// budget, so that the decision does not depend on the load of the machine.
+static INT nsev_autotune_test(const REAL err_tol,
+    fnft_nsev_autotune_cache_t * const cache)
+{
+    const UINT D = 4097;
+    COMPLEX *q = NULL, *contspec_exact = NULL, *ab_exact = NULL;
+    COMPLEX *bound_states_exact = NULL, *normconsts_exact = NULL;
+    COMPLEX *residues_exact = NULL, *contspec = NULL;
+    fnft_nsev_opts_t opts, opts_cached;
+    REAL T[2], XI[2], err;
+    UINT M, K_exact, D_tuned, D_cached;
+    INT kappa;
+    INT ret_code;
+
+    ret_code = nsev_testcases(nsev_testcases_SECH_FOCUSING, D, &q, T, &M,
+        &contspec_exact, &ab_exact, XI, &K_exact, &bound_states_exact,
+        &normconsts_exact, &residues_exact, &kappa);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    opts = fnft_nsev_default_opts();
+    ret_code = fnft_nsev_autotune(D, q, T, M, XI, kappa, err_tol, INFINITY, cache,
+        0, &opts, &D_tuned);
+    CHECK_RETCODE(ret_code, leave_fun);
+    if (D_tuned < 2) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+
+    // The cached decision has to be the same
+    opts_cached = fnft_nsev_default_opts();
+    ret_code = fnft_nsev_autotune(D, q, T, M, XI, kappa, err_tol, INFINITY, cache,
+        0, &opts_cached, &D_cached);
+    CHECK_RETCODE(ret_code, leave_fun);
+    if (opts_cached.discretization != opts.discretization
+        || D_cached != D_tuned) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+    opts_cached = fnft_nsev_default_opts();
+    ret_code = fnft_nsev_autotune(D, q, T, M, XI, kappa, 1.01*err_tol, 0.0,
+        cache, 0, &opts_cached, &D_cached);
+    CHECK_RETCODE(ret_code, leave_fun);
+    if (opts_cached.discretization != opts.discretization
+        || D_cached != D_tuned) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+
+    // No discretization can meet a tolerance far below machine precision
+    opts_cached = fnft_nsev_default_opts();
+    D_cached = 0;
+    ret_code = fnft_nsev_autotune(D, q, T, M, XI, kappa, 1e-30, 0.0, NULL,
+        0, &opts_cached, &D_cached);
+    if (ret_code == SUCCESS || D_cached != 0) {
+        ret_code = E_TEST_FAILED;
+        goto leave_fun;
+    }
+
+    // Run fnft_nsev with the selected discretization and number of samples
+    free(q);
+    free(contspec_exact);
+    free(ab_exact);
+    free(bound_states_exact);
+    free(normconsts_exact);
+    free(residues_exact);
+    q = NULL;
+    contspec_exact = NULL;
+    ab_exact = NULL;
+    bound_states_exact = NULL;
+    normconsts_exact = NULL;
+    residues_exact = NULL;
+    ret_code = nsev_testcases(nsev_testcases_SECH_FOCUSING, D_tuned, &q, T,
+        &M, &contspec_exact, &ab_exact, XI, &K_exact, &bound_states_exact,
+        &normconsts_exact, &residues_exact, &kappa);
+    CHECK_RETCODE(ret_code, leave_fun);
+    contspec = malloc(M * sizeof(COMPLEX));
+    if (contspec == NULL) {
+        ret_code = E_NOMEM;
+        goto leave_fun;
+    }
+    ret_code = fnft_nsev(D_tuned, q, T, M, contspec, XI, NULL, NULL, NULL,
+        kappa, &opts);
+    CHECK_RETCODE(ret_code, leave_fun);
+    err = misc_rel_err(M, contspec, contspec_exact);
+#ifdef DEBUG
+    printf("nsev_autotune_test: err_tol = %2.1e, discretization = %i, "
+        "D = %i, error in contspec = %2.1e\n", err_tol,
+        (int)opts.discretization, (int)D_tuned, err);
+#endif
+    if (!(err <= 10*err_tol))
+        ret_code = E_TEST_FAILED;
+
+leave_fun:
+    free(q);
+    free(contspec_exact);
+    free(ab_exact);
+    free(bound_states_exact);
+    free(normconsts_exact);
+    free(residues_exact);
+    free(contspec);
+    return ret_code;
+}
+
+INT main()
+{
+    fnft_nsev_autotune_cache_t *cache = NULL;
+    INT ret_code;
+
+    ret_code = fnft_nsev_autotune_cache_init(&cache);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    ret_code = nsev_autotune_test(1e-3, cache);
+    CHECK_RETCODE(ret_code, leave_fun);
+    ret_code = nsev_autotune_test(1e-5, cache);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+leave_fun:
+    fnft_nsev_autotune_cache_free(cache);
+    if (ret_code != SUCCESS)
+        return EXIT_FAILURE;
+    else
+        return EXIT_SUCCESS;
+}
@@ -0,0 +1,81 @@
+/*
+* This file is part of FNFT.
+*
+* FNFT is free software; you can redistribute it and/or
+* modify it under the terms of the version 2 of the GNU General
+* Public License as published by the Free Software Foundation.
+*
+* FNFT is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program. If not, see <http://www.gnu.org/licenses/>.
+*
+* Contributors:
+* Sander Wahls (TU Delft) 2018.
+*/
+#define FNFT_ENABLE_SHORT_NAMES
+
+#include <stdio.h>
+#include "fnft__nsev_testcases.h"
+#include "fnft__errwarn.h"
+
+// With a time budget of zero, only the first candidate is tried. It is
+// refined independently of the budget, so that it has to be selected for a
+// tolerance that it can meet.
+static INT nsev_autotune_zero_budget_test(const REAL err_tol)
+{
+    const UINT D = 4097;
+    COMPLEX *q = NULL, *contspec_exact = NULL, *ab_exact = NULL;
+    COMPLEX *bound_states_exact = NULL, *normconsts_exact = NULL;
+    COMPLEX *residues_exact = NULL;
+    fnft_nsev_opts_t opts;
+    REAL T[2], XI[2];
+    UINT M, K_exact, D_tuned = 0;
+    INT kappa;
+    INT ret_code;
+
+    ret_code = nsev_testcases(nsev_testcases_SECH_FOCUSING, D, &q, T, &M,
+        &contspec_exact, &ab_exact, XI, &K_exact, &bound_states_exact,
+        &normconsts_exact, &residues_exact, &kappa);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+    opts = fnft_nsev_default_opts();
+    ret_code = fnft_nsev_autotune(D, q, T, M, XI, kappa, err_tol, 0.0, NULL,
+        0, &opts, &D_tuned);
+    CHECK_RETCODE(ret_code, leave_fun);
+#ifdef DEBUG
+    printf("nsev_autotune_zero_budget_test: err_tol = %2.1e, "
+        "discretization = %i, D = %i\n", err_tol, (int)opts.discretization,
+        (int)D_tuned);
+#endif
+    if (opts.discretization != nse_discretization_2SPLIT2_MODAL
+        || D_tuned < 2 || D_tuned > D)
+        ret_code = E_TEST_FAILED;
+
+leave_fun:
+    free(q);
+    free(contspec_exact);
+    free(ab_exact);
+    free(bound_states_exact);
+    free(normconsts_exact);
+    free(residues_exact);
+    return ret_code;
+}
+
+INT main()
+{
+    INT ret_code;
+
+    // The first candidate, 2SPLIT2_MODAL, meets this loose tolerance
+    ret_code = nsev_autotune_zero_budget_test(1e-2);
+    CHECK_RETCODE(ret_code, leave_fun);
+
+leave_fun:
+    if (ret_code != SUCCESS)
+        return EXIT_FAILURE;
+    else
+        return EXIT_SUCCESS;
+}